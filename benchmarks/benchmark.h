@@ -0,0 +1,400 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "perf_counters.h"
+#include "timer.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+/// Makes the compiler assume that Value is read, so the computation of it
+/// can not be removed as dead code
+template <typename TValueType>
+inline void DoNotOptimize(TValueType const& Value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(Value) : "memory");
+#else
+    static volatile char const* p_sink;
+    p_sink = reinterpret_cast<volatile char const*>(&Value);
+    _ReadWriteBarrier();
+#endif
+}
+
+/// Makes the compiler assume that all the memory is read and written, so
+/// pending stores are not sunk out of the measured loop
+inline void ClobberMemory() {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#else
+    _ReadWriteBarrier();
+#endif
+}
+
+struct BenchmarkSettings {
+    std::size_t mNumberOfTrials = 10;
+    double mMinimumTrialTime = 0.02;  // seconds
+    double mMaximumBenchmarkTime = 2.0;  // seconds, without the warm-up
+    std::size_t mMaximumSize = 2048;  // of the matrices
+    std::size_t mMaximumVectorSize = 10000000;
+    std::string mFilter;
+    std::string mLabel;
+    bool mUsePerfCounters = false;
+};
+
+/// Result of one benchmark. The samples are the time per iteration of each
+/// trial in nanoseconds
+struct BenchmarkResult {
+    std::string mName;
+    std::string mLibrary;
+    std::string mSizeClass;
+    std::size_t mSize1 = 0;
+    std::size_t mSize2 = 0;
+    std::size_t mIterations = 0;
+    double mFlops = 0.00;  // per iteration
+    double mBytes = 0.00;  // per iteration
+    bool mIsValid = true;
+    std::vector<double> mSamples;
+    PerfCounters::Values mCounters;  // per iteration, if measured
+
+    double Median() const {
+        if (mSamples.empty())
+            return 0.00;
+        std::vector<double> sorted(mSamples);
+        std::sort(sorted.begin(), sorted.end());
+        const std::size_t middle = sorted.size() / 2;
+        if (sorted.size() % 2)
+            return sorted[middle];
+        return 0.5 * (sorted[middle - 1] + sorted[middle]);
+    }
+
+    double Mean() const {
+        double sum = 0.00;
+        for (auto sample : mSamples)
+            sum += sample;
+        return mSamples.empty() ? 0.00 : sum / mSamples.size();
+    }
+
+    /// Sample variance
+    double Variance() const {
+        if (mSamples.size() < 2)
+            return 0.00;
+        const double mean = Mean();
+        double sum = 0.00;
+        for (auto sample : mSamples)
+            sum += (sample - mean) * (sample - mean);
+        return sum / (mSamples.size() - 1);
+    }
+
+    double StandardDeviation() const { return std::sqrt(Variance()); }
+
+    double Minimum() const {
+        return mSamples.empty()
+                   ? 0.00
+                   : *std::min_element(mSamples.begin(), mSamples.end());
+    }
+
+    double Maximum() const {
+        return mSamples.empty()
+                   ? 0.00
+                   : *std::max_element(mSamples.begin(), mSamples.end());
+    }
+
+    double GFlopsPerSecond() const {
+        const double median = Median();
+        return (median > 0.00) ? mFlops / median : 0.00;
+    }
+
+    double GBytesPerSecond() const {
+        const double median = Median();
+        return (median > 0.00) ? mBytes / median : 0.00;
+    }
+
+    double InstructionsPerCycle() const {
+        return mCounters.ratio(PerfCounters::instructions, PerfCounters::cycles);
+    }
+
+    /// Retired floating point operations per cycle. Without a floating
+    /// point counter the nominal flops of the benchmark are used
+    double FlopsPerCycle() const {
+        if (mCounters.available(PerfCounters::fp_operations))
+            return mCounters.ratio(
+                PerfCounters::fp_operations, PerfCounters::cycles);
+        if (!mCounters.available(PerfCounters::cycles) ||
+            mCounters[PerfCounters::cycles] <= 0.00)
+            return -1.00;
+        return mFlops / mCounters[PerfCounters::cycles];
+    }
+
+    double L1MissRate() const {
+        return mCounters.ratio(
+            PerfCounters::l1d_misses, PerfCounters::l1d_accesses);
+    }
+
+    double LastLevelMissRate() const {
+        return mCounters.ratio(
+            PerfCounters::llc_misses, PerfCounters::llc_references);
+    }
+
+    double BranchMissRate() const {
+        return mCounters.ratio(
+            PerfCounters::branch_misses, PerfCounters::branches);
+    }
+
+    std::string SizeString() const {
+        std::stringstream size_string;
+        size_string << mSize1 << "x" << mSize2;
+        return size_string.str();
+    }
+};
+
+/// Runs and collects the benchmarks. Each benchmark is warmed up and
+/// calibrated to a number of iterations which takes at least the minimum
+/// trial time, then the trials are repeated until the number of trials or
+/// the time limit is reached
+class BenchmarkSuite {
+    BenchmarkSettings mSettings;
+    std::vector<BenchmarkResult> mResults;
+    std::ostream* mpProgressStream;
+    std::unique_ptr<PerfCounters> mpCounters;
+
+    static std::string Escape(std::string const& Text) {
+        std::string result;
+        for (char c : Text) {
+            if (c == '"' || c == '\\')
+                result += '\\';
+            result += c;
+        }
+        return result;
+    }
+
+    template <typename TFunctionType>
+    static double MeasureSeconds(
+        TFunctionType const& Function, std::size_t Iterations) {
+        Timer timer;
+        for (std::size_t i = 0; i < Iterations; i++) {
+            Function();
+            ClobberMemory();
+        }
+        return timer.elapsed_nanoseconds().count() * 1e-9;
+    }
+
+   public:
+    explicit BenchmarkSuite(BenchmarkSettings const& Settings,
+        std::ostream* pProgressStream = &std::cout)
+        : mSettings(Settings), mpProgressStream(pProgressStream) {
+        if (mSettings.mUsePerfCounters) {
+            mpCounters.reset(new PerfCounters);
+            if (!mpCounters->is_available() && mpProgressStream)
+                *mpProgressStream << "Hardware performance counters are not "
+                                     "available"
+                                  << std::endl;
+        }
+    }
+
+    bool HasCounters() const { return mpCounters && mpCounters->is_available(); }
+
+    BenchmarkSettings const& GetSettings() const { return mSettings; }
+
+    std::vector<BenchmarkResult> const& GetResults() const {
+        return mResults;
+    }
+
+    /// Benchmarks with Size2 == 1 are checked against the maximum vector size
+    bool IsSelected(std::string const& Name, std::string const& Library,
+        std::size_t Size1, std::size_t Size2) const {
+        if (Size2 == 1 ? (Size1 > mSettings.mMaximumVectorSize)
+                       : (std::max(Size1, Size2) > mSettings.mMaximumSize))
+            return false;
+        if (mSettings.mFilter.empty())
+            return true;
+        return (Name + " " + Library).find(mSettings.mFilter) !=
+               std::string::npos;
+    }
+
+    /// Measures Function and returns the stored result, or nullptr if the
+    /// benchmark is filtered out
+    template <typename TFunctionType>
+    BenchmarkResult* Run(std::string const& Name, std::string const& Library,
+        std::string const& SizeClass, std::size_t Size1, std::size_t Size2,
+        double Flops, double Bytes, TFunctionType const& Function) {
+        if (!IsSelected(Name, Library, Size1, Size2))
+            return nullptr;
+
+        BenchmarkResult result;
+        result.mName = Name;
+        result.mLibrary = Library;
+        result.mSizeClass = SizeClass;
+        result.mSize1 = Size1;
+        result.mSize2 = Size2;
+        result.mFlops = Flops;
+        result.mBytes = Bytes;
+
+        // warm-up and calibration
+        std::size_t iterations = 1;
+        double elapsed = MeasureSeconds(Function, iterations);
+        while (elapsed < mSettings.mMinimumTrialTime) {
+            const double factor = (elapsed > 0.00)
+                                      ? 1.2 * mSettings.mMinimumTrialTime / elapsed
+                                      : 10.00;
+            iterations = static_cast<std::size_t>(
+                iterations * std::min(std::max(factor, 1.5), 10.00)) + 1;
+            elapsed = MeasureSeconds(Function, iterations);
+        }
+        result.mIterations = iterations;
+
+        if (HasCounters())
+            mpCounters->start();
+        double total_time = 0.00;
+        for (std::size_t trial = 0; trial < mSettings.mNumberOfTrials;
+             trial++) {
+            if (trial >= 3 && total_time > mSettings.mMaximumBenchmarkTime)
+                break;
+            const double seconds = MeasureSeconds(Function, iterations);
+            total_time += seconds;
+            result.mSamples.push_back(seconds * 1e9 / iterations);
+        }
+        if (HasCounters()) {
+            result.mCounters = mpCounters->stop();
+            const double total_iterations =
+                static_cast<double>(iterations) * result.mSamples.size();
+            for (int i = 0; i < PerfCounters::number_of_counters; i++)
+                result.mCounters.mValues[i] /= total_iterations;
+        }
+
+        mResults.push_back(result);
+        if (mpProgressStream)
+            PrintLine(*mpProgressStream, mResults.back());
+        return &mResults.back();
+    }
+
+    void PrintHeader(std::ostream& rOStream) const {
+        rOStream << std::left << std::setw(28) << "Benchmark" << std::setw(14)
+                 << "Library" << std::setw(12) << "Size" << std::right
+                 << std::setw(14) << "Median[ns]" << std::setw(10) << "CV[%]"
+                 << std::setw(12) << "GFLOP/s" << std::setw(12) << "GB/s";
+        if (HasCounters())
+            rOStream << std::setw(8) << "IPC" << std::setw(10) << "FLOP/cyc"
+                     << std::setw(10) << "L1miss%" << std::setw(10)
+                     << "LLCmiss%" << std::setw(10) << "BRmiss%";
+        rOStream << std::endl;
+    }
+
+    void PrintLine(std::ostream& rOStream, BenchmarkResult const& Result) const {
+        const double median = Result.Median();
+        const double variation =
+            (Result.Mean() > 0.00)
+                ? 100.00 * Result.StandardDeviation() / Result.Mean()
+                : 0.00;
+        rOStream << std::left << std::setw(28) << Result.mName << std::setw(14)
+                 << Result.mLibrary << std::setw(12)
+                 << (Result.mSizeClass + " " + Result.SizeString())
+                 << std::right << std::fixed << std::setprecision(1)
+                 << std::setw(14) << median << std::setw(10) << variation
+                 << std::setprecision(3) << std::setw(12)
+                 << Result.GFlopsPerSecond() << std::setw(12)
+                 << Result.GBytesPerSecond();
+        if (HasCounters()) {
+            PrintRatio(rOStream, Result.InstructionsPerCycle(), 1.00, 8);
+            PrintRatio(rOStream, Result.FlopsPerCycle(), 1.00, 10);
+            PrintRatio(rOStream, Result.L1MissRate(), 100.00, 10);
+            PrintRatio(rOStream, Result.LastLevelMissRate(), 100.00, 10);
+            PrintRatio(rOStream, Result.BranchMissRate(), 100.00, 10);
+        }
+        if (!Result.mIsValid)
+            rOStream << " (Failed!)";
+        rOStream << std::defaultfloat << std::endl;
+    }
+
+    static void PrintRatio(
+        std::ostream& rOStream, double Ratio, double Scale, int Width) {
+        if (Ratio < 0.00)
+            rOStream << std::setw(Width) << "-";
+        else
+            rOStream << std::setprecision(2) << std::setw(Width)
+                     << Ratio * Scale;
+    }
+
+    void WriteJson(std::ostream& rOStream) const {
+        rOStream << std::setprecision(17);
+        rOStream << "{\n  \"context\": {\"label\": \""
+                 << Escape(mSettings.mLabel) << "\", \"trials\": "
+                 << mSettings.mNumberOfTrials
+                 << ", \"minimum_trial_time\": " << mSettings.mMinimumTrialTime
+                 << "},\n  \"benchmarks\": [";
+        for (std::size_t i = 0; i < mResults.size(); i++) {
+            BenchmarkResult const& result = mResults[i];
+            rOStream << ((i == 0) ? "\n" : ",\n");
+            rOStream << "    {\"name\": \"" << Escape(result.mName)
+                     << "\", \"library\": \"" << Escape(result.mLibrary)
+                     << "\", \"size_class\": \"" << result.mSizeClass
+                     << "\", \"size1\": " << result.mSize1
+                     << ", \"size2\": " << result.mSize2
+                     << ", \"iterations\": " << result.mIterations
+                     << ", \"valid\": " << (result.mIsValid ? "true" : "false")
+                     << ", \"median_ns\": " << result.Median()
+                     << ", \"mean_ns\": " << result.Mean()
+                     << ", \"variance_ns2\": " << result.Variance()
+                     << ", \"min_ns\": " << result.Minimum()
+                     << ", \"max_ns\": " << result.Maximum()
+                     << ", \"flops\": " << result.mFlops
+                     << ", \"bytes\": " << result.mBytes
+                     << ", \"gflops_per_second\": " << result.GFlopsPerSecond()
+                     << ", \"gbytes_per_second\": " << result.GBytesPerSecond()
+                     << ", \"samples_ns\": [";
+            for (std::size_t j = 0; j < result.mSamples.size(); j++)
+                rOStream << ((j == 0) ? "" : ", ") << result.mSamples[j];
+            rOStream << "]";
+            if (HasCounters()) {
+                rOStream << ", \"counters\": {";
+                bool is_first = true;
+                for (int j = 0; j < PerfCounters::number_of_counters; j++)
+                    if (result.mCounters.mIsAvailable[j]) {
+                        rOStream << (is_first ? "\"" : ", \"")
+                                 << PerfCounters::Name(j)
+                                 << "\": " << result.mCounters.mValues[j];
+                        is_first = false;
+                    }
+                rOStream << "}, \"ipc\": " << result.InstructionsPerCycle()
+                         << ", \"flops_per_cycle\": " << result.FlopsPerCycle()
+                         << ", \"l1_miss_rate\": " << result.L1MissRate()
+                         << ", \"llc_miss_rate\": " << result.LastLevelMissRate()
+                         << ", \"branch_miss_rate\": " << result.BranchMissRate();
+            }
+            rOStream << "}";
+        }
+        rOStream << "\n  ]\n}\n";
+    }
+
+    void WriteCsv(std::ostream& rOStream) const {
+        rOStream << std::setprecision(17);
+        rOStream << "name,library,size_class,size1,size2,iterations,valid,"
+                    "median_ns,mean_ns,variance_ns2,min_ns,max_ns,flops,"
+                    "bytes,gflops_per_second,gbytes_per_second,ipc,"
+                    "flops_per_cycle,l1_miss_rate,llc_miss_rate,"
+                    "branch_miss_rate\n";
+        for (auto const& result : mResults)
+            rOStream << '"' << result.mName << "\"," << result.mLibrary << ','
+                     << result.mSizeClass << ',' << result.mSize1 << ','
+                     << result.mSize2 << ',' << result.mIterations << ','
+                     << result.mIsValid << ',' << result.Median() << ','
+                     << result.Mean() << ',' << result.Variance() << ','
+                     << result.Minimum() << ',' << result.Maximum() << ','
+                     << result.mFlops << ',' << result.mBytes << ','
+                     << result.GFlopsPerSecond() << ','
+                     << result.GBytesPerSecond() << ','
+                     << result.InstructionsPerCycle() << ','
+                     << result.FlopsPerCycle() << ',' << result.L1MissRate()
+                     << ',' << result.LastLevelMissRate() << ','
+                     << result.BranchMissRate() << '\n';
+    }
+};
@@ -0,0 +1,456 @@
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Stores a baseline of run_benchmark_matrix results and compares a new run
+// against it. A benchmark is flagged as a regression when its median is
+// slower than the threshold and the difference is statistically significant
+
+/// Minimal reader for the json written by BenchmarkSuite::WriteJson
+class JsonValue {
+   public:
+    enum Type { null_type, boolean_type, number_type, string_type, array_type,
+        object_type };
+
+    Type mType = null_type;
+    bool mBoolean = false;
+    double mNumber = 0.00;
+    std::string mString;
+    std::vector<JsonValue> mArray;
+    std::map<std::string, JsonValue> mObject;
+
+    static JsonValue Parse(std::string const& Text) {
+        std::size_t position = 0;
+        JsonValue result = ParseValue(Text, position);
+        SkipSpaces(Text, position);
+        if (position != Text.size())
+            throw std::runtime_error("unexpected characters after json value");
+        return result;
+    }
+
+    JsonValue const& operator[](std::string const& Key) const {
+        static const JsonValue null_value;
+        auto i_value = mObject.find(Key);
+        return (i_value == mObject.end()) ? null_value : i_value->second;
+    }
+
+   private:
+    static void SkipSpaces(std::string const& Text, std::size_t& rPosition) {
+        while (rPosition < Text.size() &&
+               std::isspace(static_cast<unsigned char>(Text[rPosition])))
+            rPosition++;
+    }
+
+    static void Expect(
+        std::string const& Text, std::size_t& rPosition, char Character) {
+        SkipSpaces(Text, rPosition);
+        if (rPosition >= Text.size() || Text[rPosition] != Character)
+            throw std::runtime_error(
+                std::string("expected '") + Character + "' in json");
+        rPosition++;
+    }
+
+    static std::string ParseString(
+        std::string const& Text, std::size_t& rPosition) {
+        Expect(Text, rPosition, '"');
+        std::string result;
+        while (rPosition < Text.size() && Text[rPosition] != '"') {
+            if (Text[rPosition] == '\\')
+                rPosition++;
+            if (rPosition < Text.size())
+                result += Text[rPosition++];
+        }
+        Expect(Text, rPosition, '"');
+        return result;
+    }
+
+    static JsonValue ParseValue(std::string const& Text, std::size_t& rPosition) {
+        SkipSpaces(Text, rPosition);
+        if (rPosition >= Text.size())
+            throw std::runtime_error("unexpected end of json");
+
+        JsonValue result;
+        const char first = Text[rPosition];
+        if (first == '{') {
+            result.mType = object_type;
+            rPosition++;
+            SkipSpaces(Text, rPosition);
+            if (Text[rPosition] == '}') {
+                rPosition++;
+                return result;
+            }
+            do {
+                const std::string key = ParseString(Text, rPosition);
+                Expect(Text, rPosition, ':');
+                result.mObject[key] = ParseValue(Text, rPosition);
+                SkipSpaces(Text, rPosition);
+            } while (Text[rPosition++] == ',');
+            if (Text[rPosition - 1] != '}')
+                throw std::runtime_error("expected '}' in json");
+        } else if (first == '[') {
+            result.mType = array_type;
+            rPosition++;
+            SkipSpaces(Text, rPosition);
+            if (Text[rPosition] == ']') {
+                rPosition++;
+                return result;
+            }
+            do {
+                result.mArray.push_back(ParseValue(Text, rPosition));
+                SkipSpaces(Text, rPosition);
+            } while (Text[rPosition++] == ',');
+            if (Text[rPosition - 1] != ']')
+                throw std::runtime_error("expected ']' in json");
+        } else if (first == '"') {
+            result.mType = string_type;
+            result.mString = ParseString(Text, rPosition);
+        } else if (Text.compare(rPosition, 4, "true") == 0) {
+            result.mType = boolean_type;
+            result.mBoolean = true;
+            rPosition += 4;
+        } else if (Text.compare(rPosition, 5, "false") == 0) {
+            result.mType = boolean_type;
+            rPosition += 5;
+        } else if (Text.compare(rPosition, 4, "null") == 0) {
+            rPosition += 4;
+        } else {
+            const char* p_begin = Text.c_str() + rPosition;
+            char* p_end = nullptr;
+            result.mType = number_type;
+            result.mNumber = std::strtod(p_begin, &p_end);
+            if (p_end == p_begin)
+                throw std::runtime_error("invalid json value");
+            rPosition += p_end - p_begin;
+        }
+        return result;
+    }
+};
+
+struct BenchmarkSamples {
+    std::string mName;
+    std::string mLibrary;
+    std::string mSizeClass;
+    std::size_t mSize1 = 0;
+    std::size_t mSize2 = 0;
+    double mMedian = 0.00;
+    std::vector<double> mSamples;
+
+    std::string Key() const {
+        std::stringstream key;
+        key << mName << " | " << mLibrary << " | " << mSizeClass << " "
+            << mSize1 << "x" << mSize2;
+        return key.str();
+    }
+};
+
+std::string ReadFile(std::string const& FileName) {
+    std::ifstream file(FileName);
+    if (!file)
+        throw std::runtime_error("can not open " + FileName);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
+
+std::vector<BenchmarkSamples> ReadResults(std::string const& FileName) {
+    const JsonValue root = JsonValue::Parse(ReadFile(FileName));
+    std::vector<BenchmarkSamples> results;
+    for (auto const& benchmark : root["benchmarks"].mArray) {
+        BenchmarkSamples result;
+        result.mName = benchmark["name"].mString;
+        result.mLibrary = benchmark["library"].mString;
+        result.mSizeClass = benchmark["size_class"].mString;
+        result.mSize1 = static_cast<std::size_t>(benchmark["size1"].mNumber);
+        result.mSize2 = static_cast<std::size_t>(benchmark["size2"].mNumber);
+        result.mMedian = benchmark["median_ns"].mNumber;
+        for (auto const& sample : benchmark["samples_ns"].mArray)
+            result.mSamples.push_back(sample.mNumber);
+        results.push_back(result);
+    }
+    return results;
+}
+
+/// Standard normal cumulative distribution
+inline double NormalDistribution(double X) {
+    return 0.5 * std::erfc(-X / std::sqrt(2.00));
+}
+
+/// Inverse of the standard normal distribution by bisection, good enough for
+/// the confidence levels of the gate
+inline double NormalQuantile(double P) {
+    double low = -10.00;
+    double high = 10.00;
+    for (int i = 0; i < 100; i++) {
+        const double middle = 0.5 * (low + high);
+        if (NormalDistribution(middle) < P)
+            low = middle;
+        else
+            high = middle;
+    }
+    return 0.5 * (low + high);
+}
+
+/// One sided Mann-Whitney U test for the hypothesis that the samples of
+/// Current are larger than the ones of Baseline. Uses the normal
+/// approximation with tie and continuity correction and returns the p-value
+double MannWhitneyPValue(
+    std::vector<double> const& Baseline, std::vector<double> const& Current) {
+    const std::size_t n1 = Baseline.size();
+    const std::size_t n2 = Current.size();
+    if (n1 == 0 || n2 == 0)
+        return 1.00;
+
+    // ranks of the pooled samples, ties get their average rank
+    std::vector<std::pair<double, int>> pooled;
+    for (auto value : Baseline)
+        pooled.push_back(std::make_pair(value, 0));
+    for (auto value : Current)
+        pooled.push_back(std::make_pair(value, 1));
+    std::sort(pooled.begin(), pooled.end());
+
+    const double n = static_cast<double>(n1 + n2);
+    double current_rank_sum = 0.00;
+    double tie_correction = 0.00;
+    for (std::size_t i = 0; i < pooled.size();) {
+        std::size_t j = i;
+        while (j < pooled.size() && pooled[j].first == pooled[i].first)
+            j++;
+        const double rank = 0.5 * (i + 1 + j);
+        const double ties = static_cast<double>(j - i);
+        tie_correction += ties * ties * ties - ties;
+        for (std::size_t k = i; k < j; k++)
+            if (pooled[k].second == 1)
+                current_rank_sum += rank;
+        i = j;
+    }
+
+    const double u = current_rank_sum - 0.5 * n2 * (n2 + 1.00);
+    const double mean = 0.5 * n1 * n2;
+    const double variance =
+        n1 * n2 / 12.00 * ((n + 1.00) - tie_correction / (n * (n - 1.00)));
+    if (variance <= 0.00)
+        return (u > mean) ? 0.00 : 1.00;
+    const double z = (u - mean - 0.5) / std::sqrt(variance);
+    return 1.00 - NormalDistribution(z);
+}
+
+/// Lower bound of the one sided confidence interval of the relative change
+/// of the mean, (current - baseline) / baseline, from the normal
+/// approximation of the difference of the means
+double RelativeChangeLowerBound(std::vector<double> const& Baseline,
+    std::vector<double> const& Current, double Alpha) {
+    auto mean_and_variance = [](std::vector<double> const& Samples,
+                                 double& rMean, double& rVariance) {
+        rMean = 0.00;
+        for (auto value : Samples)
+            rMean += value;
+        rMean /= Samples.size();
+        rVariance = 0.00;
+        for (auto value : Samples)
+            rVariance += (value - rMean) * (value - rMean);
+        rVariance =
+            (Samples.size() > 1) ? rVariance / (Samples.size() - 1) : 0.00;
+    };
+    double baseline_mean, baseline_variance, current_mean, current_variance;
+    mean_and_variance(Baseline, baseline_mean, baseline_variance);
+    mean_and_variance(Current, current_mean, current_variance);
+    const double standard_error = std::sqrt(baseline_variance / Baseline.size() +
+                                            current_variance / Current.size());
+    const double lower_bound = current_mean - baseline_mean -
+                               NormalQuantile(1.00 - Alpha) * standard_error;
+    return lower_bound / baseline_mean;
+}
+
+struct GateSettings {
+    std::string mBaseline;
+    std::string mResults;
+    std::string mSuite;
+    std::string mTest = "mann-whitney";
+    double mThreshold = 0.05;
+    double mAlpha = 0.05;
+    std::set<std::size_t> mSizes;
+    std::vector<std::string> mSuiteArguments;
+};
+
+int RunSuite(GateSettings const& Settings, std::string const& Output) {
+    std::string command = "\"" + Settings.mSuite + "\" --format=json";
+    command += " \"--output=" + Output + "\"";
+    for (auto const& argument : Settings.mSuiteArguments)
+        command += " \"" + argument + "\"";
+    std::cout << "Running " << command << std::endl;
+    const int status = std::system(command.c_str());
+    if (status != 0)
+        std::cerr << "The benchmark suite failed with status " << status
+                  << std::endl;
+    return status;
+}
+
+/// Prints the comparison and returns the number of regressions
+std::size_t Compare(GateSettings const& Settings,
+    std::vector<BenchmarkSamples> const& Baseline,
+    std::vector<BenchmarkSamples> const& Current) {
+    std::map<std::string, BenchmarkSamples const*> baseline_map;
+    for (auto const& result : Baseline)
+        baseline_map[result.Key()] = &result;
+
+    std::size_t number_of_compared = 0;
+    std::size_t number_of_regressions = 0;
+    std::cout << std::left << std::setw(56) << "Benchmark" << std::right
+              << std::setw(14) << "Baseline[ns]" << std::setw(14)
+              << "Current[ns]" << std::setw(10) << "Change" << std::setw(12)
+              << (Settings.mTest == "ci" ? "Lower bound" : "p-value")
+              << std::endl;
+
+    for (auto const& current : Current) {
+        if (!Settings.mSizes.empty() &&
+            Settings.mSizes.find(current.mSize1) == Settings.mSizes.end())
+            continue;
+        auto i_baseline = baseline_map.find(current.Key());
+        if (i_baseline == baseline_map.end())
+            continue;
+        BenchmarkSamples const& baseline = *i_baseline->second;
+        if (baseline.mMedian <= 0.00)
+            continue;
+
+        const double change = current.mMedian / baseline.mMedian - 1.00;
+        double statistic = 0.00;
+        bool is_regression = false;
+        if (Settings.mTest == "ci") {
+            statistic = RelativeChangeLowerBound(
+                baseline.mSamples, current.mSamples, Settings.mAlpha);
+            is_regression = statistic > Settings.mThreshold;
+        } else {
+            statistic =
+                MannWhitneyPValue(baseline.mSamples, current.mSamples);
+            is_regression =
+                change > Settings.mThreshold && statistic < Settings.mAlpha;
+        }
+
+        number_of_compared++;
+        if (is_regression)
+            number_of_regressions++;
+        std::cout << std::left << std::setw(56) << current.Key() << std::right
+                  << std::fixed << std::setprecision(1) << std::setw(14)
+                  << baseline.mMedian << std::setw(14) << current.mMedian
+                  << std::setw(9) << 100.00 * change << "%"
+                  << std::setprecision(4) << std::setw(12) << statistic
+                  << (is_regression ? "  REGRESSION" : "") << std::endl;
+    }
+
+    std::cout << number_of_regressions << " regressions in "
+              << number_of_compared << " compared benchmarks" << std::endl;
+    return number_of_regressions;
+}
+
+std::string DefaultSuite(std::string const& ProgramName) {
+    const std::size_t separator = ProgramName.find_last_of("/\\");
+    const std::string directory = (separator == std::string::npos)
+                                      ? "."
+                                      : ProgramName.substr(0, separator);
+    return directory + "/run_benchmark_matrix";
+}
+
+void PrintUsage() {
+    std::cout
+        << "Usage: run_benchmark_gate save --baseline=<file> [options]\n"
+           "       run_benchmark_gate check --baseline=<file> [options]\n"
+           "  save runs the suite and stores its json results as baseline,\n"
+           "  check compares a new run with the baseline and exits with 1\n"
+           "  if a benchmark regressed.\n"
+           "  --results=<file>     compare this results file instead of a new "
+           "run\n"
+           "  --suite=<path>       benchmark executable (default\n"
+           "                       run_benchmark_matrix next to this tool)\n"
+           "  --test=mann-whitney|ci\n"
+           "                       mann-whitney: regression if the median is\n"
+           "                       slower than the threshold and p < alpha\n"
+           "                       ci: regression if the lower bound of the\n"
+           "                       1 - alpha confidence interval of the\n"
+           "                       relative change exceeds the threshold\n"
+           "  --threshold=<x>      relative slowdown, default 0.05\n"
+           "  --alpha=<x>          significance level, default 0.05\n"
+           "  --sizes=<n,m,...>    compare only these sizes, e.g. 3,6\n"
+           "  other options are passed to the suite, e.g. --filter=AMatrix\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        PrintUsage();
+        return 2;
+    }
+
+    const std::string command = argv[1];
+    GateSettings settings;
+    settings.mSuite = DefaultSuite(argv[0]);
+    for (int i = 2; i < argc; i++) {
+        const std::string argument = argv[i];
+        const std::size_t separator = argument.find('=');
+        const std::string option = argument.substr(0, separator);
+        const std::string value = (separator == std::string::npos)
+                                      ? ""
+                                      : argument.substr(separator + 1);
+        if (option == "--baseline")
+            settings.mBaseline = value;
+        else if (option == "--results")
+            settings.mResults = value;
+        else if (option == "--suite")
+            settings.mSuite = value;
+        else if (option == "--test")
+            settings.mTest = value;
+        else if (option == "--threshold")
+            settings.mThreshold = std::atof(value.c_str());
+        else if (option == "--alpha")
+            settings.mAlpha = std::atof(value.c_str());
+        else if (option == "--sizes") {
+            std::stringstream sizes(value);
+            std::string size;
+            while (std::getline(sizes, size, ','))
+                settings.mSizes.insert(std::strtoul(size.c_str(), nullptr, 10));
+        } else
+            settings.mSuiteArguments.push_back(argument);
+    }
+
+    if ((command != "save" && command != "check") ||
+        settings.mBaseline.empty() ||
+        (settings.mTest != "mann-whitney" && settings.mTest != "ci")) {
+        PrintUsage();
+        return 2;
+    }
+
+    try {
+        if (command == "save") {
+            if (!settings.mResults.empty()) {
+                std::ofstream(settings.mBaseline)
+                    << ReadFile(settings.mResults);
+                return 0;
+            }
+            return (RunSuite(settings, settings.mBaseline) == 0) ? 0 : 2;
+        }
+
+        std::string results = settings.mResults;
+        if (results.empty()) {
+            results = settings.mBaseline + ".current.json";
+            if (RunSuite(settings, results) != 0)
+                return 2;
+        }
+        const std::size_t number_of_regressions =
+            Compare(settings, ReadResults(settings.mBaseline),
+                ReadResults(results));
+        return (number_of_regressions == 0) ? 0 : 1;
+    } catch (std::exception const& Error) {
+        std::cerr << "Error: " << Error.what() << std::endl;
+        return 2;
+    }
+}
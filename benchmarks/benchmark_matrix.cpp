@@ -1,305 +1,611 @@
-#include <iostream>
 #include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
 #include <string>
+#include <type_traits>
+#include <vector>
 
-#include "timer.h"
-#include "matrix.h"
+#include "amatrix.h"
+#include "benchmark.h"
 
 #if defined(AMATRIX_COMPARE_WITH_EIGEN)
 #include "Eigen/Dense"
 #endif
 
 #if defined(AMATRIX_COMPARE_WITH_UBLAS)
+#include <boost/numeric/ublas/lu.hpp>
 #include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/vector.hpp>
 #endif
 
-#define AMATRIX_MEASURE_ABC_OPERATION(name, operation)                   \
-    void name() {                                                        \
-        TMatrixType A(TSize1, TSize2);                                   \
-        TMatrixType B(TSize1, TSize2);                                   \
-        initialize(A);                                                   \
-        initialize(B);                                                   \
-        Timer timer;                                                     \
-        for (std::size_t i_repeat = 0; i_repeat < mRepeat; i_repeat++) { \
-            operation                                                    \
-        }                                                                \
-        auto elapsed = timer.elapsed().count();                          \
-        std::cout << "\t\t" << elapsed;                                  \
-    }
-
-#define AMATRIX_MEASURE_ABCD_OPERATION(name, operation)                   \
-    void name() {                                                         \
-        TMatrixType A(TSize1, TSize2);                                    \
-        TMatrixType B(TSize1, TSize2);                                    \
-        initialize(A);                                                    \
-        initializeInverse(B);                                             \
-        initializeInverse(D);                                             \
-        Timer timer;                                                      \
-        for (std::size_t i_repeat = 0; i_repeat < mRepeat / (2 * TSize2); \
-             i_repeat++) {                                                \
-            operation                                                     \
-        }                                                                 \
-        auto elapsed = timer.elapsed().count();                           \
-        std::cout << "\t\t" << elapsed;                                   \
-    }
-
-template <typename TMatrixType, std::size_t TSize1, std::size_t TSize2>
-class ComparisonColumn {
-   protected:
-    static constexpr std::size_t mRepeat =
-        static_cast<std::size_t>(1e8 / (TSize1 * TSize2));
-
-    TMatrixType C;
-    TMatrixType D;
-    std::string mColumnName;
-
-    void initialize(TMatrixType& TheMatrix) {
-        for (std::size_t i = 0; i < TSize1; i++)
-            for (std::size_t j = 0; j < TSize2; j++)
-                TheMatrix(i, j) = j + 1.00;
-    }
-
-    void initializeInverse(TMatrixType& TheMatrix) {
-        for (std::size_t i = 0; i < TSize1; i++)
-            for (std::size_t j = 0; j < TSize2; j++)
-                TheMatrix(i, j) = 1.00 / (i + 1);
+// Each library is wrapped in an adapter which creates the operands and
+// implements the measured operations with the library's own syntax. TSize is
+// the compile time size or AMatrix::dynamic. AMatrix is also run with float,
+// which is validated against the double results with a looser tolerance
+
+template <std::size_t TSize, typename TDataType = double>
+struct AMatrixAdapter {
+    using data_type = TDataType;
+    using matrix_type = AMatrix::Matrix<TDataType, TSize, TSize>;
+    using vector_type = AMatrix::Matrix<TDataType, TSize, 1>;
+    using permutation_type = AMatrix::Matrix<std::size_t, TSize, 1>;
+
+    static const char* Name() {
+        return std::is_same<TDataType, float>::value ? "AMatrix float"
+                                                     : "AMatrix";
     }
 
-   public:
-    ComparisonColumn() = delete;
-
-    ComparisonColumn(std::string ColumnName) 
-        : C(TSize1, TSize2),
-          D(TSize1, TSize2), mColumnName(ColumnName) {
-        initialize(C);
-    }
-    std::string const& GetColumnName() { return mColumnName; }
-    TMatrixType& GetResult() { return C; }
-
-    template <typename TMatrixType2>
-    bool CheckResult(TMatrixType2 const& Reference) {
-        constexpr double tolerance = 1e-12;
-        for (std::size_t i = 0; i < TSize1; i++)
-            for (std::size_t j = 0; j < TSize2; j++)
-                if (std::abs(C(i, j) - Reference(i, j)) > tolerance) {
-                    std::cout << " " << C(i, j) << " != " << Reference(i, j);
-                    return false;
-                }
+    static matrix_type CreateMatrix(std::size_t Size) {
+        return matrix_type(Size, Size);
+    }
 
-        return true;
+    static vector_type CreateVector(std::size_t Size) {
+        return vector_type(Size, 1);
+    }
+
+    static TDataType& At(matrix_type& rA, std::size_t i, std::size_t j) {
+        return rA(i, j);
+    }
+
+    static TDataType& At(vector_type& rA, std::size_t i) { return rA[i]; }
+
+    static void Sum(matrix_type& rC, matrix_type& A, matrix_type& B) {
+        rC.noalias() = A + B;
+    }
+
+    static void Minus(matrix_type& rC, matrix_type& A, matrix_type& B) {
+        rC.noalias() = A - B;
     }
 
-    AMATRIX_MEASURE_ABC_OPERATION(MeasureSumTime,C.noalias() = A + B; B.noalias() = C;)
+    static void Scale(matrix_type& rC, matrix_type& A) {
+        rC.noalias() = TDataType(2.5) * A;
+    }
 
-    AMATRIX_MEASURE_ABCD_OPERATION(MeasureMultTime,C.noalias() = D * A; D.noalias() = B;)
+    static void Transpose(matrix_type& rC, matrix_type& A) {
+        rC.noalias() = A.transpose();
+    }
 
-    AMATRIX_MEASURE_ABCD_OPERATION(MeasureABAMultTime, C.noalias() = A * TMatrixType(D * A); D.noalias() = B;)
+    static void Product(matrix_type& rC, matrix_type& A, matrix_type& B) {
+        rC.noalias() = A * B;
+    }
 
-    AMATRIX_MEASURE_ABCD_OPERATION(MeasureATransposeBAMultTime,C.noalias() = A.transpose() * TMatrixType(D * A); D.noalias() = B;)
+    static void ProductABA(matrix_type& rC, matrix_type& A, matrix_type& B) {
+        rC.noalias() = A * (B * A);
+    }
 
+    static void ProductATBA(matrix_type& rC, matrix_type& A, matrix_type& B) {
+        rC.noalias() = A.transpose() * (B * A);
+    }
+
+    static void Gram(matrix_type& rC, matrix_type& A) {
+        rC = AMatrix::GramMatrix(A);
+    }
+
+    static void MatrixVector(vector_type& rX, matrix_type& A, vector_type& B) {
+        rX.noalias() = A * B;
+    }
+
+    static void TransposeMatrixVector(
+        vector_type& rX, matrix_type& A, vector_type& B) {
+        rX.noalias() = A.transpose() * B;
+    }
+
+    static void Solve(vector_type& rX, matrix_type& A, vector_type& B) {
+        matrix_type lu(A);
+        AMatrix::LUFactorization<matrix_type, permutation_type> factorization(
+            lu);
+        rX = factorization.solve(B);
+    }
+
+    static TDataType Dot(vector_type& A, vector_type& B) { return A.dot(B); }
+
+    static TDataType Norm(vector_type& A) { return A.norm(); }
 };
 
+#if defined(AMATRIX_COMPARE_WITH_EIGEN)
+template <std::size_t TSize>
+struct EigenAdapter {
+    static constexpr int size = (TSize == AMatrix::dynamic)
+                                    ? Eigen::Dynamic
+                                    : static_cast<int>(TSize);
+    using matrix_type = Eigen::Matrix<double, size, size, Eigen::RowMajor>;
+    using vector_type = Eigen::Matrix<double, size, 1>;
+    using data_type = double;
+
+    static const char* Name() { return "Eigen"; }
+
+    // The sized constructor of a fixed size vector with two rows would be
+    // taken as its coefficients, so fixed size operands are default
+    // constructed
+    static matrix_type CreateMatrix(std::size_t Size) {
+        return Create<matrix_type>(
+            Size, Size, std::integral_constant<bool, size == Eigen::Dynamic>());
+    }
+
+    static vector_type CreateVector(std::size_t Size) {
+        return Create<vector_type>(
+            Size, 1, std::integral_constant<bool, size == Eigen::Dynamic>());
+    }
+
+    static double& At(matrix_type& rA, std::size_t i, std::size_t j) {
+        return rA(i, j);
+    }
+
+    static double& At(vector_type& rA, std::size_t i) { return rA(i); }
+
+    static void Sum(matrix_type& rC, matrix_type& A, matrix_type& B) {
+        rC.noalias() = A + B;
+    }
+
+    static void Minus(matrix_type& rC, matrix_type& A, matrix_type& B) {
+        rC.noalias() = A - B;
+    }
+
+    static void Scale(matrix_type& rC, matrix_type& A) {
+        rC.noalias() = 2.5 * A;
+    }
+
+    static void Transpose(matrix_type& rC, matrix_type& A) {
+        rC.noalias() = A.transpose();
+    }
+
+    static void Product(matrix_type& rC, matrix_type& A, matrix_type& B) {
+        rC.noalias() = A * B;
+    }
+
+    static void ProductABA(matrix_type& rC, matrix_type& A, matrix_type& B) {
+        rC.noalias() = A * matrix_type(B * A);
+    }
+
+    static void ProductATBA(matrix_type& rC, matrix_type& A, matrix_type& B) {
+        rC.noalias() = A.transpose() * matrix_type(B * A);
+    }
+
+    static void Gram(matrix_type& rC, matrix_type& A) {
+        rC.noalias() = A.transpose() * A;
+    }
+
+    static void MatrixVector(vector_type& rX, matrix_type& A, vector_type& B) {
+        rX.noalias() = A * B;
+    }
+
+    static void TransposeMatrixVector(
+        vector_type& rX, matrix_type& A, vector_type& B) {
+        rX.noalias() = A.transpose() * B;
+    }
+
+    static void Solve(vector_type& rX, matrix_type& A, vector_type& B) {
+        rX = A.partialPivLu().solve(B);
+    }
+
+    static double Dot(vector_type& A, vector_type& B) { return A.dot(B); }
+
+    static double Norm(vector_type& A) { return A.norm(); }
+
+   private:
+    template <typename TType>
+    static TType Create(std::size_t Size1, std::size_t Size2, std::true_type) {
+        return TType(Size1, Size2);
+    }
+
+    template <typename TType>
+    static TType Create(std::size_t Size1, std::size_t Size2, std::false_type) {
+        return TType();
+    }
+};
+#endif
 
 #if defined(AMATRIX_COMPARE_WITH_UBLAS)
-using namespace boost::numeric::ublas;
-template <typename TMatrixType, std::size_t TSize1,
-    std::size_t TSize2>
+template <std::size_t TSize>
+struct UblasAdapter {
+    using matrix_type = typename std::conditional<TSize == AMatrix::dynamic,
+        boost::numeric::ublas::matrix<double>,
+        boost::numeric::ublas::bounded_matrix<double, TSize, TSize>>::type;
+    using vector_type = typename std::conditional<TSize == AMatrix::dynamic,
+        boost::numeric::ublas::vector<double>,
+        boost::numeric::ublas::bounded_vector<double, TSize>>::type;
+    using data_type = double;
+
+    static const char* Name() { return "Ublas"; }
+
+    static matrix_type CreateMatrix(std::size_t Size) {
+        return matrix_type(Size, Size);
+    }
 
-class UblasComparisonColumn
-    : public ComparisonColumn<TMatrixType, TSize1, TSize2> {
-    void initialize(TMatrixType& TheMatrix) {
-        for (std::size_t i = 0; i < TSize1; i++)
-            for (std::size_t j = 0; j < TSize2; j++)
-                TheMatrix(i, j) = j + 1.00;
+    static vector_type CreateVector(std::size_t Size) {
+        return vector_type(Size);
     }
 
-    void initializeInverse(TMatrixType& TheMatrix) {
-        for (std::size_t i = 0; i < TSize1; i++)
-            for (std::size_t j = 0; j < TSize2; j++)
-                TheMatrix(i, j) = 1.00 / (i + 1);
+    static double& At(matrix_type& rA, std::size_t i, std::size_t j) {
+        return rA(i, j);
+    }
+
+    static double& At(vector_type& rA, std::size_t i) { return rA(i); }
+
+    static void Sum(matrix_type& rC, matrix_type& A, matrix_type& B) {
+        noalias(rC) = A + B;
     }
-   public:
-    using BaseType =
-        ComparisonColumn<TMatrixType, TSize1, TSize2>;
 
-    using BaseType::mRepeat;
+    static void Minus(matrix_type& rC, matrix_type& A, matrix_type& B) {
+        noalias(rC) = A - B;
+    }
+
+    static void Scale(matrix_type& rC, matrix_type& A) {
+        noalias(rC) = 2.5 * A;
+    }
 
-    using BaseType::C;
-    using BaseType::D;
+    static void Transpose(matrix_type& rC, matrix_type& A) {
+        noalias(rC) = boost::numeric::ublas::trans(A);
+    }
 
+    static void Product(matrix_type& rC, matrix_type& A, matrix_type& B) {
+        noalias(rC) = boost::numeric::ublas::prod(A, B);
+    }
 
-    UblasComparisonColumn(std::string ColumnName)
-        : ComparisonColumn<TMatrixType, TSize1, TSize2>(
-              ColumnName) {}
+    static void ProductABA(matrix_type& rC, matrix_type& A, matrix_type& B) {
+        noalias(rC) = boost::numeric::ublas::prod(
+            A, matrix_type(boost::numeric::ublas::prod(B, A)));
+    }
 
+    static void ProductATBA(matrix_type& rC, matrix_type& A, matrix_type& B) {
+        noalias(rC) = boost::numeric::ublas::prod(boost::numeric::ublas::trans(A),
+            matrix_type(boost::numeric::ublas::prod(B, A)));
+    }
 
-    AMATRIX_MEASURE_ABC_OPERATION(MeasureSumTime, noalias(BaseType::C) =  A + B; noalias(B) = BaseType::C;)
-    AMATRIX_MEASURE_ABCD_OPERATION(MeasureMultTime,noalias(BaseType::C) = prod(BaseType::D, A); noalias(BaseType::D) = B;)
-    AMATRIX_MEASURE_ABCD_OPERATION(MeasureABAMultTime, noalias(BaseType::C) = prod(A, TMatrixType(prod(BaseType::D, A))); noalias(BaseType::D) = B;)
-    AMATRIX_MEASURE_ABCD_OPERATION(MeasureATransposeBAMultTime, noalias(BaseType::C) = prod(trans(A), TMatrixType(prod(BaseType::D, A)));noalias(BaseType::D) = B;)
+    static void Gram(matrix_type& rC, matrix_type& A) {
+        noalias(rC) =
+            boost::numeric::ublas::prod(boost::numeric::ublas::trans(A), A);
+    }
 
+    static void MatrixVector(vector_type& rX, matrix_type& A, vector_type& B) {
+        noalias(rX) = boost::numeric::ublas::prod(A, B);
+    }
+
+    static void TransposeMatrixVector(
+        vector_type& rX, matrix_type& A, vector_type& B) {
+        noalias(rX) =
+            boost::numeric::ublas::prod(boost::numeric::ublas::trans(A), B);
+    }
+
+    static void Solve(vector_type& rX, matrix_type& A, vector_type& B) {
+        matrix_type lu(A);
+        boost::numeric::ublas::permutation_matrix<std::size_t> permutation(
+            A.size1());
+        boost::numeric::ublas::lu_factorize(lu, permutation);
+        rX = B;
+        boost::numeric::ublas::lu_substitute(lu, permutation, rX);
+    }
+
+    static double Dot(vector_type& A, vector_type& B) {
+        return boost::numeric::ublas::inner_prod(A, B);
+    }
+
+    static double Norm(vector_type& A) {
+        return boost::numeric::ublas::norm_2(A);
+    }
 };
 #endif
 
-template <typename TMatrixType, std::size_t TSize1,
-    std::size_t TSize2>
-class EmptyComparisonColumn
-    : public ComparisonColumn<TMatrixType, TSize1, TSize2> {
-   public:
-    EmptyComparisonColumn(std::string ColumnName)
-        : ComparisonColumn<TMatrixType, TSize1, TSize2>("") {}
-    void MeasureSumTime() { std::cout << "\t\t"; }
-    void MeasureMultTime() { std::cout << "\t\t"; }
-    void MeasureABAMultTime() { std::cout << "\t\t"; }
-    void MeasureATransposeBAMultTime() { std::cout << "\t\t"; }
-
-    template <typename TMatrixType2>
-    bool CheckResult(TMatrixType2 const& Reference) {
+/// Results of the first (AMatrix) run of each benchmark, used to validate
+/// the other libraries
+using ReferenceResults = std::map<std::string, std::vector<double>>;
+
+template <typename TAdapter>
+std::vector<double> Flatten(
+    typename TAdapter::matrix_type& rA, std::size_t Size) {
+    std::vector<double> result;
+    for (std::size_t i = 0; i < Size; i++)
+        for (std::size_t j = 0; j < Size; j++)
+            result.push_back(TAdapter::At(rA, i, j));
+    return result;
+}
+
+template <typename TAdapter>
+std::vector<double> Flatten(
+    typename TAdapter::vector_type& rA, std::size_t Size) {
+    std::vector<double> result;
+    for (std::size_t i = 0; i < Size; i++)
+        result.push_back(TAdapter::At(rA, i));
+    return result;
+}
+
+/// Stores the first result with the given key and compares the following
+/// ones against it with a relative tolerance
+inline bool CheckResult(ReferenceResults& rReference, std::string const& Key,
+    std::vector<double> const& Result, double RelativeTolerance) {
+    auto i_reference = rReference.find(Key);
+    if (i_reference == rReference.end()) {
+        rReference[Key] = Result;
         return true;
     }
+    std::vector<double> const& reference = i_reference->second;
+    if (reference.size() != Result.size())
+        return false;
+    double scale = 0.00;
+    for (auto value : reference)
+        scale = std::max(scale, std::abs(value));
+    const double tolerance = RelativeTolerance * std::max(scale, 1.00);
+    for (std::size_t i = 0; i < Result.size(); i++)
+        if (!(std::abs(Result[i] - reference[i]) <= tolerance))
+            return false;
+    return true;
+}
+
+template <typename TAdapter>
+class MatrixBenchmarks {
+    using data_type = typename TAdapter::data_type;
+    using matrix_type = typename TAdapter::matrix_type;
+    using vector_type = typename TAdapter::vector_type;
+
+    /// Tolerance of the validation against the (double) reference
+    static constexpr double relative_tolerance =
+        (sizeof(data_type) < sizeof(double)) ? 1e-3 : 1e-10;
+
+    BenchmarkSuite& mrSuite;
+    ReferenceResults& mrReference;
+    std::string mSizeClass;
+    std::size_t mSize;
+
+    matrix_type mA;
+    matrix_type mB;
+    matrix_type mC;
+    vector_type mX;
+    vector_type mY;
+
+    std::string Key(std::string const& Name) const {
+        std::stringstream key;
+        key << Name << " " << mSizeClass << " " << mSize;
+        return key.str();
+    }
+
+    template <typename TResultType, typename TFunctionType>
+    void Run(std::string const& Name, double Flops, double Bytes,
+        TResultType& rResult, TFunctionType const& Function) {
+        BenchmarkResult* p_result = mrSuite.Run(Name, TAdapter::Name(),
+            mSizeClass, mSize, mSize, Flops, Bytes, Function);
+        if (p_result)
+            p_result->mIsValid = CheckResult(mrReference, Key(Name),
+                Flatten<TAdapter>(rResult, mSize), relative_tolerance);
+    }
+
+    template <typename TFunctionType>
+    void RunScalar(std::string const& Name, double Flops, double Bytes,
+        TFunctionType const& Function) {
+        double result = 0.00;
+        BenchmarkResult* p_result =
+            mrSuite.Run(Name, TAdapter::Name(), mSizeClass, mSize, 1, Flops,
+                Bytes, [&]() { result = Function(); DoNotOptimize(result); });
+        if (p_result)
+            p_result->mIsValid = CheckResult(mrReference, Key(Name),
+                std::vector<double>(1, result), relative_tolerance);
+    }
+
+   public:
+    MatrixBenchmarks(BenchmarkSuite& rSuite, ReferenceResults& rReference,
+        std::string const& SizeClass, std::size_t Size)
+        : mrSuite(rSuite),
+          mrReference(rReference),
+          mSizeClass(SizeClass),
+          mSize(Size),
+          mA(TAdapter::CreateMatrix(Size)),
+          mB(TAdapter::CreateMatrix(Size)),
+          mC(TAdapter::CreateMatrix(Size)),
+          mX(TAdapter::CreateVector(Size)),
+          mY(TAdapter::CreateVector(Size)) {
+        // A is diagonally dominant, so the factorization is well conditioned
+        for (std::size_t i = 0; i < Size; i++) {
+            for (std::size_t j = 0; j < Size; j++) {
+                TAdapter::At(mA, i, j) = 1.00 / (i + j + 1);
+                TAdapter::At(mB, i, j) = (j + 1.00) / Size;
+                TAdapter::At(mC, i, j) = 0.00;
+            }
+            TAdapter::At(mA, i, i) += Size;
+            TAdapter::At(mX, i) = 0.00;
+            TAdapter::At(mY, i) = 1.00 / (i + 1);
+        }
+    }
+
+    void RunAll() {
+        const double n = static_cast<double>(mSize);
+        const double matrix_bytes = n * n * sizeof(data_type);
+        const double vector_bytes = n * sizeof(data_type);
+
+        Run("C = A + B", n * n, 3 * matrix_bytes, mC,
+            [&]() { TAdapter::Sum(mC, mA, mB); });
+        Run("C = A - B", n * n, 3 * matrix_bytes, mC,
+            [&]() { TAdapter::Minus(mC, mA, mB); });
+        Run("C = s * A", n * n, 2 * matrix_bytes, mC,
+            [&]() { TAdapter::Scale(mC, mA); });
+        Run("C = A^T", 0.00, 2 * matrix_bytes, mC,
+            [&]() { TAdapter::Transpose(mC, mA); });
+        Run("C = A * B", 2 * n * n * n, 3 * matrix_bytes, mC,
+            [&]() { TAdapter::Product(mC, mA, mB); });
+        Run("C = A * B * A", 4 * n * n * n, 4 * matrix_bytes, mC,
+            [&]() { TAdapter::ProductABA(mC, mA, mB); });
+        Run("C = A^T * B * A", 4 * n * n * n, 4 * matrix_bytes, mC,
+            [&]() { TAdapter::ProductATBA(mC, mA, mB); });
+        Run("C = A^T * A", 2 * n * n * n, 2 * matrix_bytes, mC,
+            [&]() { TAdapter::Gram(mC, mA); });
+        Run("x = A * y", 2 * n * n, matrix_bytes + 2 * vector_bytes, mX,
+            [&]() { TAdapter::MatrixVector(mX, mA, mY); });
+        Run("x = A^T * y", 2 * n * n, matrix_bytes + 2 * vector_bytes, mX,
+            [&]() { TAdapter::TransposeMatrixVector(mX, mA, mY); });
+        Run("x = lu(A).solve(y)", 2 * n * n * n / 3 + 2 * n * n,
+            2 * matrix_bytes + 2 * vector_bytes, mX,
+            [&]() { TAdapter::Solve(mX, mA, mY); });
+        RunScalar("s = x.dot(y)", 2 * n, 2 * vector_bytes,
+            [&]() { return TAdapter::Dot(mX, mY); });
+        RunScalar("s = y.norm()", 2 * n, vector_bytes,
+            [&]() { return TAdapter::Norm(mY); });
+    }
 };
 
-#define RUN_BENCHMARK(name, function)                          \
-    std::cout << name;                                         \
-    mAMatrixColumn.function();                                 \
-    mEigenColumn.function();                                   \
-    if (!mEigenColumn.CheckResult(mAMatrixColumn.GetResult())) \
-        std::cout << "(Failed!)";                              \
-    mUblasColumn.function();                                   \
-    if (!mUblasColumn.CheckResult(mAMatrixColumn.GetResult())) \
-        std::cout << "(Failed!)";                              \
-    std::cout << std::endl;
-
-template <std::size_t TSize1, std::size_t TSize2>
-class BenchmarkMatrix {
-    ComparisonColumn<AMatrix::Matrix<double, TSize1, TSize2>,
-        TSize1, TSize2>
-        mAMatrixColumn;
+template <std::size_t TSize>
+void RunFixedSize(BenchmarkSuite& rSuite, ReferenceResults& rReference) {
+    MatrixBenchmarks<AMatrixAdapter<TSize>>(rSuite, rReference, "fixed", TSize)
+        .RunAll();
+    MatrixBenchmarks<AMatrixAdapter<TSize, float>>(
+        rSuite, rReference, "fixed", TSize)
+        .RunAll();
 #if defined(AMATRIX_COMPARE_WITH_EIGEN)
-    ComparisonColumn<Eigen::Matrix<double, TSize1, TSize2>,
-        TSize1, TSize2>
-        mEigenColumn;
-#else
-    EmptyComparisonColumn<
-        AMatrix::Matrix<double, TSize1, TSize2>, TSize1,
-        TSize2>
-        mEigenColumn;
+    MatrixBenchmarks<EigenAdapter<TSize>>(rSuite, rReference, "fixed", TSize)
+        .RunAll();
 #endif
 #if defined(AMATRIX_COMPARE_WITH_UBLAS)
-    UblasComparisonColumn<boost::numeric::ublas::bounded_matrix<double,
-                              TSize1, TSize2>,
-        TSize1, TSize2>
-        mUblasColumn;
-#else
-    EmptyComparisonColumn<
-        AMatrix::Matrix<double, TSize1, TSize2>, TSize1,
-        TSize2>
-        mUblasColumn;
+    MatrixBenchmarks<UblasAdapter<TSize>>(rSuite, rReference, "fixed", TSize)
+        .RunAll();
 #endif
-   public:
-    BenchmarkMatrix()
-        : mAMatrixColumn("AMatrix"),
-          mEigenColumn("Eigen"),
-          mUblasColumn("Ublas") {
-        std::cout << "Benchmark[" << TSize1 << "," << TSize2
-                  << "]";
-        std::cout << "\t\t" << mAMatrixColumn.GetColumnName();
-        std::cout << "\t\t" << mEigenColumn.GetColumnName();
-        std::cout << "\t\t" << mUblasColumn.GetColumnName();
-        std::cout << std::endl;
-    }
-
-    ~BenchmarkMatrix() = default;
-    void Run() {
-        RUN_BENCHMARK("C = A + B", MeasureSumTime)
-        RUN_BENCHMARK("C = A * B", MeasureMultTime)
-        RUN_BENCHMARK("C = A * B * A", MeasureABAMultTime)
-        RUN_BENCHMARK("C = A^T * B * A", MeasureATransposeBAMultTime)
-
-        std::cout << std::endl;
-    }
-};
+}
 
-template <std::size_t TSize1, std::size_t TSize2>
-class BenchmarkDynamicMatrix {
-    ComparisonColumn<AMatrix::Matrix<double, 0, 0>, TSize1,
-        TSize2>
-        mAMatrixColumn;
+void RunDynamicSize(BenchmarkSuite& rSuite, ReferenceResults& rReference,
+    std::size_t Size) {
+    if (Size > rSuite.GetSettings().mMaximumSize)
+        return;
+    MatrixBenchmarks<AMatrixAdapter<AMatrix::dynamic>>(
+        rSuite, rReference, "dynamic", Size)
+        .RunAll();
+    MatrixBenchmarks<AMatrixAdapter<AMatrix::dynamic, float>>(
+        rSuite, rReference, "dynamic", Size)
+        .RunAll();
 #if defined(AMATRIX_COMPARE_WITH_EIGEN)
-    ComparisonColumn<
-        Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>, TSize1,
-        TSize2>
-        mEigenColumn;
-#else
-    EmptyComparisonColumn<
-        AMatrix::Matrix<double, TSize1, TSize2>, TSize1,
-        TSize2>
-        mEigenColumn;
+    MatrixBenchmarks<EigenAdapter<AMatrix::dynamic>>(
+        rSuite, rReference, "dynamic", Size)
+        .RunAll();
 #endif
 #if defined(AMATRIX_COMPARE_WITH_UBLAS)
-    UblasComparisonColumn<boost::numeric::ublas::matrix<double>,
-        TSize1, TSize2>
-        mUblasColumn;
-#else
-    EmptyComparisonColumn<
-        AMatrix::Matrix<double, TSize1, TSize2>, TSize1,
-        TSize2>
-        mUblasColumn;
+    MatrixBenchmarks<UblasAdapter<AMatrix::dynamic>>(
+        rSuite, rReference, "dynamic", Size)
+        .RunAll();
 #endif
-   public:
-    BenchmarkDynamicMatrix()
-        : mAMatrixColumn("AMatrix"),
-          mEigenColumn("Eigen"),
-          mUblasColumn("Ublas") {
-        std::cout << "Benchmark[" << TSize1 << "," << TSize2
-                  << "]";
-        std::cout << "\t\t" << mAMatrixColumn.GetColumnName();
-        std::cout << "\t\t" << mEigenColumn.GetColumnName();
-        std::cout << "\t\t" << mUblasColumn.GetColumnName();
-        std::cout << std::endl;
-    }
-
-    ~BenchmarkDynamicMatrix() = default;
-    void Run() {
-        RUN_BENCHMARK("C = A + B", MeasureSumTime)
-        RUN_BENCHMARK("C = A * B", MeasureMultTime)
-        RUN_BENCHMARK("C = A * B * A", MeasureABAMultTime)
-        RUN_BENCHMARK("C = A^T * B * A", MeasureATransposeBAMultTime)
-
-        std::cout << std::endl;
-    }
-};
-
-int main() {
-    BenchmarkMatrix<3, 3> benchmark_3_3;
-    benchmark_3_3.Run();
-
-    BenchmarkMatrix<4, 4> benchmark_4_4;
-    benchmark_4_4.Run();
-
-    BenchmarkMatrix<6, 6> benchmark_6_6;
-    benchmark_6_6.Run();
-
-    BenchmarkMatrix<12, 12> benchmark_12_12;
-    benchmark_12_12.Run();
+}
 
-    BenchmarkMatrix<16, 16> benchmark_16_16;
-    benchmark_16_16.Run();
+/// Compares the default parallel reductions with the reproducible mode which
+/// uses fixed size chunks and a fixed reduction tree
+void RunReductions(BenchmarkSuite& rSuite, std::size_t Size) {
+    if (!rSuite.IsSelected("s = a.dot(b)", "AMatrix", Size, 1) &&
+        !rSuite.IsSelected("s = a.norm()", "AMatrix", Size, 1))
+        return;
+
+    AMatrix::Matrix<double, AMatrix::dynamic, 1> a(Size);
+    AMatrix::Matrix<double, AMatrix::dynamic, 1> b(Size);
+    for (std::size_t i = 0; i < Size; i++) {
+        a[i] = 1.00 / (i + 1);
+        b[i] = i + 1.00;
+    }
 
-    BenchmarkDynamicMatrix<3, 3> dynamic_bechmark_3_3;
-    dynamic_bechmark_3_3.Run();
+    const double bytes = Size * sizeof(double);
+    for (int is_reproducible = 0; is_reproducible < 2; is_reproducible++) {
+        AMatrix::SetReproducibleReductions(is_reproducible != 0);
+        const std::string size_class =
+            is_reproducible ? "reproducible" : "fast";
+        rSuite.Run("s = a.dot(b)", "AMatrix", size_class, Size, 1, 2.0 * Size,
+            2 * bytes, [&]() { DoNotOptimize(a.dot(b)); });
+        rSuite.Run("s = a.norm()", "AMatrix", size_class, Size, 1, 2.0 * Size,
+            bytes, [&]() { DoNotOptimize(a.norm()); });
+    }
+    AMatrix::SetReproducibleReductions(false);
+}
 
-    BenchmarkDynamicMatrix<4, 4> dynamic_benchmark_4_4;
-    dynamic_benchmark_4_4.Run();
+void PrintUsage() {
+    std::cout
+        << "Usage: run_benchmark_matrix [options]\n"
+           "  --format=console|json|csv  output format (default console)\n"
+           "  --output=<file>            write the results to a file\n"
+           "  --filter=<text>            run only benchmarks whose name and\n"
+           "                             library contain the text\n"
+           "  --trials=<n>               number of trials (default 10)\n"
+           "  --min-time=<seconds>       minimum time of a trial\n"
+           "  --max-time=<seconds>       time limit of the trials of one "
+           "benchmark\n"
+           "  --max-size=<n>             skip larger matrices (default 2048)\n"
+           "  --max-vector-size=<n>      skip longer vectors (default 1e7)\n"
+           "  --label=<text>             label stored in the json context\n"
+           "  --perf-counters            read the hardware counters (Linux)\n";
+}
 
-    BenchmarkDynamicMatrix<6, 6> dynamic_benchmark_6_6;
-    dynamic_benchmark_6_6.Run();
+int main(int argc, char* argv[]) {
+    BenchmarkSettings settings;
+    std::string format = "console";
+    std::string output;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string argument = argv[i];
+        const std::size_t separator = argument.find('=');
+        const std::string option = argument.substr(0, separator);
+        const std::string value =
+            (separator == std::string::npos) ? "" : argument.substr(separator + 1);
+        if (option == "--format")
+            format = value;
+        else if (option == "--output")
+            output = value;
+        else if (option == "--filter")
+            settings.mFilter = value;
+        else if (option == "--trials")
+            settings.mNumberOfTrials = std::strtoul(value.c_str(), nullptr, 10);
+        else if (option == "--min-time")
+            settings.mMinimumTrialTime = std::atof(value.c_str());
+        else if (option == "--max-time")
+            settings.mMaximumBenchmarkTime = std::atof(value.c_str());
+        else if (option == "--max-size")
+            settings.mMaximumSize = std::strtoul(value.c_str(), nullptr, 10);
+        else if (option == "--max-vector-size")
+            settings.mMaximumVectorSize =
+                static_cast<std::size_t>(std::atof(value.c_str()));
+        else if (option == "--label")
+            settings.mLabel = value;
+        else if (option == "--perf-counters")
+            settings.mUsePerfCounters = true;
+        else {
+            PrintUsage();
+            return (option == "--help") ? 0 : 1;
+        }
+    }
 
-    BenchmarkDynamicMatrix<12, 12> dynamic_benchmark_12_12;
-    dynamic_benchmark_12_12.Run();
+    if (format != "console" && format != "json" && format != "csv") {
+        PrintUsage();
+        return 1;
+    }
 
-    BenchmarkDynamicMatrix<16, 16> dynamic_benchmark_16_16;
-    dynamic_benchmark_16_16.Run();
+    // the progress goes to stderr when the results are written to stdout
+    std::ostream* p_progress =
+        (format == "console" || !output.empty()) ? &std::cout : &std::cerr;
+    BenchmarkSuite suite(settings, p_progress);
+    ReferenceResults reference;
+
+    suite.PrintHeader(*p_progress);
+
+    RunFixedSize<2>(suite, reference);
+    RunFixedSize<3>(suite, reference);
+    RunFixedSize<4>(suite, reference);
+    RunFixedSize<6>(suite, reference);
+    RunFixedSize<8>(suite, reference);
+    RunFixedSize<12>(suite, reference);
+    RunFixedSize<16>(suite, reference);
+
+    for (std::size_t size : {3, 4, 6, 8, 12, 16, 32, 64, 128, 256, 512, 1024,
+             2048})
+        RunDynamicSize(suite, reference, size);
+
+    for (std::size_t size : {100000, 1000000, 10000000})
+        RunReductions(suite, size);
+
+    bool all_valid = true;
+    for (auto const& result : suite.GetResults())
+        all_valid = all_valid && result.mIsValid;
+
+    if (format != "console") {
+        std::ofstream file;
+        if (!output.empty())
+            file.open(output);
+        std::ostream& stream = output.empty() ? std::cout : file;
+        if (format == "json")
+            suite.WriteJson(stream);
+        else
+            suite.WriteCsv(stream);
+    }
 
-    return 0;
+    return all_valid ? 0 : 2;
 }
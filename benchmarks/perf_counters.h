@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/// Hardware counters of the calling thread read with the Linux perf_event
+/// interface. Counters which can not be opened (other platforms, missing
+/// permissions, virtual machines without PMU) are reported as unavailable.
+/// Only user space is counted, so perf_event_paranoid <= 2 is sufficient
+class PerfCounters {
+   public:
+    enum CounterIndex {
+        cycles,
+        instructions,
+        l1d_accesses,
+        l1d_misses,
+        llc_references,
+        llc_misses,
+        branches,
+        branch_misses,
+        fp_operations,
+        number_of_counters
+    };
+
+    struct Values {
+        double mValues[number_of_counters];
+        bool mIsAvailable[number_of_counters];
+
+        Values() {
+            for (int i = 0; i < number_of_counters; i++) {
+                mValues[i] = 0.00;
+                mIsAvailable[i] = false;
+            }
+        }
+
+        bool available(CounterIndex Index) const {
+            return mIsAvailable[Index];
+        }
+
+        double operator[](CounterIndex Index) const { return mValues[Index]; }
+
+        /// Ratio of two counters, or a negative value if one of them is not
+        /// available
+        double ratio(CounterIndex Numerator, CounterIndex Denominator) const {
+            if (!mIsAvailable[Numerator] || !mIsAvailable[Denominator] ||
+                mValues[Denominator] <= 0.00)
+                return -1.00;
+            return mValues[Numerator] / mValues[Denominator];
+        }
+    };
+
+    static const char* Name(int Index) {
+        static const char* names[number_of_counters] = {"cycles",
+            "instructions", "l1d_accesses", "l1d_misses", "llc_references",
+            "llc_misses", "branches", "branch_misses", "fp_operations"};
+        return names[Index];
+    }
+
+   private:
+    struct Event {
+        int mCounter;
+        double mWeight;
+        int mFileDescriptor;
+    };
+
+    std::vector<Event> mEvents;
+    Values mValues;
+
+#if defined(__linux__)
+    static int Open(std::uint32_t Type, std::uint64_t Config) {
+        perf_event_attr attributes;
+        std::memset(&attributes, 0, sizeof(attributes));
+        attributes.size = sizeof(attributes);
+        attributes.type = Type;
+        attributes.config = Config;
+        attributes.disabled = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.read_format =
+            PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(
+            syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0));
+    }
+
+    static std::uint64_t CacheConfig(
+        std::uint64_t Cache, std::uint64_t Operation, std::uint64_t Result) {
+        return Cache | (Operation << 8) | (Result << 16);
+    }
+
+    static bool IsIntel() {
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line))
+            if (line.compare(0, 9, "vendor_id") == 0)
+                return line.find("GenuineIntel") != std::string::npos;
+        return false;
+    }
+
+    void Add(int Counter, std::uint32_t Type, std::uint64_t Config,
+        double Weight = 1.00) {
+        const int file_descriptor = Open(Type, Config);
+        if (file_descriptor >= 0)
+            mEvents.push_back(Event{Counter, Weight, file_descriptor});
+    }
+#endif
+
+   public:
+    PerfCounters() {
+#if defined(__linux__)
+        Add(cycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        Add(instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        Add(l1d_accesses, PERF_TYPE_HW_CACHE,
+            CacheConfig(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                PERF_COUNT_HW_CACHE_RESULT_ACCESS));
+        Add(l1d_misses, PERF_TYPE_HW_CACHE,
+            CacheConfig(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                PERF_COUNT_HW_CACHE_RESULT_MISS));
+        Add(llc_references, PERF_TYPE_HARDWARE,
+            PERF_COUNT_HW_CACHE_REFERENCES);
+        Add(llc_misses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        Add(branches, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS);
+        Add(branch_misses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        // There is no generic floating point event. On Intel cores
+        // FP_ARITH_INST_RETIRED (event 0xc7) counts double precision
+        // instructions by width, an FMA is counted twice
+        if (IsIntel()) {
+            Add(fp_operations, PERF_TYPE_RAW, 0x01c7, 1.00);  // scalar
+            Add(fp_operations, PERF_TYPE_RAW, 0x04c7, 2.00);  // 128 bit
+            Add(fp_operations, PERF_TYPE_RAW, 0x10c7, 4.00);  // 256 bit
+            Add(fp_operations, PERF_TYPE_RAW, 0x40c7, 8.00);  // 512 bit
+        }
+#endif
+    }
+
+    PerfCounters(PerfCounters const&) = delete;
+
+    PerfCounters& operator=(PerfCounters const&) = delete;
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (auto const& event : mEvents)
+            close(event.mFileDescriptor);
+#endif
+    }
+
+    bool is_available() const { return !mEvents.empty(); }
+
+    void start() {
+#if defined(__linux__)
+        for (auto const& event : mEvents)
+            ioctl(event.mFileDescriptor, PERF_EVENT_IOC_RESET, 0);
+        for (auto const& event : mEvents)
+            ioctl(event.mFileDescriptor, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    /// Stops the counters and returns their values since start(). Counters
+    /// which were multiplexed are scaled to the enabled time
+    Values const& stop() {
+        mValues = Values();
+#if defined(__linux__)
+        for (auto const& event : mEvents)
+            ioctl(event.mFileDescriptor, PERF_EVENT_IOC_DISABLE, 0);
+        for (auto const& event : mEvents) {
+            std::uint64_t data[3] = {0, 0, 0};
+            if (read(event.mFileDescriptor, data, sizeof(data)) !=
+                    static_cast<ssize_t>(sizeof(data)) ||
+                data[2] == 0)
+                continue;
+            const double scale = static_cast<double>(data[1]) / data[2];
+            mValues.mValues[event.mCounter] += event.mWeight * data[0] * scale;
+            mValues.mIsAvailable[event.mCounter] = true;
+        }
+#endif
+        return mValues;
+    }
+};
@@ -2,6 +2,7 @@
 #include <cmath>
 #include <string>
 
+#include "perf_counters.h"
 #include "timer.h"
 #include "matrix.h"
 
@@ -19,8 +20,46 @@ template<class TMatrixType>
                 TheMatrix(i, j) = 1.00 / (i + 1);
     }
 
+void PrintCounters(PerfCounters::Values const& Counters, std::size_t Repeat) {
+    bool is_available = false;
+    for (int i = 0; i < PerfCounters::number_of_counters; i++)
+        if (Counters.available(static_cast<PerfCounters::CounterIndex>(i))) {
+            std::cout << PerfCounters::Name(i) << " per iteration : "
+                      << Counters.mValues[i] / Repeat << std::endl;
+            is_available = true;
+        }
+    if (!is_available) {
+        std::cout << "hardware performance counters are not available"
+                  << std::endl;
+        return;
+    }
+    const double ipc =
+        Counters.ratio(PerfCounters::instructions, PerfCounters::cycles);
+    const double flops_per_cycle =
+        Counters.ratio(PerfCounters::fp_operations, PerfCounters::cycles);
+    const double l1_miss_rate =
+        Counters.ratio(PerfCounters::l1d_misses, PerfCounters::l1d_accesses);
+    const double llc_miss_rate =
+        Counters.ratio(PerfCounters::llc_misses, PerfCounters::llc_references);
+    const double branch_miss_rate =
+        Counters.ratio(PerfCounters::branch_misses, PerfCounters::branches);
+    if (ipc >= 0.00)
+        std::cout << "IPC : " << ipc << std::endl;
+    if (flops_per_cycle >= 0.00)
+        std::cout << "flops per cycle : " << flops_per_cycle << std::endl;
+    if (l1_miss_rate >= 0.00)
+        std::cout << "L1 miss rate : " << 100.00 * l1_miss_rate << "%"
+                  << std::endl;
+    if (llc_miss_rate >= 0.00)
+        std::cout << "LLC miss rate : " << 100.00 * llc_miss_rate << "%"
+                  << std::endl;
+    if (branch_miss_rate >= 0.00)
+        std::cout << "branch miss rate : " << 100.00 * branch_miss_rate << "%"
+                  << std::endl;
+}
+
 template<class TMatrixType, std::size_t TSize1, std::size_t TSize2>
-    void Profile() {                     
+    void Profile(bool UsePerfCounters) {
         constexpr std::size_t repeat = 100000000;                                   
         TMatrixType A(TSize1, TSize2);                                   
         TMatrixType B(TSize1, TSize2);                                   
@@ -28,6 +67,9 @@ template<class TMatrixType, std::size_t TSize1, std::size_t TSize2>
         initialize(A);                                                   
         initialize(B);                                                   
         initialize(C);                                                   
+        PerfCounters counters;
+        if (UsePerfCounters)
+            counters.start();
         Timer timer;                                                     
         for (std::size_t i_repeat = 0; i_repeat < repeat; i_repeat++) { 
            C = A + B; 
@@ -35,12 +77,17 @@ template<class TMatrixType, std::size_t TSize1, std::size_t TSize2>
         }                                                                
         auto elapsed = timer.elapsed().count();                          
         std::cout << "elapsed time : " << elapsed << std::endl;
+        if (UsePerfCounters)
+            PrintCounters(counters.stop(), repeat);
         std::cout << C << std::endl;                                  
     }
 
 
-int main() {
-    Profile<AMatrix::Matrix<double, AMatrix::dynamic,AMatrix::dynamic>, 6, 6>();
+int main(int argc, char* argv[]) {
+    const bool use_perf_counters =
+        argc > 1 && std::string(argv[1]) == "--perf-counters";
+    Profile<AMatrix::Matrix<double, AMatrix::dynamic,AMatrix::dynamic>, 6, 6>(
+        use_perf_counters);
 
     return 0;
 }
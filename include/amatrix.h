@@ -1,4 +1,8 @@
 #include "matrix.h"
+#include "matrix_functions.h"
+#include "mixed_precision.h"
+#include "packed_matrix.h"
+#include "symmetric_rank_update.h"
 
 namespace AMatrix {
 
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace AMatrix {
+
+/// Brain floating point storage type: the upper 16 bits of a float, with
+/// the exponent range of float and 8 bits of precision. It halves the
+/// memory traffic of float and is meant for storage only, the arithmetic is
+/// done in float or in a wider accumulator type after the conversion
+class BFloat16 {
+    std::uint16_t _bits;
+
+   public:
+    BFloat16() : _bits(0) {}
+
+    /// Rounds to the nearest value, ties to even. NaN stays a (quiet) NaN
+    BFloat16(float Value) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &Value, sizeof(bits));
+        if ((bits & 0x7fffffffu) > 0x7f800000u)
+            _bits = static_cast<std::uint16_t>((bits >> 16) | 0x0040u);
+        else
+            _bits = static_cast<std::uint16_t>(
+                (bits + 0x7fffu + ((bits >> 16) & 1u)) >> 16);
+    }
+
+    BFloat16(double Value) : BFloat16(static_cast<float>(Value)) {}
+
+    BFloat16(int Value) : BFloat16(static_cast<float>(Value)) {}
+
+    operator float() const {
+        const std::uint32_t bits = static_cast<std::uint32_t>(_bits) << 16;
+        float result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    std::uint16_t bits() const { return _bits; }
+
+    static BFloat16 from_bits(std::uint16_t Bits) {
+        BFloat16 result;
+        result._bits = Bits;
+        return result;
+    }
+
+    BFloat16& operator+=(float Other) {
+        return *this = BFloat16(float(*this) + Other);
+    }
+
+    BFloat16& operator-=(float Other) {
+        return *this = BFloat16(float(*this) - Other);
+    }
+
+    BFloat16& operator*=(float Other) {
+        return *this = BFloat16(float(*this) * Other);
+    }
+
+    BFloat16& operator/=(float Other) {
+        return *this = BFloat16(float(*this) / Other);
+    }
+};
+
+}  // namespace AMatrix
@@ -0,0 +1,243 @@
+#pragma once
+
+#include <cassert>
+
+#include "matrix_expression.h"
+#include "product_chain.h"
+
+namespace AMatrix {
+
+/// Row major matrix with sizes known at run time, up to TMaxSize1 x
+/// TMaxSize2. The elements are stored inline like the ones of a fixed size
+/// matrix, so a bounded matrix never allocates. The results of expressions
+/// of bounded matrices are held in bounded matrices, see ResultMatrix
+template <typename TDataType, std::size_t TMaxSize1, std::size_t TMaxSize2>
+class BoundedMatrix
+    : public MatrixExpression<BoundedMatrix<TDataType, TMaxSize1, TMaxSize2>,
+          row_major_access> {
+    static_assert(TMaxSize1 != dynamic && TMaxSize2 != dynamic,
+        "A bounded matrix needs bounds for both sizes");
+
+    std::size_t _size1;
+    std::size_t _size2;
+    TDataType _data[TMaxSize1 * TMaxSize2];
+
+   public:
+    using data_type = TDataType;
+    static constexpr std::size_t static_size1 = dynamic;
+    static constexpr std::size_t static_size2 = dynamic;
+    static constexpr std::size_t static_max_size1 = TMaxSize1;
+    static constexpr std::size_t static_max_size2 = TMaxSize2;
+
+    BoundedMatrix() : _size1(0), _size2(0) {}
+
+    BoundedMatrix(std::size_t TheSize1, std::size_t TheSize2) {
+        resize(TheSize1, TheSize2);
+    }
+
+    BoundedMatrix(std::size_t TheSize1, std::size_t TheSize2,
+        TDataType const& InitialValue) {
+        resize(TheSize1, TheSize2);
+        for (std::size_t i = 0; i < size(); i++)
+            _data[i] = InitialValue;
+    }
+
+    BoundedMatrix(BoundedMatrix const& Other) { copy(Other); }
+
+    template <typename TExpressionType, std::size_t TCategory>
+    explicit BoundedMatrix(
+        MatrixExpression<TExpressionType, TCategory> const& Other) {
+        auto const& other_expression = Other.expression();
+        resize(other_expression.size1(), other_expression.size2());
+        EvaluateExpression(other_expression, _data);
+    }
+
+    template <typename TFirstType, typename TSecondType>
+    explicit BoundedMatrix(
+        MatrixProductExpression<TFirstType, TSecondType> const& Other) {
+        resize(Other.size1(), Other.size2());
+        evaluate_product(Other);
+    }
+
+    BoundedMatrix& operator=(BoundedMatrix const& Other) {
+        AMATRIX_COUNT_OPERATION(assignment, Other.size1(), Other.size2());
+        copy(Other);
+        return *this;
+    }
+
+    /// An expression which reads this matrix at other positions is
+    /// evaluated into a bounded temporary first
+    template <typename TExpressionType, std::size_t TCategory>
+    BoundedMatrix& operator=(
+        MatrixExpression<TExpressionType, TCategory> const& Other) {
+        auto const& other_expression = Other.expression();
+        AMATRIX_COUNT_OPERATION(
+            assignment, other_expression.size1(), other_expression.size2());
+        if (other_expression.aliases(_data, _data + size())) {
+            BoundedMatrix temporary(Other);
+            copy(temporary);
+            return *this;
+        }
+        resize(other_expression.size1(), other_expression.size2());
+        EvaluateExpression(other_expression, _data);
+        return *this;
+    }
+
+    template <typename TFirstType, typename TSecondType>
+    BoundedMatrix& operator=(
+        MatrixProductExpression<TFirstType, TSecondType> const& Other) {
+        AMATRIX_COUNT_OPERATION(assignment, Other.size1(), Other.size2());
+        if (Other.aliases(_data, _data + size())) {
+            BoundedMatrix temporary(Other);
+            copy(temporary);
+            return *this;
+        }
+        resize(Other.size1(), Other.size2());
+        evaluate_product(Other);
+        return *this;
+    }
+
+    /// An expression which reads this matrix at other positions is
+    /// evaluated into a bounded temporary first
+    template <typename TExpressionType, std::size_t TCategory>
+    BoundedMatrix& operator+=(
+        MatrixExpression<TExpressionType, TCategory> const& Other) {
+        auto const& other_expression = Other.expression();
+        if (other_expression.aliases(_data, _data + size()))
+            return *this += BoundedMatrix(other_expression);
+        for (std::size_t i = 0; i < _size1; i++)
+            for (std::size_t j = 0; j < _size2; j++)
+                at(i, j) += other_expression(i, j);
+        return *this;
+    }
+
+    template <typename TExpressionType, std::size_t TCategory>
+    BoundedMatrix& operator-=(
+        MatrixExpression<TExpressionType, TCategory> const& Other) {
+        auto const& other_expression = Other.expression();
+        if (other_expression.aliases(_data, _data + size()))
+            return *this -= BoundedMatrix(other_expression);
+        for (std::size_t i = 0; i < _size1; i++)
+            for (std::size_t j = 0; j < _size2; j++)
+                at(i, j) -= other_expression(i, j);
+        return *this;
+    }
+
+    BoundedMatrix& operator*=(data_type TheValue) {
+        for (std::size_t i = 0; i < size(); i++)
+            _data[i] *= TheValue;
+        return *this;
+    }
+
+    TDataType& operator()(std::size_t i, std::size_t j) { return at(i, j); }
+
+    TDataType const& operator()(std::size_t i, std::size_t j) const {
+        return at(i, j);
+    }
+
+    TDataType& at(std::size_t i, std::size_t j) {
+        return _data[i * _size2 + j];
+    }
+
+    TDataType const& at(std::size_t i, std::size_t j) const {
+        return _data[i * _size2 + j];
+    }
+
+    TDataType& operator[](std::size_t i) { return _data[i]; }
+
+    TDataType const& operator[](std::size_t i) const { return _data[i]; }
+
+    TDataType& at(std::size_t i) { return _data[i]; }
+
+    TDataType const& at(std::size_t i) const { return _data[i]; }
+
+    std::size_t size1() const { return _size1; }
+
+    std::size_t size2() const { return _size2; }
+
+    std::size_t size() const { return _size1 * _size2; }
+
+    /// The new sizes must be within the bounds. The elements are not kept
+    void resize(std::size_t NewSize1, std::size_t NewSize2) {
+        assert(NewSize1 <= TMaxSize1 && NewSize2 <= TMaxSize2);
+        _size1 = NewSize1;
+        _size2 = NewSize2;
+    }
+
+    TDataType* data() { return _data; }
+
+    TDataType const* data() const { return _data; }
+
+    bool overlaps(void const* pBegin, void const* pEnd) const {
+        return AreRangesOverlapping(_data, _data + size(), pBegin, pEnd);
+    }
+
+    /// In an elementwise expression an element is only read for the same
+    /// element of the destination, which is safe if it is this matrix
+    bool aliases(void const* pBegin, void const* pEnd) const {
+        return overlaps(pBegin, pEnd) &&
+               !(pBegin == _data && pEnd == _data + size());
+    }
+
+    template <std::size_t TWidth>
+    inline Packet<TDataType, TWidth> packet(std::size_t i) const {
+        return Packet<TDataType, TWidth>::load_unaligned(_data + i);
+    }
+
+    TransposeMatrix<BoundedMatrix> transpose() const {
+        return TransposeMatrix<BoundedMatrix>(*this);
+    }
+
+   private:
+    void copy(BoundedMatrix const& Other) {
+        resize(Other.size1(), Other.size2());
+        for (std::size_t i = 0; i < size(); i++)
+            _data[i] = Other._data[i];
+    }
+
+    /// Products of dense operands use the dense kernels, the others are
+    /// evaluated as chains or element by element
+    template <typename TFirstType, typename TSecondType>
+    void evaluate_product(
+        MatrixProductExpression<TFirstType, TSecondType> const& Product) {
+        using product_type = MatrixProductExpression<TFirstType, TSecondType>;
+        using first_type = typename product_type::first_type;
+        using second_type = typename product_type::second_type;
+        evaluate_product(Product,
+            std::integral_constant<bool,
+                IsContiguous<first_type>::value &&
+                    IsContiguous<second_type>::value &&
+                    std::is_same<typename first_type::data_type,
+                        TDataType>::value &&
+                    std::is_same<typename second_type::data_type,
+                        TDataType>::value>());
+    }
+
+    template <typename TProductType>
+    void evaluate_product(
+        TProductType const& Product, std::true_type /* IsContiguous */) {
+        auto const& first = Product.first();
+        auto const& second = Product.second();
+        AMATRIX_COUNT_OPERATION(product, first.size1(), second.size2());
+        DenseProduct(first.size1(), first.size2(), second.size2(),
+            first.data(), second.data(), _data);
+    }
+
+    template <typename TProductType>
+    void evaluate_product(
+        TProductType const& Product, std::false_type /* IsContiguous */) {
+        EvaluateProduct(Product, _data);
+    }
+};
+
+template <typename TDataType, std::size_t TMaxSize1, std::size_t TMaxSize2>
+struct IsContiguous<BoundedMatrix<TDataType, TMaxSize1, TMaxSize2>> {
+    static constexpr bool value = true;
+};
+
+template <typename TDataType, std::size_t TMaxSize1, std::size_t TMaxSize2>
+struct HasPacketAccess<BoundedMatrix<TDataType, TMaxSize1, TMaxSize2>> {
+    static constexpr bool value = true;
+};
+
+}  // namespace AMatrix
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#endif
+
+// The kernels are compiled for several instruction sets and selected at run
+// time when the compiler supports target attributes (GCC and Clang on x86).
+// Translation units which already target AVX2 and FMA, e.g. with
+// -march=native, call the kernels of their own target inline instead, as do
+// all translation units when AMATRIX_DISABLE_DISPATCH is defined
+#if !defined(AMATRIX_DISABLE_DISPATCH) && defined(__GNUC__) && \
+    (defined(__x86_64__) || defined(__i386__)) && \
+    !defined(__AVX512F__) && !(defined(__AVX2__) && defined(__FMA__))
+#define AMATRIX_DISPATCH 1
+#define AMATRIX_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define AMATRIX_TARGET_AVX512 __attribute__((target("avx512f,avx2,fma")))
+#else
+#define AMATRIX_DISPATCH 0
+#endif
+
+#if defined(__GNUC__)
+#define AMATRIX_ALWAYS_INLINE inline __attribute__((always_inline))
+#define AMATRIX_RESTRICT __restrict__
+#elif defined(_MSC_VER)
+#define AMATRIX_ALWAYS_INLINE __forceinline
+#define AMATRIX_RESTRICT __restrict
+#else
+#define AMATRIX_ALWAYS_INLINE inline
+#define AMATRIX_RESTRICT
+#endif
+
+namespace AMatrix {
+
+// Instruction sets of the kernels. generic_instructions is the target of the
+// translation unit, e.g. SSE2 for x86-64 without -m flags
+enum class InstructionSet {
+    generic_instructions = 0,
+    avx2_instructions = 1,  // AVX2 and FMA
+    avx512_instructions = 2,
+};
+
+inline const char* InstructionSetName(InstructionSet TheInstructionSet) {
+    switch (TheInstructionSet) {
+        case InstructionSet::avx2_instructions:
+            return "avx2";
+        case InstructionSet::avx512_instructions:
+            return "avx512";
+        default:
+            return "generic";
+    }
+}
+
+/// Highest instruction set supported by the processor and the operating
+/// system, from cpuid and the enabled register states in xcr0
+inline InstructionSet DetectInstructionSet() {
+#if AMATRIX_DISPATCH || (defined(_MSC_VER) && \
+                         (defined(_M_X64) || defined(_M_IX86)))
+    unsigned int registers1[4] = {0, 0, 0, 0};
+    unsigned int registers7[4] = {0, 0, 0, 0};
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    const unsigned int maximum_leaf = static_cast<unsigned int>(info[0]);
+    __cpuidex(info, 1, 0);
+    std::memcpy(registers1, info, sizeof(info));
+    if (maximum_leaf >= 7) {
+        __cpuidex(info, 7, 0);
+        std::memcpy(registers7, info, sizeof(info));
+    }
+#else
+    const unsigned int maximum_leaf = __get_cpuid_max(0, nullptr);
+    __get_cpuid_count(1, 0, &registers1[0], &registers1[1], &registers1[2],
+        &registers1[3]);
+    if (maximum_leaf >= 7)
+        __get_cpuid_count(7, 0, &registers7[0], &registers7[1],
+            &registers7[2], &registers7[3]);
+#endif
+    const bool has_osxsave = (registers1[2] >> 27) & 1;
+    const bool has_fma = (registers1[2] >> 12) & 1;
+    const bool has_avx = (registers1[2] >> 28) & 1;
+    const bool has_avx2 = (registers7[1] >> 5) & 1;
+    const bool has_avx512f = (registers7[1] >> 16) & 1;
+    if (!has_osxsave || !has_avx)
+        return InstructionSet::generic_instructions;
+
+#if defined(_MSC_VER)
+    const unsigned long long xcr0 = _xgetbv(0);
+#else
+    unsigned int xcr0_low, xcr0_high;
+    __asm__("xgetbv" : "=a"(xcr0_low), "=d"(xcr0_high) : "c"(0));
+    const unsigned long long xcr0 =
+        (static_cast<unsigned long long>(xcr0_high) << 32) | xcr0_low;
+#endif
+    const bool has_ymm_state = (xcr0 & 0x6) == 0x6;
+    const bool has_zmm_state = (xcr0 & 0xe6) == 0xe6;
+
+    if (has_avx512f && has_avx2 && has_fma && has_ymm_state && has_zmm_state)
+        return InstructionSet::avx512_instructions;
+    if (has_avx2 && has_fma && has_ymm_state)
+        return InstructionSet::avx2_instructions;
+#endif
+    return InstructionSet::generic_instructions;
+}
+
+/// Instruction set of the dispatched kernels. It is detected once and can be
+/// lowered with the AMATRIX_INSTRUCTION_SET environment variable (generic,
+/// avx2 or avx512), e.g. to benchmark each path. Requests above the
+/// detected set are ignored
+inline InstructionSet& InstructionSetReference() {
+    static InstructionSet instruction_set = []() -> InstructionSet {
+        const InstructionSet detected = DetectInstructionSet();
+        const char* p_value = std::getenv("AMATRIX_INSTRUCTION_SET");
+        if (!p_value)
+            return detected;
+        InstructionSet requested = detected;
+        if (std::strcmp(p_value, "generic") == 0)
+            requested = InstructionSet::generic_instructions;
+        else if (std::strcmp(p_value, "avx2") == 0)
+            requested = InstructionSet::avx2_instructions;
+        else if (std::strcmp(p_value, "avx512") == 0)
+            requested = InstructionSet::avx512_instructions;
+        return (requested < detected) ? requested : detected;
+    }();
+    return instruction_set;
+}
+
+inline InstructionSet GetInstructionSet() { return InstructionSetReference(); }
+
+/// Sets the instruction set of the kernels, limited to the detected one.
+/// Returns the instruction set which is used
+inline InstructionSet SetInstructionSet(InstructionSet TheInstructionSet) {
+    const InstructionSet detected = DetectInstructionSet();
+    InstructionSetReference() =
+        (TheInstructionSet < detected) ? TheInstructionSet : detected;
+    return InstructionSetReference();
+}
+
+/// Size of the last level cache in bytes as reported by the operating
+/// system, or 32 MB where it is not known
+inline std::size_t DetectLastLevelCacheBytes() {
+#if defined(__linux__) && defined(_SC_LEVEL3_CACHE_SIZE)
+    const long level3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (level3 > 0)
+        return static_cast<std::size_t>(level3);
+    const long level2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    if (level2 > 0)
+        return static_cast<std::size_t>(level2);
+#endif
+    return std::size_t(32) << 20;
+}
+
+/// Outputs of the elementwise evaluation with at least this many bytes are
+/// written with non-temporal stores, since they do not fit into the cache
+/// anyway. The default is the size of the last level cache, it can be set
+/// with the AMATRIX_STREAMING_STORE_BYTES environment variable
+inline std::size_t& StreamingStoreBytesReference() {
+    static std::size_t bytes = []() -> std::size_t {
+        const char* p_value = std::getenv("AMATRIX_STREAMING_STORE_BYTES");
+        if (p_value) {
+            const long long value = std::atoll(p_value);
+            if (value > 0)
+                return static_cast<std::size_t>(value);
+        }
+        return DetectLastLevelCacheBytes();
+    }();
+    return bytes;
+}
+
+inline std::size_t GetStreamingStoreBytes() {
+    return StreamingStoreBytesReference();
+}
+
+inline void SetStreamingStoreBytes(std::size_t Bytes) {
+    StreamingStoreBytesReference() = Bytes;
+}
+
+}  // namespace AMatrix
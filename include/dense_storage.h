@@ -28,16 +28,12 @@ class DenseStorage {
     template <typename TExpressionType>
     explicit DenseStorage(
         MatrixExpression<TExpressionType, row_major_access> const& Other) {
-        for (std::size_t i = 0; i < size(); i++)
-            _data[i] = Other.expression()[i];
+        EvaluateExpression(Other.expression(), _data);
     }
 
     template <typename TOtherMatrixType>
     explicit DenseStorage(TOtherMatrixType const& Other) {
-        auto i_data = _data;
-        for (std::size_t i = 0; i < Other.size1(); i++)
-            for (std::size_t j = 0; j < Other.size2(); j++)
-                *(i_data++) = Other(i, j);
+        EvaluateExpression(Other, _data);
     }
 
     explicit DenseStorage(std::initializer_list<TDataType> InitialValues) {
@@ -50,27 +46,25 @@ class DenseStorage {
     template <typename TExpressionType, std::size_t TCategory>
     DenseStorage& operator=(
         MatrixExpression<TExpressionType, TCategory> const& Other) {
-        auto i_data = _data;
-        for (std::size_t i = 0; i <  Other.expression().size1(); i++)
-            for (std::size_t j = 0; j <  Other.expression().size2(); j++)
-                *(i_data++) = Other.expression()(i, j);
+        AMATRIX_COUNT_OPERATION(assignment, Other.expression().size1(),
+            Other.expression().size2());
+        EvaluateExpression(Other.expression(), _data);
         return *this;
     }
 
     template <typename TExpressionType>
     DenseStorage& operator=(
         MatrixExpression<TExpressionType, row_major_access> const& Other) {
-        for (std::size_t i = 0; i < size(); i++)
-            _data[i] = Other.expression()[i];
+        AMATRIX_COUNT_OPERATION(assignment, Other.expression().size1(),
+            Other.expression().size2());
+        EvaluateExpression(Other.expression(), _data);
         return *this;
     }
 
     template <typename TOtherMatrixType>
     DenseStorage& operator=(TOtherMatrixType const& Other) {
-        auto i_data = _data;
-        for (std::size_t i = 0; i < Other.size1(); i++)
-            for (std::size_t j = 0; j < Other.size2(); j++)
-                *(i_data++) = Other(i, j);
+        AMATRIX_COUNT_OPERATION(assignment, Other.size1(), Other.size2());
+        EvaluateExpression(Other, _data);
         return *this;
     }
 
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// Operation counters for finding the operations which dominate a run. They
+// are compiled in only if AMATRIX_INSTRUMENTATION is defined, otherwise the
+// hooks expand to nothing. The summary is printed to std::cerr at exit,
+// unless the AMATRIX_INSTRUMENTATION_REPORT environment variable is 0, and
+// can be printed on demand with PrintInstrumentationSummary
+
+namespace AMatrix {
+
+enum class Operation {
+    assignment,
+    product,
+    factorization,
+    allocation,
+};
+
+constexpr std::size_t number_of_operations = 4;
+
+/// Size classes of one dimension: the sizes 0 to 16 have their own class,
+/// larger ones are grouped by powers of two up to 4096 and everything above
+constexpr std::size_t number_of_size_classes = 26;
+
+inline std::size_t SizeClass(std::size_t Size) {
+    if (Size <= 16)
+        return Size;
+    std::size_t size_class = 17;
+    for (std::size_t limit = 32; limit <= 4096; limit *= 2, size_class++)
+        if (Size <= limit)
+            return size_class;
+    return number_of_size_classes - 1;
+}
+
+inline std::string SizeClassName(std::size_t SizeClass) {
+    if (SizeClass <= 16)
+        return std::to_string(SizeClass);
+    if (SizeClass == number_of_size_classes - 1)
+        return ">4096";
+    const std::size_t limit = std::size_t(32) << (SizeClass - 17);
+    return std::to_string(limit / 2 + 1) + "-" + std::to_string(limit);
+}
+
+inline const char* OperationName(Operation TheOperation) {
+    static const char* names[number_of_operations] = {
+        "assignment", "product", "factorization", "allocation"};
+    return names[static_cast<std::size_t>(TheOperation)];
+}
+
+/// Function called for each counted operation, for tracing
+using InstrumentationHook = void (*)(
+    Operation TheOperation, std::size_t Size1, std::size_t Size2);
+
+class InstrumentationCounters {
+    std::atomic<std::size_t> _counts[number_of_operations]
+                                    [number_of_size_classes]
+                                    [number_of_size_classes];
+    std::atomic<std::size_t> _allocated_bytes;
+    std::atomic<InstrumentationHook> _hook;
+    bool _report_at_exit;
+
+   public:
+    InstrumentationCounters() : _hook(nullptr) {
+        reset();
+        const char* p_value = std::getenv("AMATRIX_INSTRUMENTATION_REPORT");
+        _report_at_exit = !p_value || std::atoi(p_value) != 0;
+    }
+
+    ~InstrumentationCounters() {
+        if (_report_at_exit)
+            print_summary(std::cerr);
+    }
+
+    void reset() {
+        for (auto& operation_counts : _counts)
+            for (auto& row : operation_counts)
+                for (auto& count : row)
+                    count.store(0, std::memory_order_relaxed);
+        _allocated_bytes.store(0, std::memory_order_relaxed);
+    }
+
+    void count(Operation TheOperation, std::size_t Size1, std::size_t Size2) {
+        _counts[static_cast<std::size_t>(TheOperation)][SizeClass(Size1)]
+               [SizeClass(Size2)]
+                   .fetch_add(1, std::memory_order_relaxed);
+        InstrumentationHook hook = _hook.load(std::memory_order_relaxed);
+        if (hook)
+            hook(TheOperation, Size1, Size2);
+    }
+
+    void count_allocation(std::size_t Size, std::size_t Bytes) {
+        count(Operation::allocation, Size, 1);
+        _allocated_bytes.fetch_add(Bytes, std::memory_order_relaxed);
+    }
+
+    /// Number of operations in the size classes of Size1 and Size2
+    std::size_t get(
+        Operation TheOperation, std::size_t Size1, std::size_t Size2) const {
+        return _counts[static_cast<std::size_t>(TheOperation)]
+                      [SizeClass(Size1)][SizeClass(Size2)]
+                          .load(std::memory_order_relaxed);
+    }
+
+    /// Number of operations of all sizes
+    std::size_t total(Operation TheOperation) const {
+        std::size_t result = 0;
+        for (auto const& row : _counts[static_cast<std::size_t>(TheOperation)])
+            for (auto const& count : row)
+                result += count.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    std::size_t allocated_bytes() const {
+        return _allocated_bytes.load(std::memory_order_relaxed);
+    }
+
+    void set_hook(InstrumentationHook Hook) { _hook.store(Hook); }
+
+    void set_report_at_exit(bool ReportAtExit) {
+        _report_at_exit = ReportAtExit;
+    }
+
+    void print_summary(std::ostream& rOStream) const {
+        rOStream << "AMatrix operation counts" << std::endl;
+        rOStream << std::left << std::setw(16) << "operation" << std::setw(24)
+                 << "size" << std::right << std::setw(16) << "count"
+                 << std::endl;
+        for (std::size_t operation = 0; operation < number_of_operations;
+             operation++)
+            for (std::size_t i = 0; i < number_of_size_classes; i++)
+                for (std::size_t j = 0; j < number_of_size_classes; j++) {
+                    const std::size_t count =
+                        _counts[operation][i][j].load(std::memory_order_relaxed);
+                    if (count == 0)
+                        continue;
+                    // allocations are counted by number of elements
+                    const std::string size =
+                        (operation ==
+                            static_cast<std::size_t>(Operation::allocation))
+                            ? SizeClassName(i)
+                            : SizeClassName(i) + " x " + SizeClassName(j);
+                    rOStream << std::left << std::setw(16)
+                             << OperationName(static_cast<Operation>(operation))
+                             << std::setw(24) << size << std::right
+                             << std::setw(16) << count << std::endl;
+                }
+        rOStream << "allocated bytes : " << allocated_bytes() << std::endl;
+    }
+};
+
+inline InstrumentationCounters& GetInstrumentationCounters() {
+    static InstrumentationCounters counters;
+    return counters;
+}
+
+inline void PrintInstrumentationSummary(std::ostream& rOStream = std::cerr) {
+    GetInstrumentationCounters().print_summary(rOStream);
+}
+
+inline void ResetInstrumentation() { GetInstrumentationCounters().reset(); }
+
+/// Allocates the data of the dynamic storages
+template <typename TDataType>
+inline TDataType* AllocateStorage(std::size_t Size) {
+#if defined(AMATRIX_INSTRUMENTATION)
+    GetInstrumentationCounters().count_allocation(
+        Size, Size * sizeof(TDataType));
+#endif
+    return new TDataType[Size];
+}
+
+}  // namespace AMatrix
+
+#if defined(AMATRIX_INSTRUMENTATION)
+#define AMATRIX_COUNT_OPERATION(TheOperation, Size1, Size2) \
+    ::AMatrix::GetInstrumentationCounters().count(          \
+        ::AMatrix::Operation::TheOperation, Size1, Size2)
+#else
+#define AMATRIX_COUNT_OPERATION(TheOperation, Size1, Size2) ((void)0)
+#endif
@@ -0,0 +1,549 @@
+// Kernel set for one instruction set, included by kernels.h once per set
+// (no include guard). The including file defines
+//   AMATRIX_KERNEL_SET            name of the struct
+//   AMATRIX_KERNEL_TARGET         target attribute of the functions
+//   AMATRIX_KERNEL_REGISTER_BYTES width of the vector registers
+// The functions work on contiguous arrays through Packet, with the packets
+// of the registers of the set and a masked tail. The complex kernels work on
+// the interleaved real and imaginary parts of std::complex arrays
+
+struct AMATRIX_KERNEL_SET {
+    template <typename TDataType>
+    using packet_type = Packet<TDataType,
+        PacketWidth<TDataType, AMATRIX_KERNEL_REGISTER_BYTES>::value>;
+
+    /// Packets of at least two elements, so the real and the imaginary part
+    /// of a complex number are always in the same packet
+    template <typename TDataType>
+    using pair_packet_type = Packet<TDataType,
+        (packet_type<TDataType>::width < 2) ? 2
+                                            : packet_type<TDataType>::width>;
+
+    /// y += Alpha * x
+    template <typename TDataType>
+    AMATRIX_KERNEL_TARGET static void axpy(std::size_t Size, TDataType Alpha,
+        TDataType const* pX, TDataType* pY) {
+        using packet = packet_type<TDataType>;
+        const packet alpha = packet::broadcast(Alpha);
+        std::size_t i = 0;
+        for (; i + packet::width <= Size; i += packet::width)
+            MultiplyAdd(alpha, packet::load_unaligned(pX + i),
+                packet::load_unaligned(pY + i))
+                .store_unaligned(pY + i);
+        if (i < Size)
+            MultiplyAdd(alpha, packet::load_partial(pX + i, Size - i),
+                packet::load_partial(pY + i, Size - i))
+                .store_partial(pY + i, Size - i);
+    }
+
+    /// z = x + y
+    template <typename TDataType>
+    AMATRIX_KERNEL_TARGET static void add(std::size_t Size,
+        TDataType const* pX, TDataType const* pY, TDataType* pZ) {
+        using packet = packet_type<TDataType>;
+        std::size_t i = 0;
+        for (; i + packet::width <= Size; i += packet::width)
+            (packet::load_unaligned(pX + i) + packet::load_unaligned(pY + i))
+                .store_unaligned(pZ + i);
+        if (i < Size)
+            (packet::load_partial(pX + i, Size - i) +
+                packet::load_partial(pY + i, Size - i))
+                .store_partial(pZ + i, Size - i);
+    }
+
+    /// z = x - y
+    template <typename TDataType>
+    AMATRIX_KERNEL_TARGET static void subtract(std::size_t Size,
+        TDataType const* pX, TDataType const* pY, TDataType* pZ) {
+        using packet = packet_type<TDataType>;
+        std::size_t i = 0;
+        for (; i + packet::width <= Size; i += packet::width)
+            (packet::load_unaligned(pX + i) - packet::load_unaligned(pY + i))
+                .store_unaligned(pZ + i);
+        if (i < Size)
+            (packet::load_partial(pX + i, Size - i) -
+                packet::load_partial(pY + i, Size - i))
+                .store_partial(pZ + i, Size - i);
+    }
+
+    /// y = Alpha * x
+    template <typename TDataType>
+    AMATRIX_KERNEL_TARGET static void scale(std::size_t Size, TDataType Alpha,
+        TDataType const* pX, TDataType* pY) {
+        using packet = packet_type<TDataType>;
+        const packet alpha = packet::broadcast(Alpha);
+        std::size_t i = 0;
+        for (; i + packet::width <= Size; i += packet::width)
+            (alpha * packet::load_unaligned(pX + i)).store_unaligned(pY + i);
+        if (i < Size)
+            (alpha * packet::load_partial(pX + i, Size - i))
+                .store_partial(pY + i, Size - i);
+    }
+
+    /// Dot product with four packets of accumulators
+    template <typename TDataType>
+    AMATRIX_KERNEL_TARGET static TDataType dot(
+        std::size_t Size, TDataType const* pX, TDataType const* pY) {
+        using packet = packet_type<TDataType>;
+        constexpr std::size_t width = packet::width;
+        packet sum[4] = {packet::zero(), packet::zero(), packet::zero(),
+            packet::zero()};
+        std::size_t i = 0;
+        for (; i + 4 * width <= Size; i += 4 * width)
+            for (std::size_t k = 0; k < 4; k++)
+                sum[k] = MultiplyAdd(packet::load_unaligned(pX + i + k * width),
+                    packet::load_unaligned(pY + i + k * width), sum[k]);
+        for (; i + width <= Size; i += width)
+            sum[0] = MultiplyAdd(packet::load_unaligned(pX + i),
+                packet::load_unaligned(pY + i), sum[0]);
+        if (i < Size)
+            sum[0] = MultiplyAdd(packet::load_partial(pX + i, Size - i),
+                packet::load_partial(pY + i, Size - i), sum[0]);
+        return ReduceSum((sum[0] + sum[1]) + (sum[2] + sum[3]));
+    }
+
+    /// y = x for x with elements Stride apart, through gathers
+    template <typename TDataType>
+    AMATRIX_KERNEL_TARGET static void gather(std::size_t Size,
+        TDataType const* pX, std::size_t Stride, TDataType* pY) {
+        using packet = packet_type<TDataType>;
+        std::size_t i = 0;
+        for (; i + packet::width <= Size; i += packet::width)
+            packet::load_strided(pX + i * Stride, Stride)
+                .store_unaligned(pY + i);
+        for (; i < Size; i++)
+            pY[i] = pX[i * Stride];
+    }
+
+    /// y = x for y with elements Stride apart, through scatters
+    template <typename TDataType>
+    AMATRIX_KERNEL_TARGET static void scatter(std::size_t Size,
+        TDataType const* pX, TDataType* pY, std::size_t Stride) {
+        using packet = packet_type<TDataType>;
+        std::size_t i = 0;
+        for (; i + packet::width <= Size; i += packet::width)
+            packet::load_unaligned(pX + i)
+                .store_strided(pY + i * Stride, Stride);
+        for (; i < Size; i++)
+            pY[i * Stride] = pX[i];
+    }
+
+    /// y += Alpha * x for y with elements Stride apart
+    template <typename TDataType>
+    AMATRIX_KERNEL_TARGET static void strided_axpy(std::size_t Size,
+        TDataType Alpha, TDataType const* pX, TDataType* pY,
+        std::size_t Stride) {
+        using packet = packet_type<TDataType>;
+        const packet alpha = packet::broadcast(Alpha);
+        std::size_t i = 0;
+        for (; i + packet::width <= Size; i += packet::width)
+            MultiplyAdd(alpha, packet::load_unaligned(pX + i),
+                packet::load_strided(pY + i * Stride, Stride))
+                .store_strided(pY + i * Stride, Stride);
+        for (; i < Size; i++)
+            pY[i * Stride] += Alpha * pX[i];
+    }
+
+    /// y = x[Indices], through gathers
+    template <typename TDataType>
+    AMATRIX_KERNEL_TARGET static void indexed_gather(std::size_t Size,
+        TDataType const* pX, std::size_t const* pIndices, TDataType* pY) {
+        using packet = packet_type<TDataType>;
+        std::size_t i = 0;
+        for (; i + packet::width <= Size; i += packet::width)
+            packet::gather(pX, pIndices + i).store_unaligned(pY + i);
+        for (; i < Size; i++)
+            pY[i] = pX[pIndices[i]];
+    }
+
+    /// y[Indices] = x, through scatters. The indices must differ
+    template <typename TDataType>
+    AMATRIX_KERNEL_TARGET static void indexed_scatter(std::size_t Size,
+        TDataType const* pX, TDataType* pY, std::size_t const* pIndices) {
+        using packet = packet_type<TDataType>;
+        std::size_t i = 0;
+        for (; i + packet::width <= Size; i += packet::width)
+            packet::load_unaligned(pX + i).scatter(pY, pIndices + i);
+        for (; i < Size; i++)
+            pY[pIndices[i]] = pX[i];
+    }
+
+    /// y[Indices] += Alpha * x, the scatter add of an assembly. The indices
+    /// must differ
+    template <typename TDataType>
+    AMATRIX_KERNEL_TARGET static void indexed_axpy(std::size_t Size,
+        TDataType Alpha, TDataType const* pX, TDataType* pY,
+        std::size_t const* pIndices) {
+        using packet = packet_type<TDataType>;
+        const packet alpha = packet::broadcast(Alpha);
+        std::size_t i = 0;
+        for (; i + packet::width <= Size; i += packet::width)
+            MultiplyAdd(alpha, packet::load_unaligned(pX + i),
+                packet::gather(pY, pIndices + i))
+                .scatter(pY, pIndices + i);
+        for (; i < Size; i++)
+            pY[pIndices[i]] += Alpha * pX[i];
+    }
+
+    /// Dot product of x and y with elements StrideX and StrideY apart. An
+    /// operand with a stride of one is loaded directly
+    template <typename TDataType>
+    AMATRIX_KERNEL_TARGET static TDataType strided_dot(std::size_t Size,
+        TDataType const* pX, std::size_t StrideX, TDataType const* pY,
+        std::size_t StrideY) {
+        using packet = packet_type<TDataType>;
+        constexpr std::size_t width = packet::width;
+        packet sum[2] = {packet::zero(), packet::zero()};
+        std::size_t i = 0;
+        for (; i + 2 * width <= Size; i += 2 * width)
+            for (std::size_t k = 0; k < 2; k++)
+                sum[k] = MultiplyAdd(
+                    load_strided(pX + (i + k * width) * StrideX, StrideX),
+                    load_strided(pY + (i + k * width) * StrideY, StrideY),
+                    sum[k]);
+        TDataType result = ReduceSum(sum[0] + sum[1]);
+        for (; i < Size; i++)
+            result += pX[i * StrideX] * pY[i * StrideY];
+        return result;
+    }
+
+    /// Dot product accumulated in the wider TAccumulatorType, e.g. of float
+    /// arrays in double. Blocks of the elements are converted into buffers,
+    /// which the compiler vectorizes, and accumulated in packets of the
+    /// wider type
+    template <typename TAccumulatorType, typename TDataType>
+    AMATRIX_KERNEL_TARGET static TAccumulatorType accumulated_dot(
+        std::size_t Size, TDataType const* pX, TDataType const* pY) {
+        using packet = packet_type<TAccumulatorType>;
+        constexpr std::size_t width = packet::width;
+        constexpr std::size_t block_size = 4 * width;
+        TAccumulatorType x[block_size];
+        TAccumulatorType y[block_size];
+        packet sum[4] = {packet::zero(), packet::zero(), packet::zero(),
+            packet::zero()};
+        for (std::size_t i = 0; i < Size; i += block_size) {
+            if (i + block_size <= Size) {
+                for (std::size_t k = 0; k < block_size; k++) {
+                    x[k] = static_cast<TAccumulatorType>(pX[i + k]);
+                    y[k] = static_cast<TAccumulatorType>(pY[i + k]);
+                }
+            } else {
+                for (std::size_t k = 0; k < block_size; k++) {
+                    const bool is_inside = (i + k < Size);
+                    x[k] = is_inside ? static_cast<TAccumulatorType>(pX[i + k])
+                                     : TAccumulatorType();
+                    y[k] = is_inside ? static_cast<TAccumulatorType>(pY[i + k])
+                                     : TAccumulatorType();
+                }
+            }
+            for (std::size_t k = 0; k < 4; k++)
+                sum[k] = MultiplyAdd(packet::load_unaligned(x + k * width),
+                    packet::load_unaligned(y + k * width), sum[k]);
+        }
+        return ReduceSum((sum[0] + sum[1]) + (sum[2] + sum[3]));
+    }
+
+    /// C = A * B for row major A (Size1 x InnerSize), B (InnerSize x Size2)
+    /// and C (Size1 x Size2)
+    template <typename TDataType>
+    AMATRIX_KERNEL_TARGET static void product(std::size_t Size1,
+        std::size_t InnerSize, std::size_t Size2, TDataType const* pA,
+        TDataType const* pB, TDataType* pC) {
+        block_product(
+            Size1, InnerSize, Size2, pA, InnerSize, pB, Size2, pC, Size2);
+    }
+
+    /// C = A * B for row major blocks A (Size1 x InnerSize), B (InnerSize x
+    /// Size2) and C (Size1 x Size2) with rows LeadingA, LeadingB and
+    /// LeadingC apart. A row of C is accumulated in registers, four packets
+    /// at a time, from the rows of B
+    template <typename TDataType>
+    AMATRIX_KERNEL_TARGET static void block_product(std::size_t Size1,
+        std::size_t InnerSize, std::size_t Size2, TDataType const* pA,
+        std::size_t LeadingA, TDataType const* pB, std::size_t LeadingB,
+        TDataType* pC, std::size_t LeadingC) {
+        using packet = packet_type<TDataType>;
+        constexpr std::size_t width = packet::width;
+        for (std::size_t i = 0; i < Size1; i++) {
+            TDataType const* a_row = pA + i * LeadingA;
+            TDataType* c_row = pC + i * LeadingC;
+            std::size_t j = 0;
+            for (; j + 4 * width <= Size2; j += 4 * width) {
+                packet c[4] = {packet::zero(), packet::zero(), packet::zero(),
+                    packet::zero()};
+                for (std::size_t k = 0; k < InnerSize; k++) {
+                    const packet a_ik = packet::broadcast(a_row[k]);
+                    TDataType const* b_row = pB + k * LeadingB + j;
+                    for (std::size_t m = 0; m < 4; m++)
+                        c[m] = MultiplyAdd(
+                            a_ik, packet::load_unaligned(b_row + m * width), c[m]);
+                }
+                for (std::size_t m = 0; m < 4; m++)
+                    c[m].store_unaligned(c_row + j + m * width);
+            }
+            for (; j + width <= Size2; j += width) {
+                packet c = packet::zero();
+                for (std::size_t k = 0; k < InnerSize; k++)
+                    c = MultiplyAdd(packet::broadcast(a_row[k]),
+                        packet::load_unaligned(pB + k * LeadingB + j), c);
+                c.store_unaligned(c_row + j);
+            }
+            if (j < Size2) {
+                const std::size_t rest = Size2 - j;
+                packet c = packet::zero();
+                for (std::size_t k = 0; k < InnerSize; k++)
+                    c = MultiplyAdd(packet::broadcast(a_row[k]),
+                        packet::load_partial(pB + k * LeadingB + j, rest), c);
+                c.store_partial(c_row + j, rest);
+            }
+        }
+    }
+
+    /// y = A * x for row major A (Size1 x Size2), the dot product form.
+    /// Four rows are reduced at a time against the same packets of x
+    template <typename TDataType>
+    AMATRIX_KERNEL_TARGET static void matrix_vector_product(std::size_t Size1,
+        std::size_t Size2, TDataType const* pA, TDataType const* pX,
+        TDataType* pY) {
+        using packet = packet_type<TDataType>;
+        constexpr std::size_t width = packet::width;
+        std::size_t i = 0;
+        for (; i + 4 <= Size1; i += 4) {
+            TDataType const* a_rows = pA + i * Size2;
+            packet sum[4] = {packet::zero(), packet::zero(), packet::zero(),
+                packet::zero()};
+            std::size_t j = 0;
+            for (; j + width <= Size2; j += width) {
+                const packet x_j = packet::load_unaligned(pX + j);
+                for (std::size_t m = 0; m < 4; m++)
+                    sum[m] = MultiplyAdd(
+                        packet::load_unaligned(a_rows + m * Size2 + j), x_j,
+                        sum[m]);
+            }
+            if (j < Size2) {
+                const std::size_t rest = Size2 - j;
+                const packet x_j = packet::load_partial(pX + j, rest);
+                for (std::size_t m = 0; m < 4; m++)
+                    sum[m] = MultiplyAdd(
+                        packet::load_partial(a_rows + m * Size2 + j, rest), x_j,
+                        sum[m]);
+            }
+            for (std::size_t m = 0; m < 4; m++)
+                pY[i + m] = ReduceSum(sum[m]);
+        }
+        for (; i < Size1; i++)
+            pY[i] = dot(Size2, pA + i * Size2, pX);
+    }
+
+    /// y = A^T * x for row major A (Size1 x Size2) with rows LeadingSize
+    /// apart, the axpy form. Four rows scaled by their elements of x are
+    /// added to y at a time, so A is read once along its rows
+    template <typename TDataType>
+    AMATRIX_KERNEL_TARGET static void transpose_matrix_vector_product(
+        std::size_t Size1, std::size_t Size2, std::size_t LeadingSize,
+        TDataType const* pA, TDataType const* pX, TDataType* pY) {
+        using packet = packet_type<TDataType>;
+        constexpr std::size_t width = packet::width;
+        for (std::size_t j = 0; j < Size2; j++)
+            pY[j] = TDataType();
+        std::size_t i = 0;
+        for (; i + 4 <= Size1; i += 4) {
+            TDataType const* a_rows = pA + i * LeadingSize;
+            packet x_i[4];
+            for (std::size_t m = 0; m < 4; m++)
+                x_i[m] = packet::broadcast(pX[i + m]);
+            std::size_t j = 0;
+            for (; j + width <= Size2; j += width) {
+                packet y_j = packet::load_unaligned(pY + j);
+                for (std::size_t m = 0; m < 4; m++)
+                    y_j = MultiplyAdd(x_i[m],
+                        packet::load_unaligned(a_rows + m * LeadingSize + j),
+                        y_j);
+                y_j.store_unaligned(pY + j);
+            }
+            if (j < Size2) {
+                const std::size_t rest = Size2 - j;
+                packet y_j = packet::load_partial(pY + j, rest);
+                for (std::size_t m = 0; m < 4; m++)
+                    y_j = MultiplyAdd(x_i[m],
+                        packet::load_partial(
+                            a_rows + m * LeadingSize + j, rest),
+                        y_j);
+                y_j.store_partial(pY + j, rest);
+            }
+        }
+        for (; i < Size1; i++)
+            axpy(Size2, pX[i], pA + i * LeadingSize, pY);
+    }
+
+    /// Packet of the elements Stride apart
+    template <typename TDataType>
+    AMATRIX_KERNEL_TARGET static packet_type<TDataType> load_strided(
+        TDataType const* pData, std::size_t Stride) {
+        using packet = packet_type<TDataType>;
+        return (Stride == 1) ? packet::load_unaligned(pData)
+                             : packet::load_strided(pData, Stride);
+    }
+
+    /// y += Alpha * x for complex arrays. Alpha * x is ar * x plus the
+    /// swapped pairs of x times (-ai, ai)
+    template <typename TDataType>
+    AMATRIX_KERNEL_TARGET static void complex_axpy(std::size_t Size,
+        std::complex<TDataType> Alpha, std::complex<TDataType> const* pX,
+        std::complex<TDataType>* pY) {
+        using packet = pair_packet_type<TDataType>;
+        constexpr std::size_t width = packet::width;
+        TDataType const* x = reinterpret_cast<TDataType const*>(pX);
+        TDataType* y = reinterpret_cast<TDataType*>(pY);
+        const std::size_t size = 2 * Size;
+        TDataType imaginary[width];
+        for (std::size_t k = 0; k < width; k++)
+            imaginary[k] = (k % 2 == 0) ? -Alpha.imag() : Alpha.imag();
+        const packet alpha_real = packet::broadcast(Alpha.real());
+        const packet alpha_imaginary = packet::load_unaligned(imaginary);
+        for (std::size_t i = 0; i < size; i += width) {
+            const std::size_t rest = std::min(width, size - i);
+            const packet x_i = packet::load_partial(x + i, rest);
+            MultiplyAdd(alpha_imaginary, SwapPairs(x_i),
+                MultiplyAdd(alpha_real, x_i, packet::load_partial(y + i, rest)))
+                .store_partial(y + i, rest);
+        }
+    }
+
+    /// y = Alpha * x for complex arrays
+    template <typename TDataType>
+    AMATRIX_KERNEL_TARGET static void complex_scale(std::size_t Size,
+        std::complex<TDataType> Alpha, std::complex<TDataType> const* pX,
+        std::complex<TDataType>* pY) {
+        using packet = pair_packet_type<TDataType>;
+        constexpr std::size_t width = packet::width;
+        TDataType const* x = reinterpret_cast<TDataType const*>(pX);
+        TDataType* y = reinterpret_cast<TDataType*>(pY);
+        const std::size_t size = 2 * Size;
+        TDataType imaginary[width];
+        for (std::size_t k = 0; k < width; k++)
+            imaginary[k] = (k % 2 == 0) ? -Alpha.imag() : Alpha.imag();
+        const packet alpha_real = packet::broadcast(Alpha.real());
+        const packet alpha_imaginary = packet::load_unaligned(imaginary);
+        for (std::size_t i = 0; i < size; i += width) {
+            const std::size_t rest = std::min(width, size - i);
+            const packet x_i = packet::load_partial(x + i, rest);
+            MultiplyAdd(alpha_imaginary, SwapPairs(x_i), alpha_real * x_i)
+                .store_partial(y + i, rest);
+        }
+    }
+
+    /// Sum of x_i * y_i, or of conj(x_i) * y_i with Conjugate, for complex
+    /// arrays. The products of the same parts (xr * yr, xi * yi) and of the
+    /// swapped parts (xr * yi, xi * yr) are accumulated separately and
+    /// combined once at the end
+    template <typename TDataType>
+    AMATRIX_KERNEL_TARGET static std::complex<TDataType> complex_dot(
+        std::size_t Size, std::complex<TDataType> const* pX,
+        std::complex<TDataType> const* pY, bool Conjugate) {
+        using packet = pair_packet_type<TDataType>;
+        constexpr std::size_t width = packet::width;
+        TDataType const* x = reinterpret_cast<TDataType const*>(pX);
+        TDataType const* y = reinterpret_cast<TDataType const*>(pY);
+        const std::size_t size = 2 * Size;
+        packet same[2] = {packet::zero(), packet::zero()};
+        packet swapped[2] = {packet::zero(), packet::zero()};
+        std::size_t i = 0;
+        for (; i + 2 * width <= size; i += 2 * width)
+            for (std::size_t m = 0; m < 2; m++) {
+                const packet x_i = packet::load_unaligned(x + i + m * width);
+                const packet y_i = packet::load_unaligned(y + i + m * width);
+                same[m] = MultiplyAdd(x_i, y_i, same[m]);
+                swapped[m] = MultiplyAdd(x_i, SwapPairs(y_i), swapped[m]);
+            }
+        for (; i < size; i += width) {
+            const std::size_t rest = std::min(width, size - i);
+            const packet x_i = packet::load_partial(x + i, rest);
+            const packet y_i = packet::load_partial(y + i, rest);
+            same[0] = MultiplyAdd(x_i, y_i, same[0]);
+            swapped[0] = MultiplyAdd(x_i, SwapPairs(y_i), swapped[0]);
+        }
+
+        TDataType same_parts[width];
+        TDataType swapped_parts[width];
+        (same[0] + same[1]).store_unaligned(same_parts);
+        (swapped[0] + swapped[1]).store_unaligned(swapped_parts);
+        TDataType sums[4] = {
+            TDataType(), TDataType(), TDataType(), TDataType()};
+        for (std::size_t k = 0; k < width; k += 2) {
+            sums[0] += same_parts[k];         // xr * yr
+            sums[1] += same_parts[k + 1];     // xi * yi
+            sums[2] += swapped_parts[k];      // xr * yi
+            sums[3] += swapped_parts[k + 1];  // xi * yr
+        }
+        if (Conjugate)
+            return std::complex<TDataType>(
+                sums[0] + sums[1], sums[2] - sums[3]);
+        return std::complex<TDataType>(
+            sums[0] - sums[1], sums[2] + sums[3]);
+    }
+
+    /// C = A * B for complex row major matrices. A row of C is accumulated
+    /// as the sum of re(a_ik) * b_k and the sum of im(a_ik) * b_k over the
+    /// interleaved rows b_k of B, four packets at a time. The imaginary sums
+    /// are swapped and combined with the real ones once per block of C
+    template <typename TDataType>
+    AMATRIX_KERNEL_TARGET static void complex_product(std::size_t Size1,
+        std::size_t InnerSize, std::size_t Size2,
+        std::complex<TDataType> const* pA, std::complex<TDataType> const* pB,
+        std::complex<TDataType>* pC) {
+        using packet = pair_packet_type<TDataType>;
+        constexpr std::size_t width = packet::width;
+        TDataType const* a = reinterpret_cast<TDataType const*>(pA);
+        TDataType const* b = reinterpret_cast<TDataType const*>(pB);
+        TDataType* c = reinterpret_cast<TDataType*>(pC);
+        const std::size_t row_size = 2 * Size2;
+        TDataType signs[width];
+        for (std::size_t k = 0; k < width; k++)
+            signs[k] = (k % 2 == 0) ? TDataType(-1) : TDataType(1);
+        const packet sign = packet::load_unaligned(signs);
+
+        for (std::size_t i = 0; i < Size1; i++) {
+            TDataType const* a_row = a + 2 * i * InnerSize;
+            TDataType* c_row = c + i * row_size;
+            std::size_t j = 0;
+            for (; j + 4 * width <= row_size; j += 4 * width) {
+                packet real[4] = {packet::zero(), packet::zero(),
+                    packet::zero(), packet::zero()};
+                packet imaginary[4] = {packet::zero(), packet::zero(),
+                    packet::zero(), packet::zero()};
+                for (std::size_t k = 0; k < InnerSize; k++) {
+                    const packet a_real = packet::broadcast(a_row[2 * k]);
+                    const packet a_imaginary =
+                        packet::broadcast(a_row[2 * k + 1]);
+                    TDataType const* b_row = b + k * row_size + j;
+                    for (std::size_t m = 0; m < 4; m++) {
+                        const packet b_km =
+                            packet::load_unaligned(b_row + m * width);
+                        real[m] = MultiplyAdd(a_real, b_km, real[m]);
+                        imaginary[m] =
+                            MultiplyAdd(a_imaginary, b_km, imaginary[m]);
+                    }
+                }
+                for (std::size_t m = 0; m < 4; m++)
+                    MultiplyAdd(SwapPairs(imaginary[m]), sign, real[m])
+                        .store_unaligned(c_row + j + m * width);
+            }
+            for (; j < row_size; j += width) {
+                const std::size_t rest = std::min(width, row_size - j);
+                packet real = packet::zero();
+                packet imaginary = packet::zero();
+                for (std::size_t k = 0; k < InnerSize; k++) {
+                    const packet b_k =
+                        packet::load_partial(b + k * row_size + j, rest);
+                    real = MultiplyAdd(
+                        packet::broadcast(a_row[2 * k]), b_k, real);
+                    imaginary = MultiplyAdd(
+                        packet::broadcast(a_row[2 * k + 1]), b_k, imaginary);
+                }
+                MultiplyAdd(SwapPairs(imaginary), sign, real)
+                    .store_partial(c_row + j, rest);
+            }
+        }
+    }
+};
@@ -0,0 +1,270 @@
+#pragma once
+
+#include <algorithm>
+#include <complex>
+
+#include "cpu_features.h"
+#include "packet.h"
+
+namespace AMatrix {
+
+/// Loops shorter than this are not dispatched, the indirection would cost
+/// more than the wider instructions gain
+constexpr std::size_t dispatch_minimum_size = 32;
+
+/// Products with fewer multiplications are evaluated inline
+constexpr std::size_t dispatch_minimum_product_size = 512;
+
+// Kernels on contiguous data, one set per instruction set. The sets are
+// written once in kernel_set.h on top of Packet
+
+#define AMATRIX_KERNEL_SET GenericKernels
+#define AMATRIX_KERNEL_TARGET
+#define AMATRIX_KERNEL_REGISTER_BYTES native_register_bytes
+#include "kernel_set.h"
+#undef AMATRIX_KERNEL_SET
+#undef AMATRIX_KERNEL_TARGET
+#undef AMATRIX_KERNEL_REGISTER_BYTES
+
+#if AMATRIX_DISPATCH
+#define AMATRIX_KERNEL_SET Avx2Kernels
+#define AMATRIX_KERNEL_TARGET AMATRIX_TARGET_AVX2
+#define AMATRIX_KERNEL_REGISTER_BYTES 32
+#include "kernel_set.h"
+#undef AMATRIX_KERNEL_SET
+#undef AMATRIX_KERNEL_TARGET
+#undef AMATRIX_KERNEL_REGISTER_BYTES
+
+#define AMATRIX_KERNEL_SET Avx512Kernels
+#define AMATRIX_KERNEL_TARGET AMATRIX_TARGET_AVX512
+#define AMATRIX_KERNEL_REGISTER_BYTES 64
+#include "kernel_set.h"
+#undef AMATRIX_KERNEL_SET
+#undef AMATRIX_KERNEL_TARGET
+#undef AMATRIX_KERNEL_REGISTER_BYTES
+
+#define AMATRIX_DISPATCH_KERNEL(TheKernel, ...)                 \
+    switch (GetInstructionSet()) {                              \
+        case InstructionSet::avx512_instructions:               \
+            return Avx512Kernels::TheKernel(__VA_ARGS__);       \
+        case InstructionSet::avx2_instructions:                 \
+            return Avx2Kernels::TheKernel(__VA_ARGS__);         \
+        default:                                                \
+            return GenericKernels::TheKernel(__VA_ARGS__);      \
+    }
+#else
+#define AMATRIX_DISPATCH_KERNEL(TheKernel, ...) \
+    return GenericKernels::TheKernel(__VA_ARGS__);
+#endif
+
+// The dispatched kernels. The operands must not overlap, except that the
+// input and the output of the elementwise kernels may be the same array
+
+template <typename TDataType>
+inline void DispatchedAxpy(
+    std::size_t Size, TDataType Alpha, TDataType const* pX, TDataType* pY) {
+    AMATRIX_DISPATCH_KERNEL(axpy, Size, Alpha, pX, pY)
+}
+
+template <typename TDataType>
+inline void DispatchedAdd(std::size_t Size, TDataType const* pX,
+    TDataType const* pY, TDataType* pZ) {
+    AMATRIX_DISPATCH_KERNEL(add, Size, pX, pY, pZ)
+}
+
+template <typename TDataType>
+inline void DispatchedSubtract(std::size_t Size, TDataType const* pX,
+    TDataType const* pY, TDataType* pZ) {
+    AMATRIX_DISPATCH_KERNEL(subtract, Size, pX, pY, pZ)
+}
+
+template <typename TDataType>
+inline void DispatchedScale(
+    std::size_t Size, TDataType Alpha, TDataType const* pX, TDataType* pY) {
+    AMATRIX_DISPATCH_KERNEL(scale, Size, Alpha, pX, pY)
+}
+
+template <typename TDataType>
+inline TDataType DispatchedDot(
+    std::size_t Size, TDataType const* pX, TDataType const* pY) {
+    AMATRIX_DISPATCH_KERNEL(dot, Size, pX, pY)
+}
+
+template <typename TDataType>
+inline void DispatchedGather(std::size_t Size, TDataType const* pX,
+    std::size_t Stride, TDataType* pY) {
+    AMATRIX_DISPATCH_KERNEL(gather, Size, pX, Stride, pY)
+}
+
+template <typename TDataType>
+inline void DispatchedScatter(std::size_t Size, TDataType const* pX,
+    TDataType* pY, std::size_t Stride) {
+    AMATRIX_DISPATCH_KERNEL(scatter, Size, pX, pY, Stride)
+}
+
+template <typename TDataType>
+inline void DispatchedStridedAxpy(std::size_t Size, TDataType Alpha,
+    TDataType const* pX, TDataType* pY, std::size_t Stride) {
+    AMATRIX_DISPATCH_KERNEL(strided_axpy, Size, Alpha, pX, pY, Stride)
+}
+
+template <typename TDataType>
+inline void DispatchedIndexedGather(std::size_t Size, TDataType const* pX,
+    std::size_t const* pIndices, TDataType* pY) {
+    AMATRIX_DISPATCH_KERNEL(indexed_gather, Size, pX, pIndices, pY)
+}
+
+template <typename TDataType>
+inline void DispatchedIndexedScatter(std::size_t Size, TDataType const* pX,
+    TDataType* pY, std::size_t const* pIndices) {
+    AMATRIX_DISPATCH_KERNEL(indexed_scatter, Size, pX, pY, pIndices)
+}
+
+template <typename TDataType>
+inline void DispatchedIndexedAxpy(std::size_t Size, TDataType Alpha,
+    TDataType const* pX, TDataType* pY, std::size_t const* pIndices) {
+    AMATRIX_DISPATCH_KERNEL(indexed_axpy, Size, Alpha, pX, pY, pIndices)
+}
+
+template <typename TDataType>
+inline TDataType DispatchedStridedDot(std::size_t Size, TDataType const* pX,
+    std::size_t StrideX, TDataType const* pY, std::size_t StrideY) {
+    AMATRIX_DISPATCH_KERNEL(strided_dot, Size, pX, StrideX, pY, StrideY)
+}
+
+template <typename TAccumulatorType, typename TDataType>
+inline TAccumulatorType DispatchedAccumulatedDot(
+    std::size_t Size, TDataType const* pX, TDataType const* pY) {
+    AMATRIX_DISPATCH_KERNEL(accumulated_dot<TAccumulatorType>, Size, pX, pY)
+}
+
+template <typename TDataType>
+inline void DispatchedProduct(std::size_t Size1, std::size_t InnerSize,
+    std::size_t Size2, TDataType const* pA, TDataType const* pB,
+    TDataType* pC) {
+    AMATRIX_DISPATCH_KERNEL(product, Size1, InnerSize, Size2, pA, pB, pC)
+}
+
+/// C = A * B for row major blocks with rows LeadingA, LeadingB and LeadingC
+/// apart
+template <typename TDataType>
+inline void DispatchedBlockProduct(std::size_t Size1, std::size_t InnerSize,
+    std::size_t Size2, TDataType const* pA, std::size_t LeadingA,
+    TDataType const* pB, std::size_t LeadingB, TDataType* pC,
+    std::size_t LeadingC) {
+    AMATRIX_DISPATCH_KERNEL(block_product, Size1, InnerSize, Size2, pA,
+        LeadingA, pB, LeadingB, pC, LeadingC)
+}
+
+/// y = A * x for row major A (Size1 x Size2)
+template <typename TDataType>
+inline void DispatchedMatrixVectorProduct(std::size_t Size1,
+    std::size_t Size2, TDataType const* pA, TDataType const* pX,
+    TDataType* pY) {
+    AMATRIX_DISPATCH_KERNEL(matrix_vector_product, Size1, Size2, pA, pX, pY)
+}
+
+/// y = A^T * x for row major A (Size1 x Size2) with rows LeadingSize apart
+template <typename TDataType>
+inline void DispatchedTransposeMatrixVectorProduct(std::size_t Size1,
+    std::size_t Size2, std::size_t LeadingSize, TDataType const* pA,
+    TDataType const* pX, TDataType* pY) {
+    AMATRIX_DISPATCH_KERNEL(
+        transpose_matrix_vector_product, Size1, Size2, LeadingSize, pA, pX, pY)
+}
+
+// The complex overloads work on the interleaved parts with the complex
+// kernels. Sums and differences are taken elementwise on the parts
+
+template <typename TDataType>
+inline void DispatchedAxpy(std::size_t Size, std::complex<TDataType> Alpha,
+    std::complex<TDataType> const* pX, std::complex<TDataType>* pY) {
+    AMATRIX_DISPATCH_KERNEL(complex_axpy, Size, Alpha, pX, pY)
+}
+
+template <typename TDataType>
+inline void DispatchedAdd(std::size_t Size, std::complex<TDataType> const* pX,
+    std::complex<TDataType> const* pY, std::complex<TDataType>* pZ) {
+    DispatchedAdd(2 * Size, reinterpret_cast<TDataType const*>(pX),
+        reinterpret_cast<TDataType const*>(pY),
+        reinterpret_cast<TDataType*>(pZ));
+}
+
+template <typename TDataType>
+inline void DispatchedSubtract(std::size_t Size,
+    std::complex<TDataType> const* pX, std::complex<TDataType> const* pY,
+    std::complex<TDataType>* pZ) {
+    DispatchedSubtract(2 * Size, reinterpret_cast<TDataType const*>(pX),
+        reinterpret_cast<TDataType const*>(pY),
+        reinterpret_cast<TDataType*>(pZ));
+}
+
+template <typename TDataType>
+inline void DispatchedScale(std::size_t Size, std::complex<TDataType> Alpha,
+    std::complex<TDataType> const* pX, std::complex<TDataType>* pY) {
+    AMATRIX_DISPATCH_KERNEL(complex_scale, Size, Alpha, pX, pY)
+}
+
+template <typename TDataType>
+inline std::complex<TDataType> DispatchedDot(std::size_t Size,
+    std::complex<TDataType> const* pX, std::complex<TDataType> const* pY) {
+    AMATRIX_DISPATCH_KERNEL(complex_dot, Size, pX, pY, false)
+}
+
+/// Sum of conj(x_i) * y_i
+template <typename TDataType>
+inline std::complex<TDataType> DispatchedConjugateDot(std::size_t Size,
+    std::complex<TDataType> const* pX, std::complex<TDataType> const* pY) {
+    AMATRIX_DISPATCH_KERNEL(complex_dot, Size, pX, pY, true)
+}
+
+template <typename TDataType>
+inline void DispatchedProduct(std::size_t Size1, std::size_t InnerSize,
+    std::size_t Size2, std::complex<TDataType> const* pA,
+    std::complex<TDataType> const* pB, std::complex<TDataType>* pC) {
+    AMATRIX_DISPATCH_KERNEL(
+        complex_product, Size1, InnerSize, Size2, pA, pB, pC)
+}
+
+/// A complex A * x is the product with a single column
+template <typename TDataType>
+inline void DispatchedMatrixVectorProduct(std::size_t Size1,
+    std::size_t Size2, std::complex<TDataType> const* pA,
+    std::complex<TDataType> const* pX, std::complex<TDataType>* pY) {
+    DispatchedProduct(Size1, Size2, std::size_t(1), pA, pX, pY);
+}
+
+/// A complex A^T * x is a sum of the rows of A scaled by the elements of x
+template <typename TDataType>
+inline void DispatchedTransposeMatrixVectorProduct(std::size_t Size1,
+    std::size_t Size2, std::size_t LeadingSize,
+    std::complex<TDataType> const* pA, std::complex<TDataType> const* pX,
+    std::complex<TDataType>* pY) {
+    for (std::size_t j = 0; j < Size2; j++)
+        pY[j] = std::complex<TDataType>();
+    for (std::size_t i = 0; i < Size1; i++)
+        DispatchedAxpy(Size2, pX[i], pA + i * LeadingSize, pY);
+}
+
+/// True for the types which store their elements contiguously in row major
+/// order and give them through data()
+template <typename TType>
+struct IsContiguous {
+    static constexpr bool value = false;
+};
+
+/// True for the vector views which store their elements stride() apart,
+/// starting at data(), like the columns of a dense matrix
+template <typename TType>
+struct IsStrided {
+    static constexpr bool value = false;
+};
+
+/// True for the blocks of dense matrices, which store their rows
+/// contiguously and leading_size() apart, starting at data()
+template <typename TType>
+struct IsBlock {
+    static constexpr bool value = false;
+};
+
+}  // namespace AMatrix
@@ -3,11 +3,43 @@
 // A matrix Library to be simple and fast
 #include <cmath>
 #include <limits>
+#include <type_traits>
+#include "bounded_matrix.h"
 #include "matrix_storage.h"
+#include "matrix_reductions.h"
 #include "matrix_iterator.h"
+#include "matrix_vector_product.h"
+#include "product_chain.h"
+#include "sub_matrix.h"
+#include "temporary_pool.h"
 
 namespace AMatrix {
 
+/// Assigns to a matrix without checking if the expression reads the
+/// matrix. Returned by Matrix::noalias()
+template <typename TMatrixType>
+class NoAliasAssignment {
+    TMatrixType& _matrix;
+
+   public:
+    explicit NoAliasAssignment(TMatrixType& rMatrix) : _matrix(rMatrix) {}
+
+    template <typename TOtherMatrixType>
+    TMatrixType& operator=(TOtherMatrixType const& Other) {
+        return _matrix.assign_noalias(Other);
+    }
+
+    template <typename TOtherMatrixType>
+    TMatrixType& operator+=(TOtherMatrixType const& Other) {
+        return _matrix.add_noalias(Other);
+    }
+
+    template <typename TOtherMatrixType>
+    TMatrixType& operator-=(TOtherMatrixType const& Other) {
+        return _matrix.subtract_noalias(Other);
+    }
+};
+
 template <typename TDataType, std::size_t TSize1, std::size_t TSize2>
 class Matrix : public MatrixExpression<Matrix<TDataType, TSize1, TSize2>,
                    row_major_access>,
@@ -15,6 +47,10 @@ class Matrix : public MatrixExpression<Matrix<TDataType, TSize1, TSize2>,
    public:
     using data_type = TDataType;
     using base_type = MatrixStorage<TDataType, TSize1, TSize2>;
+    static constexpr std::size_t static_size1 = TSize1;
+    static constexpr std::size_t static_size2 = TSize2;
+    static constexpr std::size_t static_max_size1 = TSize1;
+    static constexpr std::size_t static_max_size2 = TSize2;
     using base_type::at;
     using base_type::data;
     using base_type::size;
@@ -36,10 +72,28 @@ class Matrix : public MatrixExpression<Matrix<TDataType, TSize1, TSize2>,
 
     template <typename TExpressionType, std::size_t TCategory>
     explicit Matrix(MatrixExpression<TExpressionType, TCategory> const& Other)
-        : base_type(Other) {}
+        : base_type(Other) {
+        static_assert(HaveCompatibleStaticSizes<Matrix, TExpressionType>(),
+            "The fixed sizes do not match the matrix");
+    }
 
     template <typename TOtherMatrixType>
-    explicit Matrix(TOtherMatrixType const& Other) : base_type(Other) {}
+    explicit Matrix(TOtherMatrixType const& Other) : base_type(Other) {
+        static_assert(HaveCompatibleStaticSizes<Matrix, TOtherMatrixType>(),
+            "The fixed sizes do not match the matrix");
+    }
+
+    template <typename TFirstType, typename TSecondType>
+    explicit Matrix(
+        MatrixProductExpression<TFirstType, TSecondType> const& Other)
+        : base_type(Other.size1(), Other.size2()) {
+        static_assert(HaveCompatibleStaticSizes<Matrix,
+                          MatrixProductExpression<TFirstType, TSecondType>>(),
+            "The fixed sizes do not match the matrix");
+        using is_contiguous = is_contiguous_product<
+            MatrixProductExpression<TFirstType, TSecondType>>;
+        evaluate_product(Other, data(), is_contiguous());
+    }
 
     explicit Matrix(std::initializer_list<TDataType> InitialValues)
         : base_type(InitialValues) {}
@@ -47,16 +101,50 @@ class Matrix : public MatrixExpression<Matrix<TDataType, TSize1, TSize2>,
     template <typename TExpressionType, std::size_t TCategory>
     Matrix& operator=(
         MatrixExpression<TExpressionType, TCategory> const& Other) {
-        base_type::operator=(Other);
+        static_assert(HaveCompatibleStaticSizes<Matrix, TExpressionType>(),
+            "The fixed sizes do not match the matrix");
+        assign(Other.expression(), std::true_type());
         return *this;
     }
 
     template <typename TOtherMatrixType>
     Matrix& operator=(TOtherMatrixType const& Other) {
+        static_assert(HaveCompatibleStaticSizes<Matrix, TOtherMatrixType>(),
+            "The fixed sizes do not match the matrix");
+        assign(Other, IsMatrixExpression<TOtherMatrixType>());
+        return *this;
+    }
+
+    template <typename TFirstType, typename TSecondType>
+    Matrix& operator=(
+        MatrixProductExpression<TFirstType, TSecondType> const& Other) {
+        static_assert(HaveCompatibleStaticSizes<Matrix,
+                          MatrixProductExpression<TFirstType, TSecondType>>(),
+            "The fixed sizes do not match the matrix");
+        assign_product(Other, true);
+        return *this;
+    }
+
+    /// Assignment without the aliasing check, the expression must not read
+    /// this matrix
+    template <typename TOtherMatrixType>
+    Matrix& assign_noalias(TOtherMatrixType const& Other) {
+        static_assert(HaveCompatibleStaticSizes<Matrix, TOtherMatrixType>(),
+            "The fixed sizes do not match the matrix");
         base_type::operator=(Other);
         return *this;
     }
 
+    template <typename TFirstType, typename TSecondType>
+    Matrix& assign_noalias(
+        MatrixProductExpression<TFirstType, TSecondType> const& Other) {
+        static_assert(HaveCompatibleStaticSizes<Matrix,
+                          MatrixProductExpression<TFirstType, TSecondType>>(),
+            "The fixed sizes do not match the matrix");
+        assign_product(Other, false);
+        return *this;
+    }
+
     Matrix& operator=(Matrix const& Other) {
         base_type::operator=(Other);
         return *this;
@@ -74,8 +162,36 @@ class Matrix : public MatrixExpression<Matrix<TDataType, TSize1, TSize2>,
         return true;
     }
 
+    /// An expression which reads this matrix at other positions is
+    /// evaluated into a pooled temporary first
     template <typename TExpressionType, std::size_t TCategory>
     Matrix& operator+=(
+        MatrixExpression<TExpressionType, TCategory> const& Other) {
+        auto const& other_expression = Other.expression();
+        if (!other_expression.aliases(data(), data() + size()))
+            return add_noalias(other_expression);
+        TemporaryMatrix<TDataType> temporary(
+            other_expression.size1(), other_expression.size2());
+        evaluate_operand(other_expression, temporary.data());
+        return add_noalias(temporary);
+    }
+
+    template <typename TExpressionType, std::size_t TCategory>
+    Matrix& operator-=(
+        MatrixExpression<TExpressionType, TCategory> const& Other) {
+        auto const& other_expression = Other.expression();
+        if (!other_expression.aliases(data(), data() + size()))
+            return subtract_noalias(other_expression);
+        TemporaryMatrix<TDataType> temporary(
+            other_expression.size1(), other_expression.size2());
+        evaluate_operand(other_expression, temporary.data());
+        return subtract_noalias(temporary);
+    }
+
+    /// Compound assignments without the aliasing check, the expression must
+    /// not read this matrix at other positions
+    template <typename TExpressionType, std::size_t TCategory>
+    Matrix& add_noalias(
         MatrixExpression<TExpressionType, TCategory> const& Other) {
         for (std::size_t i = 0; i < size1(); i++)
             for (std::size_t j = 0; j < size2(); j++)
@@ -85,7 +201,7 @@ class Matrix : public MatrixExpression<Matrix<TDataType, TSize1, TSize2>,
     }
 
     template <typename TExpressionType>
-    Matrix& operator+=(
+    Matrix& add_noalias(
         MatrixExpression<TExpressionType, row_major_access> const& Other) {
         for (std::size_t i = 0; i < size(); i++)
             at(i) += Other.expression()[i];
@@ -93,8 +209,20 @@ class Matrix : public MatrixExpression<Matrix<TDataType, TSize1, TSize2>,
         return *this;
     }
 
+    template <std::size_t TOtherSize1, std::size_t TOtherSize2>
+    Matrix& add_noalias(
+        Matrix<TDataType, TOtherSize1, TOtherSize2> const& Other) {
+        if (size() >= dispatch_minimum_size)
+            DispatchedAdd(size(), data(), Other.data(), data());
+        else
+            for (std::size_t i = 0; i < size(); i++)
+                at(i) += Other[i];
+
+        return *this;
+    }
+
     template <typename TExpressionType, std::size_t TCategory>
-    Matrix& operator-=(
+    Matrix& subtract_noalias(
         MatrixExpression<TExpressionType, TCategory> const& Other) {
         for (std::size_t i = 0; i < size1(); i++)
             for (std::size_t j = 0; j < size2(); j++)
@@ -104,7 +232,7 @@ class Matrix : public MatrixExpression<Matrix<TDataType, TSize1, TSize2>,
     }
 
     template <typename TExpressionType>
-    Matrix& operator-=(
+    Matrix& subtract_noalias(
         MatrixExpression<TExpressionType, row_major_access> const& Other) {
         for (std::size_t i = 0; i < size(); i++)
             at(i) -= Other.expression()[i];
@@ -112,9 +240,24 @@ class Matrix : public MatrixExpression<Matrix<TDataType, TSize1, TSize2>,
         return *this;
     }
 
+    template <std::size_t TOtherSize1, std::size_t TOtherSize2>
+    Matrix& subtract_noalias(
+        Matrix<TDataType, TOtherSize1, TOtherSize2> const& Other) {
+        if (size() >= dispatch_minimum_size)
+            DispatchedSubtract(size(), data(), Other.data(), data());
+        else
+            for (std::size_t i = 0; i < size(); i++)
+                at(i) -= Other[i];
+
+        return *this;
+    }
+
     Matrix& operator*=(data_type TheValue) {
-        for (std::size_t i = 0; i < size(); i++)
-            at(i) *= TheValue;
+        if (size() >= dispatch_minimum_size)
+            DispatchedScale(size(), TheValue, data(), data());
+        else
+            for (std::size_t i = 0; i < size(); i++)
+                at(i) *= TheValue;
 
         return *this;
     }
@@ -153,20 +296,21 @@ class Matrix : public MatrixExpression<Matrix<TDataType, TSize1, TSize2>,
     data_type dot(
         MatrixExpression<TExpressionType, row_major_access> const& Other)
         const {
-        data_type result = data_type();
-        for (std::size_t i = 0; i < size(); ++i) {
-            result += at(i) * Other.expression()[i];
-        }
-        return result;
+        return Dot(*this, Other);
     }
 
-    data_type squared_norm() const { return dot(*this); }
+    typename NumericTraits<data_type>::real_type squared_norm() const {
+        return SquaredNorm(*this);
+    }
 
-    data_type norm() const { return std::sqrt(dot(*this)); }
+    typename NumericTraits<data_type>::real_type norm() const {
+        return Norm(*this);
+    }
 
     void normalize() {
+        using real_type = typename NumericTraits<data_type>::real_type;
         auto the_norm = norm();
-        if (the_norm > std::numeric_limits<data_type>::epsilon()) {
+        if (the_norm > std::numeric_limits<real_type>::epsilon()) {
             const auto norm_inverse = 1.0 / the_norm;
             for (std::size_t i = 0; i < size(); ++i) {
                 at(i) *= norm_inverse;
@@ -174,13 +318,214 @@ class Matrix : public MatrixExpression<Matrix<TDataType, TSize1, TSize2>,
         }
     }
 
-    Matrix& noalias() { return *this; }
+    /// Skips the aliasing check of the next assignment
+    NoAliasAssignment<Matrix> noalias() {
+        return NoAliasAssignment<Matrix>(*this);
+    }
+
+    bool overlaps(void const* pBegin, void const* pEnd) const {
+        return AreRangesOverlapping(data(), data() + size(), pBegin, pEnd);
+    }
+
+    /// In an elementwise expression an element is only read for the same
+    /// element of the destination, which is safe if it is this matrix
+    bool aliases(void const* pBegin, void const* pEnd) const {
+        return overlaps(pBegin, pEnd) &&
+               !(pBegin == data() && pEnd == data() + size());
+    }
+
+    template <std::size_t TWidth>
+    inline Packet<TDataType, TWidth> packet(std::size_t i) const {
+        return Packet<TDataType, TWidth>::load_unaligned(data() + i);
+    }
 
     TransposeMatrix<Matrix<TDataType, TSize1, TSize2>> transpose() {
         return TransposeMatrix<Matrix<TDataType, TSize1, TSize2>>(*this);
     }
+
+    HermitianTransposeMatrix<Matrix> hermitian_transpose() const {
+        return HermitianTransposeMatrix<Matrix>(*this);
+    }
+
+    template <std::size_t TMode>
+    TriangularView<Matrix, TMode> triangular_view() const {
+        return TriangularView<Matrix, TMode>(*this);
+    }
+
+    template <std::size_t TMode>
+    SymmetricView<Matrix, TMode> symmetric_view() const {
+        return SymmetricView<Matrix, TMode>(*this);
+    }
+
+   private:
+    /// Products of dense matrices with at least dispatch_minimum_product_size
+    /// multiplications use the dispatched kernel, smaller ones are evaluated
+    /// element by element. Nested products other than chains count as dense
+    /// operands, since the product holds them evaluated
+    template <typename TProductType,
+        typename TFirstType = typename TProductType::first_type,
+        typename TSecondType = typename TProductType::second_type>
+    using is_contiguous_product = std::integral_constant<bool,
+        IsContiguous<TFirstType>::value && IsContiguous<TSecondType>::value &&
+            std::is_same<typename TFirstType::data_type, TDataType>::value &&
+            std::is_same<typename TSecondType::data_type, TDataType>::value>;
+
+    /// Assigns a matrix type of another library, which cannot alias
+    template <typename TOtherMatrixType>
+    void assign(TOtherMatrixType const& Other,
+        std::false_type /* IsMatrixExpression */) {
+        base_type::operator=(Other);
+    }
+
+    /// An expression which reads this matrix at other positions is
+    /// evaluated into a pooled temporary first
+    template <typename TExpressionType>
+    void assign(TExpressionType const& Other,
+        std::true_type /* IsMatrixExpression */) {
+        if (!Other.aliases(data(), data() + size())) {
+            base_type::operator=(Other);
+            return;
+        }
+        TemporaryMatrix<TDataType> temporary(Other.size1(), Other.size2());
+        EvaluateExpression(Other, temporary.data());
+        base_type::operator=(temporary);
+    }
+
+    /// Evaluates the operand of a compound assignment into pResult, products
+    /// with the product kernels
+    template <typename TExpressionType>
+    static void evaluate_operand(
+        TExpressionType const& Other, TDataType* pResult) {
+        EvaluateExpression(Other, pResult);
+    }
+
+    template <typename TFirstType, typename TSecondType>
+    static void evaluate_operand(
+        MatrixProductExpression<TFirstType, TSecondType> const& Other,
+        TDataType* pResult) {
+        evaluate_product(Other, pResult,
+            is_contiguous_product<
+                MatrixProductExpression<TFirstType, TSecondType>>());
+    }
+
+    /// Evaluates a product into pResult, which has the size of the product
+    /// and does not overlap the operands
+    template <typename TFirstType, typename TSecondType>
+    static void evaluate_product(
+        MatrixProductExpression<TFirstType, TSecondType> const& Product,
+        TDataType* pResult, std::false_type /* IsContiguous */) {
+        EvaluateProduct(Product, pResult);
+    }
+
+    template <typename TFirstType, typename TSecondType>
+    static void evaluate_product(
+        MatrixProductExpression<TFirstType, TSecondType> const& Product,
+        TDataType* pResult, std::true_type /* IsContiguous */) {
+        using first_type = typename MatrixProductExpression<TFirstType,
+            TSecondType>::first_type;
+        auto const& first = Product.first();
+        auto const& second = Product.second();
+        if (first.size1() * first.size2() * second.size2() <
+                dispatch_minimum_product_size &&
+            second.size2() != 1) {
+            evaluate_product(Product, pResult, std::false_type());
+            return;
+        }
+        AMATRIX_COUNT_OPERATION(product, first.size1(), second.size2());
+        if (second.size2() == 1)
+            MatrixVectorProduct<first_type::static_size1,
+                first_type::static_size2>(first.size1(), first.size2(),
+                first.data(), second.data(), pResult);
+        else
+            DispatchedProduct(first.size1(), first.size2(), second.size2(),
+                first.data(), second.data(), pResult);
+    }
+
+    /// A^T * x of a dense A and x is the axpy form of the matrix vector
+    /// product, the other products of a transpose are evaluated in general
+    template <typename TOriginalType, typename TSecondType>
+    static void evaluate_product(
+        MatrixProductExpression<TransposeMatrix<TOriginalType>,
+            TSecondType> const& Product,
+        TDataType* pResult, std::false_type /* IsContiguous */) {
+        using second_type = typename MatrixProductExpression<
+            TransposeMatrix<TOriginalType>, TSecondType>::second_type;
+        using is_dense = std::integral_constant<bool,
+            IsContiguous<TOriginalType>::value &&
+                IsContiguous<second_type>::value &&
+                std::is_same<typename TOriginalType::data_type,
+                    TDataType>::value &&
+                std::is_same<typename second_type::data_type,
+                    TDataType>::value>;
+        evaluate_transpose_product(Product, pResult, is_dense());
+    }
+
+    template <typename TOriginalType, typename TSecondType>
+    static void evaluate_transpose_product(
+        MatrixProductExpression<TransposeMatrix<TOriginalType>,
+            TSecondType> const& Product,
+        TDataType* pResult, std::false_type /* IsDense */) {
+        EvaluateProduct(Product, pResult);
+    }
+
+    template <typename TOriginalType, typename TSecondType>
+    static void evaluate_transpose_product(
+        MatrixProductExpression<TransposeMatrix<TOriginalType>,
+            TSecondType> const& Product,
+        TDataType* pResult, std::true_type /* IsDense */) {
+        auto const& original = Product.first().original_expression();
+        auto const& second = Product.second();
+        if (second.size2() != 1) {
+            EvaluateProduct(Product, pResult);
+            return;
+        }
+        AMATRIX_COUNT_OPERATION(product, original.size2(), 1);
+        TransposeMatrixVectorProduct<TOriginalType::static_size1,
+            TOriginalType::static_size2>(original.size1(), original.size2(),
+            original.data(), second.data(), pResult);
+    }
+
+    /// The product is evaluated in place if this matrix has its size and is
+    /// not read by it, otherwise into a pooled temporary
+    template <typename TFirstType, typename TSecondType>
+    void assign_product(
+        MatrixProductExpression<TFirstType, TSecondType> const& Product,
+        bool CheckAliasing) {
+        using is_contiguous = is_contiguous_product<
+            MatrixProductExpression<TFirstType, TSecondType>>;
+        const bool is_resized =
+            (size1() != Product.size1() || size2() != Product.size2());
+        if (is_resized ||
+            (CheckAliasing && Product.aliases(data(), data() + size()))) {
+            TemporaryMatrix<TDataType> temporary(
+                Product.size1(), Product.size2());
+            evaluate_product(Product, temporary.data(), is_contiguous());
+            base_type::operator=(temporary);
+            return;
+        }
+
+        AMATRIX_COUNT_OPERATION(assignment, size1(), size2());
+        evaluate_product(Product, data(), is_contiguous());
+    }
+};
+
+template <typename TDataType, std::size_t TSize1, std::size_t TSize2>
+struct IsContiguous<Matrix<TDataType, TSize1, TSize2>> {
+    static constexpr bool value = true;
+};
+
+template <typename TDataType, std::size_t TSize1, std::size_t TSize2>
+struct HasPacketAccess<Matrix<TDataType, TSize1, TSize2>> {
+    static constexpr bool value = true;
 };
 
+/// Evaluates an expression into a matrix of the type ResultMatrix
+template <typename TExpressionType, std::size_t TCategory>
+ResultMatrix<TExpressionType> Evaluate(
+    MatrixExpression<TExpressionType, TCategory> const& TheExpression) {
+    return ResultMatrix<TExpressionType>(TheExpression.expression());
+}
+
 template <typename TDataType, std::size_t TSize1, std::size_t TSize2>
 bool operator!=(Matrix<TDataType, TSize1, TSize2> const& First,
     Matrix<TDataType, TSize1, TSize2> const& Second) {
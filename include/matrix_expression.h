@@ -1,6 +1,19 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "instrumentation.h"
+#include "kernels.h"
+#include "numeric_traits.h"
+#include "packet.h"
+#include "parallel.h"
 
 namespace AMatrix {
 constexpr std::size_t dynamic = 0;
@@ -8,6 +21,13 @@ constexpr std::size_t row_major_access = 1;
 constexpr std::size_t column_major_access = 2;
 constexpr std::size_t unordered_access = 3;
 
+// Modes of the triangular and symmetric matrices
+constexpr std::size_t upper = 1;
+constexpr std::size_t lower = 2;
+constexpr std::size_t unit_diagonal = 4;
+constexpr std::size_t unit_upper = upper | unit_diagonal;
+constexpr std::size_t unit_lower = lower | unit_diagonal;
+
 template <std::size_t TCategory1, std::size_t TCategory2>
 class AccessTrait {
    public:
@@ -20,11 +40,62 @@ class AccessTrait<row_major_access, row_major_access> {
     static constexpr std::size_t category = row_major_access;
 };
 
+/// Static size of an elementwise combination of two operands, the fixed one
+/// if any
+constexpr std::size_t CommonStaticSize(
+    std::size_t First, std::size_t Second) {
+    return (First == dynamic) ? Second : First;
+}
+
+/// Upper bound of the size of an elementwise combination of two operands,
+/// the smaller bound if both are bounded
+constexpr std::size_t CommonStaticMaxSize(
+    std::size_t First, std::size_t Second) {
+    return (First == dynamic)
+               ? Second
+               : ((Second == dynamic || First < Second) ? First : Second);
+}
+
+/// False only if both static sizes are fixed and differ
+constexpr bool AreStaticSizesCompatible(
+    std::size_t First, std::size_t Second) {
+    return (First == dynamic) || (Second == dynamic) || (First == Second);
+}
+
+/// Static number of elements, dynamic if any of the sizes is dynamic
+constexpr std::size_t StaticLength(std::size_t Size1, std::size_t Size2) {
+    return (Size1 == dynamic || Size2 == dynamic) ? dynamic : Size1 * Size2;
+}
+
+/// The static size if it is fixed, otherwise the run time size. This gives
+/// the loops over fixed size expressions constant trip counts
+constexpr std::size_t FixedOrRuntimeSize(
+    std::size_t StaticSize, std::size_t RuntimeSize) {
+    return (StaticSize == dynamic) ? RuntimeSize : StaticSize;
+}
+
+/// True if the memory ranges [pBegin1, pEnd1) and [pBegin2, pEnd2) overlap
+inline bool AreRangesOverlapping(void const* pBegin1, void const* pEnd1,
+    void const* pBegin2, void const* pEnd2) {
+    std::less<void const*> less;
+    return less(pBegin1, pEnd2) && less(pBegin2, pEnd1);
+}
+
 template <typename TExpressionType, std::size_t TCategory = unordered_access>
 class MatrixExpression {
    public:
     static constexpr std::size_t category = TCategory;
 
+    /// Sizes known at compile time, dynamic if they are only known at run
+    /// time. The derived expressions shadow them
+    static constexpr std::size_t static_size1 = dynamic;
+    static constexpr std::size_t static_size2 = dynamic;
+
+    /// Upper bounds of the sizes known at compile time, dynamic if the sizes
+    /// are unbounded. Fixed sizes are their own bounds
+    static constexpr std::size_t static_max_size1 = dynamic;
+    static constexpr std::size_t static_max_size2 = dynamic;
+
     // using value_type = TExpressionType::value_type;
     MatrixExpression() {}
 
@@ -44,6 +115,181 @@ class MatrixExpression {
     }
 
     TExpressionType& noalias() { return expression(); }
+
+    /// True if the expression reads any memory of [pBegin, pEnd). The
+    /// expressions forward it to their operands down to the matrices, which
+    /// compare their own data. Unknown expressions are assumed to overlap
+    bool overlaps(void const* pBegin, void const* pEnd) const { return true; }
+
+    /// True if writing the result of the expression to [pBegin, pEnd) would
+    /// change elements before they are read. Elementwise expressions read
+    /// an element of a matrix only to compute the same element, so they may
+    /// be assigned to one of their operands. All others alias on overlap
+    bool aliases(void const* pBegin, void const* pEnd) const {
+        return expression().overlaps(pBegin, pEnd);
+    }
+};
+
+/// Static sizes of any matrix type, dynamic for the types which do not
+/// define static_size1 and static_size2
+template <typename TMatrixType, typename TEnable = void>
+struct StaticSizeTraits {
+    static constexpr std::size_t size1 = dynamic;
+    static constexpr std::size_t size2 = dynamic;
+};
+
+template <typename TMatrixType>
+struct StaticSizeTraits<TMatrixType,
+    typename std::conditional<true, void,
+        decltype(TMatrixType::static_size1 +
+                 TMatrixType::static_size2)>::type> {
+    static constexpr std::size_t size1 = TMatrixType::static_size1;
+    static constexpr std::size_t size2 = TMatrixType::static_size2;
+};
+
+/// True for the types derived from MatrixExpression, false for the matrix
+/// types of other libraries
+template <typename TType, typename TEnable = void>
+struct IsMatrixExpression : std::false_type {};
+
+template <typename TType>
+struct IsMatrixExpression<TType,
+    typename std::conditional<true, void, decltype(TType::category)>::type>
+    : std::is_base_of<MatrixExpression<TType, TType::category>, TType> {};
+
+/// False if the fixed sizes of the two types differ, which makes the
+/// assignment of one to the other a compile time error
+template <typename TMatrix1Type, typename TMatrix2Type>
+constexpr bool HaveCompatibleStaticSizes() {
+    return AreStaticSizesCompatible(StaticSizeTraits<TMatrix1Type>::size1,
+               StaticSizeTraits<TMatrix2Type>::size1) &&
+           AreStaticSizesCompatible(StaticSizeTraits<TMatrix1Type>::size2,
+               StaticSizeTraits<TMatrix2Type>::size2);
+}
+
+template <typename TDataType, std::size_t TSize1, std::size_t TSize2>
+class Matrix;
+
+template <typename TDataType, std::size_t TMaxSize1, std::size_t TMaxSize2>
+class BoundedMatrix;
+
+template <typename TDataType>
+class TemporaryMatrix;
+
+/// Matrix type which holds a result of the given static sizes and bounds.
+/// Fixed size results are stored in a Matrix on the stack, as are the
+/// results with bounded dynamic sizes in a BoundedMatrix. Only unbounded
+/// results are allocated
+template <typename TDataType, std::size_t TSize1, std::size_t TSize2,
+    std::size_t TMaxSize1, std::size_t TMaxSize2,
+    bool TIsBounded = (TSize1 == dynamic || TSize2 == dynamic) &&
+                      TMaxSize1 != dynamic && TMaxSize2 != dynamic>
+struct ResultMatrixType {
+    using type = Matrix<TDataType, TSize1, TSize2>;
+};
+
+template <typename TDataType, std::size_t TSize1, std::size_t TSize2,
+    std::size_t TMaxSize1, std::size_t TMaxSize2>
+struct ResultMatrixType<TDataType, TSize1, TSize2, TMaxSize1, TMaxSize2,
+    true> {
+    using type = BoundedMatrix<TDataType, TMaxSize1, TMaxSize2>;
+};
+
+/// Matrix type which holds the result of an expression
+template <typename TExpressionType>
+using ResultMatrix = typename ResultMatrixType<
+    typename TExpressionType::data_type, TExpressionType::static_size1,
+    TExpressionType::static_size2, TExpressionType::static_max_size1,
+    TExpressionType::static_max_size2>::type;
+
+/// True for the expressions whose elements are sums over a row and a
+/// column, i.e. products and expressions of products. Reading them
+/// repeatedly repeats these sums
+template <typename TExpressionType>
+struct IsExpensiveToRead {
+    static constexpr bool value = false;
+};
+
+/// How a product holds an operand. Its elements are read once for every
+/// column or row of the other operand, so expensive operands are evaluated
+/// once into their ResultMatrix, which turns a nested product from O(n^4)
+/// into two O(n^3) products. The others are referenced
+template <typename TExpressionType,
+    bool TIsEvaluated = IsExpensiveToRead<TExpressionType>::value>
+struct ProductOperand {
+    using type = TExpressionType;
+    using storage_type = TExpressionType const&;
+};
+
+template <typename TExpressionType>
+struct ProductOperand<TExpressionType, true> {
+    using type = ResultMatrix<TExpressionType>;
+    using storage_type = type;
+};
+
+template <typename TExpression1Type, typename TExpression2Type>
+class MatrixProductExpression;
+
+/// True for the products of two matrix expressions
+template <typename TExpressionType>
+struct IsMatrixProduct {
+    static constexpr bool value = false;
+};
+
+template <typename TExpression1Type, typename TExpression2Type>
+struct IsMatrixProduct<
+    MatrixProductExpression<TExpression1Type, TExpression2Type>> {
+    static constexpr bool value = true;
+};
+
+/// How a product of matrix expressions holds an operand. A product operand
+/// is kept as a lazy copy of its expression, so the chain of products is
+/// evaluated as a whole in the order chosen by EvaluateProductChain
+template <typename TExpressionType,
+    bool TIsProduct = IsMatrixProduct<TExpressionType>::value>
+struct ProductChainOperand : ProductOperand<TExpressionType> {};
+
+template <typename TExpressionType>
+struct ProductChainOperand<TExpressionType, true> {
+    using type = TExpressionType;
+    using storage_type = TExpressionType;
+};
+
+/// Row major storage of the result of a product chain: its ResultMatrix if
+/// that has fixed sizes or bounds, otherwise a vector, which only allocates
+/// when the chain is evaluated
+template <typename TDataType, std::size_t TSize1, std::size_t TSize2,
+    std::size_t TMaxSize1, std::size_t TMaxSize2>
+using ProductChainStorage =
+    typename std::conditional<TMaxSize1 != dynamic && TMaxSize2 != dynamic,
+        typename ResultMatrixType<TDataType, TSize1, TSize2, TMaxSize1,
+            TMaxSize2>::type,
+        std::vector<TDataType>>::type;
+
+/// The result of a product chain, held by value and evaluated on the first
+/// read of one of its elements. A copy of the chain evaluates its own. The
+/// first read writes the result without synchronization, so the elements
+/// of a chain expression must not be read from several threads at once;
+/// such a chain is assigned to a matrix first
+template <typename TStorageType, bool TIsChain>
+class ProductChainResult {};
+
+template <typename TStorageType>
+class ProductChainResult<TStorageType, true> {
+   protected:
+    mutable TStorageType _evaluated;
+    mutable bool _is_evaluated;
+
+    ProductChainResult() : _is_evaluated(false) {}
+
+    ProductChainResult(ProductChainResult const&) : _is_evaluated(false) {}
+};
+
+/// True for the row major expressions which also give their elements as
+/// packets through packet<TWidth>(i), next to operator[]
+template <typename TExpressionType>
+struct HasPacketAccess {
+    static constexpr bool value = false;
 };
 
 template <typename TExpressionType>
@@ -53,46 +299,134 @@ class TransposeMatrix
 
    public:
     using data_type = typename TExpressionType::data_type;
+    static constexpr std::size_t static_size1 = TExpressionType::static_size2;
+    static constexpr std::size_t static_size2 = TExpressionType::static_size1;
+    static constexpr std::size_t static_max_size1 =
+        TExpressionType::static_max_size2;
+    static constexpr std::size_t static_max_size2 =
+        TExpressionType::static_max_size1;
     TransposeMatrix() = delete;
 
     TransposeMatrix(TExpressionType const& Original)
         : _original_expression(Original) {}
 
+    TExpressionType const& original_expression() const {
+        return _original_expression;
+    }
+
     inline data_type operator()(std::size_t i, std::size_t j) const {
         return _original_expression(j, i);
     }
 
-    inline std::size_t size1() const { return _original_expression.size2(); }
-    inline std::size_t size2() const { return _original_expression.size1(); }
+    inline std::size_t size1() const {
+        return FixedOrRuntimeSize(static_size1, _original_expression.size2());
+    }
+    inline std::size_t size2() const {
+        return FixedOrRuntimeSize(static_size2, _original_expression.size1());
+    }
+
+    bool overlaps(void const* pBegin, void const* pEnd) const {
+        return _original_expression.overlaps(pBegin, pEnd);
+    }
 };
 
 template <typename TExpressionType>
-class MatrixRow : public MatrixExpression<MatrixRow<TExpressionType>> {
+struct IsExpensiveToRead<TransposeMatrix<TExpressionType>> {
+    static constexpr bool value = IsExpensiveToRead<TExpressionType>::value;
+};
+
+/// Conjugate transpose A^H, which is the transpose for real matrices
+template <typename TExpressionType>
+class HermitianTransposeMatrix
+    : public MatrixExpression<HermitianTransposeMatrix<TExpressionType>> {
+    TExpressionType const& _original_expression;
+
+   public:
+    using data_type = typename TExpressionType::data_type;
+    static constexpr std::size_t static_size1 = TExpressionType::static_size2;
+    static constexpr std::size_t static_size2 = TExpressionType::static_size1;
+    static constexpr std::size_t static_max_size1 =
+        TExpressionType::static_max_size2;
+    static constexpr std::size_t static_max_size2 =
+        TExpressionType::static_max_size1;
+    HermitianTransposeMatrix() = delete;
+
+    HermitianTransposeMatrix(TExpressionType const& Original)
+        : _original_expression(Original) {}
+
+    inline data_type operator()(std::size_t i, std::size_t j) const {
+        return NumericTraits<data_type>::conjugate(_original_expression(j, i));
+    }
+
+    inline std::size_t size1() const {
+        return FixedOrRuntimeSize(static_size1, _original_expression.size2());
+    }
+    inline std::size_t size2() const {
+        return FixedOrRuntimeSize(static_size2, _original_expression.size1());
+    }
+
+    bool overlaps(void const* pBegin, void const* pEnd) const {
+        return _original_expression.overlaps(pBegin, pEnd);
+    }
+};
+
+template <typename TExpressionType>
+struct IsExpensiveToRead<HermitianTransposeMatrix<TExpressionType>> {
+    static constexpr bool value = IsExpensiveToRead<TExpressionType>::value;
+};
+
+template <typename TExpressionType, std::size_t TCategory>
+HermitianTransposeMatrix<TExpressionType> HermitianTranspose(
+    MatrixExpression<TExpressionType, TCategory> const& TheExpression) {
+    return HermitianTransposeMatrix<TExpressionType>(
+        TheExpression.expression());
+}
+
+/// Row of a matrix. The row of a contiguous matrix is contiguous itself, it
+/// gives its elements through data() and is read and written in packets
+template <typename TExpressionType>
+class MatrixRow
+    : public MatrixExpression<MatrixRow<TExpressionType>, row_major_access> {
     TExpressionType& _original_expression;
     std::size_t _row_index;
 
+    using is_contiguous = std::integral_constant<bool,
+        IsContiguous<typename std::remove_const<TExpressionType>::type>::value>;
+
    public:
     using data_type = typename TExpressionType::data_type;
+    static constexpr std::size_t static_size1 = 1;
+    static constexpr std::size_t static_size2 = TExpressionType::static_size2;
     MatrixRow() = delete;
 
     MatrixRow(TExpressionType& Original, std::size_t RowIndex)
         : _original_expression(Original), _row_index(RowIndex) {}
 
+    MatrixRow& operator=(MatrixRow const& Other) {
+        assign(Other, is_contiguous());
+        return *this;
+    }
+
     template <typename TOtherExpressionType, std::size_t TCategory>
     MatrixRow& operator=(
         MatrixExpression<TOtherExpressionType, TCategory> const& Other) {
-        auto& other_expression = Other.expression();
-        for (std::size_t j = 0; j < size2(); j++)
-            _original_expression(_row_index, j) = Other.expression()(0, j);
+        assign(Other, is_contiguous());
         return *this;
     }
 
-    template <typename TOtherExpressionType>
-    MatrixRow& operator=(
-        MatrixExpression<TOtherExpressionType, row_major_access> const& Other) {
-        auto& other_expression = Other.expression();
-        for (std::size_t j = 0; j < size2(); j++)
-            _original_expression(_row_index, j) = Other.expression()[j];
+    template <typename TOtherExpressionType, std::size_t TCategory>
+    MatrixRow& operator+=(
+        MatrixExpression<TOtherExpressionType, TCategory> const& Other) {
+        add(data_type(1), Other.expression(),
+            uses_kernels<TOtherExpressionType>());
+        return *this;
+    }
+
+    template <typename TOtherExpressionType, std::size_t TCategory>
+    MatrixRow& operator-=(
+        MatrixExpression<TOtherExpressionType, TCategory> const& Other) {
+        add(data_type(-1), Other.expression(),
+            uses_kernels<TOtherExpressionType>());
         return *this;
     }
 
@@ -114,38 +448,147 @@ class MatrixRow : public MatrixExpression<MatrixRow<TExpressionType>> {
         return _original_expression(_row_index, i);
     }
 
-    inline std::size_t size() const { return _original_expression.size2(); }
+    inline std::size_t size() const { return size2(); }
     inline std::size_t size1() const { return 1; }
-    inline std::size_t size2() const { return _original_expression.size2(); }
+    inline std::size_t size2() const {
+        return FixedOrRuntimeSize(static_size2, _original_expression.size2());
+    }
+
+    bool overlaps(void const* pBegin, void const* pEnd) const {
+        return _original_expression.overlaps(pBegin, pEnd);
+    }
+
+    /// Only for the rows of contiguous matrices
+    data_type* data() { return &_original_expression(_row_index, 0); }
+
+    data_type const* data() const {
+        return &_original_expression(_row_index, 0);
+    }
+
+    template <std::size_t TWidth>
+    inline Packet<data_type, TWidth> packet(std::size_t i) const {
+        return Packet<data_type, TWidth>::load_unaligned(data() + i);
+    }
+
+   private:
+    /// The kernels add contiguous operands of the same type to a contiguous
+    /// row
+    template <typename TOtherExpressionType>
+    using uses_kernels = std::integral_constant<bool,
+        is_contiguous::value && IsContiguous<TOtherExpressionType>::value &&
+            std::is_same<typename TOtherExpressionType::data_type,
+                data_type>::value>;
+
+    /// An expression which reads the row at other positions, e.g. the
+    /// product of the row and its matrix, is evaluated into a temporary
+    template <typename TOtherExpressionType, std::size_t TCategory>
+    void assign(MatrixExpression<TOtherExpressionType, TCategory> const& Other,
+        std::true_type /* IsContiguous */) {
+        auto const& other_expression = Other.expression();
+        if (other_expression.aliases(data(), data() + size())) {
+            TemporaryMatrix<data_type> temporary(1, size());
+            EvaluateExpression(other_expression, temporary.data());
+            std::copy(temporary.data(), temporary.data() + size(), data());
+            return;
+        }
+        EvaluateExpression(other_expression, data());
+    }
+
+    template <typename TOtherExpressionType, std::size_t TCategory>
+    void assign(MatrixExpression<TOtherExpressionType, TCategory> const& Other,
+        std::false_type /* IsContiguous */) {
+        for (std::size_t j = 0; j < size2(); j++)
+            _original_expression(_row_index, j) = Other.expression()(0, j);
+    }
+
+    template <typename TOtherExpressionType>
+    void assign(
+        MatrixExpression<TOtherExpressionType, row_major_access> const& Other,
+        std::false_type /* IsContiguous */) {
+        for (std::size_t j = 0; j < size2(); j++)
+            _original_expression(_row_index, j) = Other.expression()[j];
+    }
+
+    template <typename TOtherExpressionType>
+    void add(data_type Alpha, TOtherExpressionType const& Other,
+        std::true_type /* UsesKernels */) {
+        if (Other.aliases(data(), data() + size())) {
+            TemporaryMatrix<data_type> temporary(1, size());
+            std::copy(Other.data(), Other.data() + size(), temporary.data());
+            add(Alpha, temporary, std::true_type());
+        } else if (size() < dispatch_minimum_size) {
+            GenericKernels::axpy(size(), Alpha, Other.data(), data());
+        } else {
+            DispatchedAxpy(size(), Alpha, Other.data(), data());
+        }
+    }
+
+    template <typename TOtherExpressionType>
+    void add(data_type Alpha, TOtherExpressionType const& Other,
+        std::false_type /* UsesKernels */) {
+        for (std::size_t j = 0; j < size2(); j++)
+            _original_expression(_row_index, j) += Alpha * Other(0, j);
+    }
+};
+
+template <typename TExpressionType>
+struct IsContiguous<MatrixRow<TExpressionType>> {
+    static constexpr bool value =
+        IsContiguous<typename std::remove_const<TExpressionType>::type>::value;
 };
 
 template <typename TExpressionType>
-class MatrixColumn : public MatrixExpression<MatrixColumn<TExpressionType>> {
+struct HasPacketAccess<MatrixRow<TExpressionType>> {
+    static constexpr bool value =
+        IsContiguous<typename std::remove_const<TExpressionType>::type>::value;
+};
+
+/// Column of a matrix. The column of a contiguous matrix is strided, its
+/// elements are stride() apart from data(). It is read and written with
+/// gathers and scatters
+template <typename TExpressionType>
+class MatrixColumn
+    : public MatrixExpression<MatrixColumn<TExpressionType>, row_major_access> {
     TExpressionType& _original_expression;
     std::size_t _column_index;
 
+    using is_strided = std::integral_constant<bool,
+        IsContiguous<typename std::remove_const<TExpressionType>::type>::value>;
+
    public:
     using data_type = typename TExpressionType::data_type;
+    static constexpr std::size_t static_size1 = TExpressionType::static_size1;
+    static constexpr std::size_t static_size2 = 1;
     MatrixColumn() = delete;
 
     MatrixColumn(TExpressionType& Original, std::size_t ColumnIndex)
         : _original_expression(Original), _column_index(ColumnIndex) {}
 
+    MatrixColumn& operator=(MatrixColumn const& Other) {
+        assign(Other, std::false_type());
+        return *this;
+    }
+
     template <typename TOtherExpressionType, std::size_t TCategory>
     MatrixColumn& operator=(
         MatrixExpression<TOtherExpressionType, TCategory> const& Other) {
-        auto& other_expression = Other.expression();
-        for (std::size_t i = 0; i < size1(); i++)
-            _original_expression(i, _column_index) = Other.expression()(i, 0);
+        assign(Other, uses_kernels<TOtherExpressionType>());
         return *this;
     }
 
-    template <typename TOtherExpressionType>
-    MatrixColumn& operator=(
-        MatrixExpression<TOtherExpressionType, row_major_access> const& Other) {
-        auto& other_expression = Other.expression();
-        for (std::size_t i = 0; i < size1(); i++)
-            _original_expression(i, _column_index) = Other.expression()[i];
+    template <typename TOtherExpressionType, std::size_t TCategory>
+    MatrixColumn& operator+=(
+        MatrixExpression<TOtherExpressionType, TCategory> const& Other) {
+        add(data_type(1), Other.expression(),
+            uses_kernels<TOtherExpressionType>());
+        return *this;
+    }
+
+    template <typename TOtherExpressionType, std::size_t TCategory>
+    MatrixColumn& operator-=(
+        MatrixExpression<TOtherExpressionType, TCategory> const& Other) {
+        add(data_type(-1), Other.expression(),
+            uses_kernels<TOtherExpressionType>());
         return *this;
     }
 
@@ -167,67 +610,102 @@ class MatrixColumn : public MatrixExpression<MatrixColumn<TExpressionType>> {
         return _original_expression(i, _column_index);
     }
 
-    inline std::size_t size() const { return _original_expression.size1(); }
-    inline std::size_t size1() const { return _original_expression.size1(); }
+    inline std::size_t size() const { return size1(); }
+    inline std::size_t size1() const {
+        return FixedOrRuntimeSize(static_size1, _original_expression.size1());
+    }
     inline std::size_t size2() const { return 1; }
-};
 
-template <typename TExpressionType>
-class SubMatrix : public MatrixExpression<SubMatrix<TExpressionType>> {
-    TExpressionType& _original_expression;
-    std::size_t _origin_index1;
-    std::size_t _origin_index2;
-    std::size_t _size1;
-    std::size_t _size2;
+    bool overlaps(void const* pBegin, void const* pEnd) const {
+        return _original_expression.overlaps(pBegin, pEnd);
+    }
 
-   public:
-    using data_type = typename TExpressionType::data_type;
-    SubMatrix() = delete;
+    /// Only for the columns of contiguous matrices
+    data_type* data() { return &_original_expression(0, _column_index); }
 
-    SubMatrix(TExpressionType& Original, std::size_t OriginIndex1,
-        std::size_t OriginIndex2, std::size_t TheSize1, std::size_t TheSize2)
-        : _original_expression(Original),
-          _origin_index1(OriginIndex1),
-          _origin_index2(OriginIndex2),
-          _size1(TheSize1),
-          _size2(TheSize2) {}
+    data_type const* data() const {
+        return &_original_expression(0, _column_index);
+    }
+
+    std::size_t stride() const { return _original_expression.size2(); }
+
+    template <std::size_t TWidth>
+    inline Packet<data_type, TWidth> packet(std::size_t i) const {
+        return Packet<data_type, TWidth>::load_strided(
+            data() + i * stride(), stride());
+    }
+
+   private:
+    /// The kernels scatter contiguous operands of the same type into a
+    /// strided column
+    template <typename TOtherExpressionType>
+    using uses_kernels = std::integral_constant<bool,
+        is_strided::value && IsContiguous<TOtherExpressionType>::value &&
+            std::is_same<typename TOtherExpressionType::data_type,
+                data_type>::value>;
 
     template <typename TOtherExpressionType, std::size_t TCategory>
-    SubMatrix& operator=(
-        MatrixExpression<TOtherExpressionType, TCategory> const& Other) {
-        auto& other_expression = Other.expression();
+    void assign(MatrixExpression<TOtherExpressionType, TCategory> const& Other,
+        std::true_type /* UsesKernels */) {
+        auto const& other_expression = Other.expression();
+        if (size() < dispatch_minimum_size)
+            GenericKernels::scatter(
+                size(), other_expression.data(), data(), stride());
+        else
+            DispatchedScatter(
+                size(), other_expression.data(), data(), stride());
+    }
+
+    template <typename TOtherExpressionType, std::size_t TCategory>
+    void assign(MatrixExpression<TOtherExpressionType, TCategory> const& Other,
+        std::false_type /* UsesKernels */) {
         for (std::size_t i = 0; i < size1(); i++)
-            for (std::size_t j = 0; j < size2(); j++)
-                _original_expression(i + _origin_index1, j + _origin_index2) =
-                    Other.expression()(i, j);
-        return *this;
+            _original_expression(i, _column_index) = Other.expression()(i, 0);
     }
 
     template <typename TOtherExpressionType>
-    SubMatrix& operator=(
-        MatrixExpression<TOtherExpressionType, row_major_access> const& Other) {
-        auto& other_expression = Other.expression();
-        std::size_t k = 0;
+    void assign(
+        MatrixExpression<TOtherExpressionType, row_major_access> const& Other,
+        std::false_type /* UsesKernels */) {
         for (std::size_t i = 0; i < size1(); i++)
-            for (std::size_t j = 0; j < size2(); j++)
-                _original_expression(i + _origin_index1, j + _origin_index2) =
-                    Other.expression()[k++];
-        return *this;
+            _original_expression(i, _column_index) = Other.expression()[i];
     }
 
-    inline data_type const& operator()(std::size_t i, std::size_t j) const {
-        return _original_expression(i + _origin_index1, j + _origin_index2);
+    template <typename TOtherExpressionType>
+    void add(data_type Alpha, TOtherExpressionType const& Other,
+        std::true_type /* UsesKernels */) {
+        if (size() < dispatch_minimum_size)
+            GenericKernels::strided_axpy(
+                size(), Alpha, Other.data(), data(), stride());
+        else
+            DispatchedStridedAxpy(
+                size(), Alpha, Other.data(), data(), stride());
     }
 
-    inline data_type& operator()(std::size_t i, std::size_t j) {
-        return _original_expression(i + _origin_index1, j + _origin_index2);
+    template <typename TOtherExpressionType>
+    void add(data_type Alpha, TOtherExpressionType const& Other,
+        std::false_type /* UsesKernels */) {
+        for (std::size_t i = 0; i < size1(); i++)
+            _original_expression(i, _column_index) += Alpha * Other(i, 0);
     }
+};
 
-    inline std::size_t size() const { return _size1 * _size2; }
-    inline std::size_t size1() const { return _size1; }
-    inline std::size_t size2() const { return _size2; }
+template <typename TExpressionType>
+struct IsStrided<MatrixColumn<TExpressionType>> {
+    static constexpr bool value =
+        IsContiguous<typename std::remove_const<TExpressionType>::type>::value;
 };
 
+template <typename TExpressionType>
+struct HasPacketAccess<MatrixColumn<TExpressionType>> {
+    static constexpr bool value =
+        IsContiguous<typename std::remove_const<TExpressionType>::type>::value;
+};
+
+/// Range of a vector. The range of a contiguous vector is contiguous
+/// itself: it is an operand of the dense kernels, is assigned from packet
+/// expressions a packet at a time and adds dense operands with the
+/// dispatched kernels
 template <typename TExpressionType>
 class SubVector
     : public MatrixExpression<SubVector<TExpressionType>, row_major_access> {
@@ -235,6 +713,9 @@ class SubVector
     std::size_t _origin_index;
     std::size_t _size;
 
+    using is_contiguous = std::integral_constant<bool,
+        IsContiguous<typename std::remove_const<TExpressionType>::type>::value>;
+
    public:
     using data_type = typename TExpressionType::data_type;
     SubVector() = delete;
@@ -245,27 +726,31 @@ class SubVector
           _origin_index(OriginIndex),
           _size(TheSize) {}
 
+    SubVector& operator=(SubVector const& Other) {
+        assign(Other, is_contiguous());
+        return *this;
+    }
+
+    /// Matrix expressions are evaluated with the packet evaluator, into a
+    /// temporary if they alias the range
     template <typename TOtherExpressionType>
     SubVector& operator=(TOtherExpressionType const& Other) {
-        for (std::size_t i = 0; i < _size; i++)
-            _original_expression[i + _origin_index] = Other[i];
-
+        using is_contiguous_expression = std::integral_constant<bool,
+            is_contiguous::value &&
+                IsMatrixExpression<TOtherExpressionType>::value>;
+        assign(Other, is_contiguous_expression());
         return *this;
     }
 
     template <typename TOtherExpressionType>
     SubVector& operator+=(TOtherExpressionType const& Other) {
-        for (std::size_t i = 0; i < _size; i++)
-            _original_expression[i + _origin_index] += Other[i];
-
+        add(Other, uses_kernels<TOtherExpressionType>());
         return *this;
     }
 
     template <typename TOtherExpressionType>
     SubVector& operator-=(TOtherExpressionType const& Other) {
-        for (std::size_t i = 0; i < _size; i++)
-            _original_expression[i + _origin_index] -= Other[i];
-
+        subtract(Other, uses_kernels<TOtherExpressionType>());
         return *this;
     }
 
@@ -292,9 +777,320 @@ class SubVector
     inline std::size_t size1() const { return _size; }
     inline std::size_t size2() const { return 1; }
 
+    bool overlaps(void const* pBegin, void const* pEnd) const {
+        return _original_expression.overlaps(pBegin, pEnd);
+    }
+
+    /// Reads the element i of the destination for the element i only if it
+    /// starts at the same address
+    bool aliases(void const* pBegin, void const* pEnd) const {
+        return overlaps(pBegin, pEnd) &&
+               !(pBegin == data() && pEnd == data() + _size);
+    }
+
     data_type* data() { return &_original_expression[_origin_index]; }
 
     data_type const* data() const { return &_original_expression[_origin_index]; }
+
+    template <std::size_t TWidth>
+    inline Packet<data_type, TWidth> packet(std::size_t i) const {
+        return Packet<data_type, TWidth>::load_unaligned(data() + i);
+    }
+
+   private:
+    /// The kernels add contiguous operands of the same type to a contiguous
+    /// range. The operands may be any type with operator[]
+    template <typename TOtherExpressionType>
+    using uses_kernels = std::integral_constant<bool,
+        is_contiguous::value && IsContiguous<TOtherExpressionType>::value &&
+            std::is_same<typename std::decay<decltype(std::declval<
+                             TOtherExpressionType const&>()[0])>::type,
+                data_type>::value>;
+
+    template <typename TOtherExpressionType>
+    void assign(TOtherExpressionType const& Other,
+        std::true_type /* IsContiguousExpression */) {
+        if (Other.aliases(data(), data() + _size)) {
+            TemporaryMatrix<data_type> temporary(_size, 1);
+            EvaluateExpression(Other, temporary.data());
+            std::copy(temporary.data(), temporary.data() + _size, data());
+            return;
+        }
+        EvaluateExpression(Other, data());
+    }
+
+    template <typename TOtherExpressionType>
+    void assign(TOtherExpressionType const& Other,
+        std::false_type /* IsContiguousExpression */) {
+        for (std::size_t i = 0; i < _size; i++)
+            _original_expression[i + _origin_index] = Other[i];
+    }
+
+    /// Operands which alias the range are copied to a temporary first
+    template <typename TOtherExpressionType>
+    void add(
+        TOtherExpressionType const& Other, std::true_type /* UsesKernels */) {
+        if (Other.aliases(data(), data() + _size)) {
+            TemporaryMatrix<data_type> temporary(_size, 1);
+            std::copy(Other.data(), Other.data() + _size, temporary.data());
+            add(temporary, std::true_type());
+        } else if (_size < dispatch_minimum_size) {
+            add(Other, std::false_type());
+        } else {
+            DispatchedAdd(_size, data(), Other.data(), data());
+        }
+    }
+
+    template <typename TOtherExpressionType>
+    void add(
+        TOtherExpressionType const& Other, std::false_type /* UsesKernels */) {
+        for (std::size_t i = 0; i < _size; i++)
+            _original_expression[i + _origin_index] += Other[i];
+    }
+
+    template <typename TOtherExpressionType>
+    void subtract(
+        TOtherExpressionType const& Other, std::true_type /* UsesKernels */) {
+        if (Other.aliases(data(), data() + _size)) {
+            TemporaryMatrix<data_type> temporary(_size, 1);
+            std::copy(Other.data(), Other.data() + _size, temporary.data());
+            subtract(temporary, std::true_type());
+        } else if (_size < dispatch_minimum_size) {
+            subtract(Other, std::false_type());
+        } else {
+            DispatchedSubtract(_size, data(), Other.data(), data());
+        }
+    }
+
+    template <typename TOtherExpressionType>
+    void subtract(
+        TOtherExpressionType const& Other, std::false_type /* UsesKernels */) {
+        for (std::size_t i = 0; i < _size; i++)
+            _original_expression[i + _origin_index] -= Other[i];
+    }
+};
+
+template <typename TExpressionType>
+struct IsContiguous<SubVector<TExpressionType>> {
+    static constexpr bool value =
+        IsContiguous<typename std::remove_const<TExpressionType>::type>::value;
+};
+
+template <typename TExpressionType>
+struct HasPacketAccess<SubVector<TExpressionType>> {
+    static constexpr bool value =
+        IsContiguous<typename std::remove_const<TExpressionType>::type>::value;
+};
+
+/// Elements of a vector at a list of indices, e.g. the degrees of freedom
+/// of an element in a global vector. The view holds a reference to the
+/// indices. It is read with gathers and written with scatters from
+/// contiguous operands when the vector is contiguous. The indices must
+/// differ for the assignments, repeated indices are read correctly
+template <typename TExpressionType>
+class IndexedSubVector : public MatrixExpression<
+                             IndexedSubVector<TExpressionType>,
+                             row_major_access> {
+    TExpressionType& _original_expression;
+    std::vector<std::size_t> const& _indices;
+
+    using is_contiguous = std::integral_constant<bool,
+        IsContiguous<typename std::remove_const<TExpressionType>::type>::value>;
+
+   public:
+    using data_type = typename TExpressionType::data_type;
+    IndexedSubVector() = delete;
+
+    IndexedSubVector(TExpressionType& Original,
+        std::vector<std::size_t> const& Indices)
+        : _original_expression(Original), _indices(Indices) {}
+
+    IndexedSubVector& operator=(IndexedSubVector const& Other) {
+        assign(Other, is_contiguous());
+        return *this;
+    }
+
+    template <typename TOtherExpressionType, std::size_t TCategory>
+    IndexedSubVector& operator=(
+        MatrixExpression<TOtherExpressionType, TCategory> const& Other) {
+        assign(Other.expression(), is_contiguous());
+        return *this;
+    }
+
+    /// Scatter add, the assembly of an element vector
+    template <typename TOtherExpressionType, std::size_t TCategory>
+    IndexedSubVector& operator+=(
+        MatrixExpression<TOtherExpressionType, TCategory> const& Other) {
+        add(data_type(1), Other.expression(), is_contiguous());
+        return *this;
+    }
+
+    template <typename TOtherExpressionType, std::size_t TCategory>
+    IndexedSubVector& operator-=(
+        MatrixExpression<TOtherExpressionType, TCategory> const& Other) {
+        add(data_type(-1), Other.expression(), is_contiguous());
+        return *this;
+    }
+
+    inline data_type const& operator()(std::size_t i, std::size_t j) const {
+        return _original_expression[_indices[i]];
+    }
+
+    inline data_type& operator()(std::size_t i, std::size_t j) {
+        return _original_expression[_indices[i]];
+    }
+
+    inline data_type const& operator[](std::size_t i) const {
+        return _original_expression[_indices[i]];
+    }
+
+    inline data_type& operator[](std::size_t i) {
+        return _original_expression[_indices[i]];
+    }
+
+    inline std::size_t size() const { return _indices.size(); }
+    inline std::size_t size1() const { return _indices.size(); }
+    inline std::size_t size2() const { return 1; }
+
+    std::vector<std::size_t> const& indices() const { return _indices; }
+
+    bool overlaps(void const* pBegin, void const* pEnd) const {
+        return _original_expression.overlaps(pBegin, pEnd);
+    }
+
+    template <std::size_t TWidth>
+    inline Packet<data_type, TWidth> packet(std::size_t i) const {
+        return Packet<data_type, TWidth>::gather(
+            _original_expression.data(), _indices.data() + i);
+    }
+
+   private:
+    /// The kernels scatter contiguous operands of the same type into a
+    /// contiguous vector
+    template <typename TOtherExpressionType>
+    using uses_kernels = std::integral_constant<bool,
+        is_contiguous::value && IsContiguous<TOtherExpressionType>::value &&
+            std::is_same<typename TOtherExpressionType::data_type,
+                data_type>::value>;
+
+    /// Operands which are not contiguous, or which read the original
+    /// vector, are evaluated into a temporary first
+    template <typename TOtherExpressionType>
+    void assign(TOtherExpressionType const& Other,
+        std::true_type /* IsContiguous */) {
+        if (!uses_kernels<TOtherExpressionType>::value ||
+            reads_original(Other)) {
+            TemporaryMatrix<data_type> temporary(size(), 1);
+            evaluate_operand(Other, temporary.data());
+            scatter(temporary, std::true_type());
+            return;
+        }
+        scatter(Other, uses_kernels<TOtherExpressionType>());
+    }
+
+    template <typename TOtherExpressionType>
+    void assign(TOtherExpressionType const& Other,
+        std::false_type /* IsContiguous */) {
+        scatter(Other, std::false_type());
+    }
+
+    template <typename TOtherExpressionType>
+    void add(data_type Alpha, TOtherExpressionType const& Other,
+        std::true_type /* IsContiguous */) {
+        if (!uses_kernels<TOtherExpressionType>::value ||
+            reads_original(Other)) {
+            TemporaryMatrix<data_type> temporary(size(), 1);
+            evaluate_operand(Other, temporary.data());
+            scatter_add(Alpha, temporary, std::true_type());
+            return;
+        }
+        scatter_add(Alpha, Other, uses_kernels<TOtherExpressionType>());
+    }
+
+    template <typename TOtherExpressionType>
+    void add(data_type Alpha, TOtherExpressionType const& Other,
+        std::false_type /* IsContiguous */) {
+        scatter_add(Alpha, Other, std::false_type());
+    }
+
+    template <typename TOtherExpressionType>
+    bool reads_original(TOtherExpressionType const& Other) const {
+        return Other.overlaps(_original_expression.data(),
+            _original_expression.data() + _original_expression.size());
+    }
+
+    template <typename TOtherExpressionType>
+    void scatter(TOtherExpressionType const& Other,
+        std::true_type /* UsesKernels */) {
+        if (size() < dispatch_minimum_size)
+            GenericKernels::indexed_scatter(size(), Other.data(),
+                _original_expression.data(), _indices.data());
+        else
+            DispatchedIndexedScatter(size(), Other.data(),
+                _original_expression.data(), _indices.data());
+    }
+
+    template <typename TOtherExpressionType, std::size_t TCategory>
+    void scatter(MatrixExpression<TOtherExpressionType, TCategory> const& Other,
+        std::false_type /* UsesKernels */) {
+        for (std::size_t i = 0; i < size(); i++)
+            _original_expression[_indices[i]] = Other.expression()(i, 0);
+    }
+
+    template <typename TOtherExpressionType>
+    void scatter(
+        MatrixExpression<TOtherExpressionType, row_major_access> const& Other,
+        std::false_type /* UsesKernels */) {
+        for (std::size_t i = 0; i < size(); i++)
+            _original_expression[_indices[i]] = Other.expression()[i];
+    }
+
+    template <typename TOtherExpressionType>
+    void scatter_add(data_type Alpha, TOtherExpressionType const& Other,
+        std::true_type /* UsesKernels */) {
+        if (size() < dispatch_minimum_size)
+            GenericKernels::indexed_axpy(size(), Alpha, Other.data(),
+                _original_expression.data(), _indices.data());
+        else
+            DispatchedIndexedAxpy(size(), Alpha, Other.data(),
+                _original_expression.data(), _indices.data());
+    }
+
+    template <typename TOtherExpressionType, std::size_t TCategory>
+    void scatter_add(data_type Alpha,
+        MatrixExpression<TOtherExpressionType, TCategory> const& Other,
+        std::false_type /* UsesKernels */) {
+        for (std::size_t i = 0; i < size(); i++)
+            _original_expression[_indices[i]] +=
+                Alpha * Other.expression()(i, 0);
+    }
+
+    template <typename TOtherExpressionType>
+    void scatter_add(data_type Alpha,
+        MatrixExpression<TOtherExpressionType, row_major_access> const& Other,
+        std::false_type /* UsesKernels */) {
+        for (std::size_t i = 0; i < size(); i++)
+            _original_expression[_indices[i]] += Alpha * Other.expression()[i];
+    }
+
+    template <typename TOtherExpressionType>
+    static void evaluate_operand(
+        TOtherExpressionType const& Other, data_type* pResult) {
+        EvaluateExpression(Other, pResult);
+    }
+
+    template <typename TFirstType, typename TSecondType>
+    static void evaluate_operand(
+        MatrixProductExpression<TFirstType, TSecondType> const& Other,
+        data_type* pResult) {
+        EvaluateProduct(Other, pResult);
+    }
+};
+
+template <typename TExpressionType>
+struct HasPacketAccess<IndexedSubVector<TExpressionType>> {
+    static constexpr bool value =
+        IsContiguous<typename std::remove_const<TExpressionType>::type>::value;
 };
 
 template <typename TDataType>
@@ -319,10 +1115,22 @@ class ZeroMatrix
 
     inline TDataType operator[](std::size_t i) const { return TDataType(); }
 
+    template <std::size_t TWidth>
+    inline Packet<TDataType, TWidth> packet(std::size_t i) const {
+        return Packet<TDataType, TWidth>::zero();
+    }
+
     inline std::size_t size1() const { return _size1; }
     inline std::size_t size2() const { return _size2; }
 
     inline std::size_t size() const { return _size1 * _size2; }
+
+    bool overlaps(void const* pBegin, void const* pEnd) const { return false; }
+};
+
+template <typename TDataType>
+struct HasPacketAccess<ZeroMatrix<TDataType>> {
+    static constexpr bool value = true;
 };
 
 template <typename TDataType>
@@ -344,6 +1152,8 @@ class IdentityMatrix
     inline std::size_t size1() const { return _size; }
     inline std::size_t size2() const { return _size; }
     inline std::size_t size() const { return _size * _size; }
+
+    bool overlaps(void const* pBegin, void const* pEnd) const { return false; }
 };
 
 template <typename TExpression1Type, typename TExpression2Type>
@@ -356,16 +1166,48 @@ class MatrixSumExpression
     TExpression2Type const& _second;
 
    public:
+    static constexpr std::size_t static_size1 = CommonStaticSize(
+        TExpression1Type::static_size1, TExpression2Type::static_size1);
+    static constexpr std::size_t static_size2 = CommonStaticSize(
+        TExpression1Type::static_size2, TExpression2Type::static_size2);
+    static constexpr std::size_t static_max_size1 =
+        CommonStaticMaxSize(TExpression1Type::static_max_size1,
+            TExpression2Type::static_max_size1);
+    static constexpr std::size_t static_max_size2 =
+        CommonStaticMaxSize(TExpression1Type::static_max_size2,
+            TExpression2Type::static_max_size2);
+    static_assert(AreStaticSizesCompatible(TExpression1Type::static_size1,
+                      TExpression2Type::static_size1) &&
+                      AreStaticSizesCompatible(TExpression1Type::static_size2,
+                          TExpression2Type::static_size2),
+        "The fixed sizes of the operands do not match");
+
     MatrixSumExpression(
         TExpression1Type const& First, TExpression2Type const& Second)
         : _first(First), _second(Second) {}
     using data_type = typename TExpression1Type::data_type;
 
-    std::size_t size1() const { return _first.size1(); }
+    std::size_t size1() const {
+        return FixedOrRuntimeSize(static_size1, _first.size1());
+    }
+
+    std::size_t size2() const {
+        return FixedOrRuntimeSize(static_size2, _first.size2());
+    }
+
+    std::size_t size() const {
+        return FixedOrRuntimeSize(
+            StaticLength(static_size1, static_size2), _first.size());
+    }
 
-    std::size_t size2() const { return _first.size2(); }
+    bool overlaps(void const* pBegin, void const* pEnd) const {
+        return _first.overlaps(pBegin, pEnd) ||
+               _second.overlaps(pBegin, pEnd);
+    }
 
-    std::size_t size() const { return _first.size(); }
+    bool aliases(void const* pBegin, void const* pEnd) const {
+        return _first.aliases(pBegin, pEnd) || _second.aliases(pBegin, pEnd);
+    }
 
     inline data_type operator()(std::size_t i, std::size_t j) const {
         return _first(i, j) + _second(i, j);
@@ -374,6 +1216,27 @@ class MatrixSumExpression
     inline data_type operator[](std::size_t i) const {
         return _first[i] + _second[i];
     }
+
+    template <std::size_t TWidth>
+    inline Packet<data_type, TWidth> packet(std::size_t i) const {
+        return _first.template packet<TWidth>(i) +
+               _second.template packet<TWidth>(i);
+    }
+};
+
+template <typename TExpression1Type, typename TExpression2Type>
+struct HasPacketAccess<MatrixSumExpression<TExpression1Type, TExpression2Type>> {
+    static constexpr bool value =
+        HasPacketAccess<TExpression1Type>::value &&
+        HasPacketAccess<TExpression2Type>::value &&
+        std::is_same<typename TExpression1Type::data_type,
+            typename TExpression2Type::data_type>::value;
+};
+
+template <typename TExpression1Type, typename TExpression2Type>
+struct IsExpensiveToRead<MatrixSumExpression<TExpression1Type, TExpression2Type>> {
+    static constexpr bool value = IsExpensiveToRead<TExpression1Type>::value ||
+                                  IsExpensiveToRead<TExpression2Type>::value;
 };
 
 template <typename TExpression1Type, typename TExpression2Type,
@@ -395,16 +1258,48 @@ class MatrixMinusExpression
     TExpression2Type const& _second;
 
    public:
+    static constexpr std::size_t static_size1 = CommonStaticSize(
+        TExpression1Type::static_size1, TExpression2Type::static_size1);
+    static constexpr std::size_t static_size2 = CommonStaticSize(
+        TExpression1Type::static_size2, TExpression2Type::static_size2);
+    static constexpr std::size_t static_max_size1 =
+        CommonStaticMaxSize(TExpression1Type::static_max_size1,
+            TExpression2Type::static_max_size1);
+    static constexpr std::size_t static_max_size2 =
+        CommonStaticMaxSize(TExpression1Type::static_max_size2,
+            TExpression2Type::static_max_size2);
+    static_assert(AreStaticSizesCompatible(TExpression1Type::static_size1,
+                      TExpression2Type::static_size1) &&
+                      AreStaticSizesCompatible(TExpression1Type::static_size2,
+                          TExpression2Type::static_size2),
+        "The fixed sizes of the operands do not match");
+
     MatrixMinusExpression(
         TExpression1Type const& First, TExpression2Type const& Second)
         : _first(First), _second(Second) {}
     using data_type = typename TExpression1Type::data_type;
 
-    std::size_t size1() const { return _first.size1(); }
+    std::size_t size1() const {
+        return FixedOrRuntimeSize(static_size1, _first.size1());
+    }
+
+    std::size_t size2() const {
+        return FixedOrRuntimeSize(static_size2, _first.size2());
+    }
+
+    std::size_t size() const {
+        return FixedOrRuntimeSize(
+            StaticLength(static_size1, static_size2), _first.size());
+    }
 
-    std::size_t size2() const { return _first.size2(); }
+    bool overlaps(void const* pBegin, void const* pEnd) const {
+        return _first.overlaps(pBegin, pEnd) ||
+               _second.overlaps(pBegin, pEnd);
+    }
 
-    std::size_t size() const { return _first.size(); }
+    bool aliases(void const* pBegin, void const* pEnd) const {
+        return _first.aliases(pBegin, pEnd) || _second.aliases(pBegin, pEnd);
+    }
 
     inline data_type operator()(std::size_t i, std::size_t j) const {
         return _first(i, j) - _second(i, j);
@@ -413,6 +1308,27 @@ class MatrixMinusExpression
     inline data_type operator[](std::size_t i) const {
         return _first[i] - _second[i];
     }
+
+    template <std::size_t TWidth>
+    inline Packet<data_type, TWidth> packet(std::size_t i) const {
+        return _first.template packet<TWidth>(i) -
+               _second.template packet<TWidth>(i);
+    }
+};
+
+template <typename TExpression1Type, typename TExpression2Type>
+struct HasPacketAccess<MatrixMinusExpression<TExpression1Type, TExpression2Type>> {
+    static constexpr bool value =
+        HasPacketAccess<TExpression1Type>::value &&
+        HasPacketAccess<TExpression2Type>::value &&
+        std::is_same<typename TExpression1Type::data_type,
+            typename TExpression2Type::data_type>::value;
+};
+
+template <typename TExpression1Type, typename TExpression2Type>
+struct IsExpensiveToRead<MatrixMinusExpression<TExpression1Type, TExpression2Type>> {
+    static constexpr bool value = IsExpensiveToRead<TExpression1Type>::value ||
+                                  IsExpensiveToRead<TExpression2Type>::value;
 };
 
 template <typename TExpression1Type, typename TExpression2Type,
@@ -432,14 +1348,36 @@ class MatrixUnaryMinusExpression
 
    public:
     using data_type = typename TExpressionType::data_type;
+    static constexpr std::size_t static_size1 = TExpressionType::static_size1;
+    static constexpr std::size_t static_size2 = TExpressionType::static_size2;
+    static constexpr std::size_t static_max_size1 =
+        TExpressionType::static_max_size1;
+    static constexpr std::size_t static_max_size2 =
+        TExpressionType::static_max_size2;
 
     MatrixUnaryMinusExpression(TExpressionType const& TheExpression)
         : _original_expression(TheExpression) {}
-    std::size_t size1() const { return _original_expression.size1(); }
+    std::size_t size1() const {
+        return FixedOrRuntimeSize(static_size1, _original_expression.size1());
+    }
+
+    std::size_t size2() const {
+        return FixedOrRuntimeSize(static_size2, _original_expression.size2());
+    }
+
+    std::size_t size() const {
+        return FixedOrRuntimeSize(
+            StaticLength(static_size1, static_size2),
+            _original_expression.size());
+    }
 
-    std::size_t size2() const { return _original_expression.size2(); }
+    bool overlaps(void const* pBegin, void const* pEnd) const {
+        return _original_expression.overlaps(pBegin, pEnd);
+    }
 
-    std::size_t size() const { return _original_expression.size(); }
+    bool aliases(void const* pBegin, void const* pEnd) const {
+        return _original_expression.aliases(pBegin, pEnd);
+    }
 
     inline data_type operator()(std::size_t i, std::size_t j) const {
         return -_original_expression(i, j);
@@ -448,6 +1386,21 @@ class MatrixUnaryMinusExpression
     inline data_type operator[](std::size_t i) const {
         return -_original_expression[i];
     }
+
+    template <std::size_t TWidth>
+    inline Packet<data_type, TWidth> packet(std::size_t i) const {
+        return -_original_expression.template packet<TWidth>(i);
+    }
+};
+
+template <typename TExpressionType>
+struct HasPacketAccess<MatrixUnaryMinusExpression<TExpressionType>> {
+    static constexpr bool value = HasPacketAccess<TExpressionType>::value;
+};
+
+template <typename TExpressionType>
+struct IsExpensiveToRead<MatrixUnaryMinusExpression<TExpressionType>> {
+    static constexpr bool value = IsExpensiveToRead<TExpressionType>::value;
 };
 
 template <typename TExpressionType>
@@ -459,15 +1412,39 @@ class MatrixScalarProductExpression
 
    public:
     using data_type = typename TExpressionType::data_type;
+    static constexpr std::size_t static_size1 = TExpressionType::static_size1;
+    static constexpr std::size_t static_size2 = TExpressionType::static_size2;
+    static constexpr std::size_t static_max_size1 =
+        TExpressionType::static_max_size1;
+    static constexpr std::size_t static_max_size2 =
+        TExpressionType::static_max_size2;
 
     MatrixScalarProductExpression(
         data_type const& First, TExpressionType const& Second)
         : _first(First), _second(Second) {}
-    std::size_t size1() const { return _second.size1(); }
+    std::size_t size1() const {
+        return FixedOrRuntimeSize(static_size1, _second.size1());
+    }
 
-    std::size_t size2() const { return _second.size2(); }
+    std::size_t size2() const {
+        return FixedOrRuntimeSize(static_size2, _second.size2());
+    }
+
+    std::size_t size() const {
+        return FixedOrRuntimeSize(
+            StaticLength(static_size1, static_size2), _second.size());
+    }
+
+    /// The scalar is referenced and may be an element of the destination
+    bool overlaps(void const* pBegin, void const* pEnd) const {
+        return AreRangesOverlapping(&_first, &_first + 1, pBegin, pEnd) ||
+               _second.overlaps(pBegin, pEnd);
+    }
 
-    std::size_t size() const { return _second.size(); }
+    bool aliases(void const* pBegin, void const* pEnd) const {
+        return AreRangesOverlapping(&_first, &_first + 1, pBegin, pEnd) ||
+               _second.aliases(pBegin, pEnd);
+    }
 
     inline data_type operator()(std::size_t i, std::size_t j) const {
         return _first * _second(i, j);
@@ -476,6 +1453,22 @@ class MatrixScalarProductExpression
     inline data_type operator[](std::size_t i) const {
         return _first * _second[i];
     }
+
+    template <std::size_t TWidth>
+    inline Packet<data_type, TWidth> packet(std::size_t i) const {
+        return Packet<data_type, TWidth>::broadcast(_first) *
+               _second.template packet<TWidth>(i);
+    }
+};
+
+template <typename TExpressionType>
+struct HasPacketAccess<MatrixScalarProductExpression<TExpressionType>> {
+    static constexpr bool value = HasPacketAccess<TExpressionType>::value;
+};
+
+template <typename TExpressionType>
+struct IsExpensiveToRead<MatrixScalarProductExpression<TExpressionType>> {
+    static constexpr bool value = IsExpensiveToRead<TExpressionType>::value;
 };
 
 template <typename TExpressionType, std::size_t TCategory>
@@ -503,15 +1496,36 @@ class MatrixScalarDivisionExpression
 
    public:
     using data_type = typename TExpressionType::data_type;
+    static constexpr std::size_t static_size1 = TExpressionType::static_size1;
+    static constexpr std::size_t static_size2 = TExpressionType::static_size2;
+    static constexpr std::size_t static_max_size1 =
+        TExpressionType::static_max_size1;
+    static constexpr std::size_t static_max_size2 =
+        TExpressionType::static_max_size2;
 
     MatrixScalarDivisionExpression(
         TExpressionType const& First, data_type const& Second)
         : _first(First), _inverse_of_second(data_type(1) / Second) {}
-    std::size_t size1() const { return _first.size1(); }
+    std::size_t size1() const {
+        return FixedOrRuntimeSize(static_size1, _first.size1());
+    }
+
+    std::size_t size2() const {
+        return FixedOrRuntimeSize(static_size2, _first.size2());
+    }
+
+    std::size_t size() const {
+        return FixedOrRuntimeSize(
+            StaticLength(static_size1, static_size2), _first.size());
+    }
 
-    std::size_t size2() const { return _first.size2(); }
+    bool overlaps(void const* pBegin, void const* pEnd) const {
+        return _first.overlaps(pBegin, pEnd);
+    }
 
-    std::size_t size() const { return _first.size(); }
+    bool aliases(void const* pBegin, void const* pEnd) const {
+        return _first.aliases(pBegin, pEnd);
+    }
 
     inline data_type operator()(std::size_t i, std::size_t j) const {
         return _first(i, j) * _inverse_of_second;
@@ -520,6 +1534,22 @@ class MatrixScalarDivisionExpression
     inline data_type operator[](std::size_t i) const {
         return _first[i] * _inverse_of_second;
     }
+
+    template <std::size_t TWidth>
+    inline Packet<data_type, TWidth> packet(std::size_t i) const {
+        return _first.template packet<TWidth>(i) *
+               Packet<data_type, TWidth>::broadcast(_inverse_of_second);
+    }
+};
+
+template <typename TExpressionType>
+struct HasPacketAccess<MatrixScalarDivisionExpression<TExpressionType>> {
+    static constexpr bool value = HasPacketAccess<TExpressionType>::value;
+};
+
+template <typename TExpressionType>
+struct IsExpensiveToRead<MatrixScalarDivisionExpression<TExpressionType>> {
+    static constexpr bool value = IsExpensiveToRead<TExpressionType>::value;
 };
 
 template <typename TExpressionType, std::size_t TCategory>
@@ -534,28 +1564,111 @@ template <typename TExpression1Type, typename TExpression2Type>
 class MatrixProductExpression
     : public MatrixExpression<
           MatrixProductExpression<TExpression1Type, TExpression2Type>,
-          unordered_access> {
-    TExpression1Type const& _first;
-    TExpression2Type const& _second;
+          unordered_access>,
+      public ProductChainResult<
+          ProductChainStorage<typename TExpression1Type::data_type,
+              TExpression1Type::static_size1, TExpression2Type::static_size2,
+              TExpression1Type::static_max_size1,
+              TExpression2Type::static_max_size2>,
+          IsMatrixProduct<TExpression1Type>::value ||
+              IsMatrixProduct<TExpression2Type>::value> {
+    typename ProductChainOperand<TExpression1Type>::storage_type _first;
+    typename ProductChainOperand<TExpression2Type>::storage_type _second;
+
+    /// Inner size of the product, fixed if any of the operands fixes it
+    static constexpr std::size_t static_inner_size = CommonStaticSize(
+        TExpression1Type::static_size2, TExpression2Type::static_size1);
 
    public:
+    static constexpr std::size_t static_size1 = TExpression1Type::static_size1;
+    static constexpr std::size_t static_size2 = TExpression2Type::static_size2;
+    static constexpr std::size_t static_max_size1 =
+        TExpression1Type::static_max_size1;
+    static constexpr std::size_t static_max_size2 =
+        TExpression2Type::static_max_size2;
+    static_assert(AreStaticSizesCompatible(TExpression1Type::static_size2,
+                      TExpression2Type::static_size1),
+        "The fixed inner sizes of the product do not match");
+
     MatrixProductExpression(
         TExpression1Type const& First, TExpression2Type const& Second)
         : _first(First), _second(Second) {}
     using data_type = typename TExpression1Type::data_type;
+    using first_type = typename ProductChainOperand<TExpression1Type>::type;
+    using second_type = typename ProductChainOperand<TExpression2Type>::type;
+    using result_type = ResultMatrix<MatrixProductExpression>;
+
+    /// True if an operand is a product itself
+    static constexpr bool is_chain = IsMatrixProduct<TExpression1Type>::value ||
+                                     IsMatrixProduct<TExpression2Type>::value;
+
+    first_type const& first() const { return _first; }
+
+    second_type const& second() const { return _second; }
 
-    std::size_t size1() const { return _first.size1(); }
+    std::size_t size1() const {
+        return FixedOrRuntimeSize(static_size1, _first.size1());
+    }
 
-    std::size_t size2() const { return _second.size2(); }
+    std::size_t size2() const {
+        return FixedOrRuntimeSize(static_size2, _second.size2());
+    }
 
     std::size_t size() const { return size1() * size2(); }
 
+    bool overlaps(void const* pBegin, void const* pEnd) const {
+        return _first.overlaps(pBegin, pEnd) ||
+               _second.overlaps(pBegin, pEnd);
+    }
+
     inline data_type operator()(std::size_t i, std::size_t j) const {
+        return element(i, j, std::integral_constant<bool, is_chain>());
+    }
+
+   private:
+    inline data_type element(
+        std::size_t i, std::size_t j, std::false_type /* IsChain */) const {
+        const std::size_t inner_size =
+            FixedOrRuntimeSize(static_inner_size, _first.size2());
         data_type result = data_type();
-        for (std::size_t k = 0; k < _first.size2(); k++)
+        for (std::size_t k = 0; k < inner_size; k++)
             result += _first(i, k) * _second(k, j);
         return result;
     }
+
+    /// A chain is evaluated once in its cheapest order instead of reading
+    /// the nested products element by element
+    inline data_type element(
+        std::size_t i, std::size_t j, std::true_type /* IsChain */) const {
+        if (!this->_is_evaluated) {
+            evaluate_chain(this->_evaluated);
+            this->_is_evaluated = true;
+        }
+        return this->_evaluated[i * size2() + j];
+    }
+
+    template <std::size_t TSize1, std::size_t TSize2>
+    void evaluate_chain(Matrix<data_type, TSize1, TSize2>& rResult) const {
+        EvaluateProduct(*this, rResult.data());
+    }
+
+    template <std::size_t TMaxSize1, std::size_t TMaxSize2>
+    void evaluate_chain(
+        BoundedMatrix<data_type, TMaxSize1, TMaxSize2>& rResult) const {
+        rResult.resize(size1(), size2());
+        EvaluateProduct(*this, rResult.data());
+    }
+
+    void evaluate_chain(std::vector<data_type>& rResult) const {
+        rResult.resize(size());
+        EvaluateProduct(*this, rResult.data());
+    }
+};
+
+template <typename TExpression1Type, typename TExpression2Type>
+struct IsExpensiveToRead<
+    MatrixProductExpression<TExpression1Type, TExpression2Type>> {
+    static constexpr bool value = true;
 };
 
 template <typename TExpression1Type, typename TExpression2Type,
@@ -576,16 +1689,30 @@ class VectorOuterProductExpression
     TExpression2Type const& _second;
 
    public:
+    static constexpr std::size_t static_size1 = StaticLength(
+        TExpression1Type::static_size1, TExpression1Type::static_size2);
+    static constexpr std::size_t static_size2 = StaticLength(
+        TExpression2Type::static_size1, TExpression2Type::static_size2);
+
     VectorOuterProductExpression(
         TExpression1Type const& First, TExpression2Type const& Second)
         : _first(First), _second(Second) {}
     using data_type = typename TExpression1Type::data_type;
 
-    std::size_t size1() const { return _first.size(); }
+    std::size_t size1() const {
+        return FixedOrRuntimeSize(static_size1, _first.size());
+    }
+
+    std::size_t size2() const {
+        return FixedOrRuntimeSize(static_size2, _second.size());
+    }
 
-    std::size_t size2() const { return _second.size(); }
+    std::size_t size() const { return size1() * size2(); }
 
-    std::size_t size() const { return size() * size(); }
+    bool overlaps(void const* pBegin, void const* pEnd) const {
+        return _first.overlaps(pBegin, pEnd) ||
+               _second.overlaps(pBegin, pEnd);
+    }
 
     inline data_type operator()(std::size_t i, std::size_t j) const {
         return _first[i] * _second[j];
@@ -601,6 +1728,290 @@ VectorOuterProductExpression<TExpression1Type, TExpression2Type> OuterProduct(
         First.expression(), Second.expression());
 }
 
+/// Solves T X = B in place for a triangular T (TRSM). rX holds B on entry
+/// and can be a vector or a matrix. The rows of rX are updated as a whole
+/// so a row major right hand side is traversed contiguously
+template <typename TTriangularType, typename TMatrixType>
+void TriangularSolveInPlace(TTriangularType const& T, TMatrixType& rX) {
+    constexpr bool is_unit = (TTriangularType::mode & unit_diagonal) != 0;
+    const std::size_t size = T.size1();
+    const std::size_t number_of_columns = rX.size2();
+
+    if (TTriangularType::mode & upper) {
+        for (std::size_t i = size; i-- > 0;) {
+            for (std::size_t k = i + 1; k < size; k++) {
+                const auto t_ik = T.stored_element(i, k);
+                for (std::size_t j = 0; j < number_of_columns; j++)
+                    rX(i, j) -= t_ik * rX(k, j);
+            }
+            if (!is_unit) {
+                const auto inverse_of_diagonal =
+                    typename TTriangularType::data_type(1) /
+                    T.stored_element(i, i);
+                for (std::size_t j = 0; j < number_of_columns; j++)
+                    rX(i, j) *= inverse_of_diagonal;
+            }
+        }
+    } else {
+        for (std::size_t i = 0; i < size; i++) {
+            for (std::size_t k = 0; k < i; k++) {
+                const auto t_ik = T.stored_element(i, k);
+                for (std::size_t j = 0; j < number_of_columns; j++)
+                    rX(i, j) -= t_ik * rX(k, j);
+            }
+            if (!is_unit) {
+                const auto inverse_of_diagonal =
+                    typename TTriangularType::data_type(1) /
+                    T.stored_element(i, i);
+                for (std::size_t j = 0; j < number_of_columns; j++)
+                    rX(i, j) *= inverse_of_diagonal;
+            }
+        }
+    }
+}
+
+/// Triangular view of a square expression. Only the elements in the given
+/// triangle of the original expression are accessed, the rest are zero.
+/// With unit_diagonal the diagonal is not accessed and taken as one
+template <typename TExpressionType, std::size_t TMode>
+class TriangularView
+    : public MatrixExpression<TriangularView<TExpressionType, TMode>> {
+    TExpressionType const& _original_expression;
+
+   public:
+    static constexpr std::size_t mode = TMode;
+    static constexpr std::size_t static_size1 = TExpressionType::static_size1;
+    static constexpr std::size_t static_size2 = TExpressionType::static_size2;
+    static constexpr std::size_t static_max_size1 =
+        TExpressionType::static_max_size1;
+    static constexpr std::size_t static_max_size2 =
+        TExpressionType::static_max_size2;
+    using data_type = typename TExpressionType::data_type;
+    TriangularView() = delete;
+
+    TriangularView(TExpressionType const& Original)
+        : _original_expression(Original) {}
+
+    inline data_type operator()(std::size_t i, std::size_t j) const {
+        if (i == j && (TMode & unit_diagonal))
+            return data_type(1);
+        if ((TMode & upper) ? (i > j) : (i < j))
+            return data_type();
+        return _original_expression(i, j);
+    }
+
+    /// Access without checking, (i, j) must be inside the triangle
+    inline data_type stored_element(std::size_t i, std::size_t j) const {
+        return _original_expression(i, j);
+    }
+
+    inline std::size_t size1() const {
+        return FixedOrRuntimeSize(static_size1, _original_expression.size1());
+    }
+    inline std::size_t size2() const {
+        return FixedOrRuntimeSize(static_size2, _original_expression.size2());
+    }
+    inline std::size_t size() const { return size1() * size2(); }
+
+    bool overlaps(void const* pBegin, void const* pEnd) const {
+        return _original_expression.overlaps(pBegin, pEnd);
+    }
+
+    template <typename TMatrixType>
+    void solve_in_place(TMatrixType& rX) const {
+        TriangularSolveInPlace(*this, rX);
+    }
+
+    template <typename TMatrixType>
+    TMatrixType solve(TMatrixType const& RHS) const {
+        TMatrixType result(RHS);
+        TriangularSolveInPlace(*this, result);
+        return result;
+    }
+};
+
+/// Symmetric view of a square expression which only accesses the elements
+/// of the given triangle of the original expression
+template <typename TExpressionType, std::size_t TMode>
+class SymmetricView
+    : public MatrixExpression<SymmetricView<TExpressionType, TMode>> {
+    TExpressionType const& _original_expression;
+
+   public:
+    static constexpr std::size_t mode = TMode;
+    static constexpr std::size_t static_size1 = TExpressionType::static_size1;
+    static constexpr std::size_t static_size2 = TExpressionType::static_size2;
+    static constexpr std::size_t static_max_size1 =
+        TExpressionType::static_max_size1;
+    static constexpr std::size_t static_max_size2 =
+        TExpressionType::static_max_size2;
+    using data_type = typename TExpressionType::data_type;
+    SymmetricView() = delete;
+
+    SymmetricView(TExpressionType const& Original)
+        : _original_expression(Original) {}
+
+    inline data_type operator()(std::size_t i, std::size_t j) const {
+        if ((TMode & upper) ? (i > j) : (i < j))
+            return _original_expression(j, i);
+        return _original_expression(i, j);
+    }
+
+    /// Access without checking, (i, j) must be inside the triangle
+    inline data_type stored_element(std::size_t i, std::size_t j) const {
+        return _original_expression(i, j);
+    }
+
+    inline std::size_t size1() const {
+        return FixedOrRuntimeSize(static_size1, _original_expression.size1());
+    }
+    inline std::size_t size2() const {
+        return FixedOrRuntimeSize(static_size2, _original_expression.size2());
+    }
+    inline std::size_t size() const { return size1() * size2(); }
+
+    bool overlaps(void const* pBegin, void const* pEnd) const {
+        return _original_expression.overlaps(pBegin, pEnd);
+    }
+};
+
+/// Product of a triangular matrix with an expression (TRMM). The sum only
+/// runs over the nonzero part of the row which halves the flops
+template <typename TTriangularType, typename TExpressionType>
+class TriangularMatrixProductExpression
+    : public MatrixExpression<
+          TriangularMatrixProductExpression<TTriangularType, TExpressionType>,
+          unordered_access> {
+    TTriangularType const& _first;
+    typename ProductOperand<TExpressionType>::storage_type _second;
+
+   public:
+    static constexpr std::size_t static_size1 = TTriangularType::static_size1;
+    static constexpr std::size_t static_size2 = TExpressionType::static_size2;
+    static_assert(AreStaticSizesCompatible(TTriangularType::static_size2,
+                      TExpressionType::static_size1),
+        "The fixed inner sizes of the product do not match");
+
+    TriangularMatrixProductExpression(
+        TTriangularType const& First, TExpressionType const& Second)
+        : _first(First), _second(Second) {}
+    using data_type = typename TTriangularType::data_type;
+
+    std::size_t size1() const {
+        return FixedOrRuntimeSize(static_size1, _first.size1());
+    }
+
+    std::size_t size2() const {
+        return FixedOrRuntimeSize(static_size2, _second.size2());
+    }
+
+    std::size_t size() const { return size1() * size2(); }
+
+    bool overlaps(void const* pBegin, void const* pEnd) const {
+        return _first.overlaps(pBegin, pEnd) ||
+               _second.overlaps(pBegin, pEnd);
+    }
+
+    inline data_type operator()(std::size_t i, std::size_t j) const {
+        constexpr bool is_unit = (TTriangularType::mode & unit_diagonal) != 0;
+        data_type result = is_unit ? _second(i, j) : data_type();
+        if (TTriangularType::mode & upper) {
+            for (std::size_t k = i + is_unit; k < _first.size2(); k++)
+                result += _first.stored_element(i, k) * _second(k, j);
+        } else {
+            for (std::size_t k = 0; k < i + !is_unit; k++)
+                result += _first.stored_element(i, k) * _second(k, j);
+        }
+        return result;
+    }
+};
+
+template <typename TTriangularType, typename TExpressionType>
+struct IsExpensiveToRead<TriangularMatrixProductExpression<TTriangularType, TExpressionType>> {
+    static constexpr bool value = true;
+};
+
+template <typename TExpression1Type, std::size_t TMode,
+    typename TExpression2Type, std::size_t TCategory2>
+TriangularMatrixProductExpression<TriangularView<TExpression1Type, TMode>,
+    TExpression2Type>
+operator*(TriangularView<TExpression1Type, TMode> const& First,
+    MatrixExpression<TExpression2Type, TCategory2> const& Second) {
+    return TriangularMatrixProductExpression<
+        TriangularView<TExpression1Type, TMode>, TExpression2Type>(
+        First, Second.expression());
+}
+
+/// Product of a symmetric matrix with an expression (SYMM). Each row of the
+/// symmetric matrix is read from the stored triangle in two branch free parts
+template <typename TSymmetricType, typename TExpressionType>
+class SymmetricMatrixProductExpression
+    : public MatrixExpression<
+          SymmetricMatrixProductExpression<TSymmetricType, TExpressionType>,
+          unordered_access> {
+    TSymmetricType const& _first;
+    typename ProductOperand<TExpressionType>::storage_type _second;
+
+   public:
+    static constexpr std::size_t static_size1 = TSymmetricType::static_size1;
+    static constexpr std::size_t static_size2 = TExpressionType::static_size2;
+    static_assert(AreStaticSizesCompatible(TSymmetricType::static_size2,
+                      TExpressionType::static_size1),
+        "The fixed inner sizes of the product do not match");
+
+    SymmetricMatrixProductExpression(
+        TSymmetricType const& First, TExpressionType const& Second)
+        : _first(First), _second(Second) {}
+    using data_type = typename TSymmetricType::data_type;
+
+    std::size_t size1() const {
+        return FixedOrRuntimeSize(static_size1, _first.size1());
+    }
+
+    std::size_t size2() const {
+        return FixedOrRuntimeSize(static_size2, _second.size2());
+    }
+
+    std::size_t size() const { return size1() * size2(); }
+
+    bool overlaps(void const* pBegin, void const* pEnd) const {
+        return _first.overlaps(pBegin, pEnd) ||
+               _second.overlaps(pBegin, pEnd);
+    }
+
+    inline data_type operator()(std::size_t i, std::size_t j) const {
+        data_type result = data_type();
+        if (TSymmetricType::mode & upper) {
+            for (std::size_t k = 0; k < i; k++)
+                result += _first.stored_element(k, i) * _second(k, j);
+            for (std::size_t k = i; k < _first.size2(); k++)
+                result += _first.stored_element(i, k) * _second(k, j);
+        } else {
+            for (std::size_t k = 0; k <= i; k++)
+                result += _first.stored_element(i, k) * _second(k, j);
+            for (std::size_t k = i + 1; k < _first.size2(); k++)
+                result += _first.stored_element(k, i) * _second(k, j);
+        }
+        return result;
+    }
+};
+
+template <typename TSymmetricType, typename TExpressionType>
+struct IsExpensiveToRead<SymmetricMatrixProductExpression<TSymmetricType, TExpressionType>> {
+    static constexpr bool value = true;
+};
+
+template <typename TExpression1Type, std::size_t TMode,
+    typename TExpression2Type, std::size_t TCategory2>
+SymmetricMatrixProductExpression<SymmetricView<TExpression1Type, TMode>,
+    TExpression2Type>
+operator*(SymmetricView<TExpression1Type, TMode> const& First,
+    MatrixExpression<TExpression2Type, TCategory2> const& Second) {
+    return SymmetricMatrixProductExpression<
+        SymmetricView<TExpression1Type, TMode>, TExpression2Type>(
+        First, Second.expression());
+}
+
 template <typename TMatrixType, typename TPermutationVectorType>
 class LUFactorization
     : public MatrixExpression<
@@ -624,11 +2035,15 @@ class LUFactorization
     inline std::size_t size1() const { return _matrix.size1(); }
     inline std::size_t size2() const { return _matrix.size2(); }
 
+    bool overlaps(void const* pBegin, void const* pEnd) const {
+        return _matrix.overlaps(pBegin, pEnd);
+    }
+
     /// The algorithm is based on wikipedia implemenation which
     /// can be found in https://en.wikipedia.org/wiki/LU_decomposition
-    double determinant() {
+    data_type determinant() {
         const std::size_t size = size1();
-        double result = _matrix(_permutation_vector[0], 0);
+        data_type result = _matrix(_permutation_vector[0], 0);
 
         for (std::size_t i = 1; i < size; i++)
             result *= _matrix(_permutation_vector[i], i);
@@ -698,20 +2113,24 @@ class LUFactorization
     /// The algorithm is based on wikipedia implemenation which
     /// can be found in https://en.wikipedia.org/wiki/LU_decomposition
     int perform_lu() {
-        constexpr double tolerance = std::numeric_limits<double>::epsilon();
+        AMATRIX_COUNT_OPERATION(
+            factorization, _matrix.size1(), _matrix.size2());
+        using real_type = typename NumericTraits<data_type>::real_type;
+        const real_type tolerance = std::numeric_limits<real_type>::epsilon();
         std::size_t size1 = _matrix.size1();
         number_of_pivoting = 0;
 
         initialize_permutation_vector();
 
         for (std::size_t i = 0; i < size1; i++) {
-            double max_pivot = 0.0;
+            // Complex pivots are compared by |re| + |im| as in LAPACK
+            real_type max_pivot = real_type();
             std::size_t i_max = i;
-            double abs_max_pivot = 0.0;
+            real_type abs_max_pivot = real_type();
 
             for (std::size_t k = i; k < size1; k++)
-                if ((abs_max_pivot = fabs(_matrix(_permutation_vector[k], i))) >
-                    max_pivot) {
+                if ((abs_max_pivot = NumericTraits<data_type>::abs1(
+                         _matrix(_permutation_vector[k], i))) > max_pivot) {
                     max_pivot = abs_max_pivot;
                     i_max = k;
                 }
@@ -729,14 +2148,25 @@ class LUFactorization
                 number_of_pivoting++;
             }
 
+            // The rows are contiguous in a dense matrix and in its blocks, so
+            // long row updates use the dispatched axpy kernel
+            const bool use_kernel = (IsContiguous<TMatrixType>::value ||
+                                        IsBlock<TMatrixType>::value) &&
+                                    size1 - i - 1 >= dispatch_minimum_size;
             for (std::size_t j = i + 1; j < size1; j++) {
                 _matrix(_permutation_vector[j], i) /=
                     _matrix(_permutation_vector[i], i);
 
-                for (std::size_t k = i + 1; k < size1; k++)
-                    _matrix(_permutation_vector[j], k) -=
-                        _matrix(_permutation_vector[j], i) *
-                        _matrix(_permutation_vector[i], k);
+                if (use_kernel)
+                    DispatchedAxpy(size1 - i - 1,
+                        -_matrix(_permutation_vector[j], i),
+                        &_matrix(_permutation_vector[i], i + 1),
+                        &_matrix(_permutation_vector[j], i + 1));
+                else
+                    for (std::size_t k = i + 1; k < size1; k++)
+                        _matrix(_permutation_vector[j], k) -=
+                            _matrix(_permutation_vector[j], i) *
+                            _matrix(_permutation_vector[i], k);
             }
         }
 
@@ -752,4 +2182,186 @@ class LUFactorization
     }
 };
 
+/// Writes the elements of an expression to pResult in row major order.
+/// Expressions with packet access are evaluated a packet of the native width
+/// at a time, other row major expressions through operator[] and the rest
+/// through operator()
+template <typename TExpressionType, typename TDataType,
+    bool TPacketAccess = HasPacketAccess<TExpressionType>::value>
+struct ExpressionEvaluator {
+    static void evaluate(
+        TExpressionType const& TheExpression, TDataType* pResult) {
+        for (std::size_t i = 0; i < TheExpression.size1(); i++)
+            for (std::size_t j = 0; j < TheExpression.size2(); j++)
+                *(pResult++) = TheExpression(i, j);
+    }
+};
+
+/// Dynamic expressions with at least this many elements are evaluated in
+/// parallel, in chunks of whole pages
+constexpr std::size_t parallel_evaluation_minimum_size = 1 << 16;
+
+/// Bytes of the pages which are split between the threads
+constexpr std::size_t evaluation_page_bytes = 4096;
+
+template <typename TExpressionType, typename TDataType>
+struct ExpressionEvaluator<TExpressionType, TDataType, true> {
+    static constexpr std::size_t width = NativePacketWidth<TDataType>::value;
+
+    static void evaluate(
+        TExpressionType const& TheExpression, TDataType* pResult) {
+        evaluate(TheExpression, pResult,
+            std::is_same<typename TExpressionType::data_type, TDataType>());
+    }
+
+    static void evaluate(TExpressionType const& TheExpression,
+        TDataType* pResult, std::true_type /* IsSameType */) {
+        evaluate_packets(TheExpression, pResult,
+            std::integral_constant<bool,
+                StaticSizeTraits<TExpressionType>::size1 != dynamic &&
+                    StaticSizeTraits<TExpressionType>::size2 != dynamic>());
+    }
+
+    static void evaluate(TExpressionType const& TheExpression,
+        TDataType* pResult, std::false_type /* IsSameType */) {
+        for (std::size_t i = 0; i < TheExpression.size(); i++)
+            pResult[i] = TheExpression[i];
+    }
+
+   private:
+    static void evaluate_packets(TExpressionType const& TheExpression,
+        TDataType* pResult, std::true_type /* IsFixedSize */) {
+        evaluate_range(TheExpression, pResult, 0, TheExpression.size());
+    }
+
+    /// Large outputs are split into chunks of whole pages, one per thread.
+    /// The chunks only depend on the size and the number of threads, so a
+    /// new matrix which is evaluated in parallel gets its pages first
+    /// touched, and thus placed on the NUMA node, by the thread which
+    /// evaluates the same chunk the next time. Outputs which do not fit
+    /// into the last level cache are streamed past it
+    static void evaluate_packets(TExpressionType const& TheExpression,
+        TDataType* pResult, std::false_type /* IsFixedSize */) {
+        const std::size_t size = TheExpression.size();
+        if (size < parallel_evaluation_minimum_size) {
+            evaluate_range(TheExpression, pResult, 0, size);
+            return;
+        }
+
+        const bool is_streamed =
+            size * sizeof(TDataType) >= GetStreamingStoreBytes();
+        constexpr std::size_t page_size =
+            evaluation_page_bytes / sizeof(TDataType);
+        const std::size_t number_of_pages = (size + page_size - 1) / page_size;
+        ParallelFor(0, number_of_pages,
+            parallel_evaluation_minimum_size / page_size,
+            [&](std::size_t PageBegin, std::size_t PageEnd) {
+                const std::size_t end = std::min(PageEnd * page_size, size);
+                if (is_streamed)
+                    stream_range(
+                        TheExpression, pResult, PageBegin * page_size, end);
+                else
+                    evaluate_range(
+                        TheExpression, pResult, PageBegin * page_size, end);
+            });
+    }
+
+    static void evaluate_range(TExpressionType const& TheExpression,
+        TDataType* pResult, std::size_t Begin, std::size_t End) {
+        const std::size_t packet_end = End - (End - Begin) % width;
+        for (std::size_t i = Begin; i < packet_end; i += width)
+            TheExpression.template packet<width>(i).store_unaligned(
+                pResult + i);
+        for (std::size_t i = packet_end; i < End; i++)
+            pResult[i] = TheExpression[i];
+    }
+
+    /// Non-temporal stores need aligned packets, the elements before the
+    /// first aligned one are stored one by one
+    static void stream_range(TExpressionType const& TheExpression,
+        TDataType* pResult, std::size_t Begin, std::size_t End) {
+        constexpr std::size_t packet_bytes = width * sizeof(TDataType);
+        std::size_t i = Begin;
+        for (; i < End &&
+               reinterpret_cast<std::uintptr_t>(pResult + i) % packet_bytes;
+             i++)
+            pResult[i] = TheExpression[i];
+        for (; i + width <= End; i += width)
+            StreamStore(
+                TheExpression.template packet<width>(i), pResult + i);
+        for (; i < End; i++)
+            pResult[i] = TheExpression[i];
+        StreamFence();
+    }
+};
+
+/// Zeros are filled with std::fill_n in the same chunks of pages as the
+/// other large expressions. The chunks only capture the destination, since
+/// a captured expression escapes into the executor and GCC then reloads its
+/// sizes after the allocation of the destination, and warns about the
+/// packet stores of small matrices
+template <typename TDataType>
+struct ExpressionEvaluator<ZeroMatrix<TDataType>, TDataType, true> {
+    static void evaluate(
+        ZeroMatrix<TDataType> const& TheExpression, TDataType* pResult) {
+        const std::size_t size = TheExpression.size();
+        if (size < parallel_evaluation_minimum_size) {
+            std::fill_n(pResult, size, TDataType());
+            return;
+        }
+
+        constexpr std::size_t page_size =
+            evaluation_page_bytes / sizeof(TDataType);
+        const std::size_t number_of_pages = (size + page_size - 1) / page_size;
+        ParallelFor(0, number_of_pages,
+            parallel_evaluation_minimum_size / page_size,
+            [pResult, size](std::size_t PageBegin, std::size_t PageEnd) {
+                const std::size_t end = std::min(PageEnd * page_size, size);
+                std::fill_n(pResult + PageBegin * page_size,
+                    end - PageBegin * page_size, TDataType());
+            });
+    }
+};
+
+/// The triangular and symmetric products are computed element by element
+/// when they are evaluated, which is counted as their product
+template <typename TTriangularType, typename TExpressionType,
+    typename TDataType>
+struct ExpressionEvaluator<
+    TriangularMatrixProductExpression<TTriangularType, TExpressionType>,
+    TDataType, false> {
+    static void evaluate(TriangularMatrixProductExpression<TTriangularType,
+                             TExpressionType> const& TheExpression,
+        TDataType* pResult) {
+        AMATRIX_COUNT_OPERATION(
+            product, TheExpression.size1(), TheExpression.size2());
+        for (std::size_t i = 0; i < TheExpression.size1(); i++)
+            for (std::size_t j = 0; j < TheExpression.size2(); j++)
+                *(pResult++) = TheExpression(i, j);
+    }
+};
+
+template <typename TSymmetricType, typename TExpressionType,
+    typename TDataType>
+struct ExpressionEvaluator<
+    SymmetricMatrixProductExpression<TSymmetricType, TExpressionType>,
+    TDataType, false> {
+    static void evaluate(SymmetricMatrixProductExpression<TSymmetricType,
+                             TExpressionType> const& TheExpression,
+        TDataType* pResult) {
+        AMATRIX_COUNT_OPERATION(
+            product, TheExpression.size1(), TheExpression.size2());
+        for (std::size_t i = 0; i < TheExpression.size1(); i++)
+            for (std::size_t j = 0; j < TheExpression.size2(); j++)
+                *(pResult++) = TheExpression(i, j);
+    }
+};
+
+template <typename TExpressionType, typename TDataType>
+inline void EvaluateExpression(
+    TExpressionType const& TheExpression, TDataType* pResult) {
+    ExpressionEvaluator<TExpressionType, TDataType>::evaluate(
+        TheExpression, pResult);
+}
+
 }  // namespace AMatrix
\ No newline at end of file
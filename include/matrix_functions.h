@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "matrix.h"
+
+namespace AMatrix {
+
+/// Maximum absolute row sum of a square matrix. It is used as a cheap
+/// estimate of the spectral radius for scaling and convergence checks
+template <typename TDataType, std::size_t TSize>
+TDataType MaxRowSumNorm(Matrix<TDataType, TSize, TSize> const& TheMatrix) {
+    TDataType result = TDataType();
+    for (std::size_t i = 0; i < TSize; i++) {
+        TDataType row_sum = TDataType();
+        for (std::size_t j = 0; j < TSize; j++)
+            row_sum += std::abs(TheMatrix(i, j));
+        if (row_sum > result)
+            result = row_sum;
+    }
+    return result;
+}
+
+/// Inverse of a fixed size matrix. The factorization works on a copy with a
+/// fixed size permutation vector so no heap allocation is performed.
+/// The determinant of the matrix is stored in rDeterminant
+template <typename TDataType, std::size_t TSize>
+Matrix<TDataType, TSize, TSize> MatrixInverse(
+    Matrix<TDataType, TSize, TSize> const& TheMatrix,
+    TDataType& rDeterminant) {
+    Matrix<TDataType, TSize, TSize> lu_matrix(TheMatrix);
+    LUFactorization<Matrix<TDataType, TSize, TSize>,
+        Matrix<std::size_t, TSize, 1>>
+        lu_factorization(lu_matrix);
+    rDeterminant = lu_factorization.determinant();
+    return lu_factorization.inverse();
+}
+
+template <typename TDataType, std::size_t TSize>
+Matrix<TDataType, TSize, TSize> MatrixInverse(
+    Matrix<TDataType, TSize, TSize> const& TheMatrix) {
+    TDataType determinant;
+    return MatrixInverse(TheMatrix, determinant);
+}
+
+/// Matrix exponential using the scaling and squaring method with a
+/// diagonal Pade approximant of degree 6. The algorithm is based on
+/// Golub and Van Loan, Matrix Computations, Algorithm 11.3.1
+template <typename TDataType, std::size_t TSize>
+Matrix<TDataType, TSize, TSize> MatrixExponential(
+    Matrix<TDataType, TSize, TSize> const& TheMatrix) {
+    using matrix_type = Matrix<TDataType, TSize, TSize>;
+    constexpr std::size_t pade_degree = 6;
+
+    const TDataType the_norm = MaxRowSumNorm(TheMatrix);
+    int number_of_squarings = 0;
+    if (the_norm > TDataType(0.5))
+        number_of_squarings =
+            std::max(0, static_cast<int>(std::ceil(std::log2(the_norm))) + 1);
+
+    const TDataType scale = std::ldexp(TDataType(1), -number_of_squarings);
+    matrix_type scaled(TheMatrix);
+    scaled *= scale;
+
+    matrix_type numerator((IdentityMatrix<TDataType>(TSize)));
+    matrix_type denominator((IdentityMatrix<TDataType>(TSize)));
+    matrix_type power((IdentityMatrix<TDataType>(TSize)));
+    TDataType coefficient = TDataType(1);
+    TDataType sign = TDataType(1);
+
+    for (std::size_t k = 1; k <= pade_degree; k++) {
+        coefficient *= TDataType(pade_degree - k + 1) /
+                       TDataType((2 * pade_degree - k + 1) * k);
+        power = matrix_type(scaled * power);
+        sign = -sign;
+        numerator += coefficient * power;
+        if (sign > TDataType())
+            denominator += coefficient * power;
+        else
+            denominator -= coefficient * power;
+    }
+
+    matrix_type result(MatrixInverse(denominator) * numerator);
+
+    for (int i = 0; i < number_of_squarings; i++)
+        result = matrix_type(result * result);
+
+    return result;
+}
+
+/// Principal square root of a matrix without eigenvalues on the closed
+/// negative real axis, e.g. a symmetric positive definite matrix, computed
+/// by the determinant scaled Denman-Beavers iteration
+template <typename TDataType, std::size_t TSize>
+Matrix<TDataType, TSize, TSize> MatrixSquareRoot(
+    Matrix<TDataType, TSize, TSize> const& TheMatrix) {
+    using matrix_type = Matrix<TDataType, TSize, TSize>;
+    constexpr std::size_t maximum_iterations = 100;
+    const TDataType tolerance =
+        10 * TSize * std::numeric_limits<TDataType>::epsilon();
+
+    matrix_type y(TheMatrix);
+    matrix_type z((IdentityMatrix<TDataType>(TSize)));
+
+    for (std::size_t iteration = 0; iteration < maximum_iterations;
+         iteration++) {
+        TDataType y_determinant;
+        TDataType z_determinant;
+        matrix_type y_inverse = MatrixInverse(y, y_determinant);
+        matrix_type z_inverse = MatrixInverse(z, z_determinant);
+
+        TDataType gamma = std::pow(std::abs(y_determinant * z_determinant),
+            TDataType(-1) / TDataType(2 * TSize));
+        if (!(gamma > TDataType()) || !std::isfinite(gamma))
+            gamma = TDataType(1);
+
+        matrix_type new_y(
+            TDataType(0.5) * (gamma * y + (TDataType(1) / gamma) * z_inverse));
+        z = matrix_type(
+            TDataType(0.5) * (gamma * z + (TDataType(1) / gamma) * y_inverse));
+
+        const TDataType change = MaxRowSumNorm(matrix_type(new_y - y));
+        y = new_y;
+        if (change <= tolerance * MaxRowSumNorm(y))
+            break;
+    }
+
+    return y;
+}
+
+/// Polar decomposition F = R U of a non-singular matrix where R is
+/// orthogonal and U is symmetric positive definite. The orthogonal factor is
+/// computed by the determinant scaled Newton iteration (Higham, Functions of
+/// Matrices, Chapter 8) and U = R^T F is symmetrized afterwards
+template <typename TDataType, std::size_t TSize>
+void PolarDecomposition(Matrix<TDataType, TSize, TSize> const& F,
+    Matrix<TDataType, TSize, TSize>& rR, Matrix<TDataType, TSize, TSize>& rU) {
+    using matrix_type = Matrix<TDataType, TSize, TSize>;
+    constexpr std::size_t maximum_iterations = 100;
+    const TDataType tolerance =
+        10 * TSize * std::numeric_limits<TDataType>::epsilon();
+
+    rR = F;
+    for (std::size_t iteration = 0; iteration < maximum_iterations;
+         iteration++) {
+        TDataType determinant;
+        matrix_type inverse = MatrixInverse(rR, determinant);
+
+        TDataType gamma = std::pow(
+            std::abs(determinant), TDataType(-1) / TDataType(TSize));
+        if (!(gamma > TDataType()) || !std::isfinite(gamma))
+            gamma = TDataType(1);
+
+        matrix_type new_r(TDataType(0.5) *
+                          (gamma * rR + (TDataType(1) / gamma) *
+                                            matrix_type(inverse.transpose())));
+
+        const TDataType change = MaxRowSumNorm(matrix_type(new_r - rR));
+        rR = new_r;
+        if (change <= tolerance * MaxRowSumNorm(rR))
+            break;
+    }
+
+    matrix_type u(rR.transpose() * F);
+    rU = matrix_type(TDataType(0.5) * (u + u.transpose()));
+}
+
+}  // namespace AMatrix
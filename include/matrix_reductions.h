@@ -0,0 +1,817 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include "matrix_expression.h"
+#include "parallel.h"
+
+namespace AMatrix {
+
+// Summation algorithms of the reductions
+constexpr std::size_t fast_summation = 0;
+constexpr std::size_t pairwise_summation = 1;
+constexpr std::size_t kahan_summation = 2;
+
+/// Number of elements below which the pairwise summation adds directly
+constexpr std::size_t pairwise_summation_block_size = 128;
+
+/// Minimum number of elements of a row major reduction before it is split
+/// into chunks which are summed in parallel
+constexpr std::size_t reduction_parallel_threshold = 1 << 18;
+
+/// Chunk size of the reproducible reductions. It does not depend on the
+/// number of threads so the partial sums are always the same
+constexpr std::size_t reproducible_reduction_chunk_size = 1 << 14;
+
+/// Reads the elements of an expression row by row. Row major expressions are
+/// read as a single row through operator[] which avoids the index
+/// computation of operator()(i, j)
+template <typename TExpressionType,
+    bool TIsLinear = (TExpressionType::category == row_major_access)>
+class ExpressionReader {
+    TExpressionType const& _expression;
+
+   public:
+    using data_type = typename TExpressionType::data_type;
+
+    ExpressionReader(TExpressionType const& TheExpression)
+        : _expression(TheExpression) {}
+
+    inline std::size_t number_of_rows() const { return _expression.size1(); }
+
+    inline std::size_t row_size() const { return _expression.size2(); }
+
+    inline data_type operator()(std::size_t i, std::size_t j) const {
+        return _expression(i, j);
+    }
+};
+
+template <typename TExpressionType>
+class ExpressionReader<TExpressionType, true> {
+    TExpressionType const& _expression;
+
+   public:
+    using data_type = typename TExpressionType::data_type;
+
+    ExpressionReader(TExpressionType const& TheExpression)
+        : _expression(TheExpression) {}
+
+    inline std::size_t number_of_rows() const { return 1; }
+
+    inline std::size_t row_size() const {
+        return _expression.size1() * _expression.size2();
+    }
+
+    inline data_type operator()(std::size_t i, std::size_t j) const {
+        return _expression[j];
+    }
+};
+
+/// Element by element product of two readers with the same layout
+template <typename TReader1Type, typename TReader2Type>
+class ProductReader {
+    TReader1Type _first;
+    TReader2Type _second;
+
+   public:
+    using data_type = typename TReader1Type::data_type;
+
+    ProductReader(TReader1Type const& First, TReader2Type const& Second)
+        : _first(First), _second(Second) {}
+
+    inline std::size_t number_of_rows() const {
+        return _first.number_of_rows();
+    }
+
+    inline std::size_t row_size() const { return _first.row_size(); }
+
+    inline data_type operator()(std::size_t i, std::size_t j) const {
+        return _first(i, j) * _second(i, j);
+    }
+};
+
+/// Element by element product of the conjugated elements of a contiguous
+/// complex array with the ones of a second array. FastSum uses the
+/// dispatched conjugate dot kernel for it
+template <typename TDataType>
+class ContiguousConjugateProductReader {
+    TDataType const* _p_first;
+    TDataType const* _p_second;
+    std::size_t _size;
+
+   public:
+    using data_type = TDataType;
+
+    ContiguousConjugateProductReader(
+        TDataType const* pFirst, TDataType const* pSecond, std::size_t Size)
+        : _p_first(pFirst), _p_second(pSecond), _size(Size) {}
+
+    inline std::size_t number_of_rows() const { return 1; }
+
+    inline std::size_t row_size() const { return _size; }
+
+    inline data_type operator()(std::size_t i, std::size_t j) const {
+        return std::conj(_p_first[j]) * _p_second[j];
+    }
+
+    TDataType const* first_data() const { return _p_first; }
+
+    TDataType const* second_data() const { return _p_second; }
+};
+
+/// Conjugated elements of a reader
+template <typename TReaderType>
+class ConjugateReader {
+    TReaderType _reader;
+
+   public:
+    using data_type = typename TReaderType::data_type;
+
+    ConjugateReader(TReaderType const& Reader) : _reader(Reader) {}
+
+    inline std::size_t number_of_rows() const {
+        return _reader.number_of_rows();
+    }
+
+    inline std::size_t row_size() const { return _reader.row_size(); }
+
+    inline data_type operator()(std::size_t i, std::size_t j) const {
+        return NumericTraits<data_type>::conjugate(_reader(i, j));
+    }
+};
+
+/// Element by element product of two contiguous arrays, read as one row
+/// and converted to TAccumulatorType. FastSum uses the dispatched dot
+/// kernels for it
+template <typename TDataType, typename TAccumulatorType = TDataType>
+class ContiguousProductReader {
+    TDataType const* _p_first;
+    TDataType const* _p_second;
+    std::size_t _size;
+
+   public:
+    using data_type = TAccumulatorType;
+
+    ContiguousProductReader(
+        TDataType const* pFirst, TDataType const* pSecond, std::size_t Size)
+        : _p_first(pFirst), _p_second(pSecond), _size(Size) {}
+
+    inline std::size_t number_of_rows() const { return 1; }
+
+    inline std::size_t row_size() const { return _size; }
+
+    inline data_type operator()(std::size_t i, std::size_t j) const {
+        return static_cast<data_type>(_p_first[j]) *
+               static_cast<data_type>(_p_second[j]);
+    }
+
+    TDataType const* first_data() const { return _p_first; }
+
+    TDataType const* second_data() const { return _p_second; }
+};
+
+/// Element by element product of two arrays with their elements StrideX
+/// and StrideY apart, read as one row. FastSum uses the dispatched strided
+/// dot kernels for it
+template <typename TDataType>
+class StridedProductReader {
+    TDataType const* _p_first;
+    TDataType const* _p_second;
+    std::size_t _first_stride;
+    std::size_t _second_stride;
+    std::size_t _size;
+
+   public:
+    using data_type = TDataType;
+
+    StridedProductReader(TDataType const* pFirst, std::size_t FirstStride,
+        TDataType const* pSecond, std::size_t SecondStride, std::size_t Size)
+        : _p_first(pFirst),
+          _p_second(pSecond),
+          _first_stride(FirstStride),
+          _second_stride(SecondStride),
+          _size(Size) {}
+
+    inline std::size_t number_of_rows() const { return 1; }
+
+    inline std::size_t row_size() const { return _size; }
+
+    inline data_type operator()(std::size_t i, std::size_t j) const {
+        return _p_first[j * _first_stride] * _p_second[j * _second_stride];
+    }
+
+    TDataType const* first_data() const { return _p_first; }
+
+    TDataType const* second_data() const { return _p_second; }
+
+    std::size_t first_stride() const { return _first_stride; }
+
+    std::size_t second_stride() const { return _second_stride; }
+};
+
+/// Elements of a reader converted to TAccumulatorType
+template <typename TReaderType, typename TAccumulatorType>
+class ConvertReader {
+    TReaderType _reader;
+
+   public:
+    using data_type = TAccumulatorType;
+
+    ConvertReader(TReaderType const& Reader) : _reader(Reader) {}
+
+    inline std::size_t number_of_rows() const {
+        return _reader.number_of_rows();
+    }
+
+    inline std::size_t row_size() const { return _reader.row_size(); }
+
+    inline data_type operator()(std::size_t i, std::size_t j) const {
+        return static_cast<data_type>(_reader(i, j));
+    }
+};
+
+/// Absolute value of the elements of a reader, optionally scaled. The
+/// values are real also for complex elements
+template <typename TReaderType>
+class AbsoluteReader {
+    using real_type =
+        typename NumericTraits<typename TReaderType::data_type>::real_type;
+
+    TReaderType _reader;
+    real_type _scale;
+
+   public:
+    using data_type = real_type;
+
+    AbsoluteReader(TReaderType const& Reader, data_type Scale = data_type(1))
+        : _reader(Reader), _scale(Scale) {}
+
+    inline std::size_t number_of_rows() const {
+        return _reader.number_of_rows();
+    }
+
+    inline std::size_t row_size() const { return _reader.row_size(); }
+
+    inline data_type operator()(std::size_t i, std::size_t j) const {
+        return std::abs(_scale * _reader(i, j));
+    }
+};
+
+/// Sum with four independent accumulators which breaks the dependency chain
+/// of the additions and lets the compiler keep them in vector registers
+template <typename TReaderType>
+typename TReaderType::data_type FastSum(TReaderType const& Reader,
+    std::size_t RowBegin, std::size_t RowEnd, std::size_t ColumnBegin,
+    std::size_t ColumnEnd) {
+    using data_type = typename TReaderType::data_type;
+    data_type sum[4] = {data_type(), data_type(), data_type(), data_type()};
+    const std::size_t unrolled_end =
+        ColumnBegin + (ColumnEnd - ColumnBegin) / 4 * 4;
+    for (std::size_t i = RowBegin; i < RowEnd; i++) {
+        std::size_t j = ColumnBegin;
+        for (; j < unrolled_end; j += 4) {
+            sum[0] += Reader(i, j);
+            sum[1] += Reader(i, j + 1);
+            sum[2] += Reader(i, j + 2);
+            sum[3] += Reader(i, j + 3);
+        }
+        for (; j < ColumnEnd; j++)
+            sum[0] += Reader(i, j);
+    }
+    return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
+
+/// Sums the products with the dot kernels, in packets of accumulators
+template <typename TDataType>
+TDataType FastSum(ContiguousProductReader<TDataType, TDataType> const& Reader,
+    std::size_t RowBegin, std::size_t RowEnd, std::size_t ColumnBegin,
+    std::size_t ColumnEnd) {
+    if (RowBegin == RowEnd)
+        return TDataType();
+    const std::size_t size = ColumnEnd - ColumnBegin;
+    TDataType const* p_first = Reader.first_data() + ColumnBegin;
+    TDataType const* p_second = Reader.second_data() + ColumnBegin;
+    if (size < dispatch_minimum_size)
+        return GenericKernels::dot(size, p_first, p_second);
+    return DispatchedDot(size, p_first, p_second);
+}
+
+/// Sums the products of strided arrays with the strided dot kernels
+template <typename TDataType>
+TDataType FastSum(StridedProductReader<TDataType> const& Reader,
+    std::size_t RowBegin, std::size_t RowEnd, std::size_t ColumnBegin,
+    std::size_t ColumnEnd) {
+    if (RowBegin == RowEnd)
+        return TDataType();
+    const std::size_t size = ColumnEnd - ColumnBegin;
+    TDataType const* p_first =
+        Reader.first_data() + ColumnBegin * Reader.first_stride();
+    TDataType const* p_second =
+        Reader.second_data() + ColumnBegin * Reader.second_stride();
+    if (size < dispatch_minimum_size)
+        return GenericKernels::strided_dot(size, p_first,
+            Reader.first_stride(), p_second, Reader.second_stride());
+    return DispatchedStridedDot(size, p_first, Reader.first_stride(),
+        p_second, Reader.second_stride());
+}
+
+/// Sums the products in the wider accumulator type with the accumulated dot
+/// kernels
+template <typename TDataType, typename TAccumulatorType>
+TAccumulatorType FastSum(
+    ContiguousProductReader<TDataType, TAccumulatorType> const& Reader,
+    std::size_t RowBegin, std::size_t RowEnd, std::size_t ColumnBegin,
+    std::size_t ColumnEnd) {
+    if (RowBegin == RowEnd)
+        return TAccumulatorType();
+    const std::size_t size = ColumnEnd - ColumnBegin;
+    TDataType const* p_first = Reader.first_data() + ColumnBegin;
+    TDataType const* p_second = Reader.second_data() + ColumnBegin;
+    if (size < dispatch_minimum_size)
+        return GenericKernels::accumulated_dot<TAccumulatorType>(
+            size, p_first, p_second);
+    return DispatchedAccumulatedDot<TAccumulatorType>(
+        size, p_first, p_second);
+}
+
+/// Sums the conjugated products with the conjugate dot kernel
+template <typename TDataType>
+TDataType FastSum(ContiguousConjugateProductReader<TDataType> const& Reader,
+    std::size_t RowBegin, std::size_t RowEnd, std::size_t ColumnBegin,
+    std::size_t ColumnEnd) {
+    if (RowBegin == RowEnd)
+        return TDataType();
+    return DispatchedConjugateDot(ColumnEnd - ColumnBegin,
+        Reader.first_data() + ColumnBegin, Reader.second_data() + ColumnBegin);
+}
+
+/// Pairwise (cascade) summation. The rows and then the columns are halved
+/// until a block is small enough for FastSum, which bounds the error growth
+/// by O(log(n)) instead of O(n)
+template <typename TReaderType>
+typename TReaderType::data_type PairwiseSum(TReaderType const& Reader,
+    std::size_t RowBegin, std::size_t RowEnd, std::size_t ColumnBegin,
+    std::size_t ColumnEnd) {
+    if (RowEnd - RowBegin > 1) {
+        const std::size_t middle = RowBegin + (RowEnd - RowBegin) / 2;
+        return PairwiseSum(Reader, RowBegin, middle, ColumnBegin, ColumnEnd) +
+               PairwiseSum(Reader, middle, RowEnd, ColumnBegin, ColumnEnd);
+    }
+    if (ColumnEnd - ColumnBegin > pairwise_summation_block_size) {
+        const std::size_t middle =
+            ColumnBegin + (ColumnEnd - ColumnBegin) / 2;
+        return PairwiseSum(Reader, RowBegin, RowEnd, ColumnBegin, middle) +
+               PairwiseSum(Reader, RowBegin, RowEnd, middle, ColumnEnd);
+    }
+    return FastSum(Reader, RowBegin, RowEnd, ColumnBegin, ColumnEnd);
+}
+
+/// Compensated summation with the Neumaier variant of the Kahan algorithm.
+/// Four independent compensated accumulators are used to keep some
+/// instruction level parallelism
+template <typename TReaderType>
+typename TReaderType::data_type KahanSum(TReaderType const& Reader,
+    std::size_t RowBegin, std::size_t RowEnd, std::size_t ColumnBegin,
+    std::size_t ColumnEnd) {
+    using data_type = typename TReaderType::data_type;
+    data_type sum[4] = {data_type(), data_type(), data_type(), data_type()};
+    data_type compensation[4] = {
+        data_type(), data_type(), data_type(), data_type()};
+
+    auto add = [&sum, &compensation](std::size_t Lane, data_type Value) {
+        const data_type new_sum = sum[Lane] + Value;
+        if (std::abs(sum[Lane]) >= std::abs(Value))
+            compensation[Lane] += (sum[Lane] - new_sum) + Value;
+        else
+            compensation[Lane] += (Value - new_sum) + sum[Lane];
+        sum[Lane] = new_sum;
+    };
+
+    const std::size_t unrolled_end =
+        ColumnBegin + (ColumnEnd - ColumnBegin) / 4 * 4;
+    for (std::size_t i = RowBegin; i < RowEnd; i++) {
+        std::size_t j = ColumnBegin;
+        for (; j < unrolled_end; j += 4) {
+            add(0, Reader(i, j));
+            add(1, Reader(i, j + 1));
+            add(2, Reader(i, j + 2));
+            add(3, Reader(i, j + 3));
+        }
+        for (; j < ColumnEnd; j++)
+            add(0, Reader(i, j));
+    }
+
+    for (std::size_t lane = 1; lane < 4; lane++) {
+        add(0, sum[lane]);
+        add(0, compensation[lane]);
+    }
+    return sum[0] + compensation[0];
+}
+
+template <std::size_t TSummation, typename TReaderType>
+typename TReaderType::data_type BlockSum(TReaderType const& Reader,
+    std::size_t RowBegin, std::size_t RowEnd, std::size_t ColumnBegin,
+    std::size_t ColumnEnd) {
+    if (TSummation == kahan_summation)
+        return KahanSum(Reader, RowBegin, RowEnd, ColumnBegin, ColumnEnd);
+    if (TSummation == pairwise_summation)
+        return PairwiseSum(Reader, RowBegin, RowEnd, ColumnBegin, ColumnEnd);
+    return FastSum(Reader, RowBegin, RowEnd, ColumnBegin, ColumnEnd);
+}
+
+/// Adds the partial sums of the chunks with a tree whose shape only depends
+/// on their number
+template <typename TDataType>
+TDataType CombinePartialSums(
+    std::vector<TDataType> const& PartialSums, std::size_t Begin, std::size_t End) {
+    if (End - Begin == 1)
+        return PartialSums[Begin];
+    const std::size_t middle = Begin + (End - Begin) / 2;
+    return CombinePartialSums(PartialSums, Begin, middle) +
+           CombinePartialSums(PartialSums, middle, End);
+}
+
+/// Sum of a long single row reader split into chunks which are summed in
+/// parallel. The default uses one chunk per thread. In the reproducible mode
+/// the chunks have a fixed size and the partial sums are combined by a fixed
+/// tree, so the result is independent of the number of threads and of the
+/// scheduling
+template <std::size_t TSummation, typename TReaderType>
+typename TReaderType::data_type ParallelRowSum(TReaderType const& Reader) {
+    using data_type = typename TReaderType::data_type;
+    const std::size_t row_size = Reader.row_size();
+
+    std::size_t chunk_size = reproducible_reduction_chunk_size;
+    if (!GetReproducibleReductions()) {
+        const std::size_t number_of_threads = GetParallelism();
+        if (number_of_threads < 2)
+            return BlockSum<TSummation>(Reader, 0, 1, 0, row_size);
+        chunk_size = (row_size + number_of_threads - 1) / number_of_threads;
+    }
+
+    const std::size_t number_of_chunks =
+        (row_size + chunk_size - 1) / chunk_size;
+    std::vector<data_type> partial_sums(number_of_chunks);
+    ParallelFor(0, number_of_chunks, 1,
+        [&](std::size_t ChunkBegin, std::size_t ChunkEnd) {
+            for (std::size_t chunk = ChunkBegin; chunk < ChunkEnd; chunk++) {
+                const std::size_t column_begin = chunk * chunk_size;
+                const std::size_t column_end =
+                    std::min(column_begin + chunk_size, row_size);
+                partial_sums[chunk] = BlockSum<TSummation>(
+                    Reader, 0, 1, column_begin, column_end);
+            }
+        });
+
+    if (TSummation == kahan_summation) {
+        data_type sum = data_type();
+        data_type compensation = data_type();
+        for (auto partial_sum : partial_sums) {
+            const data_type new_sum = sum + partial_sum;
+            if (std::abs(sum) >= std::abs(partial_sum))
+                compensation += (sum - new_sum) + partial_sum;
+            else
+                compensation += (partial_sum - new_sum) + sum;
+            sum = new_sum;
+        }
+        return sum + compensation;
+    }
+    return CombinePartialSums(partial_sums, 0, number_of_chunks);
+}
+
+template <std::size_t TSummation, typename TReaderType>
+typename TReaderType::data_type ReaderSum(TReaderType const& Reader) {
+    const std::size_t number_of_rows = Reader.number_of_rows();
+    const std::size_t row_size = Reader.row_size();
+    if (number_of_rows == 1 && row_size >= reduction_parallel_threshold)
+        return ParallelRowSum<TSummation>(Reader);
+    return BlockSum<TSummation>(Reader, 0, number_of_rows, 0, row_size);
+}
+
+/// Maximum (or minimum with TIsMinimum) of the elements of a reader
+template <bool TIsMinimum, typename TReaderType>
+typename TReaderType::data_type ReaderExtremum(TReaderType const& Reader) {
+    using data_type = typename TReaderType::data_type;
+    const std::size_t number_of_rows = Reader.number_of_rows();
+    const std::size_t row_size = Reader.row_size();
+    if (number_of_rows == 0 || row_size == 0)
+        return data_type();
+
+    data_type result[4];
+    for (std::size_t lane = 0; lane < 4; lane++)
+        result[lane] = Reader(0, 0);
+
+    auto update = [&result](std::size_t Lane, data_type Value) {
+        if (TIsMinimum ? (Value < result[Lane]) : (Value > result[Lane]))
+            result[Lane] = Value;
+    };
+
+    const std::size_t unrolled_end = row_size / 4 * 4;
+    for (std::size_t i = 0; i < number_of_rows; i++) {
+        std::size_t j = 0;
+        for (; j < unrolled_end; j += 4) {
+            update(0, Reader(i, j));
+            update(1, Reader(i, j + 1));
+            update(2, Reader(i, j + 2));
+            update(3, Reader(i, j + 3));
+        }
+        for (; j < row_size; j++)
+            update(0, Reader(i, j));
+    }
+
+    for (std::size_t lane = 1; lane < 4; lane++)
+        update(0, result[lane]);
+    return result[0];
+}
+
+/// Sum of all elements of an expression
+template <std::size_t TSummation = fast_summation, typename TExpressionType,
+    std::size_t TCategory>
+typename TExpressionType::data_type Sum(
+    MatrixExpression<TExpressionType, TCategory> const& TheExpression) {
+    return ReaderSum<TSummation>(
+        ExpressionReader<TExpressionType>(TheExpression.expression()));
+}
+
+/// Largest element of an expression
+template <typename TExpressionType, std::size_t TCategory>
+typename TExpressionType::data_type Max(
+    MatrixExpression<TExpressionType, TCategory> const& TheExpression) {
+    return ReaderExtremum<false>(
+        ExpressionReader<TExpressionType>(TheExpression.expression()));
+}
+
+/// Smallest element of an expression
+template <typename TExpressionType, std::size_t TCategory>
+typename TExpressionType::data_type Min(
+    MatrixExpression<TExpressionType, TCategory> const& TheExpression) {
+    return ReaderExtremum<true>(
+        ExpressionReader<TExpressionType>(TheExpression.expression()));
+}
+
+/// Largest absolute value of the elements, which is the infinity norm of a
+/// vector
+template <typename TExpressionType, std::size_t TCategory>
+typename NumericTraits<typename TExpressionType::data_type>::real_type NormInf(
+    MatrixExpression<TExpressionType, TCategory> const& TheExpression) {
+    using reader_type = ExpressionReader<TExpressionType>;
+    return ReaderExtremum<false>(AbsoluteReader<reader_type>(
+        reader_type(TheExpression.expression())));
+}
+
+template <std::size_t TSummation, typename TExpression1Type,
+    typename TExpression2Type>
+typename TExpression1Type::data_type ExpressionDot(
+    TExpression1Type const& First, TExpression2Type const& Second,
+    std::true_type /* IsContiguous */) {
+    return ReaderSum<TSummation>(
+        ContiguousProductReader<typename TExpression1Type::data_type>(
+            First.data(), Second.data(), First.size()));
+}
+
+/// Distance of the elements of a strided view or of a contiguous expression
+template <typename TExpressionType>
+std::size_t ElementStride(
+    TExpressionType const& TheExpression, std::true_type /* IsStrided */) {
+    return TheExpression.stride();
+}
+
+template <typename TExpressionType>
+std::size_t ElementStride(
+    TExpressionType const& TheExpression, std::false_type /* IsStrided */) {
+    return 1;
+}
+
+template <std::size_t TSummation, typename TExpression1Type,
+    typename TExpression2Type>
+typename TExpression1Type::data_type ExpressionStridedDot(
+    TExpression1Type const& First, TExpression2Type const& Second,
+    std::true_type /* IsStrided */) {
+    return ReaderSum<TSummation>(
+        StridedProductReader<typename TExpression1Type::data_type>(
+            First.data(),
+            ElementStride(First, std::integral_constant<bool,
+                                     IsStrided<TExpression1Type>::value>()),
+            Second.data(),
+            ElementStride(Second, std::integral_constant<bool,
+                                      IsStrided<TExpression2Type>::value>()),
+            First.size()));
+}
+
+template <std::size_t TSummation, typename TExpression1Type,
+    typename TExpression2Type>
+typename TExpression1Type::data_type ExpressionStridedDot(
+    TExpression1Type const& First, TExpression2Type const& Second,
+    std::false_type /* IsStrided */) {
+    constexpr bool is_linear =
+        (TExpression1Type::category == row_major_access) &&
+        (TExpression2Type::category == row_major_access);
+    using reader1_type = ExpressionReader<TExpression1Type, is_linear>;
+    using reader2_type = ExpressionReader<TExpression2Type, is_linear>;
+    return ReaderSum<TSummation>(ProductReader<reader1_type, reader2_type>(
+        reader1_type(First), reader2_type(Second)));
+}
+
+template <std::size_t TSummation, typename TExpression1Type,
+    typename TExpression2Type>
+typename TExpression1Type::data_type ExpressionDot(
+    TExpression1Type const& First, TExpression2Type const& Second,
+    std::false_type /* IsContiguous */) {
+    using is_strided = std::integral_constant<bool,
+        (IsStrided<TExpression1Type>::value ||
+            IsStrided<TExpression2Type>::value) &&
+            (IsStrided<TExpression1Type>::value ||
+                IsContiguous<TExpression1Type>::value) &&
+            (IsStrided<TExpression2Type>::value ||
+                IsContiguous<TExpression2Type>::value) &&
+            std::is_same<typename TExpression1Type::data_type,
+                typename TExpression2Type::data_type>::value>;
+    return ExpressionStridedDot<TSummation>(First, Second, is_strided());
+}
+
+/// Sum of the element by element products of two expressions with the
+/// same size. Only when both are row major they are read through operator[],
+/// two dense matrices are read directly from their data and strided views,
+/// like columns, with gathers
+template <std::size_t TSummation = fast_summation, typename TExpression1Type,
+    std::size_t TCategory1, typename TExpression2Type, std::size_t TCategory2>
+typename TExpression1Type::data_type Dot(
+    MatrixExpression<TExpression1Type, TCategory1> const& First,
+    MatrixExpression<TExpression2Type, TCategory2> const& Second) {
+    using is_contiguous = std::integral_constant<bool,
+        IsContiguous<TExpression1Type>::value &&
+            IsContiguous<TExpression2Type>::value &&
+            std::is_same<typename TExpression1Type::data_type,
+                typename TExpression2Type::data_type>::value>;
+    return ExpressionDot<TSummation>(
+        First.expression(), Second.expression(), is_contiguous());
+}
+
+template <std::size_t TSummation, typename TExpression1Type,
+    typename TExpression2Type>
+typename TExpression1Type::data_type ExpressionConjugateDot(
+    TExpression1Type const& First, TExpression2Type const& Second,
+    std::true_type /* IsContiguousComplex */) {
+    return ReaderSum<TSummation>(
+        ContiguousConjugateProductReader<typename TExpression1Type::data_type>(
+            First.data(), Second.data(), First.size()));
+}
+
+template <std::size_t TSummation, typename TExpression1Type,
+    typename TExpression2Type>
+typename TExpression1Type::data_type ExpressionConjugateDot(
+    TExpression1Type const& First, TExpression2Type const& Second,
+    std::false_type /* IsContiguousComplex */) {
+    constexpr bool is_linear =
+        (TExpression1Type::category == row_major_access) &&
+        (TExpression2Type::category == row_major_access);
+    using reader1_type =
+        ConjugateReader<ExpressionReader<TExpression1Type, is_linear>>;
+    using reader2_type = ExpressionReader<TExpression2Type, is_linear>;
+    return ReaderSum<TSummation>(ProductReader<reader1_type, reader2_type>(
+        reader1_type(First), reader2_type(Second)));
+}
+
+/// Inner product sum(conj(a_i) * b_i) of complex expressions, like the BLAS
+/// dotc. It is the same as Dot for real expressions
+template <std::size_t TSummation = fast_summation, typename TExpression1Type,
+    std::size_t TCategory1, typename TExpression2Type, std::size_t TCategory2>
+typename TExpression1Type::data_type ConjugateDot(
+    MatrixExpression<TExpression1Type, TCategory1> const& First,
+    MatrixExpression<TExpression2Type, TCategory2> const& Second) {
+    using data_type = typename TExpression1Type::data_type;
+    if (!NumericTraits<data_type>::is_complex)
+        return Dot<TSummation>(First, Second);
+    using is_contiguous_complex = std::integral_constant<bool,
+        NumericTraits<data_type>::is_complex &&
+            IsContiguous<TExpression1Type>::value &&
+            IsContiguous<TExpression2Type>::value &&
+            std::is_same<data_type,
+                typename TExpression2Type::data_type>::value>;
+    return ExpressionConjugateDot<TSummation>(
+        First.expression(), Second.expression(), is_contiguous_complex());
+}
+
+/// Sum of the squared absolute values, real also for complex expressions
+template <std::size_t TSummation = fast_summation, typename TExpressionType,
+    std::size_t TCategory>
+typename NumericTraits<typename TExpressionType::data_type>::real_type
+SquaredNorm(MatrixExpression<TExpressionType, TCategory> const& TheExpression) {
+    using data_type = typename TExpressionType::data_type;
+    return NumericTraits<data_type>::real(
+        ConjugateDot<TSummation>(TheExpression, TheExpression));
+}
+
+/// Euclidean norm which does not overflow or underflow for representable
+/// results. The sum of squares is computed directly and only when it has
+/// overflowed or lost precision by underflow the elements are scaled by the
+/// inverse of the largest absolute value, as in the BLAS nrm2
+template <std::size_t TSummation = fast_summation, typename TExpressionType,
+    std::size_t TCategory>
+typename NumericTraits<typename TExpressionType::data_type>::real_type Norm(
+    MatrixExpression<TExpressionType, TCategory> const& TheExpression) {
+    using data_type =
+        typename NumericTraits<typename TExpressionType::data_type>::real_type;
+    const data_type squared_norm = SquaredNorm<TSummation>(TheExpression);
+
+    const data_type underflow_limit = std::numeric_limits<data_type>::min() /
+                                      std::numeric_limits<data_type>::epsilon();
+    if (squared_norm >= underflow_limit &&
+        squared_norm <= std::numeric_limits<data_type>::max())
+        return std::sqrt(squared_norm);
+
+    const data_type largest = NormInf(TheExpression);
+    if (largest == data_type() ||
+        !(largest <= std::numeric_limits<data_type>::max()))
+        return largest;  // zero, infinity or NaN
+
+    // The inverse of a subnormal scale would overflow
+    const data_type scale =
+        std::max(largest, std::numeric_limits<data_type>::min());
+
+    using reader_type = ExpressionReader<TExpressionType>;
+    const AbsoluteReader<reader_type> scaled(
+        reader_type(TheExpression.expression()), data_type(1) / scale);
+    return scale * std::sqrt(ReaderSum<TSummation>(
+                       ProductReader<AbsoluteReader<reader_type>,
+                           AbsoluteReader<reader_type>>(scaled, scaled)));
+}
+
+// Mixed precision reductions: the elements are stored in a narrow type like
+// float or BFloat16 and summed in the wider TAccumulatorType
+
+/// Sum of all elements accumulated in TAccumulatorType
+template <typename TAccumulatorType = double,
+    std::size_t TSummation = fast_summation, typename TExpressionType,
+    std::size_t TCategory>
+TAccumulatorType AccumulatedSum(
+    MatrixExpression<TExpressionType, TCategory> const& TheExpression) {
+    using reader_type = ExpressionReader<TExpressionType>;
+    return ReaderSum<TSummation>(ConvertReader<reader_type, TAccumulatorType>(
+        reader_type(TheExpression.expression())));
+}
+
+template <typename TAccumulatorType, std::size_t TSummation,
+    typename TExpression1Type, typename TExpression2Type>
+TAccumulatorType ExpressionAccumulatedDot(TExpression1Type const& First,
+    TExpression2Type const& Second, std::true_type /* IsContiguous */) {
+    return ReaderSum<TSummation>(
+        ContiguousProductReader<typename TExpression1Type::data_type,
+            TAccumulatorType>(First.data(), Second.data(), First.size()));
+}
+
+template <typename TAccumulatorType, std::size_t TSummation,
+    typename TExpression1Type, typename TExpression2Type>
+TAccumulatorType ExpressionAccumulatedDot(TExpression1Type const& First,
+    TExpression2Type const& Second, std::false_type /* IsContiguous */) {
+    constexpr bool is_linear =
+        (TExpression1Type::category == row_major_access) &&
+        (TExpression2Type::category == row_major_access);
+    using reader1_type = ConvertReader<
+        ExpressionReader<TExpression1Type, is_linear>, TAccumulatorType>;
+    using reader2_type = ConvertReader<
+        ExpressionReader<TExpression2Type, is_linear>, TAccumulatorType>;
+    return ReaderSum<TSummation>(ProductReader<reader1_type, reader2_type>(
+        reader1_type(First), reader2_type(Second)));
+}
+
+/// Dot product with the products and the sum in TAccumulatorType
+template <typename TAccumulatorType = double,
+    std::size_t TSummation = fast_summation, typename TExpression1Type,
+    std::size_t TCategory1, typename TExpression2Type, std::size_t TCategory2>
+TAccumulatorType AccumulatedDot(
+    MatrixExpression<TExpression1Type, TCategory1> const& First,
+    MatrixExpression<TExpression2Type, TCategory2> const& Second) {
+    using is_contiguous = std::integral_constant<bool,
+        IsContiguous<TExpression1Type>::value &&
+            IsContiguous<TExpression2Type>::value &&
+            std::is_same<typename TExpression1Type::data_type,
+                typename TExpression2Type::data_type>::value>;
+    return ExpressionAccumulatedDot<TAccumulatorType, TSummation>(
+        First.expression(), Second.expression(), is_contiguous());
+}
+
+template <typename TAccumulatorType = double,
+    std::size_t TSummation = fast_summation, typename TExpressionType,
+    std::size_t TCategory>
+TAccumulatorType AccumulatedSquaredNorm(
+    MatrixExpression<TExpressionType, TCategory> const& TheExpression) {
+    return AccumulatedDot<TAccumulatorType, TSummation>(
+        TheExpression, TheExpression);
+}
+
+/// Euclidean norm accumulated in TAccumulatorType. The squares of float
+/// elements can not overflow or underflow in double, so no scaling is needed
+template <typename TAccumulatorType = double,
+    std::size_t TSummation = fast_summation, typename TExpressionType,
+    std::size_t TCategory>
+TAccumulatorType AccumulatedNorm(
+    MatrixExpression<TExpressionType, TCategory> const& TheExpression) {
+    return std::sqrt(
+        AccumulatedSquaredNorm<TAccumulatorType, TSummation>(TheExpression));
+}
+
+}  // namespace AMatrix
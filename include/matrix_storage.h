@@ -45,6 +45,7 @@ class MatrixStorage : public DenseStorage<TDataType, TSize1 * TSize2> {
     }
 
     MatrixStorage& operator=(MatrixStorage const& Other) {
+        AMATRIX_COUNT_OPERATION(assignment, Other.size1(), Other.size2());
         base_type::operator=(Other);
         return *this;
     }
@@ -82,20 +83,20 @@ class MatrixStorage<TDataType, dynamic, dynamic> {
 
     MatrixStorage(std::size_t TheSize1, std::size_t TheSize2)
         : _size1(TheSize1), _size2(TheSize2) {
-        _data = new TDataType[size()];
+        _data = AllocateStorage<TDataType>(size());
     }
 
     explicit MatrixStorage(std::size_t TheSize1, std::size_t TheSize2,
         TDataType const& InitialValue)
         : _size1(TheSize1), _size2(TheSize2) {
-        _data = new TDataType[size()];
+        _data = AllocateStorage<TDataType>(size());
         for (std::size_t i = 0; i < size(); i++)
             _data[i] = InitialValue;
     }
 
     MatrixStorage(MatrixStorage const& Other)
         : _size1(Other.size1()), _size2(Other.size2()) {
-        _data = new TDataType[size()];
+        _data = AllocateStorage<TDataType>(size());
         for (std::size_t i = 0; i < size(); i++)
             _data[i] = Other._data[i];
     }
@@ -109,7 +110,7 @@ class MatrixStorage<TDataType, dynamic, dynamic> {
         : _size1(1), _size2(InitialValues.size()), _data(nullptr) {
         if (_size2 == 0)
             return;
-        _data = new TDataType[size()];
+        _data = AllocateStorage<TDataType>(size());
         std::size_t position = 0;
         for (auto& i : InitialValues) {
             _data[position++] = i;
@@ -131,45 +132,41 @@ class MatrixStorage<TDataType, dynamic, dynamic> {
         MatrixExpression<TExpressionType, row_major_access> const& Other)
         : _size1(Other.expression().size1()),
           _size2(Other.expression().size2()) {
-        _data = new TDataType[size()];
-        for (std::size_t i = 0; i < size(); i++)
-            _data[i] = Other.expression()[i];
+        _data = AllocateStorage<TDataType>(size());
+        EvaluateExpression(Other.expression(), _data);
     }
 
     template <typename TOtherMatrixType>
     explicit MatrixStorage(TOtherMatrixType const& Other)
         : _size1(Other.size1()), _size2(Other.size2()) {
-        _data = new TDataType[size()];
-        auto i_data = _data;
-        for (std::size_t i = 0; i < size1(); i++)
-            for (std::size_t j = 0; j < size2(); j++)
-                *(i_data++) = Other(i, j);
+        _data = AllocateStorage<TDataType>(size());
+        EvaluateExpression(Other, _data);
     }
 
     template <typename TExpressionType, std::size_t TCategory>
     MatrixStorage& operator=(
         MatrixExpression<TExpressionType, TCategory> const& Other) {
+        AMATRIX_COUNT_OPERATION(assignment, Other.expression().size1(),
+            Other.expression().size2());
         auto& other_expression = Other.expression();
         resize(other_expression.size1(), other_expression.size2());
-        auto i_data = _data;
-        for (std::size_t i = 0; i < size1(); i++)
-            for (std::size_t j = 0; j < size2(); j++)
-                *(i_data++) = other_expression(i, j);
+        EvaluateExpression(other_expression, _data);
         return *this;
     }
 
     template <typename TExpressionType>
     MatrixStorage& operator=(
         MatrixExpression<TExpressionType, row_major_access> const& Other) {
-        auto the_expression = Other.expression();
+        AMATRIX_COUNT_OPERATION(assignment, Other.expression().size1(),
+            Other.expression().size2());
+        auto& the_expression = Other.expression();
         resize(the_expression.size1(), the_expression.size2());
-        auto i_data = _data;
-        for (std::size_t i = 0; i < size(); i++)
-            *(i_data++) = the_expression[i];
+        EvaluateExpression(the_expression, _data);
         return *this;
     }
 
     MatrixStorage& operator=(MatrixStorage const& Other) {
+        AMATRIX_COUNT_OPERATION(assignment, Other.size1(), Other.size2());
         resize(Other.size1(), Other.size2());
         for (std::size_t i = 0; i < size(); i++)
             _data[i] = Other._data[i];
@@ -220,7 +217,7 @@ class MatrixStorage<TDataType, dynamic, dynamic> {
         std::size_t new_size = NewSize1 * NewSize2;
         if (size() != new_size) {
             delete[] _data;
-            _data = new TDataType[new_size];
+            _data = AllocateStorage<TDataType>(new_size);
         }
         _size1 = NewSize1;
         _size2 = NewSize2;
@@ -247,19 +244,19 @@ class MatrixStorage<TDataType, TSize1, dynamic> {
 
     MatrixStorage(std::size_t TheSize1, std::size_t TheSize2)
         : _size2(TheSize2) {
-        _data = new TDataType[size()];
+        _data = AllocateStorage<TDataType>(size());
     }
 
     explicit MatrixStorage(std::size_t TheSize1, std::size_t TheSize2,
         TDataType const& InitialValue)
         : _size2(TheSize2) {
-        _data = new TDataType[size()];
+        _data = AllocateStorage<TDataType>(size());
         for (std::size_t i = 0; i < size(); i++)
             _data[i] = InitialValue;
     }
 
     MatrixStorage(MatrixStorage const& Other) : _size2(Other.size2()) {
-        _data = new TDataType[size()];
+        _data = AllocateStorage<TDataType>(size());
         for (std::size_t i = 0; i < size(); i++)
             _data[i] = Other._data[i];
     }
@@ -273,7 +270,7 @@ class MatrixStorage<TDataType, TSize1, dynamic> {
         : _size2(InitialValues.size() / TSize1), _data(nullptr) {
         if (_size2 == 0)
             return;
-        _data = new TDataType[size()];
+        _data = AllocateStorage<TDataType>(size());
         std::size_t position = 0;
         for (auto& i : InitialValues) {
             _data[position++] = i;
@@ -293,62 +290,56 @@ class MatrixStorage<TDataType, TSize1, dynamic> {
     template <typename TExpressionType>
     explicit MatrixStorage(
         MatrixExpression<TExpressionType, row_major_access> const& Other)
-        : _size2(Other.size2()) {
-        _data = new TDataType[size()];
-        for (std::size_t i = 0; i < size(); i++)
-            _data[i] = Other[i];
+        : _size2(Other.expression().size2()) {
+        _data = AllocateStorage<TDataType>(size());
+        EvaluateExpression(Other.expression(), _data);
     }
 
     template <typename TOtherMatrixType>
     explicit MatrixStorage(TOtherMatrixType const& Other)
         : _size2(Other.size2()) {
-        _data = new TDataType[size()];
-        auto i_data = _data;
-        for (std::size_t i = 0; i < size1(); i++)
-            for (std::size_t j = 0; j < size2(); j++)
-                *(i_data++) = Other(i, j);
+        _data = AllocateStorage<TDataType>(size());
+        EvaluateExpression(Other, _data);
     }
 
     template <typename TExpressionType, std::size_t TCategory>
     MatrixStorage& operator=(
         MatrixExpression<TExpressionType, TCategory> const& Other) {
+        AMATRIX_COUNT_OPERATION(assignment, Other.expression().size1(),
+            Other.expression().size2());
         auto& other_expression = Other.expression();
         std::size_t new_size =
             other_expression.size1() * other_expression.size2();
         if (size() != new_size) {
             delete[] _data;
-            _data = new TDataType[new_size];
+            _data = AllocateStorage<TDataType>(new_size);
         }
         _size2 = other_expression.size2();
 
-        auto i_data = _data;
-        for (std::size_t i = 0; i < size1(); i++)
-            for (std::size_t j = 0; j < size2(); j++)
-                *(i_data++) = Other.expression()(i, j);
+        EvaluateExpression(Other.expression(), _data);
         return *this;
     }
 
     template <typename TOtherMatrixType>
     MatrixStorage& operator=(TOtherMatrixType const& Other) {
+        AMATRIX_COUNT_OPERATION(assignment, Other.size1(), Other.size2());
         std::size_t new_size = Other.size1() * Other.size2();
         if (size() != new_size) {
             delete[] _data;
-            _data = new TDataType[new_size];
+            _data = AllocateStorage<TDataType>(new_size);
         }
         _size2 = Other.size2();
 
-        auto i_data = _data;
-        for (std::size_t i = 0; i < size1(); i++)
-            for (std::size_t j = 0; j < size2(); j++)
-                *(i_data++) = Other(i, j);
+        EvaluateExpression(Other, _data);
         return *this;
     }
 
     MatrixStorage& operator=(MatrixStorage const& Other) {
+        AMATRIX_COUNT_OPERATION(assignment, Other.size1(), Other.size2());
         std::size_t new_size = Other.size1() * Other.size2();
         if (size() != new_size) {
             delete[] _data;
-            _data = new TDataType[new_size];
+            _data = AllocateStorage<TDataType>(new_size);
         }
         _size2 = Other.size2();
 
@@ -399,7 +390,7 @@ class MatrixStorage<TDataType, TSize1, dynamic> {
     void resize(std::size_t NewSize) {
         if (size2() != NewSize) {
             delete[] _data;
-            _data = new TDataType[TSize1 * NewSize];
+            _data = AllocateStorage<TDataType>(TSize1 * NewSize);
         }
         _size2 = NewSize;
     }
@@ -425,19 +416,19 @@ class MatrixStorage<TDataType, dynamic, TSize2> {
 
     MatrixStorage(std::size_t TheSize1, std::size_t TheSize2 = TSize2)
         : _size1(TheSize1) {
-        _data = new TDataType[size()];
+        _data = AllocateStorage<TDataType>(size());
     }
 
     explicit MatrixStorage(std::size_t TheSize1, std::size_t TheSize2,
         TDataType const& InitialValue)
         : _size1(TheSize1) {
-        _data = new TDataType[size()];
+        _data = AllocateStorage<TDataType>(size());
         for (std::size_t i = 0; i < size(); i++)
             _data[i] = InitialValue;
     }
 
     MatrixStorage(MatrixStorage const& Other) : _size1(Other.size1()) {
-        _data = new TDataType[size()];
+        _data = AllocateStorage<TDataType>(size());
         for (std::size_t i = 0; i < size(); i++)
             _data[i] = Other._data[i];
     }
@@ -451,7 +442,7 @@ class MatrixStorage<TDataType, dynamic, TSize2> {
         : _size1(InitialValues.size() / TSize2), _data(nullptr) {
         if (_size1 == 0)
             return;
-        _data = new TDataType[size()];
+        _data = AllocateStorage<TDataType>(size());
         std::size_t position = 0;
         for (auto& i : InitialValues) {
             _data[position++] = i;
@@ -472,61 +463,55 @@ class MatrixStorage<TDataType, dynamic, TSize2> {
     explicit MatrixStorage(
         MatrixExpression<TExpressionType, row_major_access> const& Other)
         : _size1(Other.expression().size1()) {
-        _data = new TDataType[size()];
-        for (std::size_t i = 0; i < size(); i++)
-            _data[i] = Other.expression()[i];
+        _data = AllocateStorage<TDataType>(size());
+        EvaluateExpression(Other.expression(), _data);
     }
 
     template <typename TOtherMatrixType>
     explicit MatrixStorage(TOtherMatrixType const& Other)
         : _size1(Other.size1()) {
-        _data = new TDataType[size()];
-        auto i_data = _data;
-        for (std::size_t i = 0; i < size1(); i++)
-            for (std::size_t j = 0; j < size2(); j++)
-                *(i_data++) = Other(i, j);
+        _data = AllocateStorage<TDataType>(size());
+        EvaluateExpression(Other, _data);
     }
 
     template <typename TExpressionType, std::size_t TCategory>
     MatrixStorage& operator=(
         MatrixExpression<TExpressionType, TCategory> const& Other) {
+        AMATRIX_COUNT_OPERATION(assignment, Other.expression().size1(),
+            Other.expression().size2());
         auto& other_expression = Other.expression();
         std::size_t new_size =
             other_expression.size1() * other_expression.size2();
         if (size() != new_size) {
             delete[] _data;
-            _data = new TDataType[new_size];
+            _data = AllocateStorage<TDataType>(new_size);
         }
         _size1 = other_expression.size1();
 
-        auto i_data = _data;
-        for (std::size_t i = 0; i < size1(); i++)
-            for (std::size_t j = 0; j < size2(); j++)
-                *(i_data++) = Other.expression()(i, j);
+        EvaluateExpression(Other.expression(), _data);
         return *this;
     }
 
     template <typename TOtherMatrixType>
     MatrixStorage& operator=(TOtherMatrixType const& Other) {
+        AMATRIX_COUNT_OPERATION(assignment, Other.size1(), Other.size2());
         std::size_t new_size = Other.size();
         if (size() != new_size) {
             delete[] _data;
-            _data = new TDataType[new_size];
+            _data = AllocateStorage<TDataType>(new_size);
         }
         _size1 = Other.size1();
 
-        auto i_data = _data;
-        for (std::size_t i = 0; i < size1(); i++)
-            for (std::size_t j = 0; j < size2(); j++)
-                *(i_data++) = Other(i, j);
+        EvaluateExpression(Other, _data);
         return *this;
     }
 
     MatrixStorage& operator=(MatrixStorage const& Other) {
+        AMATRIX_COUNT_OPERATION(assignment, Other.size1(), Other.size2());
         std::size_t new_size = Other.size1() * Other.size2();
         if (size() != new_size) {
             delete[] _data;
-            _data = new TDataType[new_size];
+            _data = AllocateStorage<TDataType>(new_size);
         }
         _size1 = Other.size1();
 
@@ -577,7 +562,7 @@ class MatrixStorage<TDataType, dynamic, TSize2> {
     void resize(std::size_t NewSize) {
         if (size1() != NewSize) {
             delete[] _data;
-            _data = new TDataType[NewSize * TSize2];
+            _data = AllocateStorage<TDataType>(NewSize * TSize2);
         }
         _size1 = NewSize;
     }
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <type_traits>
+
+#include "kernels.h"
+#include "matrix_expression.h"
+#include "parallel.h"
+
+namespace AMatrix {
+
+/// Fixed size matrix vector products with at most this many elements of A
+/// are unrolled completely
+constexpr std::size_t matrix_vector_unroll_size = 64;
+
+/// Minimum number of elements of A per thread of a matrix vector product.
+/// Smaller products are bound by the cost of starting the threads rather
+/// than by the memory bandwidth
+constexpr std::size_t matrix_vector_parallel_chunk_size = 1 << 17;
+
+/// Dot product of two arrays of TSize elements, written out by the compiler
+/// without a loop
+template <std::size_t TSize>
+struct UnrolledDot {
+    template <typename TDataType>
+    static inline TDataType apply(TDataType const* pX, TDataType const* pY) {
+        return UnrolledDot<TSize - 1>::apply(pX, pY) +
+               pX[TSize - 1] * pY[TSize - 1];
+    }
+};
+
+template <>
+struct UnrolledDot<1> {
+    template <typename TDataType>
+    static inline TDataType apply(TDataType const* pX, TDataType const* pY) {
+        return pX[0] * pY[0];
+    }
+};
+
+/// y += Alpha * x for arrays of TSize elements, without a loop
+template <std::size_t TSize>
+struct UnrolledAxpy {
+    template <typename TDataType>
+    static inline void apply(
+        TDataType Alpha, TDataType const* pX, TDataType* pY) {
+        UnrolledAxpy<TSize - 1>::apply(Alpha, pX, pY);
+        pY[TSize - 1] += Alpha * pX[TSize - 1];
+    }
+};
+
+template <>
+struct UnrolledAxpy<1> {
+    template <typename TDataType>
+    static inline void apply(
+        TDataType Alpha, TDataType const* pX, TDataType* pY) {
+        pY[0] += Alpha * pX[0];
+    }
+};
+
+/// True if a matrix vector product with these static sizes of A is unrolled
+template <std::size_t TStaticSize1, std::size_t TStaticSize2>
+using IsUnrolledMatrixVectorProduct = std::integral_constant<bool,
+    TStaticSize1 != dynamic && TStaticSize2 != dynamic &&
+        TStaticSize1 * TStaticSize2 <= matrix_vector_unroll_size>;
+
+template <std::size_t TStaticSize1, std::size_t TStaticSize2,
+    typename TDataType>
+void MatrixVectorProduct(std::size_t Size1, std::size_t Size2,
+    TDataType const* pA, TDataType const* pX, TDataType* pY,
+    std::true_type /* IsUnrolled */) {
+    for (std::size_t i = 0; i < TStaticSize1; i++)
+        pY[i] = UnrolledDot<TStaticSize2>::apply(pA + i * TStaticSize2, pX);
+}
+
+template <std::size_t TStaticSize1, std::size_t TStaticSize2,
+    typename TDataType>
+void MatrixVectorProduct(std::size_t Size1, std::size_t Size2,
+    TDataType const* pA, TDataType const* pX, TDataType* pY,
+    std::false_type /* IsUnrolled */) {
+    if (Size1 * Size2 < dispatch_minimum_product_size) {
+        for (std::size_t i = 0; i < Size1; i++) {
+            TDataType result = TDataType();
+            for (std::size_t j = 0; j < Size2; j++)
+                result += pA[i * Size2 + j] * pX[j];
+            pY[i] = result;
+        }
+        return;
+    }
+
+    const std::size_t minimum_rows =
+        matrix_vector_parallel_chunk_size / Size2 + 1;
+    ParallelFor(0, Size1, minimum_rows,
+        [&](std::size_t RowBegin, std::size_t RowEnd) {
+            DispatchedMatrixVectorProduct(RowEnd - RowBegin, Size2,
+                pA + RowBegin * Size2, pX, pY + RowBegin);
+        });
+}
+
+/// y = A * x for a row major A (Size1 x Size2) with the static sizes
+/// TStaticSize1 x TStaticSize2, the dot product form. Small fixed sizes are
+/// unrolled, large products are split by rows between threads
+template <std::size_t TStaticSize1, std::size_t TStaticSize2,
+    typename TDataType>
+void MatrixVectorProduct(std::size_t Size1, std::size_t Size2,
+    TDataType const* pA, TDataType const* pX, TDataType* pY) {
+    MatrixVectorProduct<TStaticSize1, TStaticSize2>(Size1, Size2, pA, pX, pY,
+        IsUnrolledMatrixVectorProduct<TStaticSize1, TStaticSize2>());
+}
+
+template <std::size_t TStaticSize1, std::size_t TStaticSize2,
+    typename TDataType>
+void TransposeMatrixVectorProduct(std::size_t Size1, std::size_t Size2,
+    TDataType const* pA, TDataType const* pX, TDataType* pY,
+    std::true_type /* IsUnrolled */) {
+    for (std::size_t j = 0; j < TStaticSize2; j++)
+        pY[j] = TDataType();
+    for (std::size_t i = 0; i < TStaticSize1; i++)
+        UnrolledAxpy<TStaticSize2>::apply(pX[i], pA + i * TStaticSize2, pY);
+}
+
+template <std::size_t TStaticSize1, std::size_t TStaticSize2,
+    typename TDataType>
+void TransposeMatrixVectorProduct(std::size_t Size1, std::size_t Size2,
+    TDataType const* pA, TDataType const* pX, TDataType* pY,
+    std::false_type /* IsUnrolled */) {
+    if (Size1 * Size2 < dispatch_minimum_product_size) {
+        for (std::size_t j = 0; j < Size2; j++)
+            pY[j] = TDataType();
+        for (std::size_t i = 0; i < Size1; i++)
+            for (std::size_t j = 0; j < Size2; j++)
+                pY[j] += pX[i] * pA[i * Size2 + j];
+        return;
+    }
+
+    const std::size_t minimum_columns =
+        matrix_vector_parallel_chunk_size / Size1 + 1;
+    ParallelFor(0, Size2, minimum_columns,
+        [&](std::size_t ColumnBegin, std::size_t ColumnEnd) {
+            DispatchedTransposeMatrixVectorProduct(Size1,
+                ColumnEnd - ColumnBegin, Size2, pA + ColumnBegin, pX,
+                pY + ColumnBegin);
+        });
+}
+
+/// y = A^T * x for a row major A (Size1 x Size2) with the static sizes
+/// TStaticSize1 x TStaticSize2, the axpy form. Small fixed sizes are
+/// unrolled, large products are split by columns of A between threads, so
+/// every thread writes its own part of y
+template <std::size_t TStaticSize1, std::size_t TStaticSize2,
+    typename TDataType>
+void TransposeMatrixVectorProduct(std::size_t Size1, std::size_t Size2,
+    TDataType const* pA, TDataType const* pX, TDataType* pY) {
+    TransposeMatrixVectorProduct<TStaticSize1, TStaticSize2>(Size1, Size2, pA,
+        pX, pY, IsUnrolledMatrixVectorProduct<TStaticSize1, TStaticSize2>());
+}
+
+}  // namespace AMatrix
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "bfloat16.h"
+#include "matrix.h"
+
+namespace AMatrix {
+
+/// Number of rows of A which are converted and multiplied together by
+/// AccumulatedProduct
+constexpr std::size_t accumulated_product_block_size = 64;
+
+/// C = A * B with the products accumulated in TAccumulatorType, e.g. for
+/// float or BFloat16 operands in double. B is converted once to the
+/// accumulator type, like the packing of a GEMM, then blocks of rows of A are
+/// converted, multiplied with the dispatched product kernel and rounded into
+/// C. C must have the size A.size1() x B.size2() and must not overlap A or B
+template <typename TAccumulatorType = double, typename TResultType,
+    typename TExpression1Type, std::size_t TCategory1,
+    typename TExpression2Type, std::size_t TCategory2>
+void AccumulatedProduct(TResultType& rC,
+    MatrixExpression<TExpression1Type, TCategory1> const& A,
+    MatrixExpression<TExpression2Type, TCategory2> const& B) {
+    using result_data_type = typename TResultType::data_type;
+    TExpression1Type const& a_expression = A.expression();
+    TExpression2Type const& b_expression = B.expression();
+    const std::size_t size1 = a_expression.size1();
+    const std::size_t inner_size = a_expression.size2();
+    const std::size_t size2 = b_expression.size2();
+    AMATRIX_COUNT_OPERATION(product, size1, size2);
+
+    std::vector<TAccumulatorType> b_data(inner_size * size2);
+    for (std::size_t k = 0; k < inner_size; k++)
+        for (std::size_t j = 0; j < size2; j++)
+            b_data[k * size2 + j] =
+                static_cast<TAccumulatorType>(b_expression(k, j));
+
+    const std::size_t block_size =
+        std::min(accumulated_product_block_size, size1);
+    std::vector<TAccumulatorType> a_block(block_size * inner_size);
+    std::vector<TAccumulatorType> c_block(block_size * size2);
+    for (std::size_t i_begin = 0; i_begin < size1; i_begin += block_size) {
+        const std::size_t rows = std::min(block_size, size1 - i_begin);
+        for (std::size_t i = 0; i < rows; i++)
+            for (std::size_t k = 0; k < inner_size; k++)
+                a_block[i * inner_size + k] = static_cast<TAccumulatorType>(
+                    a_expression(i_begin + i, k));
+
+        DispatchedProduct(rows, inner_size, size2, a_block.data(),
+            b_data.data(), c_block.data());
+
+        for (std::size_t i = 0; i < rows; i++)
+            for (std::size_t j = 0; j < size2; j++)
+                rC(i_begin + i, j) =
+                    static_cast<result_data_type>(c_block[i * size2 + j]);
+    }
+}
+
+/// Solves A x = b to the accuracy of the data type of A (usually double)
+/// with an LU factorization in the narrower TFactorizationDataType (float by
+/// default), which takes half the memory and twice the SIMD width. The
+/// solution of the factorization is improved by iterative refinement as in
+/// LAPACK's dsgesv: the residual r = b - A x is computed with the original
+/// A, the correction A d = r is solved with the narrow factorization and
+/// x += d, until the residual is below sqrt(n) * epsilon * |A| * |x| in the
+/// infinity norms. This converges when the condition number of A is well
+/// below 1 / epsilon of the factorization type. converged() tells if it did,
+/// otherwise the caller should fall back to a factorization in the full
+/// precision. A is referenced, not copied, and must outlive the solver
+template <typename TMatrixType, typename TFactorizationDataType = float>
+class IterativeRefinementLU {
+   public:
+    using data_type = typename TMatrixType::data_type;
+    using factorization_matrix_type =
+        Matrix<TFactorizationDataType, dynamic, dynamic>;
+    using factorization_vector_type =
+        Matrix<TFactorizationDataType, dynamic, 1>;
+    using permutation_vector_type = Matrix<std::size_t, dynamic, 1>;
+
+   private:
+    TMatrixType const& _matrix;
+    data_type _residual_tolerance;
+    factorization_matrix_type _factors;
+    LUFactorization<factorization_matrix_type, permutation_vector_type>
+        _factorization;
+    std::size_t _maximum_iterations;
+    std::size_t _number_of_iterations;
+    bool _is_converged;
+
+    /// sqrt(n) * epsilon * |A|, with the largest absolute row sum as |A|
+    static data_type residual_tolerance(TMatrixType const& A) {
+        data_type norm = data_type();
+        for (std::size_t i = 0; i < A.size1(); i++) {
+            data_type row_sum = data_type();
+            for (std::size_t j = 0; j < A.size2(); j++)
+                row_sum += std::abs(A(i, j));
+            norm = std::max(norm, row_sum);
+        }
+        return std::sqrt(static_cast<data_type>(A.size1())) *
+               std::numeric_limits<data_type>::epsilon() * norm;
+    }
+
+   public:
+    IterativeRefinementLU() = delete;
+
+    /// The default of 30 refinement steps is the one of dsgesv
+    IterativeRefinementLU(
+        TMatrixType const& Original, std::size_t MaximumIterations = 30)
+        : _matrix(Original),
+          _residual_tolerance(residual_tolerance(Original)),
+          _factors(Original),
+          _factorization(_factors),
+          _maximum_iterations(MaximumIterations),
+          _number_of_iterations(0),
+          _is_converged(false) {}
+
+    template <typename TVectorType>
+    TVectorType solve(TVectorType const& RHS) {
+        TVectorType result(
+            _factorization.solve(factorization_vector_type(RHS)));
+
+        _number_of_iterations = 0;
+        _is_converged = false;
+        for (;;) {
+            TVectorType residual(RHS - _matrix * result);
+            if (NormInf(residual) <= _residual_tolerance * NormInf(result)) {
+                _is_converged = true;
+                break;
+            }
+            if (_number_of_iterations == _maximum_iterations)
+                break;
+
+            factorization_vector_type correction(
+                _factorization.solve(factorization_vector_type(residual)));
+            for (std::size_t i = 0; i < result.size(); i++)
+                result[i] += static_cast<data_type>(correction[i]);
+            _number_of_iterations++;
+        }
+
+        return result;
+    }
+
+    /// Number of refinement steps of the last solve
+    std::size_t number_of_iterations() const { return _number_of_iterations; }
+
+    /// If the residual of the last solve reached the tolerance
+    bool converged() const { return _is_converged; }
+};
+
+}  // namespace AMatrix
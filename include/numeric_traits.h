@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cmath>
+#include <complex>
+
+namespace AMatrix {
+
+/// Properties of the element types which differ between real and complex
+/// numbers. real_type is the type of the absolute values and norms
+template <typename TDataType>
+struct NumericTraits {
+    using real_type = TDataType;
+    static constexpr bool is_complex = false;
+
+    static TDataType conjugate(TDataType Value) { return Value; }
+
+    static real_type real(TDataType Value) { return Value; }
+
+    /// Cheap magnitude for the pivot search, |x| for real numbers
+    static real_type abs1(TDataType Value) { return std::abs(Value); }
+};
+
+template <typename TRealType>
+struct NumericTraits<std::complex<TRealType>> {
+    using real_type = TRealType;
+    static constexpr bool is_complex = true;
+
+    static std::complex<TRealType> conjugate(std::complex<TRealType> Value) {
+        return std::conj(Value);
+    }
+
+    static real_type real(std::complex<TRealType> Value) {
+        return Value.real();
+    }
+
+    /// |re| + |im| as in the BLAS izamax, which avoids the square root of
+    /// the absolute value
+    static real_type abs1(std::complex<TRealType> Value) {
+        return std::abs(Value.real()) + std::abs(Value.imag());
+    }
+};
+
+}  // namespace AMatrix
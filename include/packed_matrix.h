@@ -0,0 +1,311 @@
+#pragma once
+
+#include "matrix_expression.h"
+
+namespace AMatrix {
+
+/// Row wise packed storage of one triangle of a square matrix. Only
+/// TSize * (TSize + 1) / 2 elements are stored
+template <typename TDataType, std::size_t TSize, std::size_t TMode>
+class PackedStorage {
+    TDataType _data[TSize * (TSize + 1) / 2];
+
+   public:
+    PackedStorage() {}
+
+    explicit PackedStorage(std::size_t TheSize) {}
+
+    PackedStorage(PackedStorage const& Other) {
+        for (std::size_t i = 0; i < packed_size(); i++)
+            _data[i] = Other._data[i];
+    }
+
+    PackedStorage& operator=(PackedStorage const& Other) {
+        for (std::size_t i = 0; i < packed_size(); i++)
+            _data[i] = Other._data[i];
+        return *this;
+    }
+
+    /// Position of (i, j) in the packed data, (i, j) must be in the triangle
+    static std::size_t index(std::size_t i, std::size_t j) {
+        return (TMode & upper) ? i * (2 * TSize - i + 1) / 2 + j - i
+                               : i * (i + 1) / 2 + j;
+    }
+
+    TDataType& at(std::size_t i, std::size_t j) { return _data[index(i, j)]; }
+
+    TDataType const& at(std::size_t i, std::size_t j) const {
+        return _data[index(i, j)];
+    }
+
+    static constexpr std::size_t size1() { return TSize; }
+
+    static constexpr std::size_t size2() { return TSize; }
+
+    static constexpr std::size_t size() { return TSize * TSize; }
+
+    static constexpr std::size_t packed_size() {
+        return TSize * (TSize + 1) / 2;
+    }
+
+    void resize(std::size_t NewSize) {}
+
+    TDataType* data() { return _data; }
+
+    TDataType const* data() const { return _data; }
+};
+
+template <typename TDataType, std::size_t TMode>
+class PackedStorage<TDataType, dynamic, TMode> {
+    std::size_t _size;
+    TDataType* _data;
+
+   public:
+    PackedStorage() : _size(0), _data(nullptr) {}
+
+    explicit PackedStorage(std::size_t TheSize) : _size(TheSize) {
+        _data = AllocateStorage<TDataType>(packed_size());
+    }
+
+    PackedStorage(PackedStorage const& Other) : _size(Other._size) {
+        _data = AllocateStorage<TDataType>(packed_size());
+        for (std::size_t i = 0; i < packed_size(); i++)
+            _data[i] = Other._data[i];
+    }
+
+    PackedStorage(PackedStorage&& Other)
+        : _size(Other._size), _data(Other._data) {
+        Other._data = nullptr;
+    }
+
+    virtual ~PackedStorage() {
+        if (_data)
+            delete[] _data;
+    }
+
+    PackedStorage& operator=(PackedStorage const& Other) {
+        resize(Other._size);
+        for (std::size_t i = 0; i < packed_size(); i++)
+            _data[i] = Other._data[i];
+        return *this;
+    }
+
+    PackedStorage& operator=(PackedStorage&& Other) {
+        if (_data)
+            delete[] _data;
+
+        _size = Other._size;
+        _data = Other._data;
+        Other._data = nullptr;
+
+        return *this;
+    }
+
+    /// Position of (i, j) in the packed data, (i, j) must be in the triangle
+    std::size_t index(std::size_t i, std::size_t j) const {
+        return (TMode & upper) ? i * (2 * _size - i + 1) / 2 + j - i
+                               : i * (i + 1) / 2 + j;
+    }
+
+    TDataType& at(std::size_t i, std::size_t j) { return _data[index(i, j)]; }
+
+    TDataType const& at(std::size_t i, std::size_t j) const {
+        return _data[index(i, j)];
+    }
+
+    std::size_t size1() const { return _size; }
+
+    std::size_t size2() const { return _size; }
+
+    std::size_t size() const { return _size * _size; }
+
+    std::size_t packed_size() const { return _size * (_size + 1) / 2; }
+
+    void resize(std::size_t NewSize) {
+        if (NewSize != _size) {
+            delete[] _data;
+            _size = NewSize;
+            _data = AllocateStorage<TDataType>(packed_size());
+        }
+    }
+
+    TDataType* data() { return _data; }
+
+    TDataType const* data() const { return _data; }
+};
+
+/// Triangular matrix which stores only its nonzero triangle. With
+/// unit_diagonal the stored diagonal is ignored and taken as one
+template <typename TDataType, std::size_t TSize, std::size_t TMode>
+class TriangularMatrix
+    : public MatrixExpression<TriangularMatrix<TDataType, TSize, TMode>>,
+      public PackedStorage<TDataType, TSize, TMode> {
+   public:
+    static constexpr std::size_t mode = TMode;
+    using data_type = TDataType;
+    using base_type = PackedStorage<TDataType, TSize, TMode>;
+    using base_type::at;
+    using base_type::size1;
+    using base_type::size2;
+
+    TriangularMatrix() {}
+
+    explicit TriangularMatrix(std::size_t TheSize) : base_type(TheSize) {}
+
+    template <typename TExpressionType, std::size_t TCategory>
+    explicit TriangularMatrix(
+        MatrixExpression<TExpressionType, TCategory> const& Other)
+        : base_type(Other.expression().size1()) {
+        assign(Other.expression());
+    }
+
+    template <typename TExpressionType, std::size_t TCategory>
+    TriangularMatrix& operator=(
+        MatrixExpression<TExpressionType, TCategory> const& Other) {
+        base_type::resize(Other.expression().size1());
+        assign(Other.expression());
+        return *this;
+    }
+
+    inline TDataType operator()(std::size_t i, std::size_t j) const {
+        if (i == j && (TMode & unit_diagonal))
+            return TDataType(1);
+        if ((TMode & upper) ? (i > j) : (i < j))
+            return TDataType();
+        return at(i, j);
+    }
+
+    /// Access without checking, (i, j) must be inside the triangle
+    inline TDataType stored_element(std::size_t i, std::size_t j) const {
+        return at(i, j);
+    }
+
+    bool overlaps(void const* pBegin, void const* pEnd) const {
+        return AreRangesOverlapping(base_type::data(),
+            base_type::data() + base_type::packed_size(), pBegin, pEnd);
+    }
+
+    template <typename TMatrixType>
+    void solve_in_place(TMatrixType& rX) const {
+        TriangularSolveInPlace(*this, rX);
+    }
+
+    template <typename TMatrixType>
+    TMatrixType solve(TMatrixType const& RHS) const {
+        TMatrixType result(RHS);
+        TriangularSolveInPlace(*this, result);
+        return result;
+    }
+
+   private:
+    template <typename TExpressionType>
+    void assign(TExpressionType const& Other) {
+        for (std::size_t i = 0; i < size1(); i++)
+            if (TMode & upper)
+                for (std::size_t j = i; j < size2(); j++)
+                    at(i, j) = Other(i, j);
+            else
+                for (std::size_t j = 0; j <= i; j++)
+                    at(i, j) = Other(i, j);
+    }
+};
+
+/// Symmetric matrix which stores only the given triangle. at(i, j) gives
+/// the stored element for both (i, j) and (j, i)
+template <typename TDataType, std::size_t TSize, std::size_t TMode>
+class SymmetricMatrix
+    : public MatrixExpression<SymmetricMatrix<TDataType, TSize, TMode>>,
+      public PackedStorage<TDataType, TSize, TMode> {
+   public:
+    static constexpr std::size_t mode = TMode;
+    using data_type = TDataType;
+    using base_type = PackedStorage<TDataType, TSize, TMode>;
+    using base_type::size1;
+    using base_type::size2;
+
+    SymmetricMatrix() {}
+
+    explicit SymmetricMatrix(std::size_t TheSize) : base_type(TheSize) {}
+
+    /// Only the stored triangle of the expression is read
+    template <typename TExpressionType, std::size_t TCategory>
+    explicit SymmetricMatrix(
+        MatrixExpression<TExpressionType, TCategory> const& Other)
+        : base_type(Other.expression().size1()) {
+        assign(Other.expression());
+    }
+
+    template <typename TExpressionType, std::size_t TCategory>
+    SymmetricMatrix& operator=(
+        MatrixExpression<TExpressionType, TCategory> const& Other) {
+        base_type::resize(Other.expression().size1());
+        assign(Other.expression());
+        return *this;
+    }
+
+    inline TDataType operator()(std::size_t i, std::size_t j) const {
+        return at(i, j);
+    }
+
+    inline TDataType& operator()(std::size_t i, std::size_t j) {
+        return at(i, j);
+    }
+
+    TDataType& at(std::size_t i, std::size_t j) {
+        if ((TMode & upper) ? (i > j) : (i < j))
+            return base_type::at(j, i);
+        return base_type::at(i, j);
+    }
+
+    TDataType const& at(std::size_t i, std::size_t j) const {
+        if ((TMode & upper) ? (i > j) : (i < j))
+            return base_type::at(j, i);
+        return base_type::at(i, j);
+    }
+
+    /// Access without checking, (i, j) must be inside the triangle
+    inline TDataType stored_element(std::size_t i, std::size_t j) const {
+        return base_type::at(i, j);
+    }
+
+    bool overlaps(void const* pBegin, void const* pEnd) const {
+        return AreRangesOverlapping(base_type::data(),
+            base_type::data() + base_type::packed_size(), pBegin, pEnd);
+    }
+
+   private:
+    template <typename TExpressionType>
+    void assign(TExpressionType const& Other) {
+        for (std::size_t i = 0; i < size1(); i++)
+            if (TMode & upper)
+                for (std::size_t j = i; j < size2(); j++)
+                    base_type::at(i, j) = Other(i, j);
+            else
+                for (std::size_t j = 0; j <= i; j++)
+                    base_type::at(i, j) = Other(i, j);
+    }
+};
+
+template <typename TDataType, std::size_t TSize, std::size_t TMode,
+    typename TExpressionType, std::size_t TCategory>
+TriangularMatrixProductExpression<TriangularMatrix<TDataType, TSize, TMode>,
+    TExpressionType>
+operator*(TriangularMatrix<TDataType, TSize, TMode> const& First,
+    MatrixExpression<TExpressionType, TCategory> const& Second) {
+    return TriangularMatrixProductExpression<
+        TriangularMatrix<TDataType, TSize, TMode>, TExpressionType>(
+        First, Second.expression());
+}
+
+template <typename TDataType, std::size_t TSize, std::size_t TMode,
+    typename TExpressionType, std::size_t TCategory>
+SymmetricMatrixProductExpression<SymmetricMatrix<TDataType, TSize, TMode>,
+    TExpressionType>
+operator*(SymmetricMatrix<TDataType, TSize, TMode> const& First,
+    MatrixExpression<TExpressionType, TCategory> const& Second) {
+    return SymmetricMatrixProductExpression<
+        SymmetricMatrix<TDataType, TSize, TMode>, TExpressionType>(
+        First, Second.expression());
+}
+
+}  // namespace AMatrix
@@ -0,0 +1,965 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "cpu_features.h"
+
+// Packets are the vector registers of the kernels. Each backend defines
+// Packet<TDataType, TWidth> for the widths of its registers, all other
+// combinations use the portable array backend:
+//   SSE2     Packet<double, 2>, Packet<float, 4>
+//   AVX2     Packet<double, 4>, Packet<float, 8>    (with FMA)
+//   AVX-512  Packet<double, 8>, Packet<float, 16>
+//   NEON     Packet<double, 2>, Packet<float, 4>    (AArch64)
+// The AVX2 and AVX-512 backends are also available to the dispatched kernel
+// sets when the translation unit is compiled for a lower target, their
+// functions then carry the target attribute of the kernel set and may only
+// be called from it
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AMATRIX_HAS_SSE2_PACKETS 1
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#define AMATRIX_HAS_AVX2_PACKETS 1
+#define AMATRIX_AVX2_PACKET_INLINE AMATRIX_ALWAYS_INLINE
+#elif AMATRIX_DISPATCH
+#define AMATRIX_HAS_AVX2_PACKETS 1
+#define AMATRIX_AVX2_PACKET_INLINE AMATRIX_ALWAYS_INLINE AMATRIX_TARGET_AVX2
+#endif
+
+#if defined(__AVX512F__)
+#define AMATRIX_HAS_AVX512_PACKETS 1
+#define AMATRIX_AVX512_PACKET_INLINE AMATRIX_ALWAYS_INLINE
+#elif AMATRIX_DISPATCH
+#define AMATRIX_HAS_AVX512_PACKETS 1
+#define AMATRIX_AVX512_PACKET_INLINE \
+    AMATRIX_ALWAYS_INLINE AMATRIX_TARGET_AVX512
+#endif
+
+#if defined(AMATRIX_HAS_AVX2_PACKETS) || defined(AMATRIX_HAS_AVX512_PACKETS)
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define AMATRIX_HAS_NEON_PACKETS 1
+#include <arm_neon.h>
+#endif
+
+namespace AMatrix {
+
+/// Number of elements of the packets which are native to the translation
+/// unit. Only float and double have vector backends
+template <typename TDataType>
+struct NativePacketWidth {
+    static constexpr std::size_t value = 1;
+};
+
+/// Width of the packets of TDataType in registers of TRegisterBytes
+template <typename TDataType, std::size_t TRegisterBytes>
+struct PacketWidth {
+    static constexpr std::size_t value = 1;
+};
+
+template <std::size_t TRegisterBytes>
+struct PacketWidth<double, TRegisterBytes> {
+    static constexpr std::size_t value = TRegisterBytes / sizeof(double);
+};
+
+template <std::size_t TRegisterBytes>
+struct PacketWidth<float, TRegisterBytes> {
+    static constexpr std::size_t value = TRegisterBytes / sizeof(float);
+};
+
+#if defined(__AVX512F__)
+constexpr std::size_t native_register_bytes = 64;
+#elif defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+constexpr std::size_t native_register_bytes = 32;
+#elif defined(AMATRIX_HAS_SSE2_PACKETS) || defined(AMATRIX_HAS_NEON_PACKETS)
+constexpr std::size_t native_register_bytes = 16;
+#else
+constexpr std::size_t native_register_bytes = sizeof(double);
+#endif
+
+template <>
+struct NativePacketWidth<double> {
+    static constexpr std::size_t value =
+        PacketWidth<double, native_register_bytes>::value;
+};
+
+template <>
+struct NativePacketWidth<float> {
+    static constexpr std::size_t value =
+        PacketWidth<float, native_register_bytes>::value;
+};
+
+/// Portable backend, an array of TWidth elements. The compiler may still
+/// vectorize its loops
+template <typename TDataType, std::size_t TWidth>
+class Packet {
+    TDataType _values[TWidth];
+
+   public:
+    using data_type = TDataType;
+    static constexpr std::size_t width = TWidth;
+
+    AMATRIX_ALWAYS_INLINE static Packet zero() {
+        return broadcast(TDataType());
+    }
+
+    AMATRIX_ALWAYS_INLINE static Packet broadcast(TDataType Value) {
+        Packet result;
+        for (std::size_t i = 0; i < TWidth; i++)
+            result._values[i] = Value;
+        return result;
+    }
+
+    /// pData must be aligned to the size of the packet
+    AMATRIX_ALWAYS_INLINE static Packet load(TDataType const* pData) {
+        return load_unaligned(pData);
+    }
+
+    AMATRIX_ALWAYS_INLINE static Packet load_unaligned(TDataType const* pData) {
+        Packet result;
+        for (std::size_t i = 0; i < TWidth; i++)
+            result._values[i] = pData[i];
+        return result;
+    }
+
+    /// Loads the first Size < width elements, the others are zero
+    AMATRIX_ALWAYS_INLINE static Packet load_partial(
+        TDataType const* pData, std::size_t Size) {
+        Packet result = zero();
+        for (std::size_t i = 0; i < Size; i++)
+            result._values[i] = pData[i];
+        return result;
+    }
+
+    AMATRIX_ALWAYS_INLINE void store(TDataType* pData) const {
+        store_unaligned(pData);
+    }
+
+    AMATRIX_ALWAYS_INLINE void store_unaligned(TDataType* pData) const {
+        for (std::size_t i = 0; i < TWidth; i++)
+            pData[i] = _values[i];
+    }
+
+    /// Stores the first Size < width elements
+    AMATRIX_ALWAYS_INLINE void store_partial(
+        TDataType* pData, std::size_t Size) const {
+        for (std::size_t i = 0; i < Size; i++)
+            pData[i] = _values[i];
+    }
+
+    /// Loads the elements pData[i * Stride]
+    AMATRIX_ALWAYS_INLINE static Packet load_strided(
+        TDataType const* pData, std::size_t Stride) {
+        Packet result;
+        for (std::size_t i = 0; i < TWidth; i++)
+            result._values[i] = pData[i * Stride];
+        return result;
+    }
+
+    /// Loads the elements pData[pIndices[i]]
+    AMATRIX_ALWAYS_INLINE static Packet gather(
+        TDataType const* pData, std::size_t const* pIndices) {
+        Packet result;
+        for (std::size_t i = 0; i < TWidth; i++)
+            result._values[i] = pData[pIndices[i]];
+        return result;
+    }
+
+    AMATRIX_ALWAYS_INLINE void store_strided(
+        TDataType* pData, std::size_t Stride) const {
+        for (std::size_t i = 0; i < TWidth; i++)
+            pData[i * Stride] = _values[i];
+    }
+
+    /// Stores to pData[pIndices[i]], the indices must differ
+    AMATRIX_ALWAYS_INLINE void scatter(
+        TDataType* pData, std::size_t const* pIndices) const {
+        for (std::size_t i = 0; i < TWidth; i++)
+            pData[pIndices[i]] = _values[i];
+    }
+
+    AMATRIX_ALWAYS_INLINE TDataType operator[](std::size_t i) const {
+        return _values[i];
+    }
+
+    AMATRIX_ALWAYS_INLINE TDataType& operator[](std::size_t i) {
+        return _values[i];
+    }
+};
+
+template <typename TDataType, std::size_t TWidth>
+AMATRIX_ALWAYS_INLINE Packet<TDataType, TWidth> operator+(
+    Packet<TDataType, TWidth> const& First,
+    Packet<TDataType, TWidth> const& Second) {
+    Packet<TDataType, TWidth> result;
+    for (std::size_t i = 0; i < TWidth; i++)
+        result[i] = First[i] + Second[i];
+    return result;
+}
+
+template <typename TDataType, std::size_t TWidth>
+AMATRIX_ALWAYS_INLINE Packet<TDataType, TWidth> operator-(
+    Packet<TDataType, TWidth> const& First,
+    Packet<TDataType, TWidth> const& Second) {
+    Packet<TDataType, TWidth> result;
+    for (std::size_t i = 0; i < TWidth; i++)
+        result[i] = First[i] - Second[i];
+    return result;
+}
+
+template <typename TDataType, std::size_t TWidth>
+AMATRIX_ALWAYS_INLINE Packet<TDataType, TWidth> operator*(
+    Packet<TDataType, TWidth> const& First,
+    Packet<TDataType, TWidth> const& Second) {
+    Packet<TDataType, TWidth> result;
+    for (std::size_t i = 0; i < TWidth; i++)
+        result[i] = First[i] * Second[i];
+    return result;
+}
+
+template <typename TDataType, std::size_t TWidth>
+AMATRIX_ALWAYS_INLINE Packet<TDataType, TWidth> operator-(
+    Packet<TDataType, TWidth> const& ThePacket) {
+    return Packet<TDataType, TWidth>::zero() - ThePacket;
+}
+
+/// First * Second + Third, fused where the backend has FMA
+template <typename TDataType, std::size_t TWidth>
+AMATRIX_ALWAYS_INLINE Packet<TDataType, TWidth> MultiplyAdd(
+    Packet<TDataType, TWidth> const& First,
+    Packet<TDataType, TWidth> const& Second,
+    Packet<TDataType, TWidth> const& Third) {
+    return First * Second + Third;
+}
+
+/// Sum of the elements
+template <typename TDataType, std::size_t TWidth>
+AMATRIX_ALWAYS_INLINE TDataType ReduceSum(
+    Packet<TDataType, TWidth> const& ThePacket) {
+    TDataType result = ThePacket[0];
+    for (std::size_t i = 1; i < TWidth; i++)
+        result += ThePacket[i];
+    return result;
+}
+
+/// Element i is taken from Second if bit i of Mask is set, else from First
+template <typename TDataType, std::size_t TWidth>
+AMATRIX_ALWAYS_INLINE Packet<TDataType, TWidth> Blend(unsigned int Mask,
+    Packet<TDataType, TWidth> const& First,
+    Packet<TDataType, TWidth> const& Second) {
+    Packet<TDataType, TWidth> result;
+    for (std::size_t i = 0; i < TWidth; i++)
+        result[i] = ((Mask >> i) & 1) ? Second[i] : First[i];
+    return result;
+}
+
+/// Swaps the elements of the pairs (0, 1), (2, 3), ... which exchanges the
+/// real and imaginary parts of interleaved complex numbers
+template <typename TDataType, std::size_t TWidth>
+AMATRIX_ALWAYS_INLINE Packet<TDataType, TWidth> SwapPairs(
+    Packet<TDataType, TWidth> const& ThePacket) {
+    Packet<TDataType, TWidth> result;
+    for (std::size_t i = 0; i < TWidth; i++)
+        result[i] = ThePacket[((i ^ 1) < TWidth) ? (i ^ 1) : i];
+    return result;
+}
+
+/// Stores a packet to pData, aligned to the size of the packet, with a
+/// non-temporal store where the backend has one. It writes around the
+/// caches, so large outputs do not evict the operands. StreamFence orders
+/// the streamed stores before the following ones
+template <typename TDataType, std::size_t TWidth>
+AMATRIX_ALWAYS_INLINE void StreamStore(
+    Packet<TDataType, TWidth> const& ThePacket, TDataType* pData) {
+    ThePacket.store(pData);
+}
+
+AMATRIX_ALWAYS_INLINE void StreamFence() {
+#if defined(AMATRIX_HAS_SSE2_PACKETS)
+    _mm_sfence();
+#endif
+}
+
+// The register backends share the interface of the portable one. Their
+// register is public as value() for operations which are not covered here
+
+#define AMATRIX_DEFINE_PACKET(TheInline, TheDataType, TheWidth, TheRegister,   \
+    TheZero, TheBroadcast, TheLoad, TheLoadUnaligned, TheStore,               \
+    TheStoreUnaligned)                                                        \
+    template <>                                                               \
+    class Packet<TheDataType, TheWidth> {                                     \
+        TheRegister _value;                                                   \
+                                                                              \
+       public:                                                                \
+        using data_type = TheDataType;                                        \
+        using register_type = TheRegister;                                    \
+        static constexpr std::size_t width = TheWidth;                        \
+                                                                              \
+        Packet() = default;                                                   \
+        TheInline explicit Packet(TheRegister Value) : _value(Value) {}       \
+        TheInline TheRegister value() const { return _value; }                \
+        TheInline static Packet zero() { return Packet(TheZero()); }          \
+        TheInline static Packet broadcast(TheDataType Value) {                \
+            return Packet(TheBroadcast(Value));                               \
+        }                                                                     \
+        TheInline static Packet load(TheDataType const* pData) {              \
+            return Packet(TheLoad(pData));                                    \
+        }                                                                     \
+        TheInline static Packet load_unaligned(TheDataType const* pData) {    \
+            return Packet(TheLoadUnaligned(pData));                           \
+        }                                                                     \
+        TheInline static Packet load_partial(                                 \
+            TheDataType const* pData, std::size_t Size);                      \
+        TheInline void store(TheDataType* pData) const {                      \
+            TheStore(pData, _value);                                          \
+        }                                                                     \
+        TheInline void store_unaligned(TheDataType* pData) const {            \
+            TheStoreUnaligned(pData, _value);                                 \
+        }                                                                     \
+        TheInline void store_partial(                                         \
+            TheDataType* pData, std::size_t Size) const;                      \
+        TheInline static Packet load_strided(                                 \
+            TheDataType const* pData, std::size_t Stride);                    \
+        TheInline static Packet gather(                                       \
+            TheDataType const* pData, std::size_t const* pIndices);           \
+        TheInline void store_strided(                                         \
+            TheDataType* pData, std::size_t Stride) const;                    \
+        TheInline void scatter(                                               \
+            TheDataType* pData, std::size_t const* pIndices) const;           \
+        TheInline TheDataType operator[](std::size_t i) const {               \
+            TheDataType values[TheWidth];                                     \
+            store_unaligned(values);                                          \
+            return values[i];                                                 \
+        }                                                                     \
+    };
+
+#define AMATRIX_DEFINE_PACKET_OPERATORS(TheInline, TheDataType, TheWidth,     \
+    TheAdd, TheSubtract, TheMultiply)                                         \
+    TheInline Packet<TheDataType, TheWidth> operator+(                        \
+        Packet<TheDataType, TheWidth> const& First,                           \
+        Packet<TheDataType, TheWidth> const& Second) {                        \
+        return Packet<TheDataType, TheWidth>(                                 \
+            TheAdd(First.value(), Second.value()));                           \
+    }                                                                         \
+    TheInline Packet<TheDataType, TheWidth> operator-(                        \
+        Packet<TheDataType, TheWidth> const& First,                           \
+        Packet<TheDataType, TheWidth> const& Second) {                        \
+        return Packet<TheDataType, TheWidth>(                                 \
+            TheSubtract(First.value(), Second.value()));                      \
+    }                                                                         \
+    TheInline Packet<TheDataType, TheWidth> operator*(                        \
+        Packet<TheDataType, TheWidth> const& First,                           \
+        Packet<TheDataType, TheWidth> const& Second) {                        \
+        return Packet<TheDataType, TheWidth>(                                 \
+            TheMultiply(First.value(), Second.value()));                      \
+    }                                                                         \
+    TheInline Packet<TheDataType, TheWidth> operator-(                        \
+        Packet<TheDataType, TheWidth> const& ThePacket) {                     \
+        return Packet<TheDataType, TheWidth>::zero() - ThePacket;             \
+    }
+
+// The stores of the intrinsics may alias any type, so the compiler reloads
+// everything after them, e.g. the data pointers of the operands of an
+// expression. GCC and Clang store through vector types of the element type
+// instead, which only alias the elements
+#if defined(__GNUC__)
+#define AMATRIX_DEFINE_PACKET_STORES(TheInline, TheName, TheDataType,          \
+    TheRegister, TheStore, TheStoreUnaligned)                                 \
+    typedef TheDataType TheName##Vector                                       \
+        __attribute__((vector_size(sizeof(TheRegister))));                    \
+    typedef TheDataType TheName##UnalignedVector __attribute__((              \
+        vector_size(sizeof(TheRegister)), aligned(sizeof(TheDataType))));     \
+    TheInline void TheName##Store(TheDataType* pData, TheRegister Value) {    \
+        *reinterpret_cast<TheName##Vector*>(pData) = (TheName##Vector)Value;  \
+    }                                                                         \
+    TheInline void TheName##StoreUnaligned(                                   \
+        TheDataType* pData, TheRegister Value) {                              \
+        *reinterpret_cast<TheName##UnalignedVector*>(pData) =                 \
+            (TheName##UnalignedVector)Value;                                  \
+    }
+#else
+#define AMATRIX_DEFINE_PACKET_STORES(TheInline, TheName, TheDataType,          \
+    TheRegister, TheStore, TheStoreUnaligned)                                 \
+    TheInline void TheName##Store(TheDataType* pData, TheRegister Value) {    \
+        TheStore(pData, Value);                                               \
+    }                                                                         \
+    TheInline void TheName##StoreUnaligned(                                   \
+        TheDataType* pData, TheRegister Value) {                              \
+        TheStoreUnaligned(pData, Value);                                      \
+    }
+#endif
+
+// Partial loads and stores of the backends without masked instructions go
+// through a buffer on the stack
+#define AMATRIX_DEFINE_BUFFERED_PARTIAL_ACCESS(TheInline, TheDataType,        \
+    TheWidth)                                                                 \
+    TheInline Packet<TheDataType, TheWidth>                                   \
+    Packet<TheDataType, TheWidth>::load_partial(                              \
+        TheDataType const* pData, std::size_t Size) {                         \
+        TheDataType values[TheWidth] = {};                                    \
+        for (std::size_t i = 0; i < Size; i++)                                \
+            values[i] = pData[i];                                             \
+        return load_unaligned(values);                                        \
+    }                                                                         \
+    TheInline void Packet<TheDataType, TheWidth>::store_partial(              \
+        TheDataType* pData, std::size_t Size) const {                         \
+        TheDataType values[TheWidth];                                         \
+        store_unaligned(values);                                              \
+        for (std::size_t i = 0; i < Size; i++)                                \
+            pData[i] = values[i];                                             \
+    }
+
+// Strided and indexed accesses of the backends without gather or scatter
+// instructions go element by element through a buffer on the stack
+#define AMATRIX_DEFINE_BUFFERED_GATHER(TheInline, TheDataType, TheWidth)      \
+    TheInline Packet<TheDataType, TheWidth>                                   \
+    Packet<TheDataType, TheWidth>::load_strided(                              \
+        TheDataType const* pData, std::size_t Stride) {                       \
+        TheDataType values[TheWidth];                                         \
+        for (std::size_t i = 0; i < TheWidth; i++)                            \
+            values[i] = pData[i * Stride];                                    \
+        return load_unaligned(values);                                        \
+    }                                                                         \
+    TheInline Packet<TheDataType, TheWidth>                                   \
+    Packet<TheDataType, TheWidth>::gather(                                    \
+        TheDataType const* pData, std::size_t const* pIndices) {              \
+        TheDataType values[TheWidth];                                         \
+        for (std::size_t i = 0; i < TheWidth; i++)                            \
+            values[i] = pData[pIndices[i]];                                   \
+        return load_unaligned(values);                                        \
+    }
+
+#define AMATRIX_DEFINE_BUFFERED_SCATTER(TheInline, TheDataType, TheWidth)     \
+    TheInline void Packet<TheDataType, TheWidth>::store_strided(              \
+        TheDataType* pData, std::size_t Stride) const {                       \
+        TheDataType values[TheWidth];                                         \
+        store_unaligned(values);                                              \
+        for (std::size_t i = 0; i < TheWidth; i++)                            \
+            pData[i * Stride] = values[i];                                    \
+    }                                                                         \
+    TheInline void Packet<TheDataType, TheWidth>::scatter(                    \
+        TheDataType* pData, std::size_t const* pIndices) const {              \
+        TheDataType values[TheWidth];                                         \
+        store_unaligned(values);                                              \
+        for (std::size_t i = 0; i < TheWidth; i++)                            \
+            pData[pIndices[i]] = values[i];                                   \
+    }
+
+#if defined(AMATRIX_HAS_SSE2_PACKETS)
+
+AMATRIX_DEFINE_PACKET_STORES(AMATRIX_ALWAYS_INLINE, Sse2Double, double, __m128d, _mm_store_pd,
+    _mm_storeu_pd)
+AMATRIX_DEFINE_PACKET(AMATRIX_ALWAYS_INLINE, double, 2, __m128d,
+    _mm_setzero_pd, _mm_set1_pd, _mm_load_pd, _mm_loadu_pd, Sse2DoubleStore,
+    Sse2DoubleStoreUnaligned)
+AMATRIX_DEFINE_PACKET_OPERATORS(
+    AMATRIX_ALWAYS_INLINE, double, 2, _mm_add_pd, _mm_sub_pd, _mm_mul_pd)
+AMATRIX_DEFINE_BUFFERED_PARTIAL_ACCESS(AMATRIX_ALWAYS_INLINE, double, 2)
+AMATRIX_DEFINE_BUFFERED_GATHER(AMATRIX_ALWAYS_INLINE, double, 2)
+AMATRIX_DEFINE_BUFFERED_SCATTER(AMATRIX_ALWAYS_INLINE, double, 2)
+
+AMATRIX_DEFINE_PACKET_STORES(AMATRIX_ALWAYS_INLINE, Sse2Float, float, __m128, _mm_store_ps,
+    _mm_storeu_ps)
+AMATRIX_DEFINE_PACKET(AMATRIX_ALWAYS_INLINE, float, 4, __m128,
+    _mm_setzero_ps, _mm_set1_ps, _mm_load_ps, _mm_loadu_ps, Sse2FloatStore,
+    Sse2FloatStoreUnaligned)
+AMATRIX_DEFINE_PACKET_OPERATORS(
+    AMATRIX_ALWAYS_INLINE, float, 4, _mm_add_ps, _mm_sub_ps, _mm_mul_ps)
+AMATRIX_DEFINE_BUFFERED_PARTIAL_ACCESS(AMATRIX_ALWAYS_INLINE, float, 4)
+AMATRIX_DEFINE_BUFFERED_GATHER(AMATRIX_ALWAYS_INLINE, float, 4)
+AMATRIX_DEFINE_BUFFERED_SCATTER(AMATRIX_ALWAYS_INLINE, float, 4)
+
+#if defined(__FMA__)
+#include <immintrin.h>
+
+AMATRIX_ALWAYS_INLINE Packet<double, 2> MultiplyAdd(Packet<double, 2> const& First,
+    Packet<double, 2> const& Second, Packet<double, 2> const& Third) {
+    return Packet<double, 2>(
+        _mm_fmadd_pd(First.value(), Second.value(), Third.value()));
+}
+
+AMATRIX_ALWAYS_INLINE Packet<float, 4> MultiplyAdd(Packet<float, 4> const& First,
+    Packet<float, 4> const& Second, Packet<float, 4> const& Third) {
+    return Packet<float, 4>(
+        _mm_fmadd_ps(First.value(), Second.value(), Third.value()));
+}
+#endif
+
+AMATRIX_ALWAYS_INLINE double ReduceSum(Packet<double, 2> const& ThePacket) {
+    const __m128d value = ThePacket.value();
+    return _mm_cvtsd_f64(_mm_add_sd(value, _mm_unpackhi_pd(value, value)));
+}
+
+AMATRIX_ALWAYS_INLINE float ReduceSum(Packet<float, 4> const& ThePacket) {
+    const __m128 value = ThePacket.value();
+    const __m128 pairs = _mm_add_ps(value, _mm_movehl_ps(value, value));
+    return _mm_cvtss_f32(
+        _mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+}
+
+AMATRIX_ALWAYS_INLINE Packet<double, 2> Blend(unsigned int Mask,
+    Packet<double, 2> const& First, Packet<double, 2> const& Second) {
+    const __m128d mask = _mm_castsi128_pd(
+        _mm_set_epi64x(-static_cast<long long>((Mask >> 1) & 1),
+            -static_cast<long long>(Mask & 1)));
+    return Packet<double, 2>(_mm_or_pd(_mm_and_pd(mask, Second.value()),
+        _mm_andnot_pd(mask, First.value())));
+}
+
+AMATRIX_ALWAYS_INLINE Packet<float, 4> Blend(unsigned int Mask,
+    Packet<float, 4> const& First, Packet<float, 4> const& Second) {
+    const __m128 mask = _mm_castsi128_ps(
+        _mm_set_epi32(-static_cast<int>((Mask >> 3) & 1),
+            -static_cast<int>((Mask >> 2) & 1),
+            -static_cast<int>((Mask >> 1) & 1), -static_cast<int>(Mask & 1)));
+    return Packet<float, 4>(_mm_or_ps(_mm_and_ps(mask, Second.value()),
+        _mm_andnot_ps(mask, First.value())));
+}
+
+AMATRIX_ALWAYS_INLINE Packet<double, 2> SwapPairs(
+    Packet<double, 2> const& ThePacket) {
+    return Packet<double, 2>(
+        _mm_shuffle_pd(ThePacket.value(), ThePacket.value(), 1));
+}
+
+AMATRIX_ALWAYS_INLINE void StreamStore(
+    Packet<double, 2> const& ThePacket, double* pData) {
+    _mm_stream_pd(pData, ThePacket.value());
+}
+
+AMATRIX_ALWAYS_INLINE void StreamStore(
+    Packet<float, 4> const& ThePacket, float* pData) {
+    _mm_stream_ps(pData, ThePacket.value());
+}
+
+AMATRIX_ALWAYS_INLINE Packet<float, 4> SwapPairs(
+    Packet<float, 4> const& ThePacket) {
+    return Packet<float, 4>(_mm_shuffle_ps(
+        ThePacket.value(), ThePacket.value(), _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+#endif  // AMATRIX_HAS_SSE2_PACKETS
+
+#if defined(AMATRIX_HAS_AVX2_PACKETS)
+
+AMATRIX_DEFINE_PACKET_STORES(AMATRIX_AVX2_PACKET_INLINE, Avx2Double, double, __m256d, _mm256_store_pd,
+    _mm256_storeu_pd)
+AMATRIX_DEFINE_PACKET(AMATRIX_AVX2_PACKET_INLINE, double, 4, __m256d,
+    _mm256_setzero_pd, _mm256_set1_pd, _mm256_load_pd, _mm256_loadu_pd,
+    Avx2DoubleStore, Avx2DoubleStoreUnaligned)
+AMATRIX_DEFINE_PACKET_OPERATORS(AMATRIX_AVX2_PACKET_INLINE, double, 4,
+    _mm256_add_pd, _mm256_sub_pd, _mm256_mul_pd)
+
+AMATRIX_DEFINE_PACKET_STORES(AMATRIX_AVX2_PACKET_INLINE, Avx2Float, float, __m256, _mm256_store_ps,
+    _mm256_storeu_ps)
+AMATRIX_DEFINE_PACKET(AMATRIX_AVX2_PACKET_INLINE, float, 8, __m256,
+    _mm256_setzero_ps, _mm256_set1_ps, _mm256_load_ps, _mm256_loadu_ps,
+    Avx2FloatStore, Avx2FloatStoreUnaligned)
+AMATRIX_DEFINE_PACKET_OPERATORS(AMATRIX_AVX2_PACKET_INLINE, float, 8,
+    _mm256_add_ps, _mm256_sub_ps, _mm256_mul_ps)
+
+/// Elements below Size are set in the masks of maskload and maskstore
+AMATRIX_AVX2_PACKET_INLINE __m256i Avx2TailMask64(std::size_t Size) {
+    return _mm256_cmpgt_epi64(_mm256_set1_epi64x(static_cast<long long>(Size)),
+        _mm256_setr_epi64x(0, 1, 2, 3));
+}
+
+AMATRIX_AVX2_PACKET_INLINE __m256i Avx2TailMask32(std::size_t Size) {
+    return _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(Size)),
+        _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+AMATRIX_AVX2_PACKET_INLINE Packet<double, 4> Packet<double, 4>::load_partial(
+    double const* pData, std::size_t Size) {
+    return Packet(_mm256_maskload_pd(pData, Avx2TailMask64(Size)));
+}
+
+AMATRIX_AVX2_PACKET_INLINE void Packet<double, 4>::store_partial(
+    double* pData, std::size_t Size) const {
+    _mm256_maskstore_pd(pData, Avx2TailMask64(Size), _value);
+}
+
+AMATRIX_AVX2_PACKET_INLINE Packet<float, 8> Packet<float, 8>::load_partial(
+    float const* pData, std::size_t Size) {
+    return Packet(_mm256_maskload_ps(pData, Avx2TailMask32(Size)));
+}
+
+AMATRIX_AVX2_PACKET_INLINE void Packet<float, 8>::store_partial(
+    float* pData, std::size_t Size) const {
+    _mm256_maskstore_ps(pData, Avx2TailMask32(Size), _value);
+}
+
+// AVX2 gathers with 64 bit indices, it has no scatter instructions
+
+AMATRIX_AVX2_PACKET_INLINE Packet<double, 4> Packet<double, 4>::load_strided(
+    double const* pData, std::size_t Stride) {
+    const long long stride = static_cast<long long>(Stride);
+    return Packet(_mm256_i64gather_pd(pData,
+        _mm256_setr_epi64x(0, stride, 2 * stride, 3 * stride), 8));
+}
+
+AMATRIX_AVX2_PACKET_INLINE Packet<double, 4> Packet<double, 4>::gather(
+    double const* pData, std::size_t const* pIndices) {
+    return Packet(_mm256_i64gather_pd(pData,
+        _mm256_loadu_si256(reinterpret_cast<__m256i const*>(pIndices)), 8));
+}
+
+AMATRIX_AVX2_PACKET_INLINE Packet<float, 8> Packet<float, 8>::load_strided(
+    float const* pData, std::size_t Stride) {
+    const long long stride = static_cast<long long>(Stride);
+    const __m256i indices =
+        _mm256_setr_epi64x(0, stride, 2 * stride, 3 * stride);
+    return Packet(_mm256_set_m128(
+        _mm256_i64gather_ps(pData + 4 * Stride, indices, 4),
+        _mm256_i64gather_ps(pData, indices, 4)));
+}
+
+AMATRIX_AVX2_PACKET_INLINE Packet<float, 8> Packet<float, 8>::gather(
+    float const* pData, std::size_t const* pIndices) {
+    __m256i const* indices = reinterpret_cast<__m256i const*>(pIndices);
+    return Packet(_mm256_set_m128(
+        _mm256_i64gather_ps(pData, _mm256_loadu_si256(indices + 1), 4),
+        _mm256_i64gather_ps(pData, _mm256_loadu_si256(indices), 4)));
+}
+
+AMATRIX_DEFINE_BUFFERED_SCATTER(AMATRIX_AVX2_PACKET_INLINE, double, 4)
+AMATRIX_DEFINE_BUFFERED_SCATTER(AMATRIX_AVX2_PACKET_INLINE, float, 8)
+
+AMATRIX_AVX2_PACKET_INLINE Packet<double, 4> MultiplyAdd(
+    Packet<double, 4> const& First, Packet<double, 4> const& Second,
+    Packet<double, 4> const& Third) {
+    return Packet<double, 4>(
+        _mm256_fmadd_pd(First.value(), Second.value(), Third.value()));
+}
+
+AMATRIX_AVX2_PACKET_INLINE Packet<float, 8> MultiplyAdd(
+    Packet<float, 8> const& First, Packet<float, 8> const& Second,
+    Packet<float, 8> const& Third) {
+    return Packet<float, 8>(
+        _mm256_fmadd_ps(First.value(), Second.value(), Third.value()));
+}
+
+AMATRIX_AVX2_PACKET_INLINE double ReduceSum(Packet<double, 4> const& ThePacket) {
+    const __m256d value = ThePacket.value();
+    const __m128d halves = _mm_add_pd(
+        _mm256_castpd256_pd128(value), _mm256_extractf128_pd(value, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(halves, _mm_unpackhi_pd(halves, halves)));
+}
+
+AMATRIX_AVX2_PACKET_INLINE float ReduceSum(Packet<float, 8> const& ThePacket) {
+    const __m256 value = ThePacket.value();
+    const __m128 halves = _mm_add_ps(
+        _mm256_castps256_ps128(value), _mm256_extractf128_ps(value, 1));
+    const __m128 pairs = _mm_add_ps(halves, _mm_movehl_ps(halves, halves));
+    return _mm_cvtss_f32(
+        _mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+}
+
+AMATRIX_AVX2_PACKET_INLINE Packet<double, 4> Blend(unsigned int Mask,
+    Packet<double, 4> const& First, Packet<double, 4> const& Second) {
+    const __m256i bits = _mm256_setr_epi64x(1, 2, 4, 8);
+    const __m256i mask = _mm256_cmpeq_epi64(
+        _mm256_and_si256(_mm256_set1_epi64x(Mask), bits), bits);
+    return Packet<double, 4>(_mm256_blendv_pd(
+        First.value(), Second.value(), _mm256_castsi256_pd(mask)));
+}
+
+AMATRIX_AVX2_PACKET_INLINE Packet<float, 8> Blend(unsigned int Mask,
+    Packet<float, 8> const& First, Packet<float, 8> const& Second) {
+    const __m256i bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    const __m256i mask = _mm256_cmpeq_epi32(
+        _mm256_and_si256(_mm256_set1_epi32(static_cast<int>(Mask)), bits),
+        bits);
+    return Packet<float, 8>(_mm256_blendv_ps(
+        First.value(), Second.value(), _mm256_castsi256_ps(mask)));
+}
+
+AMATRIX_AVX2_PACKET_INLINE Packet<double, 4> SwapPairs(
+    Packet<double, 4> const& ThePacket) {
+    return Packet<double, 4>(_mm256_permute_pd(ThePacket.value(), 0x5));
+}
+
+AMATRIX_AVX2_PACKET_INLINE Packet<float, 8> SwapPairs(
+    Packet<float, 8> const& ThePacket) {
+    return Packet<float, 8>(_mm256_permute_ps(ThePacket.value(), 0xb1));
+}
+
+AMATRIX_AVX2_PACKET_INLINE void StreamStore(
+    Packet<double, 4> const& ThePacket, double* pData) {
+    _mm256_stream_pd(pData, ThePacket.value());
+}
+
+AMATRIX_AVX2_PACKET_INLINE void StreamStore(
+    Packet<float, 8> const& ThePacket, float* pData) {
+    _mm256_stream_ps(pData, ThePacket.value());
+}
+
+#endif  // AMATRIX_HAS_AVX2_PACKETS
+
+#if defined(AMATRIX_HAS_AVX512_PACKETS)
+
+AMATRIX_DEFINE_PACKET_STORES(AMATRIX_AVX512_PACKET_INLINE, Avx512Double, double, __m512d, _mm512_store_pd,
+    _mm512_storeu_pd)
+AMATRIX_DEFINE_PACKET(AMATRIX_AVX512_PACKET_INLINE, double, 8, __m512d,
+    _mm512_setzero_pd, _mm512_set1_pd, _mm512_load_pd, _mm512_loadu_pd,
+    Avx512DoubleStore, Avx512DoubleStoreUnaligned)
+AMATRIX_DEFINE_PACKET_OPERATORS(AMATRIX_AVX512_PACKET_INLINE, double, 8,
+    _mm512_add_pd, _mm512_sub_pd, _mm512_mul_pd)
+
+AMATRIX_DEFINE_PACKET_STORES(AMATRIX_AVX512_PACKET_INLINE, Avx512Float, float, __m512, _mm512_store_ps,
+    _mm512_storeu_ps)
+AMATRIX_DEFINE_PACKET(AMATRIX_AVX512_PACKET_INLINE, float, 16, __m512,
+    _mm512_setzero_ps, _mm512_set1_ps, _mm512_load_ps, _mm512_loadu_ps,
+    Avx512FloatStore, Avx512FloatStoreUnaligned)
+AMATRIX_DEFINE_PACKET_OPERATORS(AMATRIX_AVX512_PACKET_INLINE, float, 16,
+    _mm512_add_ps, _mm512_sub_ps, _mm512_mul_ps)
+
+AMATRIX_AVX512_PACKET_INLINE Packet<double, 8> Packet<double, 8>::load_partial(
+    double const* pData, std::size_t Size) {
+    return Packet(_mm512_maskz_loadu_pd(
+        static_cast<__mmask8>((1u << Size) - 1), pData));
+}
+
+AMATRIX_AVX512_PACKET_INLINE void Packet<double, 8>::store_partial(
+    double* pData, std::size_t Size) const {
+    _mm512_mask_storeu_pd(
+        pData, static_cast<__mmask8>((1u << Size) - 1), _value);
+}
+
+AMATRIX_AVX512_PACKET_INLINE Packet<float, 16> Packet<float, 16>::load_partial(
+    float const* pData, std::size_t Size) {
+    return Packet(_mm512_maskz_loadu_ps(
+        static_cast<__mmask16>((1u << Size) - 1), pData));
+}
+
+AMATRIX_AVX512_PACKET_INLINE void Packet<float, 16>::store_partial(
+    float* pData, std::size_t Size) const {
+    _mm512_mask_storeu_ps(
+        pData, static_cast<__mmask16>((1u << Size) - 1), _value);
+}
+
+/// Offsets of the elements of a packet of eight Stride apart
+AMATRIX_AVX512_PACKET_INLINE __m512i Avx512Strides(std::size_t Stride) {
+    const long long stride = static_cast<long long>(Stride);
+    return _mm512_setr_epi64(0, stride, 2 * stride, 3 * stride, 4 * stride,
+        5 * stride, 6 * stride, 7 * stride);
+}
+
+AMATRIX_AVX512_PACKET_INLINE Packet<double, 8> Packet<double, 8>::load_strided(
+    double const* pData, std::size_t Stride) {
+    return Packet(_mm512_i64gather_pd(Avx512Strides(Stride), pData, 8));
+}
+
+AMATRIX_AVX512_PACKET_INLINE Packet<double, 8> Packet<double, 8>::gather(
+    double const* pData, std::size_t const* pIndices) {
+    return Packet(_mm512_i64gather_pd(_mm512_loadu_si512(pIndices), pData, 8));
+}
+
+AMATRIX_AVX512_PACKET_INLINE void Packet<double, 8>::store_strided(
+    double* pData, std::size_t Stride) const {
+    _mm512_i64scatter_pd(pData, Avx512Strides(Stride), _value, 8);
+}
+
+/// The indices must differ, otherwise the element stored last is kept
+AMATRIX_AVX512_PACKET_INLINE void Packet<double, 8>::scatter(
+    double* pData, std::size_t const* pIndices) const {
+    _mm512_i64scatter_pd(pData, _mm512_loadu_si512(pIndices), _value, 8);
+}
+
+// A packet of 16 floats takes two gathers or scatters of 8 with 64 bit
+// indices, one for each half
+
+AMATRIX_AVX512_PACKET_INLINE __m512 Avx512Combine(__m256 Low, __m256 High) {
+    return _mm512_castpd_ps(_mm512_insertf64x4(
+        _mm512_castpd256_pd512(_mm256_castps_pd(Low)),
+        _mm256_castps_pd(High), 1));
+}
+
+AMATRIX_AVX512_PACKET_INLINE __m256 Avx512HighHalf(__m512 Value) {
+    return _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(Value), 1));
+}
+
+AMATRIX_AVX512_PACKET_INLINE Packet<float, 16> Packet<float, 16>::load_strided(
+    float const* pData, std::size_t Stride) {
+    const __m512i strides = Avx512Strides(Stride);
+    return Packet(Avx512Combine(_mm512_i64gather_ps(strides, pData, 4),
+        _mm512_i64gather_ps(strides, pData + 8 * Stride, 4)));
+}
+
+AMATRIX_AVX512_PACKET_INLINE Packet<float, 16> Packet<float, 16>::gather(
+    float const* pData, std::size_t const* pIndices) {
+    return Packet(Avx512Combine(
+        _mm512_i64gather_ps(_mm512_loadu_si512(pIndices), pData, 4),
+        _mm512_i64gather_ps(_mm512_loadu_si512(pIndices + 8), pData, 4)));
+}
+
+AMATRIX_AVX512_PACKET_INLINE void Packet<float, 16>::store_strided(
+    float* pData, std::size_t Stride) const {
+    const __m512i strides = Avx512Strides(Stride);
+    _mm512_i64scatter_ps(pData, strides, _mm512_castps512_ps256(_value), 4);
+    _mm512_i64scatter_ps(
+        pData + 8 * Stride, strides, Avx512HighHalf(_value), 4);
+}
+
+AMATRIX_AVX512_PACKET_INLINE void Packet<float, 16>::scatter(
+    float* pData, std::size_t const* pIndices) const {
+    _mm512_i64scatter_ps(pData, _mm512_loadu_si512(pIndices),
+        _mm512_castps512_ps256(_value), 4);
+    _mm512_i64scatter_ps(pData, _mm512_loadu_si512(pIndices + 8),
+        Avx512HighHalf(_value), 4);
+}
+
+AMATRIX_AVX512_PACKET_INLINE Packet<double, 8> MultiplyAdd(
+    Packet<double, 8> const& First, Packet<double, 8> const& Second,
+    Packet<double, 8> const& Third) {
+    return Packet<double, 8>(
+        _mm512_fmadd_pd(First.value(), Second.value(), Third.value()));
+}
+
+AMATRIX_AVX512_PACKET_INLINE Packet<float, 16> MultiplyAdd(
+    Packet<float, 16> const& First, Packet<float, 16> const& Second,
+    Packet<float, 16> const& Third) {
+    return Packet<float, 16>(
+        _mm512_fmadd_ps(First.value(), Second.value(), Third.value()));
+}
+
+AMATRIX_AVX512_PACKET_INLINE double ReduceSum(
+    Packet<double, 8> const& ThePacket) {
+    return _mm512_reduce_add_pd(ThePacket.value());
+}
+
+AMATRIX_AVX512_PACKET_INLINE float ReduceSum(
+    Packet<float, 16> const& ThePacket) {
+    return _mm512_reduce_add_ps(ThePacket.value());
+}
+
+AMATRIX_AVX512_PACKET_INLINE Packet<double, 8> Blend(unsigned int Mask,
+    Packet<double, 8> const& First, Packet<double, 8> const& Second) {
+    return Packet<double, 8>(_mm512_mask_blend_pd(
+        static_cast<__mmask8>(Mask), First.value(), Second.value()));
+}
+
+AMATRIX_AVX512_PACKET_INLINE Packet<float, 16> Blend(unsigned int Mask,
+    Packet<float, 16> const& First, Packet<float, 16> const& Second) {
+    return Packet<float, 16>(_mm512_mask_blend_ps(
+        static_cast<__mmask16>(Mask), First.value(), Second.value()));
+}
+
+AMATRIX_AVX512_PACKET_INLINE Packet<double, 8> SwapPairs(
+    Packet<double, 8> const& ThePacket) {
+    return Packet<double, 8>(_mm512_permute_pd(ThePacket.value(), 0x55));
+}
+
+AMATRIX_AVX512_PACKET_INLINE Packet<float, 16> SwapPairs(
+    Packet<float, 16> const& ThePacket) {
+    return Packet<float, 16>(_mm512_permute_ps(ThePacket.value(), 0xb1));
+}
+
+AMATRIX_AVX512_PACKET_INLINE void StreamStore(
+    Packet<double, 8> const& ThePacket, double* pData) {
+    _mm512_stream_pd(pData, ThePacket.value());
+}
+
+AMATRIX_AVX512_PACKET_INLINE void StreamStore(
+    Packet<float, 16> const& ThePacket, float* pData) {
+    _mm512_stream_ps(pData, ThePacket.value());
+}
+
+#endif  // AMATRIX_HAS_AVX512_PACKETS
+
+#if defined(AMATRIX_HAS_NEON_PACKETS)
+
+AMATRIX_ALWAYS_INLINE float64x2_t NeonZeroF64() { return vdupq_n_f64(0.0); }
+
+AMATRIX_ALWAYS_INLINE float32x4_t NeonZeroF32() { return vdupq_n_f32(0.0f); }
+
+AMATRIX_ALWAYS_INLINE void NeonStoreF64(double* pData, float64x2_t Value) {
+    vst1q_f64(pData, Value);
+}
+
+AMATRIX_ALWAYS_INLINE void NeonStoreF32(float* pData, float32x4_t Value) {
+    vst1q_f32(pData, Value);
+}
+
+AMATRIX_DEFINE_PACKET(AMATRIX_ALWAYS_INLINE, double, 2, float64x2_t,
+    NeonZeroF64, vdupq_n_f64, vld1q_f64, vld1q_f64, NeonStoreF64,
+    NeonStoreF64)
+AMATRIX_DEFINE_PACKET_OPERATORS(
+    AMATRIX_ALWAYS_INLINE, double, 2, vaddq_f64, vsubq_f64, vmulq_f64)
+AMATRIX_DEFINE_BUFFERED_PARTIAL_ACCESS(AMATRIX_ALWAYS_INLINE, double, 2)
+AMATRIX_DEFINE_BUFFERED_GATHER(AMATRIX_ALWAYS_INLINE, double, 2)
+AMATRIX_DEFINE_BUFFERED_SCATTER(AMATRIX_ALWAYS_INLINE, double, 2)
+
+AMATRIX_DEFINE_PACKET(AMATRIX_ALWAYS_INLINE, float, 4, float32x4_t,
+    NeonZeroF32, vdupq_n_f32, vld1q_f32, vld1q_f32, NeonStoreF32,
+    NeonStoreF32)
+AMATRIX_DEFINE_PACKET_OPERATORS(
+    AMATRIX_ALWAYS_INLINE, float, 4, vaddq_f32, vsubq_f32, vmulq_f32)
+AMATRIX_DEFINE_BUFFERED_PARTIAL_ACCESS(AMATRIX_ALWAYS_INLINE, float, 4)
+AMATRIX_DEFINE_BUFFERED_GATHER(AMATRIX_ALWAYS_INLINE, float, 4)
+AMATRIX_DEFINE_BUFFERED_SCATTER(AMATRIX_ALWAYS_INLINE, float, 4)
+
+AMATRIX_ALWAYS_INLINE Packet<double, 2> MultiplyAdd(Packet<double, 2> const& First,
+    Packet<double, 2> const& Second, Packet<double, 2> const& Third) {
+    return Packet<double, 2>(
+        vfmaq_f64(Third.value(), First.value(), Second.value()));
+}
+
+AMATRIX_ALWAYS_INLINE Packet<float, 4> MultiplyAdd(Packet<float, 4> const& First,
+    Packet<float, 4> const& Second, Packet<float, 4> const& Third) {
+    return Packet<float, 4>(
+        vfmaq_f32(Third.value(), First.value(), Second.value()));
+}
+
+AMATRIX_ALWAYS_INLINE double ReduceSum(Packet<double, 2> const& ThePacket) {
+    return vaddvq_f64(ThePacket.value());
+}
+
+AMATRIX_ALWAYS_INLINE float ReduceSum(Packet<float, 4> const& ThePacket) {
+    return vaddvq_f32(ThePacket.value());
+}
+
+AMATRIX_ALWAYS_INLINE Packet<double, 2> Blend(unsigned int Mask,
+    Packet<double, 2> const& First, Packet<double, 2> const& Second) {
+    const std::uint64_t bits[2] = {0 - static_cast<std::uint64_t>(Mask & 1),
+        0 - static_cast<std::uint64_t>((Mask >> 1) & 1)};
+    return Packet<double, 2>(
+        vbslq_f64(vld1q_u64(bits), Second.value(), First.value()));
+}
+
+AMATRIX_ALWAYS_INLINE Packet<float, 4> Blend(unsigned int Mask,
+    Packet<float, 4> const& First, Packet<float, 4> const& Second) {
+    const std::uint32_t bits[4] = {0 - (Mask & 1), 0 - ((Mask >> 1) & 1),
+        0 - ((Mask >> 2) & 1), 0 - ((Mask >> 3) & 1)};
+    return Packet<float, 4>(
+        vbslq_f32(vld1q_u32(bits), Second.value(), First.value()));
+}
+
+AMATRIX_ALWAYS_INLINE Packet<double, 2> SwapPairs(
+    Packet<double, 2> const& ThePacket) {
+    return Packet<double, 2>(
+        vextq_f64(ThePacket.value(), ThePacket.value(), 1));
+}
+
+AMATRIX_ALWAYS_INLINE Packet<float, 4> SwapPairs(
+    Packet<float, 4> const& ThePacket) {
+    return Packet<float, 4>(vrev64q_f32(ThePacket.value()));
+}
+
+#endif  // AMATRIX_HAS_NEON_PACKETS
+
+#undef AMATRIX_DEFINE_PACKET
+#undef AMATRIX_DEFINE_PACKET_OPERATORS
+#undef AMATRIX_DEFINE_PACKET_STORES
+#undef AMATRIX_DEFINE_BUFFERED_PARTIAL_ACCESS
+#undef AMATRIX_DEFINE_BUFFERED_GATHER
+#undef AMATRIX_DEFINE_BUFFERED_SCATTER
+
+}  // namespace AMatrix
@@ -0,0 +1,384 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+namespace AMatrix {
+
+/// Number of threads used by the parallel kernels. The default is taken from
+/// the AMATRIX_NUM_THREADS environment variable or the hardware concurrency
+inline std::size_t& NumberOfThreadsReference() {
+    static std::size_t number_of_threads = []() -> std::size_t {
+        const char* p_value = std::getenv("AMATRIX_NUM_THREADS");
+        if (p_value) {
+            const long value = std::atol(p_value);
+            if (value > 0)
+                return static_cast<std::size_t>(value);
+        }
+        const std::size_t hardware_threads =
+            std::thread::hardware_concurrency();
+        return (hardware_threads > 0) ? hardware_threads : 1;
+    }();
+    return number_of_threads;
+}
+
+inline std::size_t GetNumberOfThreads() { return NumberOfThreadsReference(); }
+
+/// When true the parallel reductions give bitwise identical results for any
+/// number of threads. The default can be set by defining
+/// AMATRIX_REPRODUCIBLE_REDUCTIONS or by the environment variable with the
+/// same name
+inline bool& ReproducibleReductionsReference() {
+    static bool is_reproducible = []() -> bool {
+#if defined(AMATRIX_REPRODUCIBLE_REDUCTIONS)
+        return true;
+#else
+        const char* p_value = std::getenv("AMATRIX_REPRODUCIBLE_REDUCTIONS");
+        return p_value && std::atoi(p_value) != 0;
+#endif
+    }();
+    return is_reproducible;
+}
+
+inline bool GetReproducibleReductions() {
+    return ReproducibleReductionsReference();
+}
+
+inline void SetReproducibleReductions(bool IsReproducible) {
+    ReproducibleReductionsReference() = IsReproducible;
+}
+
+/// True inside a task of an executor. Parallel kernels which are called
+/// from a task run serially instead of splitting their work again
+inline bool& ParallelRegionReference() {
+    static thread_local bool is_in_parallel_region = false;
+    return is_in_parallel_region;
+}
+
+inline bool IsInParallelRegion() { return ParallelRegionReference(); }
+
+/// Marks the current thread as inside a task until it is destroyed
+class ParallelRegionGuard {
+    bool _was_in_parallel_region;
+
+   public:
+    ParallelRegionGuard() : _was_in_parallel_region(IsInParallelRegion()) {
+        ParallelRegionReference() = true;
+    }
+
+    ParallelRegionGuard(ParallelRegionGuard const& Other) = delete;
+
+    ParallelRegionGuard& operator=(ParallelRegionGuard const& Other) = delete;
+
+    ~ParallelRegionGuard() {
+        ParallelRegionReference() = _was_in_parallel_region;
+    }
+};
+
+/// Runs the tasks of the parallel kernels. run(NumberOfTasks, Task) calls
+/// Task(i) once for every i < NumberOfTasks, in any order and on any of
+/// its threads, and returns when all calls are done. Applications derive
+/// from it to run the kernels in their own scheduler. The tasks must run
+/// inside a ParallelRegionGuard, so nested kernels stay serial
+class Executor {
+   public:
+    virtual ~Executor() {}
+
+    /// Number of tasks which run at the same time, the kernels split their
+    /// work into this many chunks
+    virtual std::size_t number_of_threads() const = 0;
+
+    virtual void run(std::size_t NumberOfTasks,
+        std::function<void(std::size_t)> const& Task) = 0;
+};
+
+/// Runs the tasks one after the other in the calling thread
+class SerialExecutor : public Executor {
+   public:
+    std::size_t number_of_threads() const override { return 1; }
+
+    void run(std::size_t NumberOfTasks,
+        std::function<void(std::size_t)> const& Task) override {
+        ParallelRegionGuard guard;
+        for (std::size_t i = 0; i < NumberOfTasks; i++)
+            Task(i);
+    }
+};
+
+/// Pool of threads which live as long as the executor. The tasks of a run
+/// are dealt to one queue per thread in consecutive blocks, the calling
+/// thread takes part as the first one. A thread which runs out of tasks
+/// steals from the front of the other queues, so uneven tasks are
+/// balanced. Runs from several threads are executed one after the other
+class ThreadPoolExecutor : public Executor {
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<std::size_t> tasks;
+    };
+
+    std::vector<std::unique_ptr<TaskQueue>> _queues;
+    std::vector<std::thread> _threads;
+    std::mutex _run_mutex;
+    std::mutex _mutex;
+    std::condition_variable _start_condition;
+    std::condition_variable _done_condition;
+    std::function<void(std::size_t)> const* _p_task = nullptr;
+    std::size_t _generation = 0;
+    std::size_t _number_of_remaining_tasks = 0;
+    bool _is_stopped = false;
+    std::atomic<std::size_t> _number_of_threads{0};
+
+   public:
+    explicit ThreadPoolExecutor(std::size_t NumberOfThreads) {
+        start(NumberOfThreads);
+    }
+
+    ThreadPoolExecutor(ThreadPoolExecutor const& Other) = delete;
+
+    ThreadPoolExecutor& operator=(ThreadPoolExecutor const& Other) = delete;
+
+    ~ThreadPoolExecutor() override { stop(); }
+
+    std::size_t number_of_threads() const override {
+        return _number_of_threads;
+    }
+
+    /// Restarts the pool with another number of threads, after the running
+    /// tasks are done
+    void resize(std::size_t NumberOfThreads) {
+        if (NumberOfThreads == _number_of_threads)
+            return;
+        std::lock_guard<std::mutex> run_lock(_run_mutex);
+        stop();
+        start(NumberOfThreads);
+    }
+
+    void run(std::size_t NumberOfTasks,
+        std::function<void(std::size_t)> const& Task) override {
+        if (NumberOfTasks < 2 || _threads.empty() || IsInParallelRegion()) {
+            SerialExecutor().run(NumberOfTasks, Task);
+            return;
+        }
+
+        std::lock_guard<std::mutex> run_lock(_run_mutex);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _p_task = &Task;
+            _number_of_remaining_tasks = NumberOfTasks;
+            const std::size_t number_of_queues = _queues.size();
+            for (std::size_t i = 0; i < NumberOfTasks; i++) {
+                TaskQueue& r_queue =
+                    *_queues[i * number_of_queues / NumberOfTasks];
+                std::lock_guard<std::mutex> queue_lock(r_queue.mutex);
+                r_queue.tasks.push_back(i);
+            }
+            _generation++;
+        }
+        _start_condition.notify_all();
+
+        execute_tasks(0);
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done_condition.wait(
+            lock, [this]() { return _number_of_remaining_tasks == 0; });
+        _p_task = nullptr;
+    }
+
+   private:
+    void start(std::size_t NumberOfThreads) {
+        const std::size_t number_of_threads =
+            (NumberOfThreads > 0) ? NumberOfThreads : 1;
+        _is_stopped = false;
+        _number_of_threads = number_of_threads;
+        for (std::size_t i = 0; i < number_of_threads; i++)
+            _queues.emplace_back(new TaskQueue);
+        for (std::size_t i = 1; i < number_of_threads; i++)
+            _threads.emplace_back([this, i]() { work(i); });
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _is_stopped = true;
+        }
+        _start_condition.notify_all();
+        for (auto& thread : _threads)
+            thread.join();
+        _threads.clear();
+        _queues.clear();
+    }
+
+    void work(std::size_t QueueIndex) {
+        std::size_t generation = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _start_condition.wait(lock, [&]() {
+                    return _is_stopped || _generation != generation;
+                });
+                if (_is_stopped)
+                    return;
+                generation = _generation;
+            }
+            execute_tasks(QueueIndex);
+        }
+    }
+
+    /// Takes a task from the back of the own queue or else from the front
+    /// of another one
+    bool take_task(std::size_t QueueIndex, std::size_t& rTask) {
+        const std::size_t number_of_queues = _queues.size();
+        for (std::size_t k = 0; k < number_of_queues; k++) {
+            TaskQueue& r_queue = *_queues[(QueueIndex + k) % number_of_queues];
+            std::lock_guard<std::mutex> queue_lock(r_queue.mutex);
+            if (r_queue.tasks.empty())
+                continue;
+            if (k == 0) {
+                rTask = r_queue.tasks.back();
+                r_queue.tasks.pop_back();
+            } else {
+                rTask = r_queue.tasks.front();
+                r_queue.tasks.pop_front();
+            }
+            return true;
+        }
+        return false;
+    }
+
+    void execute_tasks(std::size_t QueueIndex) {
+        std::size_t task;
+        while (take_task(QueueIndex, task)) {
+            {
+                ParallelRegionGuard guard;
+                (*_p_task)(task);
+            }
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (--_number_of_remaining_tasks == 0)
+                _done_condition.notify_all();
+        }
+    }
+};
+
+#if defined(_OPENMP)
+/// Runs the tasks in a parallel loop of OpenMP, in the threads of the
+/// OpenMP runtime of the application
+class OpenMPExecutor : public Executor {
+   public:
+    std::size_t number_of_threads() const override {
+        return static_cast<std::size_t>(omp_get_max_threads());
+    }
+
+    void run(std::size_t NumberOfTasks,
+        std::function<void(std::size_t)> const& Task) override {
+        if (omp_in_parallel() || IsInParallelRegion()) {
+            SerialExecutor().run(NumberOfTasks, Task);
+            return;
+        }
+        const long number_of_tasks = static_cast<long>(NumberOfTasks);
+#pragma omp parallel for schedule(dynamic, 1)
+        for (long i = 0; i < number_of_tasks; i++) {
+            ParallelRegionGuard guard;
+            Task(static_cast<std::size_t>(i));
+        }
+    }
+};
+#endif
+
+/// The built-in pool with GetNumberOfThreads() threads
+inline ThreadPoolExecutor& DefaultThreadPool() {
+    static ThreadPoolExecutor pool(GetNumberOfThreads());
+    return pool;
+}
+
+/// Sets the number of threads and resizes the default thread pool, so
+/// GetExecutor() itself never restarts the pool while it runs
+inline void SetNumberOfThreads(std::size_t NumberOfThreads) {
+    NumberOfThreadsReference() = (NumberOfThreads > 0) ? NumberOfThreads : 1;
+    DefaultThreadPool().resize(GetNumberOfThreads());
+}
+
+/// Executor of the parallel kernels, the default thread pool unless it is
+/// set by SetExecutor. The default can also be chosen with the
+/// AMATRIX_EXECUTOR environment variable: threads, serial or openmp
+inline Executor*& ExecutorReference() {
+    static Executor* p_executor = []() -> Executor* {
+        const char* p_value = std::getenv("AMATRIX_EXECUTOR");
+        if (p_value && std::strcmp(p_value, "serial") == 0) {
+            static SerialExecutor serial_executor;
+            return &serial_executor;
+        }
+#if defined(_OPENMP)
+        if (p_value && std::strcmp(p_value, "openmp") == 0) {
+            static OpenMPExecutor openmp_executor;
+            return &openmp_executor;
+        }
+#endif
+        return nullptr;
+    }();
+    return p_executor;
+}
+
+inline Executor& GetExecutor() {
+    Executor* p_executor = ExecutorReference();
+    return p_executor ? *p_executor : DefaultThreadPool();
+}
+
+/// Sets the executor of the parallel kernels, which must outlive its use.
+/// A nullptr restores the default thread pool
+inline void SetExecutor(Executor* pExecutor) {
+    ExecutorReference() = pExecutor;
+}
+
+/// Number of chunks the parallel kernels split their work into: the
+/// threads of the executor, or one inside a task
+inline std::size_t GetParallelism() {
+    return IsInParallelRegion() ? 1 : GetExecutor().number_of_threads();
+}
+
+/// Calls Function(ChunkBegin, ChunkEnd) for consecutive chunks of the range
+/// [Begin, End), one chunk per thread of the executor. Ranges with less
+/// than MinimumChunkSize items per thread are split into fewer chunks and a
+/// single chunk is executed in the calling thread
+template <typename TFunctionType>
+void ParallelFor(std::size_t Begin, std::size_t End,
+    std::size_t MinimumChunkSize, TFunctionType const& Function) {
+    if (End <= Begin)
+        return;
+
+    const std::size_t size = End - Begin;
+    const std::size_t minimum_chunk_size =
+        (MinimumChunkSize > 0) ? MinimumChunkSize : 1;
+    std::size_t number_of_chunks = GetParallelism();
+    if (size / minimum_chunk_size < number_of_chunks)
+        number_of_chunks = size / minimum_chunk_size;
+
+    if (number_of_chunks < 2) {
+        Function(Begin, End);
+        return;
+    }
+
+    const std::size_t chunk_size = size / number_of_chunks;
+    const std::size_t remainder = size % number_of_chunks;
+    GetExecutor().run(number_of_chunks, [&](std::size_t Chunk) {
+        const std::size_t chunk_begin =
+            Begin + Chunk * chunk_size + std::min(Chunk, remainder);
+        const std::size_t chunk_end =
+            chunk_begin + chunk_size + ((Chunk < remainder) ? 1 : 0);
+        Function(chunk_begin, chunk_end);
+    });
+}
+
+}  // namespace AMatrix
@@ -0,0 +1,577 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "kernels.h"
+#include "matrix_expression.h"
+#include "matrix_vector_product.h"
+#include "temporary_pool.h"
+
+namespace AMatrix {
+
+/// C = A * B for row major contiguous operands with the kernel for the
+/// shape: the matrix vector product for a single column, inline loops for
+/// small products, the dispatched kernel otherwise
+template <typename TDataType>
+void DenseProduct(std::size_t Size1, std::size_t InnerSize, std::size_t Size2,
+    TDataType const* pA, TDataType const* pB, TDataType* pC) {
+    if (Size2 == 1) {
+        MatrixVectorProduct<dynamic, dynamic>(Size1, InnerSize, pA, pB, pC);
+        return;
+    }
+    if (Size1 * InnerSize * Size2 >= dispatch_minimum_product_size) {
+        DispatchedProduct(Size1, InnerSize, Size2, pA, pB, pC);
+        return;
+    }
+    for (std::size_t i = 0; i < Size1; i++)
+        for (std::size_t j = 0; j < Size2; j++) {
+            TDataType result = TDataType();
+            for (std::size_t k = 0; k < InnerSize; k++)
+                result += pA[i * InnerSize + k] * pB[k * Size2 + j];
+            pC[i * Size2 + j] = result;
+        }
+}
+
+/// C = A * B for row major blocks with rows LeadingA, LeadingB and
+/// LeadingC apart, with inline loops for small products and the dispatched
+/// block kernel otherwise
+template <typename TDataType>
+void DenseBlockProduct(std::size_t Size1, std::size_t InnerSize,
+    std::size_t Size2, TDataType const* pA, std::size_t LeadingA,
+    TDataType const* pB, std::size_t LeadingB, TDataType* pC,
+    std::size_t LeadingC) {
+    if (Size1 * InnerSize * Size2 >= dispatch_minimum_product_size) {
+        DispatchedBlockProduct(Size1, InnerSize, Size2, pA, LeadingA, pB,
+            LeadingB, pC, LeadingC);
+        return;
+    }
+    for (std::size_t i = 0; i < Size1; i++)
+        for (std::size_t j = 0; j < Size2; j++) {
+            TDataType result = TDataType();
+            for (std::size_t k = 0; k < InnerSize; k++)
+                result += pA[i * LeadingA + k] * pB[k * LeadingB + j];
+            pC[i * LeadingC + j] = result;
+        }
+}
+
+/// Distance of the rows of a block or of a contiguous matrix
+template <typename TMatrixType>
+std::size_t GetLeadingSize(
+    TMatrixType const& TheMatrix, std::true_type /* IsBlock */) {
+    return TheMatrix.leading_size();
+}
+
+template <typename TMatrixType>
+std::size_t GetLeadingSize(
+    TMatrixType const& TheMatrix, std::false_type /* IsBlock */) {
+    return TheMatrix.size2();
+}
+
+template <typename TMatrixType>
+std::size_t GetLeadingSize(TMatrixType const& TheMatrix) {
+    return GetLeadingSize(TheMatrix,
+        std::integral_constant<bool, IsBlock<TMatrixType>::value>());
+}
+
+/// True for the products of blocks and contiguous matrices of the same
+/// type, which the block product kernel reads directly
+template <typename TProductType,
+    typename TFirstType = typename TProductType::first_type,
+    typename TSecondType = typename TProductType::second_type>
+using IsBlockProduct = std::integral_constant<bool,
+    (IsBlock<TFirstType>::value || IsContiguous<TFirstType>::value) &&
+        (IsBlock<TSecondType>::value || IsContiguous<TSecondType>::value) &&
+        std::is_same<typename TFirstType::data_type,
+            typename TSecondType::data_type>::value>;
+
+/// Cheapest order of a chain of products A_0 * A_1 * ... * A_{n-1}, found
+/// by the classic dynamic program over the split points. Dimensions holds
+/// the number of rows of every operand followed by the number of columns of
+/// the last one. The cost of a product is its number of multiplications
+class ProductChainPlan {
+    std::size_t _length;
+    std::vector<std::size_t> _costs;
+    std::vector<std::size_t> _splits;
+
+    std::size_t index(std::size_t First, std::size_t Last) const {
+        return First * _length + Last;
+    }
+
+   public:
+    explicit ProductChainPlan(std::vector<std::size_t> const& Dimensions)
+        : _length(Dimensions.size() - 1),
+          _costs(_length * _length, 0),
+          _splits(_length * _length, 0) {
+        for (std::size_t length = 2; length <= _length; length++)
+            for (std::size_t first = 0; first + length <= _length; first++) {
+                const std::size_t last = first + length - 1;
+                std::size_t& r_cost = _costs[index(first, last)];
+                r_cost = static_cast<std::size_t>(-1);
+                for (std::size_t split = first; split < last; split++) {
+                    const std::size_t cost = _costs[index(first, split)] +
+                                             _costs[index(split + 1, last)] +
+                                             Dimensions[first] *
+                                                 Dimensions[split + 1] *
+                                                 Dimensions[last + 1];
+                    if (cost < r_cost) {
+                        r_cost = cost;
+                        _splits[index(first, last)] = split;
+                    }
+                }
+            }
+    }
+
+    std::size_t length() const { return _length; }
+
+    /// Multiplications of the cheapest order of the operands First..Last
+    std::size_t cost(std::size_t First, std::size_t Last) const {
+        return _costs[index(First, Last)];
+    }
+
+    std::size_t cost() const { return cost(0, _length - 1); }
+
+    /// The operands First..Split are multiplied with Split + 1..Last last
+    std::size_t split(std::size_t First, std::size_t Last) const {
+        return _splits[index(First, Last)];
+    }
+};
+
+/// The operands of a chain of products with dynamic sizes, flattened from
+/// the nested product expressions and evaluated in the order of a
+/// ProductChainPlan. Operands which are not contiguous matrices of the data
+/// type are evaluated once into pooled temporaries, as are the intermediate
+/// products
+template <typename TDataType>
+class ProductChain {
+    using temporary_type = TemporaryMatrix<TDataType>;
+
+    struct Operand {
+        TDataType const* p_data;
+        std::size_t size1;
+        std::size_t size2;
+    };
+
+    std::vector<Operand> _operands;
+    std::vector<std::unique_ptr<temporary_type>> _evaluated_operands;
+
+    template <typename TExpressionType>
+    void add(TExpressionType const& TheOperand, std::true_type /* IsDense */) {
+        _operands.push_back(
+            Operand{TheOperand.data(), TheOperand.size1(), TheOperand.size2()});
+    }
+
+    template <typename TExpressionType>
+    void add(
+        TExpressionType const& TheOperand, std::false_type /* IsDense */) {
+        _evaluated_operands.emplace_back(
+            new temporary_type(TheOperand.size1(), TheOperand.size2()));
+        EvaluateExpression(TheOperand, _evaluated_operands.back()->data());
+        add(*_evaluated_operands.back(), std::true_type());
+    }
+
+    /// Evaluates the operands First..Last into pResult
+    void multiply(ProductChainPlan const& Plan, std::size_t First,
+        std::size_t Last, TDataType* pResult) const {
+        const std::size_t split = Plan.split(First, Last);
+        std::unique_ptr<temporary_type> left_temporary;
+        std::unique_ptr<temporary_type> right_temporary;
+        TDataType const* p_left = part(Plan, First, split, left_temporary);
+        TDataType const* p_right =
+            part(Plan, split + 1, Last, right_temporary);
+        AMATRIX_COUNT_OPERATION(
+            product, _operands[First].size1, _operands[Last].size2);
+        DenseProduct(_operands[First].size1, _operands[split].size2,
+            _operands[Last].size2, p_left, p_right, pResult);
+    }
+
+    TDataType const* part(ProductChainPlan const& Plan, std::size_t First,
+        std::size_t Last, std::unique_ptr<temporary_type>& rTemporary) const {
+        if (First == Last)
+            return _operands[First].p_data;
+        rTemporary.reset(new temporary_type(
+            _operands[First].size1, _operands[Last].size2));
+        multiply(Plan, First, Last, rTemporary->data());
+        return rTemporary->data();
+    }
+
+   public:
+    template <typename TFirstType, typename TSecondType>
+    void add(MatrixProductExpression<TFirstType, TSecondType> const& Product) {
+        add(Product.first());
+        add(Product.second());
+    }
+
+    template <typename TExpressionType>
+    void add(TExpressionType const& TheOperand) {
+        using data_type = typename TExpressionType::data_type;
+        add(TheOperand,
+            std::integral_constant<bool,
+                IsContiguous<TExpressionType>::value &&
+                    std::is_same<data_type, TDataType>::value>());
+    }
+
+    std::size_t size() const { return _operands.size(); }
+
+    ProductChainPlan plan() const {
+        std::vector<std::size_t> dimensions;
+        for (auto& r_operand : _operands)
+            dimensions.push_back(r_operand.size1);
+        dimensions.push_back(_operands.back().size2);
+        return ProductChainPlan(dimensions);
+    }
+
+    /// pResult must not overlap the operands
+    void evaluate(TDataType* pResult) const {
+        multiply(plan(), 0, _operands.size() - 1, pResult);
+    }
+};
+
+/// Number of operands of a chain of products
+template <typename TExpressionType>
+struct ProductChainLength {
+    static constexpr std::size_t value = 1;
+};
+
+template <typename TFirstType, typename TSecondType>
+struct ProductChainLength<MatrixProductExpression<TFirstType, TSecondType>> {
+    using product_type = MatrixProductExpression<TFirstType, TSecondType>;
+    static constexpr std::size_t value =
+        ProductChainLength<typename product_type::first_type>::value +
+        ProductChainLength<typename product_type::second_type>::value;
+};
+
+/// The static sizes of the operands of a chain, in the order of the
+/// dimensions of a ProductChainPlan
+template <typename TExpressionType>
+struct StaticProductChainSizes {
+    static constexpr bool is_fixed = TExpressionType::static_size1 !=
+                                         dynamic &&
+                                     TExpressionType::static_size2 != dynamic;
+
+    static constexpr std::size_t at(std::size_t Index) {
+        return Index == 0 ? TExpressionType::static_size1
+                          : TExpressionType::static_size2;
+    }
+};
+
+template <typename TFirstType, typename TSecondType>
+struct StaticProductChainSizes<
+    MatrixProductExpression<TFirstType, TSecondType>> {
+    using product_type = MatrixProductExpression<TFirstType, TSecondType>;
+    using first_sizes =
+        StaticProductChainSizes<typename product_type::first_type>;
+    using second_sizes =
+        StaticProductChainSizes<typename product_type::second_type>;
+    static constexpr std::size_t first_length =
+        ProductChainLength<typename product_type::first_type>::value;
+    static constexpr bool is_fixed =
+        first_sizes::is_fixed && second_sizes::is_fixed;
+
+    static constexpr std::size_t at(std::size_t Index) {
+        return Index < first_length ? first_sizes::at(Index)
+                                    : second_sizes::at(Index - first_length);
+    }
+};
+
+/// The ProductChainPlan of a chain with fixed sizes, computed at compile
+/// time. Of the splits with the same cost the first one is taken, as by
+/// ProductChainPlan
+template <typename TProductType>
+struct StaticProductChainPlan {
+    using sizes = StaticProductChainSizes<TProductType>;
+
+    static constexpr std::size_t cost(std::size_t First, std::size_t Last) {
+        return First == Last ? 0
+                             : split_cost(First, Last, split(First, Last));
+    }
+
+    static constexpr std::size_t split(std::size_t First, std::size_t Last) {
+        return cheapest_split(First, Last, First);
+    }
+
+   private:
+    static constexpr std::size_t split_cost(
+        std::size_t First, std::size_t Last, std::size_t Split) {
+        return cost(First, Split) + cost(Split + 1, Last) +
+               sizes::at(First) * sizes::at(Split + 1) *
+                   sizes::at(Last + 1);
+    }
+
+    /// The cheapest of the splits from Split to Last - 1
+    static constexpr std::size_t cheapest_split(
+        std::size_t First, std::size_t Last, std::size_t Split) {
+        return Split + 1 == Last ||
+                       split_cost(First, Last, Split) <=
+                           split_cost(First, Last,
+                               cheapest_split(First, Last, Split + 1))
+                   ? Split
+                   : cheapest_split(First, Last, Split + 1);
+    }
+};
+
+/// Operand TIndex of a chain of products
+template <std::size_t TIndex, typename TExpressionType>
+struct ProductChainOperandAt {
+    using type = TExpressionType;
+
+    static type const& get(TExpressionType const& TheOperand) {
+        return TheOperand;
+    }
+};
+
+template <std::size_t TIndex, typename TFirstType, typename TSecondType>
+struct ProductChainOperandAt<TIndex,
+    MatrixProductExpression<TFirstType, TSecondType>> {
+    using product_type = MatrixProductExpression<TFirstType, TSecondType>;
+    using first_type = typename product_type::first_type;
+    using second_type = typename product_type::second_type;
+    static constexpr std::size_t first_length =
+        ProductChainLength<first_type>::value;
+    using is_in_first = std::integral_constant<bool, (TIndex < first_length)>;
+    using operand_type = typename std::conditional<is_in_first::value,
+        ProductChainOperandAt<TIndex, first_type>,
+        ProductChainOperandAt<TIndex - first_length, second_type>>::type;
+    using type = typename operand_type::type;
+
+    static type const& get(product_type const& Product) {
+        return get(Product, is_in_first());
+    }
+
+   private:
+    static type const& get(
+        product_type const& Product, std::true_type /* IsInFirst */) {
+        return operand_type::get(Product.first());
+    }
+
+    static type const& get(
+        product_type const& Product, std::false_type /* IsInFirst */) {
+        return operand_type::get(Product.second());
+    }
+};
+
+template <typename TProductType, std::size_t TFirst, std::size_t TLast>
+void EvaluateStaticProductChain(
+    TProductType const& Product, typename TProductType::data_type* pResult);
+
+/// The operands First..Last of a chain with fixed sizes, multiplied into a
+/// fixed size matrix on the stack
+template <typename TProductType, std::size_t TFirst, std::size_t TLast>
+class StaticProductChainPart {
+    using sizes = StaticProductChainSizes<TProductType>;
+    using data_type = typename TProductType::data_type;
+
+    Matrix<data_type, sizes::at(TFirst), sizes::at(TLast + 1)> _result;
+
+   public:
+    explicit StaticProductChainPart(TProductType const& Product) {
+        EvaluateStaticProductChain<TProductType, TFirst, TLast>(
+            Product, _result.data());
+    }
+
+    data_type const* data() const { return _result.data(); }
+};
+
+/// A single operand is read in place if it is dense, otherwise it is
+/// evaluated into a fixed size matrix
+template <typename TOperandType, typename TDataType,
+    bool TIsDense = IsContiguous<TOperandType>::value &&
+                    std::is_same<typename TOperandType::data_type,
+                        TDataType>::value>
+class StaticProductChainOperand {
+    TDataType const* _p_data;
+
+   public:
+    explicit StaticProductChainOperand(TOperandType const& TheOperand)
+        : _p_data(TheOperand.data()) {}
+
+    TDataType const* data() const { return _p_data; }
+};
+
+template <typename TOperandType, typename TDataType>
+class StaticProductChainOperand<TOperandType, TDataType, false> {
+    Matrix<TDataType, TOperandType::static_size1, TOperandType::static_size2>
+        _evaluated;
+
+   public:
+    explicit StaticProductChainOperand(TOperandType const& TheOperand) {
+        EvaluateExpression(TheOperand, _evaluated.data());
+    }
+
+    TDataType const* data() const { return _evaluated.data(); }
+};
+
+template <typename TProductType, std::size_t TIndex>
+class StaticProductChainPart<TProductType, TIndex, TIndex>
+    : public StaticProductChainOperand<
+          typename ProductChainOperandAt<TIndex, TProductType>::type,
+          typename TProductType::data_type> {
+    using operand_at = ProductChainOperandAt<TIndex, TProductType>;
+
+   public:
+    explicit StaticProductChainPart(TProductType const& Product)
+        : StaticProductChainOperand<typename operand_at::type,
+              typename TProductType::data_type>(operand_at::get(Product)) {}
+};
+
+/// Multiplies the operands First..Last of a chain with fixed sizes into
+/// pResult in the order of the StaticProductChainPlan
+template <typename TProductType, std::size_t TFirst, std::size_t TLast>
+void EvaluateStaticProductChain(
+    TProductType const& Product, typename TProductType::data_type* pResult) {
+    using sizes = StaticProductChainSizes<TProductType>;
+    constexpr std::size_t split =
+        StaticProductChainPlan<TProductType>::split(TFirst, TLast);
+    StaticProductChainPart<TProductType, TFirst, split> left(Product);
+    StaticProductChainPart<TProductType, split + 1, TLast> right(Product);
+    AMATRIX_COUNT_OPERATION(product, sizes::at(TFirst), sizes::at(TLast + 1));
+    DenseProduct(sizes::at(TFirst), sizes::at(split + 1),
+        sizes::at(TLast + 1), left.data(), right.data(), pResult);
+}
+
+template <typename TFirstType, typename TSecondType>
+void EvaluateProductChain(
+    MatrixProductExpression<TFirstType, TSecondType> const& Product,
+    typename MatrixProductExpression<TFirstType, TSecondType>::data_type*
+        pResult,
+    std::true_type /* IsFixedSize */) {
+    using product_type = MatrixProductExpression<TFirstType, TSecondType>;
+    EvaluateStaticProductChain<product_type, 0,
+        ProductChainLength<product_type>::value - 1>(Product, pResult);
+}
+
+template <typename TFirstType, typename TSecondType>
+void EvaluateProductChain(
+    MatrixProductExpression<TFirstType, TSecondType> const& Product,
+    typename MatrixProductExpression<TFirstType, TSecondType>::data_type*
+        pResult,
+    std::false_type /* IsFixedSize */) {
+    ProductChain<
+        typename MatrixProductExpression<TFirstType, TSecondType>::data_type>
+        chain;
+    chain.add(Product);
+    chain.evaluate(pResult);
+}
+
+/// Evaluates a chain of products in the cheapest order into pResult, which
+/// has the size of the product and does not overlap the operands. Chains of
+/// fixed size operands are planned at compile time and evaluated with
+/// their intermediate products on the stack, the others are planned when
+/// evaluated and use pooled temporaries
+template <typename TFirstType, typename TSecondType>
+void EvaluateProductChain(
+    MatrixProductExpression<TFirstType, TSecondType> const& Product,
+    typename MatrixProductExpression<TFirstType, TSecondType>::data_type*
+        pResult) {
+    EvaluateProductChain(Product, pResult,
+        std::integral_constant<bool,
+            StaticProductChainSizes<MatrixProductExpression<TFirstType,
+                TSecondType>>::is_fixed>());
+}
+
+template <typename TFirstType, typename TSecondType>
+void EvaluateProduct(
+    MatrixProductExpression<TFirstType, TSecondType> const& Product,
+    typename MatrixProductExpression<TFirstType, TSecondType>::data_type*
+        pResult);
+
+template <typename TFirstType, typename TSecondType>
+void EvaluateBlockProduct(
+    MatrixProductExpression<TFirstType, TSecondType> const& Product,
+    typename MatrixProductExpression<TFirstType, TSecondType>::data_type*
+        pResult,
+    std::size_t LeadingSize, std::true_type /* IsBlockProduct */) {
+    auto const& first = Product.first();
+    auto const& second = Product.second();
+    AMATRIX_COUNT_OPERATION(product, first.size1(), second.size2());
+    DenseBlockProduct(first.size1(), first.size2(), second.size2(),
+        first.data(), GetLeadingSize(first), second.data(),
+        GetLeadingSize(second), pResult, LeadingSize);
+}
+
+template <typename TFirstType, typename TSecondType>
+void EvaluateBlockProduct(
+    MatrixProductExpression<TFirstType, TSecondType> const& Product,
+    typename MatrixProductExpression<TFirstType, TSecondType>::data_type*
+        pResult,
+    std::size_t LeadingSize, std::false_type /* IsBlockProduct */) {
+    using data_type =
+        typename MatrixProductExpression<TFirstType, TSecondType>::data_type;
+    if (LeadingSize == Product.size2()) {
+        EvaluateProduct(Product, pResult);
+        return;
+    }
+    TemporaryMatrix<data_type> temporary(Product.size1(), Product.size2());
+    EvaluateProduct(Product, temporary.data());
+    for (std::size_t i = 0; i < Product.size1(); i++)
+        std::copy(temporary.data() + i * Product.size2(),
+            temporary.data() + (i + 1) * Product.size2(),
+            pResult + i * LeadingSize);
+}
+
+template <typename TFirstType, typename TSecondType>
+void EvaluateProduct(
+    MatrixProductExpression<TFirstType, TSecondType> const& Product,
+    typename MatrixProductExpression<TFirstType, TSecondType>::data_type*
+        pResult,
+    std::true_type /* IsChain */) {
+    EvaluateProductChain(Product, pResult);
+}
+
+template <typename TFirstType, typename TSecondType>
+void EvaluateProduct(
+    MatrixProductExpression<TFirstType, TSecondType> const& Product,
+    typename MatrixProductExpression<TFirstType, TSecondType>::data_type*
+        pResult,
+    std::false_type /* IsChain */) {
+    EvaluateProduct(Product, pResult, std::false_type(),
+        IsBlockProduct<MatrixProductExpression<TFirstType, TSecondType>>());
+}
+
+template <typename TFirstType, typename TSecondType>
+void EvaluateProduct(
+    MatrixProductExpression<TFirstType, TSecondType> const& Product,
+    typename MatrixProductExpression<TFirstType, TSecondType>::data_type*
+        pResult,
+    std::false_type /* IsChain */, std::true_type /* IsBlockProduct */) {
+    EvaluateBlockProduct(
+        Product, pResult, Product.size2(), std::true_type());
+}
+
+template <typename TFirstType, typename TSecondType>
+void EvaluateProduct(
+    MatrixProductExpression<TFirstType, TSecondType> const& Product,
+    typename MatrixProductExpression<TFirstType, TSecondType>::data_type*
+        pResult,
+    std::false_type /* IsChain */, std::false_type /* IsBlockProduct */) {
+    AMATRIX_COUNT_OPERATION(product, Product.size1(), Product.size2());
+    EvaluateExpression(Product, pResult);
+}
+
+/// Evaluates a product which is not read from two dense matrices into
+/// pResult: chains in their cheapest order, products of blocks with the
+/// block kernel and the others element by element
+template <typename TFirstType, typename TSecondType>
+void EvaluateProduct(
+    MatrixProductExpression<TFirstType, TSecondType> const& Product,
+    typename MatrixProductExpression<TFirstType, TSecondType>::data_type*
+        pResult) {
+    EvaluateProduct(Product, pResult,
+        std::integral_constant<bool,
+            MatrixProductExpression<TFirstType, TSecondType>::is_chain>());
+}
+
+/// Evaluates a product into the block at pResult with rows LeadingSize
+/// apart, which does not overlap the operands. The products of other
+/// operands are evaluated into a temporary first
+template <typename TFirstType, typename TSecondType>
+void EvaluateBlockProduct(
+    MatrixProductExpression<TFirstType, TSecondType> const& Product,
+    typename MatrixProductExpression<TFirstType, TSecondType>::data_type*
+        pResult,
+    std::size_t LeadingSize) {
+    EvaluateBlockProduct(Product, pResult, LeadingSize,
+        IsBlockProduct<MatrixProductExpression<TFirstType, TSecondType>>());
+}
+
+}  // namespace AMatrix
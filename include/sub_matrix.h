@@ -0,0 +1,545 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "matrix_expression.h"
+#include "product_chain.h"
+#include "temporary_pool.h"
+
+namespace AMatrix {
+
+/// Block of a matrix. The block of a contiguous matrix stores its rows
+/// contiguously and leading_size() apart, starting at data(). Such blocks
+/// are operands of the block product and LU kernels and are written a
+/// packet of a row at a time, so blocked algorithms work on views without
+/// copies
+template <typename TExpressionType>
+class SubMatrix : public MatrixExpression<SubMatrix<TExpressionType>> {
+    TExpressionType& _original_expression;
+    std::size_t _origin_index1;
+    std::size_t _origin_index2;
+    std::size_t _size1;
+    std::size_t _size2;
+
+    using is_block = std::integral_constant<bool,
+        IsContiguous<typename std::remove_const<TExpressionType>::type>::value>;
+
+   public:
+    using data_type = typename TExpressionType::data_type;
+    SubMatrix() = delete;
+
+    SubMatrix(TExpressionType& Original, std::size_t OriginIndex1,
+        std::size_t OriginIndex2, std::size_t TheSize1, std::size_t TheSize2)
+        : _original_expression(Original),
+          _origin_index1(OriginIndex1),
+          _origin_index2(OriginIndex2),
+          _size1(TheSize1),
+          _size2(TheSize2) {}
+
+    SubMatrix& operator=(SubMatrix const& Other) {
+        assign(Other, is_block());
+        return *this;
+    }
+
+    template <typename TOtherExpressionType, std::size_t TCategory>
+    SubMatrix& operator=(
+        MatrixExpression<TOtherExpressionType, TCategory> const& Other) {
+        assign(Other, is_block());
+        return *this;
+    }
+
+    template <typename TFirstType, typename TSecondType>
+    SubMatrix& operator=(
+        MatrixProductExpression<TFirstType, TSecondType> const& Other) {
+        assign_product(Other, is_block());
+        return *this;
+    }
+
+    template <typename TOtherExpressionType, std::size_t TCategory>
+    SubMatrix& operator+=(
+        MatrixExpression<TOtherExpressionType, TCategory> const& Other) {
+        add(data_type(1), Other.expression(), is_block());
+        return *this;
+    }
+
+    template <typename TOtherExpressionType, std::size_t TCategory>
+    SubMatrix& operator-=(
+        MatrixExpression<TOtherExpressionType, TCategory> const& Other) {
+        add(data_type(-1), Other.expression(), is_block());
+        return *this;
+    }
+
+    /// The product is evaluated into a temporary, which is added with the
+    /// packet kernels, e.g. for a Schur complement S -= A * B
+    template <typename TFirstType, typename TSecondType>
+    SubMatrix& operator+=(
+        MatrixProductExpression<TFirstType, TSecondType> const& Other) {
+        add_product(data_type(1), Other);
+        return *this;
+    }
+
+    template <typename TFirstType, typename TSecondType>
+    SubMatrix& operator-=(
+        MatrixProductExpression<TFirstType, TSecondType> const& Other) {
+        add_product(data_type(-1), Other);
+        return *this;
+    }
+
+    inline data_type const& operator()(std::size_t i, std::size_t j) const {
+        return _original_expression(i + _origin_index1, j + _origin_index2);
+    }
+
+    inline data_type& operator()(std::size_t i, std::size_t j) {
+        return _original_expression(i + _origin_index1, j + _origin_index2);
+    }
+
+    inline std::size_t size() const { return _size1 * _size2; }
+    inline std::size_t size1() const { return _size1; }
+    inline std::size_t size2() const { return _size2; }
+
+    bool overlaps(void const* pBegin, void const* pEnd) const {
+        return _original_expression.overlaps(pBegin, pEnd);
+    }
+
+    /// Only for the blocks of contiguous matrices
+    data_type* data() {
+        return &_original_expression(_origin_index1, _origin_index2);
+    }
+
+    data_type const* data() const {
+        return &_original_expression(_origin_index1, _origin_index2);
+    }
+
+    std::size_t leading_size() const { return _original_expression.size2(); }
+
+   private:
+    /// Past the last element of the block
+    data_type const* data_end() const {
+        return (_size1 == 0) ? data()
+                             : data() + (_size1 - 1) * leading_size() + _size2;
+    }
+
+    template <typename TOtherExpressionType>
+    using uses_packets = std::integral_constant<bool,
+        HasPacketAccess<TOtherExpressionType>::value &&
+            std::is_same<typename TOtherExpressionType::data_type,
+                data_type>::value>;
+
+    /// An expression which reads the original matrix is evaluated into a
+    /// temporary first, since the element (i, j) of the block is not the
+    /// element i * size2() + j of the original
+    template <typename TOtherExpressionType, std::size_t TCategory>
+    void assign(MatrixExpression<TOtherExpressionType, TCategory> const& Other,
+        std::true_type /* IsBlock */) {
+        auto const& other_expression = Other.expression();
+        if (other_expression.overlaps(data(), data_end())) {
+            TemporaryMatrix<data_type> temporary(_size1, _size2);
+            EvaluateExpression(other_expression, temporary.data());
+            assign_rows(temporary, std::true_type());
+            return;
+        }
+        assign_rows(
+            other_expression, uses_packets<TOtherExpressionType>());
+    }
+
+    template <typename TOtherExpressionType, std::size_t TCategory>
+    void assign(MatrixExpression<TOtherExpressionType, TCategory> const& Other,
+        std::false_type /* IsBlock */) {
+        for (std::size_t i = 0; i < size1(); i++)
+            for (std::size_t j = 0; j < size2(); j++)
+                _original_expression(i + _origin_index1, j + _origin_index2) =
+                    Other.expression()(i, j);
+    }
+
+    template <typename TOtherExpressionType>
+    void assign(
+        MatrixExpression<TOtherExpressionType, row_major_access> const& Other,
+        std::false_type /* IsBlock */) {
+        std::size_t k = 0;
+        for (std::size_t i = 0; i < size1(); i++)
+            for (std::size_t j = 0; j < size2(); j++)
+                _original_expression(i + _origin_index1, j + _origin_index2) =
+                    Other.expression()[k++];
+    }
+
+    template <typename TOtherExpressionType>
+    void assign_rows(TOtherExpressionType const& Other,
+        std::true_type /* UsesPackets */) {
+        constexpr std::size_t width = NativePacketWidth<data_type>::value;
+        for (std::size_t i = 0; i < _size1; i++) {
+            data_type* p_row = data() + i * leading_size();
+            const std::size_t row_begin = i * _size2;
+            std::size_t j = 0;
+            for (; j + width <= _size2; j += width)
+                Other.template packet<width>(row_begin + j)
+                    .store_unaligned(p_row + j);
+            for (; j < _size2; j++)
+                p_row[j] = Other[row_begin + j];
+        }
+    }
+
+    template <typename TOtherExpressionType>
+    void assign_rows(TOtherExpressionType const& Other,
+        std::false_type /* UsesPackets */) {
+        for (std::size_t i = 0; i < _size1; i++) {
+            data_type* p_row = data() + i * leading_size();
+            for (std::size_t j = 0; j < _size2; j++)
+                p_row[j] = Other(i, j);
+        }
+    }
+
+    /// Products of blocks and dense matrices are written into the block by
+    /// the block product kernel
+    template <typename TFirstType, typename TSecondType>
+    void assign_product(
+        MatrixProductExpression<TFirstType, TSecondType> const& Other,
+        std::true_type /* IsBlock */) {
+        if (Other.overlaps(data(), data_end())) {
+            TemporaryMatrix<data_type> temporary(_size1, _size2);
+            EvaluateProduct(Other, temporary.data());
+            assign_rows(temporary, std::true_type());
+            return;
+        }
+        EvaluateBlockProduct(Other, data(), leading_size());
+    }
+
+    template <typename TFirstType, typename TSecondType>
+    void assign_product(
+        MatrixProductExpression<TFirstType, TSecondType> const& Other,
+        std::false_type /* IsBlock */) {
+        assign(Other, std::false_type());
+    }
+
+    template <typename TOtherExpressionType>
+    void add(data_type Alpha, TOtherExpressionType const& Other,
+        std::true_type /* IsBlock */) {
+        if (Other.overlaps(data(), data_end())) {
+            TemporaryMatrix<data_type> temporary(_size1, _size2);
+            EvaluateExpression(Other, temporary.data());
+            add_rows(Alpha, temporary, std::true_type());
+            return;
+        }
+        add_rows(Alpha, Other, uses_packets<TOtherExpressionType>());
+    }
+
+    template <typename TOtherExpressionType>
+    void add(data_type Alpha, TOtherExpressionType const& Other,
+        std::false_type /* IsBlock */) {
+        for (std::size_t i = 0; i < size1(); i++)
+            for (std::size_t j = 0; j < size2(); j++)
+                _original_expression(i + _origin_index1, j + _origin_index2) +=
+                    Alpha * Other(i, j);
+    }
+
+    template <typename TOtherExpressionType>
+    void add_rows(data_type Alpha, TOtherExpressionType const& Other,
+        std::true_type /* UsesPackets */) {
+        constexpr std::size_t width = NativePacketWidth<data_type>::value;
+        using packet = Packet<data_type, width>;
+        const packet alpha = packet::broadcast(Alpha);
+        for (std::size_t i = 0; i < _size1; i++) {
+            data_type* p_row = data() + i * leading_size();
+            const std::size_t row_begin = i * _size2;
+            std::size_t j = 0;
+            for (; j + width <= _size2; j += width)
+                MultiplyAdd(alpha, Other.template packet<width>(row_begin + j),
+                    packet::load_unaligned(p_row + j))
+                    .store_unaligned(p_row + j);
+            for (; j < _size2; j++)
+                p_row[j] += Alpha * Other[row_begin + j];
+        }
+    }
+
+    template <typename TOtherExpressionType>
+    void add_rows(data_type Alpha, TOtherExpressionType const& Other,
+        std::false_type /* UsesPackets */) {
+        for (std::size_t i = 0; i < _size1; i++) {
+            data_type* p_row = data() + i * leading_size();
+            for (std::size_t j = 0; j < _size2; j++)
+                p_row[j] += Alpha * Other(i, j);
+        }
+    }
+
+    template <typename TFirstType, typename TSecondType>
+    void add_product(data_type Alpha,
+        MatrixProductExpression<TFirstType, TSecondType> const& Other) {
+        TemporaryMatrix<data_type> temporary(_size1, _size2);
+        EvaluateProduct(Other, temporary.data());
+        add(Alpha, temporary, is_block());
+    }
+};
+
+template <typename TExpressionType>
+struct IsBlock<SubMatrix<TExpressionType>> {
+    static constexpr bool value =
+        IsContiguous<typename std::remove_const<TExpressionType>::type>::value;
+};
+
+/// Elements of a matrix at lists of row and column indices, e.g. the
+/// degrees of freedom of an element in a global matrix. The view holds
+/// references to the indices. For a contiguous matrix the rows of the view
+/// are read with gathers and written with scatters, or with the contiguous
+/// kernels when the column indices form runs of consecutive indices, like
+/// the sorted degrees of freedom of the nodes. The indices must differ for
+/// the assignments, repeated indices are read correctly
+template <typename TExpressionType>
+class IndexedView : public MatrixExpression<IndexedView<TExpressionType>> {
+    TExpressionType& _original_expression;
+    std::vector<std::size_t> const& _row_indices;
+    std::vector<std::size_t> const& _column_indices;
+    bool _uses_runs;
+
+    using is_contiguous = std::integral_constant<bool,
+        IsContiguous<typename std::remove_const<TExpressionType>::type>::value>;
+
+   public:
+    using data_type = typename TExpressionType::data_type;
+    IndexedView() = delete;
+
+    IndexedView(TExpressionType& Original,
+        std::vector<std::size_t> const& RowIndices,
+        std::vector<std::size_t> const& ColumnIndices)
+        : _original_expression(Original),
+          _row_indices(RowIndices),
+          _column_indices(ColumnIndices),
+          _uses_runs(false) {
+        // Runs shorter than a packet are cheaper to gather
+        std::size_t number_of_runs = 0;
+        for (std::size_t j = 0; j < size2(); j++)
+            if (j == 0 || _column_indices[j] != _column_indices[j - 1] + 1)
+                number_of_runs++;
+        _uses_runs = size2() >= number_of_runs *
+                                    NativePacketWidth<data_type>::value;
+    }
+
+    IndexedView& operator=(IndexedView const& Other) {
+        update(Assignment(), Other);
+        return *this;
+    }
+
+    template <typename TOtherExpressionType, std::size_t TCategory>
+    IndexedView& operator=(
+        MatrixExpression<TOtherExpressionType, TCategory> const& Other) {
+        update(Assignment(), Other.expression());
+        return *this;
+    }
+
+    /// Scatter add, the assembly of an element matrix
+    template <typename TOtherExpressionType, std::size_t TCategory>
+    IndexedView& operator+=(
+        MatrixExpression<TOtherExpressionType, TCategory> const& Other) {
+        update(ScaledAddition{data_type(1)}, Other.expression());
+        return *this;
+    }
+
+    template <typename TOtherExpressionType, std::size_t TCategory>
+    IndexedView& operator-=(
+        MatrixExpression<TOtherExpressionType, TCategory> const& Other) {
+        update(ScaledAddition{data_type(-1)}, Other.expression());
+        return *this;
+    }
+
+    inline data_type const& operator()(std::size_t i, std::size_t j) const {
+        return _original_expression(_row_indices[i], _column_indices[j]);
+    }
+
+    inline data_type& operator()(std::size_t i, std::size_t j) {
+        return _original_expression(_row_indices[i], _column_indices[j]);
+    }
+
+    inline std::size_t size() const { return size1() * size2(); }
+    inline std::size_t size1() const { return _row_indices.size(); }
+    inline std::size_t size2() const { return _column_indices.size(); }
+
+    std::vector<std::size_t> const& row_indices() const {
+        return _row_indices;
+    }
+
+    std::vector<std::size_t> const& column_indices() const {
+        return _column_indices;
+    }
+
+    bool overlaps(void const* pBegin, void const* pEnd) const {
+        return _original_expression.overlaps(pBegin, pEnd);
+    }
+
+    /// Writes the elements to pResult in row major order
+    template <typename TResultType>
+    void evaluate(TResultType* pResult) const {
+        evaluate(pResult,
+            std::integral_constant<bool,
+                is_contiguous::value &&
+                    std::is_same<TResultType, data_type>::value>());
+    }
+
+   private:
+    data_type* original_row(std::size_t i) {
+        return _original_expression.data() +
+               _row_indices[i] * _original_expression.size2();
+    }
+
+    data_type const* original_row(std::size_t i) const {
+        return _original_expression.data() +
+               _row_indices[i] * _original_expression.size2();
+    }
+
+    /// Calls TheFunction(Begin, End) for the runs of consecutive column
+    /// indices
+    template <typename TFunctionType>
+    void for_each_run(TFunctionType const& TheFunction) const {
+        std::size_t run_begin = 0;
+        for (std::size_t j = 1; j <= size2(); j++)
+            if (j == size2() ||
+                _column_indices[j] != _column_indices[j - 1] + 1) {
+                TheFunction(run_begin, j);
+                run_begin = j;
+            }
+    }
+
+    void evaluate(data_type* pResult, std::true_type /* UsesKernels */) const {
+        std::size_t const* p_columns = _column_indices.data();
+        for (std::size_t i = 0; i < size1(); i++) {
+            data_type const* p_row = original_row(i);
+            data_type* p_result_row = pResult + i * size2();
+            if (_uses_runs)
+                for_each_run([&](std::size_t Begin, std::size_t End) {
+                    std::copy(p_row + p_columns[Begin],
+                        p_row + p_columns[Begin] + (End - Begin),
+                        p_result_row + Begin);
+                });
+            else if (size2() < dispatch_minimum_size)
+                GenericKernels::indexed_gather(
+                    size2(), p_row, p_columns, p_result_row);
+            else
+                DispatchedIndexedGather(
+                    size2(), p_row, p_columns, p_result_row);
+        }
+    }
+
+    template <typename TResultType>
+    void evaluate(
+        TResultType* pResult, std::false_type /* UsesKernels */) const {
+        for (std::size_t i = 0; i < size1(); i++)
+            for (std::size_t j = 0; j < size2(); j++)
+                *(pResult++) = (*this)(i, j);
+    }
+
+    /// Tags of the updates of the view
+    struct Assignment {};
+
+    struct ScaledAddition {
+        data_type alpha;
+    };
+
+    /// Assigns Other or adds Alpha * Other. Operands which are not
+    /// contiguous, or which read the original matrix, are evaluated into a
+    /// temporary first
+    template <typename TUpdateType, typename TOtherExpressionType>
+    void update(TUpdateType Update, TOtherExpressionType const& Other) {
+        using uses_kernels = std::integral_constant<bool,
+            is_contiguous::value &&
+                IsContiguous<TOtherExpressionType>::value &&
+                std::is_same<typename TOtherExpressionType::data_type,
+                    data_type>::value>;
+        if (!is_contiguous::value) {
+            update(Update, Other, std::false_type());
+            return;
+        }
+        if (!uses_kernels::value || Other.overlaps(
+                _original_expression.data(),
+                _original_expression.data() + _original_expression.size())) {
+            TemporaryMatrix<data_type> temporary(size1(), size2());
+            evaluate_operand(Other, temporary.data());
+            update(Update, temporary, is_contiguous());
+            return;
+        }
+        update(Update, Other, uses_kernels());
+    }
+
+    template <typename TUpdateType, typename TOtherExpressionType>
+    void update(TUpdateType Update, TOtherExpressionType const& Other,
+        std::true_type /* UsesKernels */) {
+        for (std::size_t i = 0; i < size1(); i++)
+            update_row(Update, Other.data() + i * size2(), original_row(i));
+    }
+
+    template <typename TUpdateType, typename TOtherExpressionType>
+    void update(TUpdateType Update, TOtherExpressionType const& Other,
+        std::false_type /* UsesKernels */) {
+        for (std::size_t i = 0; i < size1(); i++)
+            for (std::size_t j = 0; j < size2(); j++)
+                update_element(Update, Other(i, j), (*this)(i, j));
+    }
+
+    void update_row(Assignment, data_type const* pOtherRow, data_type* pRow) {
+        std::size_t const* p_columns = _column_indices.data();
+        if (_uses_runs)
+            for_each_run([&](std::size_t Begin, std::size_t End) {
+                std::copy(pOtherRow + Begin, pOtherRow + End,
+                    pRow + p_columns[Begin]);
+            });
+        else if (size2() < dispatch_minimum_size)
+            GenericKernels::indexed_scatter(
+                size2(), pOtherRow, pRow, p_columns);
+        else
+            DispatchedIndexedScatter(size2(), pOtherRow, pRow, p_columns);
+    }
+
+    void update_row(
+        ScaledAddition Update, data_type const* pOtherRow, data_type* pRow) {
+        std::size_t const* p_columns = _column_indices.data();
+        if (_uses_runs)
+            for_each_run([&](std::size_t Begin, std::size_t End) {
+                if (End - Begin < dispatch_minimum_size)
+                    GenericKernels::axpy(End - Begin, Update.alpha,
+                        pOtherRow + Begin, pRow + p_columns[Begin]);
+                else
+                    DispatchedAxpy(End - Begin, Update.alpha,
+                        pOtherRow + Begin, pRow + p_columns[Begin]);
+            });
+        else if (size2() < dispatch_minimum_size)
+            GenericKernels::indexed_axpy(
+                size2(), Update.alpha, pOtherRow, pRow, p_columns);
+        else
+            DispatchedIndexedAxpy(
+                size2(), Update.alpha, pOtherRow, pRow, p_columns);
+    }
+
+    template <typename TOtherDataType>
+    static void update_element(
+        Assignment, TOtherDataType const& Other, data_type& rElement) {
+        rElement = Other;
+    }
+
+    template <typename TOtherDataType>
+    static void update_element(
+        ScaledAddition Update, TOtherDataType const& Other,
+        data_type& rElement) {
+        rElement += Update.alpha * Other;
+    }
+
+    template <typename TOtherExpressionType>
+    static void evaluate_operand(
+        TOtherExpressionType const& Other, data_type* pResult) {
+        EvaluateExpression(Other, pResult);
+    }
+
+    template <typename TFirstType, typename TSecondType>
+    static void evaluate_operand(
+        MatrixProductExpression<TFirstType, TSecondType> const& Other,
+        data_type* pResult) {
+        EvaluateProduct(Other, pResult);
+    }
+};
+
+/// A matrix is assigned from an indexed view with the gathers of its rows
+template <typename TExpressionType, typename TDataType>
+struct ExpressionEvaluator<IndexedView<TExpressionType>, TDataType, false> {
+    static void evaluate(IndexedView<TExpressionType> const& TheExpression,
+        TDataType* pResult) {
+        TheExpression.evaluate(pResult);
+    }
+};
+
+}  // namespace AMatrix
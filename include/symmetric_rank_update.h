@@ -0,0 +1,183 @@
+#pragma once
+
+#include <vector>
+#include "matrix.h"
+#include "packed_matrix.h"
+#include "parallel.h"
+
+namespace AMatrix {
+
+/// Minimum number of multiply-adds of a rank update before it is split
+/// between threads
+constexpr std::size_t rank_update_parallel_threshold = 1 << 22;
+
+/// Number of rows of A which are processed together in the A^T * A kernel
+constexpr std::size_t rank_update_block_size = 64;
+
+/// Splits the rows of an n x n triangle into NumberOfParts ranges with
+/// almost the same number of elements
+template <std::size_t TMode>
+std::vector<std::size_t> BalancedTriangleRows(
+    std::size_t Size, std::size_t NumberOfParts) {
+    std::vector<std::size_t> boundaries(1, 0);
+    const std::size_t total = Size * (Size + 1) / 2;
+    std::size_t accumulated = 0;
+    for (std::size_t i = 0; i < Size; i++) {
+        accumulated += (TMode & upper) ? Size - i : i + 1;
+        if (accumulated * NumberOfParts >= total * boundaries.size() &&
+            boundaries.size() < NumberOfParts)
+            boundaries.push_back(i + 1);
+    }
+    boundaries.push_back(Size);
+    return boundaries;
+}
+
+/// Runs Function(RowBegin, RowEnd) over the rows of an n x n triangle,
+/// split between threads when the total work is large enough
+template <std::size_t TMode, typename TFunctionType>
+void ForEachTriangleRows(
+    std::size_t Size, std::size_t WorkPerElement, TFunctionType const& Function) {
+    const std::size_t work = Size * (Size + 1) / 2 * WorkPerElement;
+    const std::size_t number_of_threads = GetParallelism();
+    if (work < rank_update_parallel_threshold || number_of_threads < 2 ||
+        Size < 2) {
+        Function(0, Size);
+        return;
+    }
+
+    const std::vector<std::size_t> boundaries =
+        BalancedTriangleRows<TMode>(Size, number_of_threads);
+    ParallelFor(0, boundaries.size() - 1, 1,
+        [&](std::size_t PartBegin, std::size_t PartEnd) {
+            for (std::size_t part = PartBegin; part < PartEnd; part++)
+                Function(boundaries[part], boundaries[part + 1]);
+        });
+}
+
+/// Scales the TMode triangle of rows [RowBegin, RowEnd) of C by Beta. A zero
+/// Beta overwrites the triangle so an uninitialized C can be used
+template <std::size_t TMode, typename TResultType, typename TDataType>
+void ScaleTriangleRows(TResultType& rC, TDataType Beta, std::size_t RowBegin,
+    std::size_t RowEnd) {
+    const std::size_t size = rC.size1();
+    for (std::size_t i = RowBegin; i < RowEnd; i++) {
+        const std::size_t j_begin = (TMode & upper) ? i : 0;
+        const std::size_t j_end = (TMode & upper) ? size : i + 1;
+        TDataType* c_row = &rC(i, j_begin);
+        if (Beta == TDataType())
+            for (std::size_t j = 0; j < j_end - j_begin; j++)
+                c_row[j] = TDataType();
+        else
+            for (std::size_t j = 0; j < j_end - j_begin; j++)
+                c_row[j] *= Beta;
+    }
+}
+
+/// Symmetric rank-k update C = Alpha * A * A^T + Beta * C (SYRK). Only the
+/// TMode triangle of C is computed. Each element is the dot product of two
+/// contiguous rows of A. C can be a square Matrix or a SymmetricMatrix with
+/// the same mode and must have the size A.size1() x A.size1()
+template <std::size_t TMode, typename TResultType, typename TDataType,
+    std::size_t TSize1, std::size_t TSize2>
+void SymmetricRankUpdate(TResultType& rC,
+    Matrix<TDataType, TSize1, TSize2> const& A, TDataType Alpha = 1,
+    TDataType Beta = 0) {
+    const std::size_t size = A.size1();
+    const std::size_t inner_size = A.size2();
+    TDataType const* a_data = A.data();
+    AMATRIX_COUNT_OPERATION(product, size, size);
+
+    ForEachTriangleRows<TMode>(
+        size, inner_size, [&](std::size_t RowBegin, std::size_t RowEnd) {
+            ScaleTriangleRows<TMode>(rC, Beta, RowBegin, RowEnd);
+            for (std::size_t i = RowBegin; i < RowEnd; i++) {
+                const std::size_t j_begin = (TMode & upper) ? i : 0;
+                const std::size_t j_end = (TMode & upper) ? size : i + 1;
+                TDataType const* a_i = a_data + i * inner_size;
+                TDataType* c_row = &rC(i, j_begin);
+                for (std::size_t j = j_begin; j < j_end; j++) {
+                    TDataType const* a_j = a_data + j * inner_size;
+                    // Independent accumulators to break the dependency chain
+                    TDataType sum[4] = {
+                        TDataType(), TDataType(), TDataType(), TDataType()};
+                    std::size_t k = 0;
+                    for (; k + 4 <= inner_size; k += 4) {
+                        sum[0] += a_i[k] * a_j[k];
+                        sum[1] += a_i[k + 1] * a_j[k + 1];
+                        sum[2] += a_i[k + 2] * a_j[k + 2];
+                        sum[3] += a_i[k + 3] * a_j[k + 3];
+                    }
+                    for (; k < inner_size; k++)
+                        sum[0] += a_i[k] * a_j[k];
+                    c_row[j - j_begin] +=
+                        Alpha * ((sum[0] + sum[1]) + (sum[2] + sum[3]));
+                }
+            }
+        });
+}
+
+/// Symmetric rank-k update C = Alpha * A^T * A + Beta * C (SYRK). Only the
+/// TMode triangle of C is computed, as a sum of rank-1 updates with rows of A
+/// so A and C are both traversed along their rows. The rows of A are
+/// processed in blocks to keep them in cache while the rows of C are updated.
+/// C can be a square Matrix or a SymmetricMatrix with the same mode and must
+/// have the size A.size2() x A.size2()
+template <std::size_t TMode, typename TResultType, typename TDataType,
+    std::size_t TSize1, std::size_t TSize2>
+void TransposeSymmetricRankUpdate(TResultType& rC,
+    Matrix<TDataType, TSize1, TSize2> const& A, TDataType Alpha = 1,
+    TDataType Beta = 0) {
+    const std::size_t size = A.size2();
+    const std::size_t number_of_rows = A.size1();
+    TDataType const* a_data = A.data();
+    AMATRIX_COUNT_OPERATION(product, size, size);
+
+    ForEachTriangleRows<TMode>(size, number_of_rows,
+        [&](std::size_t RowBegin, std::size_t RowEnd) {
+            ScaleTriangleRows<TMode>(rC, Beta, RowBegin, RowEnd);
+            for (std::size_t k_block = 0; k_block < number_of_rows;
+                 k_block += rank_update_block_size) {
+                const std::size_t k_end =
+                    (k_block + rank_update_block_size < number_of_rows)
+                        ? k_block + rank_update_block_size
+                        : number_of_rows;
+                for (std::size_t i = RowBegin; i < RowEnd; i++) {
+                    const std::size_t j_begin = (TMode & upper) ? i : 0;
+                    const std::size_t j_end = (TMode & upper) ? size : i + 1;
+                    const std::size_t length = j_end - j_begin;
+                    TDataType* c_row = &rC(i, j_begin);
+                    for (std::size_t k = k_block; k < k_end; k++) {
+                        TDataType const* a_row = a_data + k * size;
+                        const TDataType a_ki = Alpha * a_row[i];
+                        a_row += j_begin;
+                        for (std::size_t j = 0; j < length; j++)
+                            c_row[j] += a_ki * a_row[j];
+                    }
+                }
+            }
+        });
+}
+
+/// Copies the TMode triangle of a square matrix to the other one
+template <std::size_t TMode, typename TDataType, std::size_t TSize1,
+    std::size_t TSize2>
+void MirrorTriangle(Matrix<TDataType, TSize1, TSize2>& rC) {
+    for (std::size_t i = 0; i < rC.size1(); i++)
+        for (std::size_t j = i + 1; j < rC.size2(); j++)
+            if (TMode & upper)
+                rC(j, i) = rC(i, j);
+            else
+                rC(i, j) = rC(j, i);
+}
+
+/// Gram matrix A^T * A computed by TransposeSymmetricRankUpdate and mirrored
+template <typename TDataType, std::size_t TSize1, std::size_t TSize2>
+Matrix<TDataType, TSize2, TSize2> GramMatrix(
+    Matrix<TDataType, TSize1, TSize2> const& A) {
+    Matrix<TDataType, TSize2, TSize2> result(A.size2(), A.size2());
+    TransposeSymmetricRankUpdate<upper>(result, A);
+    MirrorTriangle<upper>(result);
+    return result;
+}
+
+}  // namespace AMatrix
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "instrumentation.h"
+#include "matrix_expression.h"
+
+namespace AMatrix {
+
+/// Released buffers of the temporaries of one thread and data type. The
+/// aliased assignments take a buffer from here instead of allocating a new
+/// matrix, so repeated assignments of the same size allocate only once
+template <typename TDataType>
+class TemporaryPool {
+    using block_type = std::pair<TDataType*, std::size_t>;
+
+    std::vector<block_type> _free_blocks;
+
+    TemporaryPool() {}
+
+   public:
+    TemporaryPool(TemporaryPool const& Other) = delete;
+
+    TemporaryPool& operator=(TemporaryPool const& Other) = delete;
+
+    ~TemporaryPool() { clear(); }
+
+    static TemporaryPool& local() {
+        static thread_local TemporaryPool pool;
+        return pool;
+    }
+
+    /// Gives the most recently released block, grown to at least Size
+    block_type acquire(std::size_t Size) {
+        if (_free_blocks.empty())
+            return block_type(AllocateStorage<TDataType>(Size), Size);
+
+        block_type block = _free_blocks.back();
+        _free_blocks.pop_back();
+        if (block.second < Size) {
+            delete[] block.first;
+            block = block_type(AllocateStorage<TDataType>(Size), Size);
+        }
+        return block;
+    }
+
+    void release(block_type Block) { _free_blocks.push_back(Block); }
+
+    std::size_t number_of_free_blocks() const { return _free_blocks.size(); }
+
+    /// Frees the released blocks, the ones in use stay valid
+    void clear() {
+        for (auto& block : _free_blocks)
+            delete[] block.first;
+        _free_blocks.clear();
+    }
+};
+
+/// Contiguous row major temporary which holds its block of the pool until
+/// it is destroyed. It is a row major expression, so a matrix is assigned
+/// from it with the packet copy of the storage
+template <typename TDataType>
+class TemporaryMatrix
+    : public MatrixExpression<TemporaryMatrix<TDataType>, row_major_access> {
+    std::pair<TDataType*, std::size_t> _block;
+    std::size_t _size1;
+    std::size_t _size2;
+
+   public:
+    using data_type = TDataType;
+
+    TemporaryMatrix(std::size_t TheSize1, std::size_t TheSize2)
+        : _block(TemporaryPool<TDataType>::local().acquire(
+              TheSize1 * TheSize2)),
+          _size1(TheSize1),
+          _size2(TheSize2) {}
+
+    TemporaryMatrix(TemporaryMatrix const& Other) = delete;
+
+    TemporaryMatrix& operator=(TemporaryMatrix const& Other) = delete;
+
+    ~TemporaryMatrix() { TemporaryPool<TDataType>::local().release(_block); }
+
+    inline TDataType const& operator()(std::size_t i, std::size_t j) const {
+        return _block.first[i * _size2 + j];
+    }
+
+    inline TDataType& operator()(std::size_t i, std::size_t j) {
+        return _block.first[i * _size2 + j];
+    }
+
+    inline TDataType const& operator[](std::size_t i) const {
+        return _block.first[i];
+    }
+
+    template <std::size_t TWidth>
+    inline Packet<TDataType, TWidth> packet(std::size_t i) const {
+        return Packet<TDataType, TWidth>::load_unaligned(_block.first + i);
+    }
+
+    std::size_t size1() const { return _size1; }
+    std::size_t size2() const { return _size2; }
+    std::size_t size() const { return _size1 * _size2; }
+
+    TDataType* data() { return _block.first; }
+
+    TDataType const* data() const { return _block.first; }
+
+    bool overlaps(void const* pBegin, void const* pEnd) const {
+        return AreRangesOverlapping(data(), data() + size(), pBegin, pEnd);
+    }
+};
+
+template <typename TDataType>
+struct IsContiguous<TemporaryMatrix<TDataType>> {
+    static constexpr bool value = true;
+};
+
+template <typename TDataType>
+struct HasPacketAccess<TemporaryMatrix<TDataType>> {
+    static constexpr bool value = true;
+};
+
+}  // namespace AMatrix
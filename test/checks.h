@@ -15,3 +15,9 @@
         std::cout << a << " is not equal to " << b << std::endl; \
         return 1;                                                \
     }
+
+#define AMATRIX_CHECK_NEAR(a, b, tolerance)                          \
+    if (std::abs((a) - (b)) > (tolerance)) {                         \
+        std::cout << (a) << " is not near to " << (b) << std::endl; \
+        return 1;                                                    \
+    }
@@ -0,0 +1,161 @@
+#define AMATRIX_INSTRUMENTATION
+
+#include "amatrix.h"
+#include "checks.h"
+
+using AMatrix::Operation;
+using bounded_matrix = AMatrix::BoundedMatrix<double, 27, 27>;
+using dynamic_matrix =
+    AMatrix::Matrix<double, AMatrix::dynamic, AMatrix::dynamic>;
+
+// The bounds are carried through the expressions
+static_assert(AMatrix::MatrixSumExpression<bounded_matrix,
+                  AMatrix::BoundedMatrix<double, 9, 30>>::static_max_size1 ==
+                  9,
+    "");
+static_assert(AMatrix::MatrixProductExpression<bounded_matrix,
+                  AMatrix::Matrix<double, 27, 3>>::static_max_size2 == 3,
+    "");
+static_assert(
+    std::is_same<AMatrix::ResultMatrix<AMatrix::MatrixProductExpression<
+                     bounded_matrix, bounded_matrix>>,
+        bounded_matrix>::value,
+    "");
+static_assert(
+    std::is_same<AMatrix::ResultMatrix<AMatrix::MatrixSumExpression<
+                     bounded_matrix, dynamic_matrix>>,
+        bounded_matrix>::value,
+    "");
+static_assert(
+    std::is_same<AMatrix::ResultMatrix<AMatrix::MatrixProductExpression<
+                     dynamic_matrix, dynamic_matrix>>,
+        dynamic_matrix>::value,
+    "");
+
+template <typename TMatrixType>
+TMatrixType MakeMatrix(std::size_t Size1, std::size_t Size2) {
+    TMatrixType result(Size1, Size2);
+    for (std::size_t i = 0; i < Size1; i++)
+        for (std::size_t j = 0; j < Size2; j++)
+            result(i, j) = 1.00 / (i + 2 * j + 1);
+    return result;
+}
+
+template <typename TMatrixType, typename TExpectedType>
+std::size_t CheckNear(TMatrixType const& Result,
+    TExpectedType const& Expected, double Tolerance) {
+    AMATRIX_CHECK_EQUAL(Result.size1(), Expected.size1());
+    AMATRIX_CHECK_EQUAL(Result.size2(), Expected.size2());
+    for (std::size_t i = 0; i < Result.size1(); i++)
+        for (std::size_t j = 0; j < Result.size2(); j++)
+            AMATRIX_CHECK_NEAR(Result(i, j), Expected(i, j), Tolerance);
+    return 0;  // not failed
+}
+
+std::size_t TestAccessAndResize() {
+    bounded_matrix a_matrix(3, 5, 2.00);
+    AMATRIX_CHECK_EQUAL(a_matrix.size1(), 3);
+    AMATRIX_CHECK_EQUAL(a_matrix.size2(), 5);
+    AMATRIX_CHECK_EQUAL(a_matrix.size(), 15);
+    AMATRIX_CHECK_EQUAL(a_matrix(2, 4), 2.00);
+    a_matrix(1, 2) = 7.00;
+    AMATRIX_CHECK_EQUAL(a_matrix[7], 7.00);
+
+    bounded_matrix b_matrix(a_matrix);
+    AMATRIX_CHECK_EQUAL(b_matrix(1, 2), 7.00);
+    b_matrix.resize(27, 27);
+    AMATRIX_CHECK_EQUAL(b_matrix.size(), 27 * 27);
+
+    bounded_matrix empty_matrix;
+    AMATRIX_CHECK_EQUAL(empty_matrix.size(), 0);
+    empty_matrix = a_matrix;
+    AMATRIX_CHECK_EQUAL(empty_matrix.size1(), 3);
+    AMATRIX_CHECK_EQUAL(empty_matrix(1, 2), 7.00);
+
+    return 0;  // not failed
+}
+
+std::size_t TestExpressions(std::size_t Size) {
+    auto& counters = AMatrix::GetInstrumentationCounters();
+    dynamic_matrix a_dynamic = MakeMatrix<dynamic_matrix>(Size, Size);
+    dynamic_matrix b_dynamic(a_dynamic.transpose());
+    dynamic_matrix d_dynamic(2.00 * a_dynamic + b_dynamic);
+    dynamic_matrix expected_product(d_dynamic * a_dynamic);
+    dynamic_matrix sum_dynamic(expected_product + b_dynamic);
+    dynamic_matrix expected_nested(d_dynamic * sum_dynamic);
+
+    bounded_matrix a_matrix = MakeMatrix<bounded_matrix>(Size, Size);
+    bounded_matrix b_matrix(a_matrix.transpose());
+    counters.reset();
+
+    const double factor = 2.00;
+    bounded_matrix d_matrix(factor * a_matrix + b_matrix);
+    std::size_t number_of_failed_tests = CheckNear(d_matrix, d_dynamic, 0.00);
+
+    bounded_matrix product(d_matrix * a_matrix);
+    number_of_failed_tests +=
+        CheckNear(product, expected_product, 1e-12 * Size);
+
+    // The inner expression is evaluated into a bounded temporary
+    bounded_matrix nested(d_matrix * (d_matrix * a_matrix + b_matrix));
+    number_of_failed_tests +=
+        CheckNear(nested, expected_nested, 1e-12 * Size * Size);
+    auto evaluated = AMatrix::Evaluate(d_matrix * a_matrix - b_matrix);
+    AMATRIX_CHECK((std::is_same<decltype(evaluated), bounded_matrix>::value));
+    AMATRIX_CHECK_NEAR(evaluated(0, Size - 1),
+        expected_product(0, Size - 1) - b_dynamic(0, Size - 1),
+        1e-12 * Size);
+
+    // The destination is read by the product
+    product = d_matrix;
+    product = product * a_matrix;
+    number_of_failed_tests +=
+        CheckNear(product, expected_product, 1e-12 * Size);
+
+    AMATRIX_CHECK_EQUAL(counters.total(Operation::allocation), 0);
+
+    // A bounded matrix is an operand of the dense matrices
+    dynamic_matrix mixed(a_dynamic * d_matrix);
+    dynamic_matrix expected_mixed(a_dynamic * d_dynamic);
+    number_of_failed_tests += CheckNear(mixed, expected_mixed, 1e-12 * Size);
+
+    return number_of_failed_tests;
+}
+
+std::size_t TestRectangular() {
+    AMatrix::BoundedMatrix<double, 6, 24> b_matrix =
+        MakeMatrix<AMatrix::BoundedMatrix<double, 6, 24>>(3, 24);
+    AMatrix::BoundedMatrix<double, 6, 6> c_matrix =
+        MakeMatrix<AMatrix::BoundedMatrix<double, 6, 6>>(3, 3);
+
+    // The stiffness of an element, B^T * C * B
+    auto k_matrix =
+        AMatrix::Evaluate(b_matrix.transpose() * (c_matrix * b_matrix));
+    AMATRIX_CHECK((std::is_same<decltype(k_matrix),
+        AMatrix::BoundedMatrix<double, 24, 24>>::value));
+    AMATRIX_CHECK_EQUAL(k_matrix.size1(), 24);
+    AMATRIX_CHECK_EQUAL(k_matrix.size2(), 24);
+    for (std::size_t i = 0; i < 24; i++)
+        for (std::size_t j = 0; j < 24; j++) {
+            double expected = 0.00;
+            for (std::size_t k = 0; k < 3; k++)
+                for (std::size_t l = 0; l < 3; l++)
+                    expected +=
+                        b_matrix(k, i) * c_matrix(k, l) * b_matrix(l, j);
+            AMATRIX_CHECK_NEAR(k_matrix(i, j), expected, 1e-12);
+        }
+
+    return 0;  // not failed
+}
+
+int main() {
+    std::size_t number_of_failed_tests = 0;
+    number_of_failed_tests += TestAccessAndResize();
+    number_of_failed_tests += TestExpressions(3);
+    number_of_failed_tests += TestExpressions(27);
+    number_of_failed_tests += TestRectangular();
+
+    std::cout << number_of_failed_tests << " tests failed" << std::endl;
+
+    return number_of_failed_tests;
+}
@@ -0,0 +1,203 @@
+#include <cmath>
+#include <complex>
+
+#include "amatrix.h"
+#include "checks.h"
+
+using complex_type = std::complex<double>;
+using complex_matrix =
+    AMatrix::Matrix<complex_type, AMatrix::dynamic, AMatrix::dynamic>;
+using complex_vector = AMatrix::Matrix<complex_type, AMatrix::dynamic, 1>;
+using permutation_vector = AMatrix::Matrix<std::size_t, AMatrix::dynamic, 1>;
+
+template <typename TMatrixType>
+TMatrixType MakeMatrix(std::size_t Size1, std::size_t Size2) {
+    using data_type = typename TMatrixType::data_type;
+    TMatrixType result(Size1, Size2);
+    for (std::size_t i = 0; i < Size1; i++)
+        for (std::size_t j = 0; j < Size2; j++)
+            result(i, j) = data_type(1.00 / (i + 2 * j + 1),
+                               0.50 / (2 * i + j + 1)) +
+                           ((i == j) ? data_type(Size1, 1.00) : data_type());
+    return result;
+}
+
+template <typename TDataType>
+std::size_t TestProduct(double Tolerance) {
+    using matrix_type =
+        AMatrix::Matrix<TDataType, AMatrix::dynamic, AMatrix::dynamic>;
+    matrix_type a_matrix = MakeMatrix<matrix_type>(41, 37);
+    matrix_type b_matrix = MakeMatrix<matrix_type>(37, 43);
+    matrix_type c_matrix(a_matrix * b_matrix);
+
+    for (std::size_t i = 0; i < 41; i++)
+        for (std::size_t j = 0; j < 43; j++) {
+            TDataType expected = TDataType();
+            for (std::size_t k = 0; k < 37; k++)
+                expected += a_matrix(i, k) * b_matrix(k, j);
+            AMATRIX_CHECK_NEAR(std::abs(c_matrix(i, j) - expected), 0.00,
+                Tolerance * std::abs(expected));
+        }
+
+    return 0;  // not failed
+}
+
+std::size_t TestElementwise() {
+    complex_matrix a_matrix = MakeMatrix<complex_matrix>(40, 50);
+    complex_matrix b_matrix(a_matrix);
+    const complex_type alpha(0.50, -2.00);
+
+    b_matrix *= alpha;
+    for (std::size_t i = 0; i < 40; i++)
+        for (std::size_t j = 0; j < 50; j++)
+            AMATRIX_CHECK_NEAR(
+                std::abs(b_matrix(i, j) - alpha * a_matrix(i, j)), 0.00, 1e-14);
+
+    b_matrix += a_matrix;
+    b_matrix -= a_matrix;
+    for (std::size_t i = 0; i < 40; i++)
+        for (std::size_t j = 0; j < 50; j++)
+            AMATRIX_CHECK_NEAR(
+                std::abs(b_matrix(i, j) - alpha * a_matrix(i, j)), 0.00, 1e-14);
+
+    return 0;  // not failed
+}
+
+template <typename TDataType>
+std::size_t TestDotAndNorm(double Tolerance) {
+    using vector_type = AMatrix::Matrix<TDataType, AMatrix::dynamic, 1>;
+    using real_type = typename TDataType::value_type;
+    const std::size_t size = 1001;
+    vector_type a_vector(size);
+    vector_type b_vector(size);
+    std::complex<double> dot;
+    std::complex<double> conjugate_dot;
+    double squared_norm = 0.00;
+    for (std::size_t i = 0; i < size; i++) {
+        a_vector[i] = TDataType(real_type(1) / (i + 1), real_type(i % 7));
+        b_vector[i] = TDataType(real_type(i % 5), real_type(1) / (i + 2));
+        const std::complex<double> a(a_vector[i]);
+        const std::complex<double> b(b_vector[i]);
+        dot += a * b;
+        conjugate_dot += std::conj(a) * b;
+        squared_norm += std::norm(a);
+    }
+
+    const TDataType result = AMatrix::Dot(a_vector, b_vector);
+    AMATRIX_CHECK_NEAR(std::abs(std::complex<double>(result) - dot), 0.00,
+        Tolerance * std::abs(dot));
+    const TDataType conjugate_result =
+        AMatrix::ConjugateDot(a_vector, b_vector);
+    AMATRIX_CHECK_NEAR(
+        std::abs(std::complex<double>(conjugate_result) - conjugate_dot), 0.00,
+        Tolerance * std::abs(conjugate_dot));
+
+    // The generic path of the expressions gives the same results
+    const TDataType expression_result =
+        AMatrix::ConjugateDot(a_vector, TDataType(1) * b_vector);
+    AMATRIX_CHECK_NEAR(
+        std::abs(std::complex<double>(expression_result) - conjugate_dot),
+        0.00, Tolerance * std::abs(conjugate_dot));
+
+    const real_type norm = a_vector.norm();
+    AMATRIX_CHECK_NEAR(a_vector.squared_norm(), squared_norm,
+        Tolerance * squared_norm);
+    AMATRIX_CHECK_NEAR(norm, std::sqrt(squared_norm),
+        Tolerance * std::sqrt(squared_norm));
+    AMATRIX_CHECK_EQUAL(AMatrix::NormInf(a_vector), std::abs(a_vector[6]));
+
+    return 0;  // not failed
+}
+
+std::size_t TestHermitianTranspose() {
+    AMatrix::Matrix<complex_type, 2, 3> a_matrix;
+    for (std::size_t i = 0; i < 2; i++)
+        for (std::size_t j = 0; j < 3; j++)
+            a_matrix(i, j) = complex_type(i + 1.00, j - 1.00);
+
+    AMatrix::Matrix<complex_type, 3, 2> a_hermitian(
+        a_matrix.hermitian_transpose());
+    for (std::size_t i = 0; i < 3; i++)
+        for (std::size_t j = 0; j < 2; j++)
+            AMATRIX_CHECK_EQUAL(a_hermitian(i, j), std::conj(a_matrix(j, i)));
+
+    // A^H * A is Hermitian with a real diagonal
+    AMatrix::Matrix<complex_type, 3, 3> gram(
+        AMatrix::HermitianTranspose(a_matrix) * a_matrix);
+    for (std::size_t i = 0; i < 3; i++) {
+        AMATRIX_CHECK_EQUAL(gram(i, i).imag(), 0.00);
+        for (std::size_t j = 0; j < 3; j++)
+            AMATRIX_CHECK_EQUAL(gram(i, j), std::conj(gram(j, i)));
+    }
+
+    // For real matrices it is the transpose
+    AMatrix::Matrix<double, 2, 3> b_matrix{1., 2., 3., 4., 5., 6.};
+    AMatrix::Matrix<double, 3, 2> b_transpose(b_matrix.hermitian_transpose());
+    AMATRIX_CHECK_EQUAL(b_transpose(2, 0), 3.00);
+    AMATRIX_CHECK_EQUAL(b_transpose(0, 1), 4.00);
+
+    return 0;  // not failed
+}
+
+std::size_t TestLU() {
+    // The first column has a zero and an imaginary pivot
+    AMatrix::Matrix<complex_type, 2, 2> a_matrix{complex_type(0.00, 0.00),
+        complex_type(1.00, 1.00), complex_type(0.00, 2.00),
+        complex_type(3.00, 0.00)};
+    AMatrix::LUFactorization<AMatrix::Matrix<complex_type, 2, 2>,
+        permutation_vector>
+        small_factorization(a_matrix);
+    const complex_type determinant = small_factorization.determinant();
+    AMATRIX_CHECK_NEAR(std::abs(determinant - complex_type(2.00, -2.00)),
+        0.00, 1e-14);
+
+    const std::size_t size = 60;
+    complex_matrix b_matrix = MakeMatrix<complex_matrix>(size, size);
+    complex_matrix original(b_matrix);
+    complex_vector x_vector(size);
+    for (std::size_t i = 0; i < size; i++)
+        x_vector[i] = complex_type(i + 1.00, 1.00 - i);
+    complex_vector b_vector(original * x_vector);
+
+    AMatrix::LUFactorization<complex_matrix, permutation_vector>
+        lu_factorization(b_matrix);
+    complex_vector solution = lu_factorization.solve(b_vector);
+    for (std::size_t i = 0; i < size; i++)
+        AMATRIX_CHECK_NEAR(std::abs(solution[i] - x_vector[i]), 0.00, 1e-10);
+
+    return 0;  // not failed
+}
+
+std::size_t TestAllKernels() {
+    std::size_t number_of_failed_tests = 0;
+    number_of_failed_tests += TestProduct<std::complex<double>>(1e-13);
+    number_of_failed_tests += TestProduct<std::complex<float>>(1e-5);
+    number_of_failed_tests += TestElementwise();
+    number_of_failed_tests += TestDotAndNorm<std::complex<double>>(1e-12);
+    number_of_failed_tests += TestDotAndNorm<std::complex<float>>(1e-4);
+    number_of_failed_tests += TestLU();
+    return number_of_failed_tests;
+}
+
+int main() {
+    std::size_t number_of_failed_tests = 0;
+    const AMatrix::InstructionSet detected = AMatrix::DetectInstructionSet();
+    const AMatrix::InstructionSet instruction_sets[] = {
+        AMatrix::InstructionSet::generic_instructions,
+        AMatrix::InstructionSet::avx2_instructions,
+        AMatrix::InstructionSet::avx512_instructions};
+
+    for (auto instruction_set : instruction_sets) {
+        if (instruction_set > detected)
+            continue;
+        AMatrix::SetInstructionSet(instruction_set);
+        number_of_failed_tests += TestAllKernels();
+    }
+    AMatrix::SetInstructionSet(detected);
+
+    number_of_failed_tests += TestHermitianTranspose();
+
+    std::cout << number_of_failed_tests << " tests failed" << std::endl;
+
+    return number_of_failed_tests;
+}
@@ -1,3 +1,5 @@
+#include <type_traits>
+
 #include "amatrix.h"
 #include "checks.h"
 
@@ -66,6 +68,56 @@ std::size_t TestMatrixProduct(std::size_t TSize1, std::size_t TSize2,
     return 0;  // not failed
 }
 
+std::size_t TestNestedProduct(std::size_t TSize) {
+    std::cout << "Testing A X (B X A) and (A X B)^H X A with size " << TSize
+              << " ";
+    using matrix_type =
+        AMatrix::Matrix<double, AMatrix::dynamic, AMatrix::dynamic>;
+    matrix_type a_matrix(TSize, TSize);
+    matrix_type b_matrix(TSize, TSize);
+    for (std::size_t i = 0; i < TSize; i++)
+        for (std::size_t j = 0; j < TSize; j++) {
+            a_matrix(i, j) = 1.00 / (i + j + 1);
+            b_matrix(i, j) = (i == j) ? 2.00 : 0.50 / (i + 1);
+        }
+
+    // Product chains hold their inner products lazily and are evaluated as
+    // a whole, other expressions of products are held evaluated
+    static_assert(decltype(a_matrix * (b_matrix * a_matrix))::is_chain, "");
+    static_assert(
+        std::is_same<decltype(AMatrix::HermitianTranspose(
+                                  a_matrix * b_matrix) *
+                              a_matrix)::first_type,
+            matrix_type>::value,
+        "");
+
+    matrix_type b_a(b_matrix * a_matrix);
+    matrix_type expected(a_matrix * b_a);
+    matrix_type c_matrix(a_matrix * (b_matrix * a_matrix));
+    for (std::size_t i = 0; i < TSize; i++)
+        for (std::size_t j = 0; j < TSize; j++)
+            AMATRIX_CHECK_NEAR(c_matrix(i, j), expected(i, j), 1e-12);
+
+    matrix_type a_b(a_matrix * b_matrix);
+    expected = a_b.transpose() * a_matrix;
+    c_matrix = AMatrix::HermitianTranspose(a_matrix * b_matrix) * a_matrix;
+    for (std::size_t i = 0; i < TSize; i++)
+        for (std::size_t j = 0; j < TSize; j++)
+            AMATRIX_CHECK_NEAR(c_matrix(i, j), expected(i, j), 1e-12);
+
+    // Aliasing of the destination with a nested product is resolved by the
+    // evaluation of the inner product
+    c_matrix = a_matrix;
+    c_matrix = c_matrix * b_matrix * a_matrix;
+    expected = a_b * a_matrix;
+    for (std::size_t i = 0; i < TSize; i++)
+        for (std::size_t j = 0; j < TSize; j++)
+            AMATRIX_CHECK_NEAR(c_matrix(i, j), expected(i, j), 1e-12);
+
+    std::cout << "OK" << std::endl;
+    return 0;  // not failed
+}
+
 int main() {
     std::size_t number_of_failed_tests = 0;
 
@@ -134,6 +186,10 @@ int main() {
     number_of_failed_tests += TestMatrixProduct(1,3,3);
     number_of_failed_tests += TestMatrixProduct(2,3,3);
 
+    // nested product test
+    number_of_failed_tests += TestNestedProduct(3);
+    number_of_failed_tests += TestNestedProduct(40);
+
     std::cout << number_of_failed_tests << " tests failed" << std::endl;
 
     return number_of_failed_tests;
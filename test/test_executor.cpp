@@ -0,0 +1,130 @@
+#include <atomic>
+#include <vector>
+
+#include "amatrix.h"
+#include "checks.h"
+
+/// Application executor which counts its runs and runs them serially
+class CountingExecutor : public AMatrix::Executor {
+   public:
+    std::size_t number_of_runs = 0;
+
+    std::size_t number_of_threads() const override { return 3; }
+
+    void run(std::size_t NumberOfTasks,
+        std::function<void(std::size_t)> const& Task) override {
+        number_of_runs++;
+        AMatrix::SerialExecutor().run(NumberOfTasks, Task);
+    }
+};
+
+std::size_t TestEveryTaskOnce(AMatrix::Executor& rExecutor) {
+    const std::size_t number_of_tasks = 1000;
+    std::vector<std::atomic<int>> calls(number_of_tasks);
+    for (auto& r_calls : calls)
+        r_calls = 0;
+
+    // The checks of the tasks are counted, their return value is discarded
+    std::atomic<std::size_t> number_of_failures(0);
+    for (int run = 0; run < 10; run++)
+        rExecutor.run(number_of_tasks, [&](std::size_t Task) {
+            if (!AMatrix::IsInParallelRegion())
+                number_of_failures++;
+            // Uneven tasks, which are balanced by stealing
+            volatile double sum = 0.00;
+            for (std::size_t i = 0; i < (Task % 10) * 1000; i++)
+                sum = sum + i;
+            calls[Task]++;
+        });
+
+    AMATRIX_CHECK_EQUAL(number_of_failures.load(), 0);
+    for (auto& r_calls : calls)
+        AMATRIX_CHECK_EQUAL(r_calls.load(), 10);
+    AMATRIX_CHECK(!AMatrix::IsInParallelRegion());
+
+    return 0;  // not failed
+}
+
+std::size_t TestNestedParallelFor() {
+    AMatrix::ThreadPoolExecutor pool(4);
+    std::atomic<std::size_t> number_of_inner_chunks(0);
+    std::atomic<std::size_t> number_of_failures(0);
+    pool.run(8, [&](std::size_t Task) {
+        if (AMatrix::GetParallelism() != 1)
+            number_of_failures++;
+        // A nested kernel runs in one chunk
+        AMatrix::ParallelFor(0, 1000, 1,
+            [&](std::size_t ChunkBegin, std::size_t ChunkEnd) {
+                number_of_inner_chunks++;
+            });
+        // A nested run is executed serially by the same thread
+        pool.run(4, [](std::size_t) {});
+    });
+    AMATRIX_CHECK_EQUAL(number_of_failures.load(), 0);
+    AMATRIX_CHECK_EQUAL(number_of_inner_chunks.load(), 8);
+
+    return 0;  // not failed
+}
+
+std::size_t TestApplicationExecutor() {
+    CountingExecutor executor;
+    AMatrix::SetExecutor(&executor);
+    AMATRIX_CHECK_EQUAL(AMatrix::GetParallelism(), 3);
+
+    std::vector<int> chunk_of_item(999, -1);
+    int number_of_chunks = 0;
+    AMatrix::ParallelFor(0, 999, 1,
+        [&](std::size_t ChunkBegin, std::size_t ChunkEnd) {
+            for (std::size_t i = ChunkBegin; i < ChunkEnd; i++)
+                chunk_of_item[i] = number_of_chunks;
+            number_of_chunks++;
+        });
+    AMATRIX_CHECK_EQUAL(executor.number_of_runs, 1);
+    AMATRIX_CHECK_EQUAL(number_of_chunks, 3);
+    AMATRIX_CHECK_EQUAL(chunk_of_item[332], 0);
+    AMATRIX_CHECK_EQUAL(chunk_of_item[333], 1);
+    AMATRIX_CHECK_EQUAL(chunk_of_item[998], 2);
+
+    // The kernels run in the executor of the application
+    const std::size_t size = 1 << 20;
+    AMatrix::Matrix<double, AMatrix::dynamic, 1> a_vector(size);
+    for (std::size_t i = 0; i < size; i++)
+        a_vector[i] = 1.00;
+    AMATRIX_CHECK_EQUAL(a_vector.dot(a_vector), double(size));
+    AMATRIX_CHECK(executor.number_of_runs > 1);
+
+    AMatrix::SetExecutor(nullptr);
+    AMATRIX_CHECK(&AMatrix::GetExecutor() == &AMatrix::DefaultThreadPool());
+
+    return 0;  // not failed
+}
+
+std::size_t TestDefaultPool() {
+    const std::size_t number_of_threads = AMatrix::GetNumberOfThreads();
+    AMatrix::SetNumberOfThreads(5);
+    AMATRIX_CHECK_EQUAL(AMatrix::GetExecutor().number_of_threads(), 5);
+    AMATRIX_CHECK_EQUAL(AMatrix::GetParallelism(), 5);
+    std::size_t number_of_failed_tests =
+        TestEveryTaskOnce(AMatrix::GetExecutor());
+    AMatrix::SetNumberOfThreads(number_of_threads);
+    AMATRIX_CHECK_EQUAL(
+        AMatrix::GetExecutor().number_of_threads(), number_of_threads);
+    return number_of_failed_tests;
+}
+
+int main() {
+    std::size_t number_of_failed_tests = 0;
+    AMatrix::SerialExecutor serial_executor;
+    number_of_failed_tests += TestEveryTaskOnce(serial_executor);
+    AMatrix::ThreadPoolExecutor pool(4);
+    number_of_failed_tests += TestEveryTaskOnce(pool);
+    pool.resize(2);
+    number_of_failed_tests += TestEveryTaskOnce(pool);
+    number_of_failed_tests += TestNestedParallelFor();
+    number_of_failed_tests += TestApplicationExecutor();
+    number_of_failed_tests += TestDefaultPool();
+
+    std::cout << number_of_failed_tests << " tests failed" << std::endl;
+
+    return number_of_failed_tests;
+}
@@ -0,0 +1,124 @@
+#define AMATRIX_INSTRUMENTATION
+
+#include <sstream>
+
+#include "amatrix.h"
+#include "checks.h"
+
+using AMatrix::Operation;
+
+std::size_t TestFixedMatrixCounts() {
+    auto& counters = AMatrix::GetInstrumentationCounters();
+    counters.reset();
+
+    AMatrix::Matrix<double, 3, 3> a_matrix{2, 1, 0, 1, 3, 1, 0, 1, 4};
+    AMatrix::Matrix<double, 3, 3> b_matrix(a_matrix);
+    AMatrix::Matrix<double, 3, 3> c_matrix;
+    c_matrix = a_matrix + b_matrix;
+    c_matrix.noalias() = a_matrix * b_matrix;
+    c_matrix = b_matrix;
+
+    AMATRIX_CHECK_EQUAL(counters.get(Operation::assignment, 3, 3), 3);
+    AMATRIX_CHECK_EQUAL(counters.get(Operation::product, 3, 3), 1);
+    AMATRIX_CHECK_EQUAL(counters.total(Operation::allocation), 0);
+
+    AMatrix::LUFactorization<AMatrix::Matrix<double, 3, 3>,
+        AMatrix::Matrix<std::size_t, 3, 1>>
+        lu_factorization(b_matrix);
+    AMATRIX_CHECK_EQUAL(counters.get(Operation::factorization, 3, 3), 1);
+    AMATRIX_CHECK_EQUAL(counters.total(Operation::factorization), 1);
+
+    return 0;  // not failed
+}
+
+std::size_t TestDynamicMatrixCounts() {
+    auto& counters = AMatrix::GetInstrumentationCounters();
+    counters.reset();
+
+    AMatrix::Matrix<double, AMatrix::dynamic, AMatrix::dynamic> a_matrix(
+        100, 20);
+    AMatrix::Matrix<double, AMatrix::dynamic, AMatrix::dynamic> b_matrix(
+        20, 100);
+    for (std::size_t i = 0; i < 100; i++)
+        for (std::size_t j = 0; j < 20; j++)
+            a_matrix(i, j) = b_matrix(j, i) = 1.00 / (i + j + 1);
+
+    AMATRIX_CHECK_EQUAL(counters.get(Operation::allocation, 2000, 1), 2);
+    AMATRIX_CHECK_EQUAL(counters.allocated_bytes(), 2 * 2000 * sizeof(double));
+
+    AMatrix::Matrix<double, AMatrix::dynamic, AMatrix::dynamic> c_matrix(
+        a_matrix * b_matrix);
+    AMATRIX_CHECK_EQUAL(counters.get(Operation::product, 100, 100), 1);
+    AMATRIX_CHECK_EQUAL(counters.get(Operation::product, 65, 128), 1);
+    AMATRIX_CHECK_EQUAL(counters.total(Operation::allocation), 3);
+
+    // Same size, no new allocation
+    c_matrix = a_matrix * b_matrix;
+    AMATRIX_CHECK_EQUAL(counters.get(Operation::assignment, 100, 100), 1);
+    AMATRIX_CHECK_EQUAL(counters.total(Operation::allocation), 3);
+
+    auto gram_matrix = AMatrix::GramMatrix(a_matrix);
+    AMATRIX_CHECK_EQUAL(counters.get(Operation::product, 20, 20), 1);
+
+    std::stringstream summary;
+    AMatrix::PrintInstrumentationSummary(summary);
+    AMATRIX_CHECK(summary.str().find("65-128 x 65-128") != std::string::npos);
+    AMATRIX_CHECK(summary.str().find("allocation") != std::string::npos);
+
+    counters.reset();
+    AMATRIX_CHECK_EQUAL(counters.total(Operation::product), 0);
+
+    return 0;  // not failed
+}
+
+std::size_t TestProductCounts() {
+    auto& counters = AMatrix::GetInstrumentationCounters();
+    using AMatrix::ZeroMatrix;
+    AMatrix::Matrix<double, AMatrix::dynamic, AMatrix::dynamic> a_matrix(
+        ZeroMatrix<double>(40, 30));
+    AMatrix::Matrix<double, AMatrix::dynamic, AMatrix::dynamic> b_matrix(
+        ZeroMatrix<double>(30, 20));
+    AMatrix::Matrix<double, AMatrix::dynamic, 1> x_vector(
+        ZeroMatrix<double>(20, 1));
+    counters.reset();
+
+    // Products are counted when they are computed, not when built
+    auto product = a_matrix * b_matrix;
+    AMATRIX_CHECK_EQUAL(counters.total(Operation::product), 0);
+    AMatrix::Matrix<double, AMatrix::dynamic, AMatrix::dynamic> c_matrix(
+        product);
+    AMATRIX_CHECK_EQUAL(counters.get(Operation::product, 40, 20), 1);
+
+    // A chain counts the products of its plan, B * x first
+    AMatrix::Matrix<double, AMatrix::dynamic, 1> y_vector(
+        a_matrix * b_matrix * x_vector);
+    AMATRIX_CHECK_EQUAL(counters.get(Operation::product, 30, 1), 1);
+    AMATRIX_CHECK_EQUAL(counters.get(Operation::product, 40, 1), 1);
+    AMATRIX_CHECK_EQUAL(counters.total(Operation::product), 3);
+
+    return 0;  // not failed
+}
+
+std::size_t TestSizeClasses() {
+    AMATRIX_CHECK_EQUAL(AMatrix::SizeClass(16), 16);
+    AMATRIX_CHECK_EQUAL(AMatrix::SizeClass(17), AMatrix::SizeClass(32));
+    AMATRIX_CHECK(AMatrix::SizeClass(32) != AMatrix::SizeClass(33));
+    AMATRIX_CHECK_EQUAL(AMatrix::SizeClassName(AMatrix::SizeClass(100)),
+        std::string("65-128"));
+    AMATRIX_CHECK_EQUAL(AMatrix::SizeClassName(AMatrix::SizeClass(5000)),
+        std::string(">4096"));
+    return 0;  // not failed
+}
+
+int main() {
+    std::size_t number_of_failed_tests = 0;
+    AMatrix::GetInstrumentationCounters().set_report_at_exit(false);
+    number_of_failed_tests += TestFixedMatrixCounts();
+    number_of_failed_tests += TestDynamicMatrixCounts();
+    number_of_failed_tests += TestProductCounts();
+    number_of_failed_tests += TestSizeClasses();
+
+    std::cout << number_of_failed_tests << " tests failed" << std::endl;
+
+    return number_of_failed_tests;
+}
@@ -0,0 +1,131 @@
+#include <cmath>
+
+#include "amatrix.h"
+#include "checks.h"
+
+using dynamic_matrix =
+    AMatrix::Matrix<double, AMatrix::dynamic, AMatrix::dynamic>;
+using dynamic_vector = AMatrix::Matrix<double, AMatrix::dynamic, 1>;
+
+dynamic_matrix MakeMatrix(std::size_t Size1, std::size_t Size2) {
+    dynamic_matrix result(Size1, Size2);
+    for (std::size_t i = 0; i < Size1; i++)
+        for (std::size_t j = 0; j < Size2; j++)
+            result(i, j) = 1.00 / (i + 2 * j + 1) + ((i == j) ? Size1 : 0);
+    return result;
+}
+
+std::size_t TestProduct() {
+    dynamic_matrix a_matrix = MakeMatrix(41, 37);
+    dynamic_matrix b_matrix = MakeMatrix(37, 43);
+    dynamic_matrix c_matrix(a_matrix * b_matrix);
+
+    AMATRIX_CHECK_EQUAL(c_matrix.size1(), 41);
+    AMATRIX_CHECK_EQUAL(c_matrix.size2(), 43);
+    for (std::size_t i = 0; i < 41; i++)
+        for (std::size_t j = 0; j < 43; j++) {
+            double expected = 0.00;
+            for (std::size_t k = 0; k < 37; k++)
+                expected += a_matrix(i, k) * b_matrix(k, j);
+            AMATRIX_CHECK_NEAR(c_matrix(i, j), expected, 1e-12);
+        }
+
+    // Assigning a product to one of its operands uses a temporary
+    dynamic_matrix d_matrix = MakeMatrix(37, 37);
+    dynamic_matrix e_matrix(d_matrix);
+    dynamic_matrix expected(a_matrix * e_matrix);
+    a_matrix = a_matrix * d_matrix;
+    for (std::size_t i = 0; i < 41; i++)
+        for (std::size_t j = 0; j < 37; j++)
+            AMATRIX_CHECK_NEAR(a_matrix(i, j), expected(i, j), 1e-12);
+
+    return 0;  // not failed
+}
+
+std::size_t TestElementwise() {
+    dynamic_matrix a_matrix = MakeMatrix(40, 50);
+    dynamic_matrix b_matrix = MakeMatrix(40, 50);
+    dynamic_matrix c_matrix(a_matrix);
+
+    c_matrix += b_matrix;
+    for (std::size_t i = 0; i < 40; i++)
+        for (std::size_t j = 0; j < 50; j++)
+            AMATRIX_CHECK_EQUAL(c_matrix(i, j), 2.00 * a_matrix(i, j));
+
+    c_matrix *= 0.5;
+    c_matrix -= b_matrix;
+    for (std::size_t i = 0; i < 40; i++)
+        for (std::size_t j = 0; j < 50; j++)
+            AMATRIX_CHECK_EQUAL(c_matrix(i, j), 0.00);
+
+    return 0;  // not failed
+}
+
+std::size_t TestDot() {
+    const std::size_t size = 1001;
+    dynamic_vector a_vector(size);
+    dynamic_vector b_vector(size);
+    double expected = 0.00;
+    for (std::size_t i = 0; i < size; i++) {
+        a_vector[i] = i + 1.00;
+        b_vector[i] = 1.00 / (i + 1.00);
+        expected += a_vector[i] * b_vector[i];
+    }
+    AMATRIX_CHECK_NEAR(AMatrix::Dot(a_vector, b_vector), expected, 1e-10);
+    AMATRIX_CHECK_NEAR(AMatrix::Dot<AMatrix::pairwise_summation>(
+                           a_vector, b_vector),
+        expected, 1e-10);
+
+    return 0;  // not failed
+}
+
+std::size_t TestLUSolve() {
+    const std::size_t size = 60;
+    dynamic_matrix a_matrix = MakeMatrix(size, size);
+    dynamic_matrix original(a_matrix);
+    dynamic_vector x_vector(size);
+    for (std::size_t i = 0; i < size; i++)
+        x_vector[i] = i + 1.00;
+    dynamic_vector b_vector(original * x_vector);
+
+    AMatrix::LUFactorization<dynamic_matrix,
+        AMatrix::Matrix<std::size_t, AMatrix::dynamic, 1>>
+        lu_factorization(a_matrix);
+    dynamic_vector solution = lu_factorization.solve(b_vector);
+    for (std::size_t i = 0; i < size; i++)
+        AMATRIX_CHECK_NEAR(solution[i], x_vector[i], 1e-10);
+
+    return 0;  // not failed
+}
+
+std::size_t TestAllKernels() {
+    std::size_t number_of_failed_tests = 0;
+    number_of_failed_tests += TestProduct();
+    number_of_failed_tests += TestElementwise();
+    number_of_failed_tests += TestDot();
+    number_of_failed_tests += TestLUSolve();
+    return number_of_failed_tests;
+}
+
+int main() {
+    std::size_t number_of_failed_tests = 0;
+    const AMatrix::InstructionSet detected = AMatrix::DetectInstructionSet();
+    const AMatrix::InstructionSet instruction_sets[] = {
+        AMatrix::InstructionSet::generic_instructions,
+        AMatrix::InstructionSet::avx2_instructions,
+        AMatrix::InstructionSet::avx512_instructions};
+
+    for (auto instruction_set : instruction_sets) {
+        if (instruction_set > detected)
+            continue;
+        AMATRIX_CHECK(AMatrix::SetInstructionSet(instruction_set) ==
+                      instruction_set);
+        std::cout << "instruction set "
+                  << AMatrix::InstructionSetName(instruction_set) << std::endl;
+        number_of_failed_tests += TestAllKernels();
+    }
+
+    std::cout << number_of_failed_tests << " tests failed" << std::endl;
+
+    return number_of_failed_tests;
+}
@@ -0,0 +1,146 @@
+#include "amatrix.h"
+#include "checks.h"
+
+using dynamic_matrix =
+    AMatrix::Matrix<double, AMatrix::dynamic, AMatrix::dynamic>;
+
+template <typename TMatrixType>
+TMatrixType MakeMatrix(std::size_t Size1, std::size_t Size2) {
+    TMatrixType result(Size1, Size2);
+    for (std::size_t i = 0; i < Size1; i++)
+        for (std::size_t j = 0; j < Size2; j++)
+            result(i, j) = 1.00 / (i + 2 * j + 1);
+    return result;
+}
+
+template <typename TMatrixType>
+std::size_t TestAliasedProduct(std::size_t Size) {
+    TMatrixType a_matrix = MakeMatrix<TMatrixType>(Size, Size);
+    TMatrixType b_matrix = MakeMatrix<TMatrixType>(Size, Size);
+    TMatrixType expected(a_matrix);
+    for (std::size_t i = 0; i < Size; i++)
+        for (std::size_t j = 0; j < Size; j++) {
+            expected(i, j) = 0.00;
+            for (std::size_t k = 0; k < Size; k++)
+                expected(i, j) += a_matrix(i, k) * b_matrix(k, j);
+        }
+
+    a_matrix = a_matrix * b_matrix;
+    for (std::size_t i = 0; i < Size; i++)
+        for (std::size_t j = 0; j < Size; j++)
+            AMATRIX_CHECK_NEAR(a_matrix(i, j), expected(i, j), 1e-12);
+
+    return 0;  // not failed
+}
+
+std::size_t TestAliasedTranspose() {
+    AMatrix::Matrix<double, 3, 3> a_matrix{1., 2., 3., 4., 5., 6., 7., 8., 9.};
+    a_matrix = a_matrix.transpose();
+    for (std::size_t i = 0; i < 3; i++)
+        for (std::size_t j = 0; j < 3; j++)
+            AMATRIX_CHECK_EQUAL(a_matrix(i, j), 1.00 + i + 3 * j);
+
+    // The scalar is an element of the destination
+    dynamic_matrix b_matrix = MakeMatrix<dynamic_matrix>(4, 5);
+    dynamic_matrix original(b_matrix);
+    b_matrix = b_matrix(0, 0) * b_matrix;
+    for (std::size_t i = 0; i < 20; i++)
+        AMATRIX_CHECK_EQUAL(b_matrix[i], original(0, 0) * original[i]);
+
+    return 0;  // not failed
+}
+
+template <typename TMatrixType>
+std::size_t TestAliasedCompoundAssignment(std::size_t Size) {
+    TMatrixType a_matrix = MakeMatrix<TMatrixType>(Size, Size);
+    TMatrixType b_matrix = MakeMatrix<TMatrixType>(Size, Size);
+    TMatrixType original(a_matrix);
+
+    a_matrix += a_matrix * b_matrix;
+    for (std::size_t i = 0; i < Size; i++)
+        for (std::size_t j = 0; j < Size; j++) {
+            double expected = original(i, j);
+            for (std::size_t k = 0; k < Size; k++)
+                expected += original(i, k) * b_matrix(k, j);
+            AMATRIX_CHECK_NEAR(a_matrix(i, j), expected, 1e-12);
+        }
+
+    // The symmetric part of a matrix vanishes
+    a_matrix = original;
+    a_matrix -= a_matrix.transpose();
+    for (std::size_t i = 0; i < Size; i++)
+        for (std::size_t j = 0; j < Size; j++)
+            AMATRIX_CHECK_EQUAL(
+                a_matrix(i, j), original(i, j) - original(j, i));
+
+    return 0;  // not failed
+}
+
+std::size_t TestPooledTemporaries() {
+    auto& pool = AMatrix::TemporaryPool<double>::local();
+    pool.clear();
+
+    dynamic_matrix a_matrix = MakeMatrix<dynamic_matrix>(30, 30);
+    dynamic_matrix b_matrix = MakeMatrix<dynamic_matrix>(30, 30);
+
+    // Elementwise expressions may read the destination at the same element
+    a_matrix = a_matrix + b_matrix;
+    a_matrix = 2.00 * a_matrix - b_matrix;
+    AMATRIX_CHECK_EQUAL(pool.number_of_free_blocks(), 0);
+    AMATRIX_CHECK(!(a_matrix + b_matrix).aliases(
+        a_matrix.data(), a_matrix.data() + a_matrix.size()));
+    AMATRIX_CHECK(a_matrix.transpose().aliases(
+        a_matrix.data(), a_matrix.data() + a_matrix.size()));
+
+    // The temporary of the aliased product goes back to the pool and is
+    // reused by the next one
+    a_matrix = a_matrix * b_matrix;
+    AMATRIX_CHECK_EQUAL(pool.number_of_free_blocks(), 1);
+    a_matrix = b_matrix * a_matrix;
+    AMATRIX_CHECK_EQUAL(pool.number_of_free_blocks(), 1);
+
+    // Without aliasing the product is evaluated in place
+    dynamic_matrix c_matrix(30, 30);
+    pool.clear();
+    c_matrix = a_matrix * b_matrix;
+    c_matrix.noalias() = a_matrix * b_matrix;
+    AMATRIX_CHECK_EQUAL(pool.number_of_free_blocks(), 0);
+
+    return 0;  // not failed
+}
+
+std::size_t TestNoAlias() {
+    dynamic_matrix a_matrix = MakeMatrix<dynamic_matrix>(5, 4);
+    dynamic_matrix b_matrix = MakeMatrix<dynamic_matrix>(4, 3);
+    dynamic_matrix c_matrix(5, 3);
+    c_matrix.noalias() = a_matrix * b_matrix;
+    dynamic_matrix d_matrix(a_matrix * b_matrix);
+    AMATRIX_CHECK(c_matrix == d_matrix);
+
+    c_matrix.noalias() += a_matrix * b_matrix;
+    AMATRIX_CHECK_EQUAL(c_matrix(4, 2), 2.00 * d_matrix(4, 2));
+
+    return 0;  // not failed
+}
+
+int main() {
+    std::size_t number_of_failed_tests = 0;
+    number_of_failed_tests += TestAliasedProduct<dynamic_matrix>(3);
+    number_of_failed_tests += TestAliasedProduct<dynamic_matrix>(70);
+    number_of_failed_tests +=
+        TestAliasedProduct<AMatrix::Matrix<double, 4, 4>>(4);
+    number_of_failed_tests += TestAliasedTranspose();
+    number_of_failed_tests +=
+        TestAliasedCompoundAssignment<AMatrix::Matrix<double, 3, 3>>(3);
+    number_of_failed_tests += TestAliasedCompoundAssignment<dynamic_matrix>(3);
+    number_of_failed_tests +=
+        TestAliasedCompoundAssignment<dynamic_matrix>(40);
+    number_of_failed_tests += TestAliasedCompoundAssignment<
+        AMatrix::BoundedMatrix<double, 5, 5>>(3);
+    number_of_failed_tests += TestPooledTemporaries();
+    number_of_failed_tests += TestNoAlias();
+
+    std::cout << number_of_failed_tests << " tests failed" << std::endl;
+
+    return number_of_failed_tests;
+}
@@ -81,9 +81,61 @@ std::size_t TestMatrixColumnExpressionAssign() {
     return 0;  // not failed
 }
 
+template <typename TDataType>
+std::size_t TestStridedColumn(std::size_t Size1, std::size_t Size2) {
+    using matrix_type =
+        AMatrix::Matrix<TDataType, AMatrix::dynamic, AMatrix::dynamic>;
+    using vector_type = AMatrix::Matrix<TDataType, AMatrix::dynamic, 1>;
+    matrix_type a_matrix(Size1, Size2);
+    for (std::size_t i = 0; i < Size1; i++)
+        for (std::size_t j = 0; j < Size2; j++)
+            a_matrix(i, j) = TDataType(i % 13) - TDataType(j % 5);
+    vector_type b_vector(Size1, 1);
+    for (std::size_t i = 0; i < Size1; i++)
+        b_vector[i] = TDataType(i % 7) - 3;
+
+    const std::size_t j = Size2 / 2;
+    AMatrix::MatrixColumn<matrix_type> a_column_j(a_matrix, j);
+    AMATRIX_CHECK_EQUAL(a_column_j.stride(), Size2);
+    AMATRIX_CHECK(a_column_j.data() == &a_matrix(0, j));
+
+    // Gathered
+    vector_type column(a_column_j);
+    TDataType expected_dot = TDataType();
+    for (std::size_t i = 0; i < Size1; i++) {
+        AMATRIX_CHECK_EQUAL(column[i], a_matrix(i, j));
+        expected_dot += a_matrix(i, j) * b_vector[i];
+    }
+    AMATRIX_CHECK_EQUAL(AMatrix::Dot(a_column_j, b_vector), expected_dot);
+    AMATRIX_CHECK_EQUAL(AMatrix::Dot(b_vector, a_column_j), expected_dot);
+    AMATRIX_CHECK_EQUAL(AMatrix::Dot(a_column_j, a_column_j),
+        AMatrix::Dot(column, column));
+
+    // Scattered
+    a_column_j = b_vector;
+    a_column_j += b_vector;
+    a_column_j -= column;
+    for (std::size_t i = 0; i < Size1; i++) {
+        AMATRIX_CHECK_EQUAL(a_matrix(i, j), 2 * b_vector[i] - column[i]);
+        if (j > 0)
+            AMATRIX_CHECK_EQUAL(a_matrix(i, j - 1),
+                TDataType(i % 13) - TDataType((j - 1) % 5));
+        if (j + 1 < Size2)
+            AMATRIX_CHECK_EQUAL(a_matrix(i, j + 1),
+                TDataType(i % 13) - TDataType((j + 1) % 5));
+    }
+
+    return 0;  // not failed
+}
+
 int main() {
     std::size_t number_of_failed_tests = 0;
 
+    number_of_failed_tests += TestStridedColumn<double>(5, 3);
+    number_of_failed_tests += TestStridedColumn<double>(100, 7);
+    number_of_failed_tests += TestStridedColumn<double>(1001, 33);
+    number_of_failed_tests += TestStridedColumn<float>(517, 4);
+
     number_of_failed_tests += TestMatrixColumnAcess<1, 1>();
     number_of_failed_tests += TestMatrixColumnAcess<1, 2>();
     number_of_failed_tests += TestMatrixColumnAcess<2, 1>();
@@ -0,0 +1,123 @@
+#include "amatrix.h"
+#include "checks.h"
+
+std::size_t TestMatrixExponentialDiagonal() {
+    AMatrix::Matrix<double, 3, 3> a_matrix{
+        1.0, 0.0, 0.0, 0.0, -2.0, 0.0, 0.0, 0.0, 0.5};
+
+    auto exp_a = AMatrix::MatrixExponential(a_matrix);
+
+    for (std::size_t i = 0; i < 3; i++)
+        for (std::size_t j = 0; j < 3; j++)
+            AMATRIX_CHECK_NEAR(exp_a(i, j),
+                (i == j) ? std::exp(a_matrix(i, i)) : 0.00, 1e-13);
+
+    return 0;  // not failed
+}
+
+std::size_t TestMatrixExponentialRotation() {
+    // exp of a skew symmetric matrix is a rotation
+    const double angle = 2.5;
+    AMatrix::Matrix<double, 2, 2> a_matrix{0.0, -angle, angle, 0.0};
+
+    auto exp_a = AMatrix::MatrixExponential(a_matrix);
+
+    AMATRIX_CHECK_NEAR(exp_a(0, 0), std::cos(angle), 1e-13);
+    AMATRIX_CHECK_NEAR(exp_a(0, 1), -std::sin(angle), 1e-13);
+    AMATRIX_CHECK_NEAR(exp_a(1, 0), std::sin(angle), 1e-13);
+    AMATRIX_CHECK_NEAR(exp_a(1, 1), std::cos(angle), 1e-13);
+
+    return 0;  // not failed
+}
+
+std::size_t TestMatrixExponentialNilpotent() {
+    AMatrix::Matrix<double, 3, 3> a_matrix{
+        0.0, 1.0, 2.0, 0.0, 0.0, 3.0, 0.0, 0.0, 0.0};
+    // exp(A) = I + A + A^2 / 2
+    AMatrix::Matrix<double, 3, 3> correct_result{
+        1.0, 1.0, 3.5, 0.0, 1.0, 3.0, 0.0, 0.0, 1.0};
+
+    auto exp_a = AMatrix::MatrixExponential(a_matrix);
+
+    for (std::size_t i = 0; i < 3; i++)
+        for (std::size_t j = 0; j < 3; j++)
+            AMATRIX_CHECK_NEAR(exp_a(i, j), correct_result(i, j), 1e-13);
+
+    return 0;  // not failed
+}
+
+template <std::size_t TSize>
+std::size_t TestMatrixSquareRoot() {
+    AMatrix::Matrix<double, TSize, TSize> b_matrix;
+    for (std::size_t i = 0; i < TSize; i++)
+        for (std::size_t j = 0; j < TSize; j++)
+            b_matrix(i, j) = 1.00 / (i + j + 1) + (i == j);
+
+    // a = b^T b is symmetric positive definite
+    AMatrix::Matrix<double, TSize, TSize> a_matrix(
+        b_matrix.transpose() * b_matrix);
+
+    auto sqrt_a = AMatrix::MatrixSquareRoot(a_matrix);
+    AMatrix::Matrix<double, TSize, TSize> square(sqrt_a * sqrt_a);
+
+    for (std::size_t i = 0; i < TSize; i++)
+        for (std::size_t j = 0; j < TSize; j++) {
+            AMATRIX_CHECK_NEAR(square(i, j), a_matrix(i, j), 1e-12);
+            AMATRIX_CHECK_NEAR(sqrt_a(i, j), sqrt_a(j, i), 1e-12);
+        }
+
+    return 0;  // not failed
+}
+
+template <std::size_t TSize>
+std::size_t TestMatrixPolarDecomposition() {
+    AMatrix::Matrix<double, TSize, TSize> f_matrix;
+    for (std::size_t i = 0; i < TSize; i++)
+        for (std::size_t j = 0; j < TSize; j++)
+            f_matrix(i, j) = (i == j) ? 1.5 + 0.1 * i : 0.3 * i - 0.2 * j;
+
+    AMatrix::Matrix<double, TSize, TSize> r_matrix;
+    AMatrix::Matrix<double, TSize, TSize> u_matrix;
+    AMatrix::PolarDecomposition(f_matrix, r_matrix, u_matrix);
+
+    AMatrix::Matrix<double, TSize, TSize> r_transpose_r(
+        r_matrix.transpose() * r_matrix);
+    AMatrix::Matrix<double, TSize, TSize> r_u(r_matrix * u_matrix);
+
+    for (std::size_t i = 0; i < TSize; i++)
+        for (std::size_t j = 0; j < TSize; j++) {
+            AMATRIX_CHECK_NEAR(r_transpose_r(i, j), (i == j) ? 1.00 : 0.00, 1e-13);
+            AMATRIX_CHECK_NEAR(r_u(i, j), f_matrix(i, j), 1e-13);
+            AMATRIX_CHECK_NEAR(u_matrix(i, j), u_matrix(j, i), 1e-13);
+        }
+
+    // U should be the square root of F^T F
+    AMatrix::Matrix<double, TSize, TSize> c_matrix(
+        f_matrix.transpose() * f_matrix);
+    auto sqrt_c = AMatrix::MatrixSquareRoot(c_matrix);
+    for (std::size_t i = 0; i < TSize; i++)
+        for (std::size_t j = 0; j < TSize; j++)
+            AMATRIX_CHECK_NEAR(u_matrix(i, j), sqrt_c(i, j), 1e-12);
+
+    return 0;  // not failed
+}
+
+int main() {
+    std::size_t number_of_failed_tests = 0;
+    number_of_failed_tests += TestMatrixExponentialDiagonal();
+    number_of_failed_tests += TestMatrixExponentialRotation();
+    number_of_failed_tests += TestMatrixExponentialNilpotent();
+
+    number_of_failed_tests += TestMatrixSquareRoot<1>();
+    number_of_failed_tests += TestMatrixSquareRoot<2>();
+    number_of_failed_tests += TestMatrixSquareRoot<3>();
+    number_of_failed_tests += TestMatrixSquareRoot<6>();
+
+    number_of_failed_tests += TestMatrixPolarDecomposition<2>();
+    number_of_failed_tests += TestMatrixPolarDecomposition<3>();
+    number_of_failed_tests += TestMatrixPolarDecomposition<4>();
+
+    std::cout << number_of_failed_tests << " tests failed" << std::endl;
+
+    return number_of_failed_tests;
+}
@@ -0,0 +1,105 @@
+#include <vector>
+
+#include "amatrix.h"
+#include "checks.h"
+
+using dynamic_matrix =
+    AMatrix::Matrix<double, AMatrix::dynamic, AMatrix::dynamic>;
+
+dynamic_matrix MakeMatrix(std::size_t Size1, std::size_t Size2) {
+    dynamic_matrix result(Size1, Size2);
+    for (std::size_t i = 0; i < Size1; i++)
+        for (std::size_t j = 0; j < Size2; j++)
+            result(i, j) = double(i * Size2 + j);
+    return result;
+}
+
+/// The degrees of freedom of the nodes, each with three consecutive ones
+std::vector<std::size_t> NodalDofs(std::vector<std::size_t> const& Nodes) {
+    std::vector<std::size_t> dofs;
+    for (std::size_t node : Nodes)
+        for (std::size_t k = 0; k < 3; k++)
+            dofs.push_back(3 * node + k);
+    return dofs;
+}
+
+std::size_t TestIndexedView(std::vector<std::size_t> const& RowDofs,
+    std::vector<std::size_t> const& ColumnDofs, std::size_t GlobalSize) {
+    dynamic_matrix global_matrix = MakeMatrix(GlobalSize, GlobalSize);
+    dynamic_matrix expected(global_matrix);
+    const std::size_t size1 = RowDofs.size();
+    const std::size_t size2 = ColumnDofs.size();
+
+    AMatrix::IndexedView<dynamic_matrix> element_dofs(
+        global_matrix, RowDofs, ColumnDofs);
+    AMATRIX_CHECK_EQUAL(element_dofs.size1(), size1);
+    AMATRIX_CHECK_EQUAL(element_dofs.size2(), size2);
+
+    // Extraction with gathers
+    dynamic_matrix element_matrix(element_dofs);
+    for (std::size_t i = 0; i < size1; i++)
+        for (std::size_t j = 0; j < size2; j++)
+            AMATRIX_CHECK_EQUAL(element_matrix(i, j),
+                global_matrix(RowDofs[i], ColumnDofs[j]));
+
+    // Assembly with scatters
+    for (std::size_t i = 0; i < element_matrix.size(); i++)
+        element_matrix[i] = 0.50 * i;
+    element_dofs += element_matrix;
+    for (std::size_t i = 0; i < size1; i++)
+        for (std::size_t j = 0; j < size2; j++)
+            expected(RowDofs[i], ColumnDofs[j]) += element_matrix(i, j);
+    for (std::size_t i = 0; i < global_matrix.size(); i++)
+        AMATRIX_CHECK_EQUAL(global_matrix[i], expected[i]);
+
+    // Expressions and products are evaluated first
+    const double factor = 2.00;
+    element_dofs -= factor * element_matrix;
+    dynamic_matrix b_matrix = MakeMatrix(size2, size2);
+    element_dofs += element_matrix * b_matrix;
+    for (std::size_t i = 0; i < size1; i++)
+        for (std::size_t j = 0; j < size2; j++) {
+            double product = 0.00;
+            for (std::size_t k = 0; k < size2; k++)
+                product += element_matrix(i, k) * b_matrix(k, j);
+            expected(RowDofs[i], ColumnDofs[j]) +=
+                product - 2.00 * element_matrix(i, j);
+        }
+    for (std::size_t i = 0; i < global_matrix.size(); i++)
+        AMATRIX_CHECK_NEAR(global_matrix[i], expected[i], 1e-9);
+
+    element_dofs = element_matrix;
+    for (std::size_t i = 0; i < size1; i++)
+        for (std::size_t j = 0; j < size2; j++)
+            AMATRIX_CHECK_EQUAL(global_matrix(RowDofs[i], ColumnDofs[j]),
+                element_matrix(i, j));
+
+    return 0;  // not failed
+}
+
+int main() {
+    std::size_t number_of_failed_tests = 0;
+
+    // Scattered degrees of freedom
+    std::vector<std::size_t> scattered = {7, 2, 19, 11, 5};
+    number_of_failed_tests += TestIndexedView(scattered, scattered, 20);
+    std::vector<std::size_t> long_scattered;
+    for (std::size_t i = 0; i < 40; i++)
+        long_scattered.push_back((i * 13 + 5) % 97);
+    number_of_failed_tests +=
+        TestIndexedView(long_scattered, long_scattered, 97);
+
+    // Runs of nodal degrees of freedom, for the contiguous kernels
+    std::vector<std::size_t> dofs = NodalDofs({4, 0, 9, 2});
+    number_of_failed_tests += TestIndexedView(dofs, dofs, 30);
+    std::vector<std::size_t> sorted_dofs = NodalDofs({1, 2, 3, 7, 8, 9});
+    number_of_failed_tests += TestIndexedView(sorted_dofs, scattered, 30);
+    std::vector<std::size_t> long_run;
+    for (std::size_t i = 0; i < 40; i++)
+        long_run.push_back(i + 10);
+    number_of_failed_tests += TestIndexedView(long_run, long_run, 60);
+
+    std::cout << number_of_failed_tests << " tests failed" << std::endl;
+
+    return number_of_failed_tests;
+}
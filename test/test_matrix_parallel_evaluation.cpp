@@ -0,0 +1,69 @@
+#include "amatrix.h"
+#include "checks.h"
+
+template <typename TDataType>
+std::size_t TestElementwise(std::size_t Size1, std::size_t Size2) {
+    using matrix_type =
+        AMatrix::Matrix<TDataType, AMatrix::dynamic, AMatrix::dynamic>;
+    matrix_type a_matrix(Size1, Size2);
+    matrix_type b_matrix(Size1, Size2);
+    for (std::size_t i = 0; i < a_matrix.size(); i++) {
+        a_matrix[i] = TDataType(i % 101);
+        b_matrix[i] = TDataType(i % 37) - 18;
+    }
+    const TDataType factor = 3;
+
+    matrix_type sum(a_matrix + b_matrix);
+    matrix_type difference(Size1, Size2);
+    difference = a_matrix - b_matrix;
+    matrix_type scaled(Size1, Size2);
+    scaled.noalias() = factor * a_matrix;
+    for (std::size_t i = 0; i < a_matrix.size(); i++) {
+        AMATRIX_CHECK_EQUAL(sum[i], a_matrix[i] + b_matrix[i]);
+        AMATRIX_CHECK_EQUAL(difference[i], a_matrix[i] - b_matrix[i]);
+        AMATRIX_CHECK_EQUAL(scaled[i], factor * a_matrix[i]);
+    }
+
+    // Zeros are filled in the same chunks
+    difference = AMatrix::ZeroMatrix<TDataType>(Size1, Size2);
+    for (std::size_t i = 0; i < difference.size(); i++)
+        AMATRIX_CHECK_EQUAL(difference[i], TDataType());
+
+    // The destination is read at the same element only
+    a_matrix = factor * a_matrix + b_matrix;
+    for (std::size_t i = 0; i < a_matrix.size(); i++)
+        AMATRIX_CHECK_EQUAL(a_matrix[i], factor * sum[i] - (factor - 1) *
+                                             b_matrix[i]);
+
+    return 0;  // not failed
+}
+
+std::size_t TestAllSizes() {
+    std::size_t number_of_failed_tests = 0;
+    number_of_failed_tests += TestElementwise<double>(3, 5);
+    number_of_failed_tests += TestElementwise<double>(257, 263);
+    number_of_failed_tests += TestElementwise<double>(1000, 700);
+    number_of_failed_tests += TestElementwise<double>(1, 300001);
+    number_of_failed_tests += TestElementwise<float>(517, 301);
+    return number_of_failed_tests;
+}
+
+int main() {
+    std::size_t number_of_failed_tests = 0;
+    const std::size_t number_of_threads = AMatrix::GetNumberOfThreads();
+    const std::size_t streaming_store_bytes = AMatrix::GetStreamingStoreBytes();
+    for (std::size_t threads = 1; threads <= 4; threads += 3) {
+        AMatrix::SetNumberOfThreads(threads);
+        AMatrix::SetStreamingStoreBytes(streaming_store_bytes);
+        number_of_failed_tests += TestAllSizes();
+        // Every parallel evaluation is streamed
+        AMatrix::SetStreamingStoreBytes(1);
+        number_of_failed_tests += TestAllSizes();
+    }
+    AMatrix::SetNumberOfThreads(number_of_threads);
+    AMatrix::SetStreamingStoreBytes(streaming_store_bytes);
+
+    std::cout << number_of_failed_tests << " tests failed" << std::endl;
+
+    return number_of_failed_tests;
+}
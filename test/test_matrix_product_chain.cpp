@@ -0,0 +1,188 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "amatrix.h"
+#include "checks.h"
+
+std::atomic<std::size_t> number_of_allocations(0);
+
+void* operator new(std::size_t Size) {
+    number_of_allocations++;
+    if (void* p_memory = std::malloc(Size))
+        return p_memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pMemory) noexcept { std::free(pMemory); }
+
+using dynamic_matrix =
+    AMatrix::Matrix<double, AMatrix::dynamic, AMatrix::dynamic>;
+using dynamic_vector = AMatrix::Matrix<double, AMatrix::dynamic, 1>;
+
+template <typename TMatrixType>
+TMatrixType MakeMatrix(std::size_t Size1, std::size_t Size2) {
+    TMatrixType result(Size1, Size2);
+    for (std::size_t i = 0; i < Size1; i++)
+        for (std::size_t j = 0; j < Size2; j++)
+            result(i, j) = 1.00 / (i + 2 * j + 1);
+    return result;
+}
+
+template <typename TMatrixType, typename TExpressionType>
+std::size_t CheckNear(TMatrixType const& Result,
+    TExpressionType const& Expected, double Tolerance) {
+    AMATRIX_CHECK_EQUAL(Result.size1(), Expected.size1());
+    AMATRIX_CHECK_EQUAL(Result.size2(), Expected.size2());
+    for (std::size_t i = 0; i < Result.size1(); i++)
+        for (std::size_t j = 0; j < Result.size2(); j++)
+            AMATRIX_CHECK_NEAR(Result(i, j), Expected(i, j), Tolerance);
+    return 0;  // not failed
+}
+
+std::size_t TestPlan() {
+    // The example of Cormen et al.
+    AMatrix::ProductChainPlan plan({30, 35, 15, 5, 10, 20, 25});
+    AMATRIX_CHECK_EQUAL(plan.length(), 6);
+    AMATRIX_CHECK_EQUAL(plan.cost(), 15125);
+    AMATRIX_CHECK_EQUAL(plan.split(0, 5), 2);
+    AMATRIX_CHECK_EQUAL(plan.split(0, 2), 0);
+    AMATRIX_CHECK_EQUAL(plan.split(3, 5), 4);
+
+    // A * B * C * v is evaluated from the right with matrix vector products
+    AMatrix::ProductChainPlan vector_plan({40, 40, 40, 40, 1});
+    AMATRIX_CHECK_EQUAL(vector_plan.cost(), 3 * 40 * 40);
+    AMATRIX_CHECK_EQUAL(vector_plan.split(0, 3), 0);
+    AMATRIX_CHECK_EQUAL(vector_plan.split(1, 3), 1);
+
+    // A single product has one order
+    AMatrix::ProductChainPlan single_plan({4, 5, 6});
+    AMATRIX_CHECK_EQUAL(single_plan.cost(), 120);
+    AMATRIX_CHECK_EQUAL(single_plan.split(0, 1), 0);
+
+    return 0;  // not failed
+}
+
+std::size_t TestMatrixVectorChain(std::size_t Size) {
+    dynamic_matrix a_matrix = MakeMatrix<dynamic_matrix>(Size, Size);
+    dynamic_matrix b_matrix = MakeMatrix<dynamic_matrix>(Size, Size);
+    dynamic_matrix c_matrix = MakeMatrix<dynamic_matrix>(Size, Size);
+    dynamic_vector v_vector(Size);
+    for (std::size_t i = 0; i < Size; i++)
+        v_vector[i] = i + 1.00;
+
+    dynamic_vector c_v(c_matrix * v_vector);
+    dynamic_vector b_c_v(b_matrix * c_v);
+    dynamic_vector expected(a_matrix * b_c_v);
+
+    dynamic_vector result(a_matrix * b_matrix * c_matrix * v_vector);
+    std::size_t number_of_failed_tests =
+        CheckNear(result, expected, 1e-10 * Size);
+
+    // The chain of an assignment is flattened the same way
+    result = a_matrix * (b_matrix * c_matrix) * v_vector;
+    number_of_failed_tests += CheckNear(result, expected, 1e-10 * Size);
+
+    AMatrix::ProductChain<double> chain;
+    chain.add(a_matrix * b_matrix * c_matrix * v_vector);
+    AMATRIX_CHECK_EQUAL(chain.size(), 4);
+    AMATRIX_CHECK_EQUAL(chain.plan().cost(), 3 * Size * Size);
+
+    return number_of_failed_tests;
+}
+
+std::size_t TestRectangularChain() {
+    dynamic_matrix a_matrix = MakeMatrix<dynamic_matrix>(7, 30);
+    dynamic_matrix b_matrix = MakeMatrix<dynamic_matrix>(30, 2);
+    dynamic_matrix c_matrix = MakeMatrix<dynamic_matrix>(2, 25);
+
+    dynamic_matrix a_b(a_matrix * b_matrix);
+    dynamic_matrix expected(a_b * c_matrix);
+    dynamic_matrix result(a_matrix * b_matrix * c_matrix);
+    std::size_t number_of_failed_tests = CheckNear(result, expected, 1e-12);
+
+    // Operands which are not dense are evaluated once
+    dynamic_matrix c_transpose(c_matrix.transpose());
+    result = a_matrix * b_matrix * c_transpose.transpose();
+    number_of_failed_tests += CheckNear(result, expected, 1e-12);
+
+    // Reading an element evaluates the chain once
+    auto chain = a_matrix * b_matrix * c_matrix;
+    AMATRIX_CHECK_NEAR(chain(6, 24), expected(6, 24), 1e-12);
+    AMATRIX_CHECK_NEAR(chain(3, 0), expected(3, 0), 1e-12);
+
+    return number_of_failed_tests;
+}
+
+std::size_t TestFixedSizeChain() {
+    using matrix_3x3 = AMatrix::Matrix<double, 3, 3>;
+    matrix_3x3 a_matrix{1., 2., 3., 4., 5., 6., 7., 8., 10.};
+    matrix_3x3 b_matrix{2., 0., 1., 0., 1., 0., 1., 0., 3.};
+    AMatrix::Matrix<double, 3, 1> v_vector{1., -1., 2.};
+
+    auto result = AMatrix::Evaluate(a_matrix * b_matrix * v_vector);
+    AMATRIX_CHECK((std::is_same<decltype(result),
+        AMatrix::Matrix<double, 3, 1>>::value));
+    matrix_3x3 a_b(a_matrix * b_matrix);
+    AMatrix::Matrix<double, 3, 1> expected(a_b * v_vector);
+    for (std::size_t i = 0; i < 3; i++)
+        AMATRIX_CHECK_EQUAL(result[i], expected[i]);
+
+    // Fixed size chains are evaluated on the stack
+    matrix_3x3 c_matrix(a_b);
+    matrix_3x3 expected_a_b_c(a_b * c_matrix);
+    const std::size_t allocations_before = number_of_allocations;
+    matrix_3x3 a_b_c(a_matrix * b_matrix * c_matrix);
+    a_b_c = a_matrix * b_matrix * c_matrix;
+    auto chain = a_matrix * b_matrix * c_matrix;
+    AMATRIX_CHECK_EQUAL(chain(2, 1), expected_a_b_c(2, 1));
+    AMATRIX_CHECK_EQUAL(number_of_allocations, allocations_before);
+    for (std::size_t i = 0; i < 9; i++)
+        AMATRIX_CHECK_EQUAL(a_b_c[i], expected_a_b_c[i]);
+
+    return 0;  // not failed
+}
+
+std::size_t TestStaticPlan() {
+    using AMatrix::Matrix;
+    using product_type =
+        AMatrix::MatrixProductExpression<AMatrix::MatrixProductExpression<
+                                             AMatrix::MatrixProductExpression<
+                                                 Matrix<double, 2, 40>,
+                                                 Matrix<double, 40, 40>>,
+                                             Matrix<double, 40, 40>>,
+            Matrix<double, 40, 1>>;
+    using plan = AMatrix::StaticProductChainPlan<product_type>;
+    static_assert(AMatrix::ProductChainLength<product_type>::value == 4, "");
+    static_assert(plan::split(0, 3) == 0, "");
+    static_assert(plan::split(1, 3) == 1, "");
+    static_assert(plan::cost(0, 3) == 2 * 40 * 40 + 2 * 40, "");
+
+    Matrix<double, 2, 40> a_matrix = MakeMatrix<Matrix<double, 2, 40>>(2, 40);
+    Matrix<double, 40, 40> b_matrix =
+        MakeMatrix<Matrix<double, 40, 40>>(40, 40);
+    Matrix<double, 40, 1> v_vector = MakeMatrix<Matrix<double, 40, 1>>(40, 1);
+    Matrix<double, 40, 1> b_v(b_matrix * v_vector);
+    Matrix<double, 40, 1> b_b_v(b_matrix * b_v);
+    Matrix<double, 2, 1> expected(a_matrix * b_b_v);
+
+    // The transpose is evaluated as an operand on the stack
+    Matrix<double, 40, 40> b_transpose(b_matrix.transpose());
+    Matrix<double, 2, 1> result(
+        a_matrix * b_matrix * b_transpose.transpose() * v_vector);
+    return CheckNear(result, expected, 1e-12);
+}
+
+int main() {
+    std::size_t number_of_failed_tests = 0;
+    number_of_failed_tests += TestPlan();
+    number_of_failed_tests += TestMatrixVectorChain(5);
+    number_of_failed_tests += TestMatrixVectorChain(60);
+    number_of_failed_tests += TestRectangularChain();
+    number_of_failed_tests += TestFixedSizeChain();
+    number_of_failed_tests += TestStaticPlan();
+
+    std::cout << number_of_failed_tests << " tests failed" << std::endl;
+
+    return number_of_failed_tests;
+}
@@ -80,9 +80,93 @@ std::size_t TestMatrixRowExpressionAssign() {
     return 0;  // not failed
 }
 
+template <typename TDataType>
+std::size_t TestContiguousRow(std::size_t Size1, std::size_t Size2) {
+    using matrix_type =
+        AMatrix::Matrix<TDataType, AMatrix::dynamic, AMatrix::dynamic>;
+    using vector_type = AMatrix::Matrix<TDataType, 1, AMatrix::dynamic>;
+    static_assert(AMatrix::IsContiguous<AMatrix::MatrixRow<matrix_type>>::value,
+        "The rows of a dense matrix are contiguous");
+    matrix_type a_matrix(Size1, Size2);
+    for (std::size_t i = 0; i < Size1; i++)
+        for (std::size_t j = 0; j < Size2; j++)
+            a_matrix(i, j) = TDataType(i % 5) - TDataType(j % 13);
+    vector_type b_vector(1, Size2);
+    for (std::size_t j = 0; j < Size2; j++)
+        b_vector[j] = TDataType(j % 7) - 3;
+
+    const std::size_t i = Size1 / 2;
+    AMatrix::MatrixRow<matrix_type> a_row_i(a_matrix, i);
+    AMATRIX_CHECK(a_row_i.data() == &a_matrix(i, 0));
+
+    vector_type row(a_row_i);
+    TDataType expected_dot = TDataType();
+    for (std::size_t j = 0; j < Size2; j++) {
+        AMATRIX_CHECK_EQUAL(row[j], a_matrix(i, j));
+        expected_dot += a_matrix(i, j) * b_vector[j];
+    }
+    AMATRIX_CHECK_EQUAL(AMatrix::Dot(a_row_i, b_vector), expected_dot);
+
+    // The row is a dense operand of a vector matrix product
+    matrix_type b_matrix(Size2, 3);
+    for (std::size_t k = 0; k < b_matrix.size(); k++)
+        b_matrix[k] = TDataType(k % 3);
+    AMatrix::Matrix<TDataType, 1, AMatrix::dynamic> product(
+        a_row_i * b_matrix);
+    for (std::size_t j = 0; j < 3; j++) {
+        TDataType expected = TDataType();
+        for (std::size_t k = 0; k < Size2; k++)
+            expected += a_matrix(i, k) * b_matrix(k, j);
+        AMATRIX_CHECK_EQUAL(product[j], expected);
+    }
+
+    const TDataType factor = 2;
+    a_row_i = factor * b_vector;
+    a_row_i += b_vector;
+    a_row_i -= row;
+    for (std::size_t j = 0; j < Size2; j++) {
+        AMATRIX_CHECK_EQUAL(a_matrix(i, j), 3 * b_vector[j] - row[j]);
+        if (i > 0)
+            AMATRIX_CHECK_EQUAL(a_matrix(i - 1, j),
+                TDataType((i - 1) % 5) - TDataType(j % 13));
+    }
+
+    return 0;  // not failed
+}
+
+/// A row assigned from a product which reads the row itself
+std::size_t TestAliasedRowProduct(std::size_t Size) {
+    using matrix_type =
+        AMatrix::Matrix<double, AMatrix::dynamic, AMatrix::dynamic>;
+    matrix_type a_matrix(Size, Size);
+    for (std::size_t i = 0; i < Size; i++)
+        for (std::size_t j = 0; j < Size; j++)
+            a_matrix(i, j) = double((i + 2 * j) % 5) - 2.00;
+    matrix_type expected(1, Size);
+    for (std::size_t j = 0; j < Size; j++) {
+        expected(0, j) = 0.00;
+        for (std::size_t k = 0; k < Size; k++)
+            expected(0, j) += a_matrix(0, k) * a_matrix(k, j);
+    }
+
+    AMatrix::MatrixRow<matrix_type> a_row_0(a_matrix, 0);
+    a_row_0 = a_row_0 * a_matrix;
+    for (std::size_t j = 0; j < Size; j++)
+        AMATRIX_CHECK_EQUAL(a_matrix(0, j), expected(0, j));
+
+    return 0;  // not failed
+}
+
 int main() {
     std::size_t number_of_failed_tests = 0;
 
+    number_of_failed_tests += TestContiguousRow<double>(3, 5);
+    number_of_failed_tests += TestContiguousRow<double>(7, 100);
+    number_of_failed_tests += TestContiguousRow<double>(33, 1001);
+    number_of_failed_tests += TestContiguousRow<float>(4, 517);
+    number_of_failed_tests += TestAliasedRowProduct(3);
+    number_of_failed_tests += TestAliasedRowProduct(40);
+
     number_of_failed_tests += TestMatrixRowAcess<1, 1>();
     number_of_failed_tests += TestMatrixRowAcess<1, 2>();
     number_of_failed_tests += TestMatrixRowAcess<2, 1>();
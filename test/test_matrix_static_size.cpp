@@ -0,0 +1,107 @@
+#include <type_traits>
+
+#include "amatrix.h"
+#include "checks.h"
+
+using matrix_2x3 = AMatrix::Matrix<double, 2, 3>;
+using matrix_3x2 = AMatrix::Matrix<double, 3, 2>;
+using dynamic_matrix =
+    AMatrix::Matrix<double, AMatrix::dynamic, AMatrix::dynamic>;
+
+// The static sizes are known at compile time
+static_assert(matrix_2x3::static_size1 == 2, "");
+static_assert(matrix_2x3::static_size2 == 3, "");
+static_assert(dynamic_matrix::static_size1 == AMatrix::dynamic, "");
+static_assert(AMatrix::TransposeMatrix<matrix_2x3>::static_size1 == 3, "");
+static_assert(AMatrix::MatrixRow<matrix_2x3>::static_size2 == 3, "");
+static_assert(AMatrix::MatrixColumn<matrix_2x3>::static_size1 == 2, "");
+static_assert(
+    AMatrix::MatrixSumExpression<dynamic_matrix, matrix_2x3>::static_size1 ==
+        2,
+    "");
+static_assert(
+    AMatrix::MatrixProductExpression<matrix_2x3, matrix_3x2>::static_size2 ==
+        2,
+    "");
+static_assert(AMatrix::MatrixProductExpression<matrix_2x3,
+                  dynamic_matrix>::static_size2 == AMatrix::dynamic,
+    "");
+static_assert(!AMatrix::HaveCompatibleStaticSizes<matrix_2x3, matrix_3x2>(),
+    "");
+static_assert(
+    AMatrix::HaveCompatibleStaticSizes<matrix_2x3, dynamic_matrix>(), "");
+
+// The results of fixed size expressions are fixed size matrices
+static_assert(
+    std::is_same<AMatrix::ResultMatrix<AMatrix::MatrixProductExpression<
+                     matrix_3x2, matrix_2x3>>,
+        AMatrix::Matrix<double, 3, 3>>::value,
+    "");
+static_assert(
+    std::is_same<AMatrix::ResultMatrix<AMatrix::MatrixProductExpression<
+                     dynamic_matrix, matrix_3x2>>,
+        AMatrix::Matrix<double, AMatrix::dynamic, 2>>::value,
+    "");
+
+std::size_t TestFixedSizeEvaluate() {
+    matrix_2x3 a_matrix{1., 2., 3., 4., 5., 6.};
+    matrix_3x2 b_matrix{1., 0., 0., 1., 1., 1.};
+
+    auto c_matrix = AMatrix::Evaluate(a_matrix * b_matrix);
+    AMATRIX_CHECK((std::is_same<decltype(c_matrix),
+        AMatrix::Matrix<double, 2, 2>>::value));
+    AMATRIX_CHECK_EQUAL(c_matrix(0, 0), 4.00);
+    AMATRIX_CHECK_EQUAL(c_matrix(0, 1), 5.00);
+    AMATRIX_CHECK_EQUAL(c_matrix(1, 0), 10.00);
+    AMATRIX_CHECK_EQUAL(c_matrix(1, 1), 11.00);
+
+    auto d_matrix = AMatrix::Evaluate(a_matrix + 2.00 * a_matrix);
+    AMATRIX_CHECK((std::is_same<decltype(d_matrix), matrix_2x3>::value));
+    for (std::size_t i = 0; i < 6; i++)
+        AMATRIX_CHECK_EQUAL(d_matrix[i], 3.00 * a_matrix[i]);
+
+    return 0;  // not failed
+}
+
+std::size_t TestMixedSizeEvaluate() {
+    dynamic_matrix a_matrix(2, 3);
+    for (std::size_t i = 0; i < 6; i++)
+        a_matrix[i] = i + 1.00;
+    matrix_2x3 b_matrix{1., 1., 1., 1., 1., 1.};
+
+    // The fixed operand fixes the sizes of the sum
+    auto sum = AMatrix::Evaluate(a_matrix + b_matrix);
+    AMATRIX_CHECK((std::is_same<decltype(sum), matrix_2x3>::value));
+    for (std::size_t i = 0; i < 6; i++)
+        AMATRIX_CHECK_EQUAL(sum[i], i + 2.00);
+
+    auto product = AMatrix::Evaluate(a_matrix.transpose() * b_matrix);
+    AMATRIX_CHECK_EQUAL(product.size1(), 3);
+    AMATRIX_CHECK_EQUAL(product.size2(), 3);
+    AMATRIX_CHECK_EQUAL(product(2, 1), 9.00);
+
+    return 0;  // not failed
+}
+
+std::size_t TestOuterProductSize() {
+    AMatrix::Matrix<double, 3, 1> a_vector{1., 2., 3.};
+    AMatrix::Matrix<double, 2, 1> b_vector{4., 5.};
+    auto outer = AMatrix::OuterProduct(a_vector, b_vector);
+    AMATRIX_CHECK_EQUAL(outer.size1(), 3);
+    AMATRIX_CHECK_EQUAL(outer.size2(), 2);
+    AMATRIX_CHECK_EQUAL(outer.size(), 6);
+    AMATRIX_CHECK_EQUAL(AMatrix::Evaluate(outer)(2, 1), 15.00);
+
+    return 0;  // not failed
+}
+
+int main() {
+    std::size_t number_of_failed_tests = 0;
+    number_of_failed_tests += TestFixedSizeEvaluate();
+    number_of_failed_tests += TestMixedSizeEvaluate();
+    number_of_failed_tests += TestOuterProductSize();
+
+    std::cout << number_of_failed_tests << " tests failed" << std::endl;
+
+    return number_of_failed_tests;
+}
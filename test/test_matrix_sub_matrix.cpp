@@ -1,3 +1,5 @@
+#include <vector>
+
 #include "amatrix.h"
 #include "checks.h"
 
@@ -96,9 +98,123 @@ std::size_t TestSubMatrixExpressionAssign() {
     return 0;  // not failed
 }
 
+using dynamic_matrix =
+    AMatrix::Matrix<double, AMatrix::dynamic, AMatrix::dynamic>;
+using block_type = AMatrix::SubMatrix<dynamic_matrix>;
+
+dynamic_matrix MakeMatrix(std::size_t Size1, std::size_t Size2) {
+    dynamic_matrix result(Size1, Size2);
+    for (std::size_t i = 0; i < Size1; i++)
+        for (std::size_t j = 0; j < Size2; j++)
+            result(i, j) = 1.00 / (i + 2 * j + 1) + ((i == j) ? 4.00 : 0.00);
+    return result;
+}
+
+/// The blocks of a matrix are operands of the block kernels
+std::size_t TestBlockKernels(std::size_t Size) {
+    static_assert(AMatrix::IsBlock<block_type>::value, "");
+    dynamic_matrix a_matrix = MakeMatrix(2 * Size, 2 * Size);
+    dynamic_matrix original(a_matrix);
+    block_type a_11(a_matrix, 0, 0, Size, Size);
+    block_type a_12(a_matrix, 0, Size, Size, Size);
+    block_type a_21(a_matrix, Size, 0, Size, Size);
+    block_type a_22(a_matrix, Size, Size, Size, Size);
+    AMATRIX_CHECK(a_22.data() == &a_matrix(Size, Size));
+    AMATRIX_CHECK_EQUAL(a_22.leading_size(), 2 * Size);
+
+    // Products of blocks
+    dynamic_matrix product(a_12 * a_21);
+    dynamic_matrix expected(Size, Size);
+    for (std::size_t i = 0; i < Size; i++)
+        for (std::size_t j = 0; j < Size; j++) {
+            double sum = 0.00;
+            for (std::size_t k = 0; k < Size; k++)
+                sum += original(i, Size + k) * original(Size + k, j);
+            expected(i, j) = sum;
+            AMATRIX_CHECK_NEAR(product(i, j), sum, 1e-12 * Size);
+        }
+
+    // The Schur complement A_22 - A_21 * A_12 written into the block
+    a_22 -= a_21 * a_12;
+    for (std::size_t i = 0; i < Size; i++)
+        for (std::size_t j = 0; j < Size; j++) {
+            double sum = 0.00;
+            for (std::size_t k = 0; k < Size; k++)
+                sum += original(Size + i, k) * original(k, Size + j);
+            AMATRIX_CHECK_NEAR(a_matrix(Size + i, Size + j),
+                original(Size + i, Size + j) - sum, 1e-12 * Size);
+        }
+
+    // A product into a block, which reads the other blocks
+    a_11 = a_12 * a_21;
+    for (std::size_t i = 0; i < Size; i++)
+        for (std::size_t j = 0; j < Size; j++)
+            AMATRIX_CHECK_NEAR(a_matrix(i, j), expected(i, j), 1e-12 * Size);
+
+    // Elementwise assignments a packet of a row at a time
+    const double factor = 2.00;
+    dynamic_matrix b_matrix = MakeMatrix(Size, Size);
+    a_12 = factor * b_matrix;
+    a_12 += b_matrix;
+    a_21 = a_12;
+    a_21 -= b_matrix;
+    for (std::size_t i = 0; i < Size; i++)
+        for (std::size_t j = 0; j < Size; j++) {
+            AMATRIX_CHECK_NEAR(
+                a_matrix(i, Size + j), 3.00 * b_matrix(i, j), 1e-12);
+            AMATRIX_CHECK_NEAR(
+                a_matrix(Size + i, j), 2.00 * b_matrix(i, j), 1e-12);
+        }
+
+    // A block which overlaps the assigned one is read first
+    block_type a_shifted(a_matrix, 0, 1, Size, Size);
+    dynamic_matrix shifted(a_shifted);
+    a_11 = a_shifted;
+    for (std::size_t i = 0; i < Size; i++)
+        for (std::size_t j = 0; j < Size; j++)
+            AMATRIX_CHECK_EQUAL(a_matrix(i, j), shifted(i, j));
+
+    return 0;  // not failed
+}
+
+/// Panel LU of a block in place
+std::size_t TestBlockLU(std::size_t Size) {
+    dynamic_matrix a_matrix = MakeMatrix(Size + 3, Size + 5);
+    dynamic_matrix original(a_matrix);
+    block_type a_block(a_matrix, 2, 3, Size, Size);
+    AMatrix::Matrix<double, AMatrix::dynamic, 1> x_vector(Size, 1);
+    for (std::size_t i = 0; i < Size; i++)
+        x_vector[i] = (i % 5) - 2.00;
+    AMatrix::Matrix<double, AMatrix::dynamic, 1> b_vector(Size, 1);
+    for (std::size_t i = 0; i < Size; i++) {
+        b_vector[i] = 0.00;
+        for (std::size_t j = 0; j < Size; j++)
+            b_vector[i] += original(2 + i, 3 + j) * x_vector[j];
+    }
+
+    AMatrix::LUFactorization<block_type, std::vector<std::size_t>>
+        lu_factorization(a_block);
+    auto solution = lu_factorization.solve(b_vector);
+    for (std::size_t i = 0; i < Size; i++)
+        AMATRIX_CHECK_NEAR(solution[i], x_vector[i], 1e-10);
+    // The elements around the block are kept
+    AMATRIX_CHECK_EQUAL(a_matrix(1, 3), original(1, 3));
+    AMATRIX_CHECK_EQUAL(a_matrix(2, 2), original(2, 2));
+    AMATRIX_CHECK_EQUAL(
+        a_matrix(2 + Size, 3 + Size), original(2 + Size, 3 + Size));
+
+    return 0;  // not failed
+}
+
 int main() {
     std::size_t number_of_failed_tests = 0;
 
+    number_of_failed_tests += TestBlockKernels(3);
+    number_of_failed_tests += TestBlockKernels(37);
+    number_of_failed_tests += TestBlockKernels(130);
+    number_of_failed_tests += TestBlockLU(4);
+    number_of_failed_tests += TestBlockLU(90);
+
     number_of_failed_tests += TestSubMatrixAcess<1, 1>();
 
     number_of_failed_tests += TestSubMatrixAcess<1, 2>();
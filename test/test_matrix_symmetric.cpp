@@ -0,0 +1,88 @@
+#include "amatrix.h"
+#include "checks.h"
+
+template <std::size_t TSize, std::size_t TMode>
+std::size_t TestSymmetricView() {
+    AMatrix::Matrix<double, TSize, TSize> a_matrix;
+    for (std::size_t i = 0; i < TSize; i++)
+        for (std::size_t j = 0; j < TSize; j++)
+            a_matrix(i, j) = i * 10.00 + j;
+
+    auto view = a_matrix.template symmetric_view<TMode>();
+    for (std::size_t i = 0; i < TSize; i++)
+        for (std::size_t j = 0; j < TSize; j++) {
+            bool is_stored = (TMode & AMatrix::upper) ? (i <= j) : (i >= j);
+            double expected = is_stored ? a_matrix(i, j) : a_matrix(j, i);
+            AMATRIX_CHECK_EQUAL(view(i, j), expected);
+            AMATRIX_CHECK_EQUAL(view(i, j), view(j, i));
+        }
+
+    return 0;  // not failed
+}
+
+template <std::size_t TSize, std::size_t TMode>
+std::size_t TestSymmetricProduct() {
+    AMatrix::Matrix<double, TSize, TSize> a_matrix;
+    AMatrix::Matrix<double, TSize, 2> b_matrix;
+    for (std::size_t i = 0; i < TSize; i++)
+        for (std::size_t j = 0; j < TSize; j++)
+            a_matrix(i, j) = 1.00 / (i + j + 1);
+    for (std::size_t i = 0; i < TSize; i++)
+        for (std::size_t j = 0; j < 2; j++)
+            b_matrix(i, j) = i - 2.00 * j;
+
+    AMatrix::Matrix<double, TSize, 2> c_matrix;
+    AMatrix::Matrix<double, TSize, 2> reference;
+    c_matrix = a_matrix.template symmetric_view<TMode>() * b_matrix;
+    reference = a_matrix * b_matrix;
+
+    for (std::size_t i = 0; i < TSize; i++)
+        for (std::size_t j = 0; j < 2; j++)
+            AMATRIX_CHECK_NEAR(c_matrix(i, j), reference(i, j), 1e-14);
+
+    AMatrix::SymmetricMatrix<double, TSize, TMode> packed(a_matrix);
+    AMATRIX_CHECK_EQUAL(packed.packed_size(), TSize * (TSize + 1) / 2);
+    c_matrix = packed * b_matrix;
+    for (std::size_t i = 0; i < TSize; i++)
+        for (std::size_t j = 0; j < 2; j++)
+            AMATRIX_CHECK_NEAR(c_matrix(i, j), reference(i, j), 1e-14);
+
+    return 0;  // not failed
+}
+
+std::size_t TestSymmetricMatrixAccess() {
+    AMatrix::SymmetricMatrix<double, AMatrix::dynamic, AMatrix::upper> packed(
+        4);
+    for (std::size_t i = 0; i < 4; i++)
+        for (std::size_t j = 0; j < 4; j++)
+            packed.at(i, j) = i + j;
+
+    AMatrix::Matrix<double, AMatrix::dynamic, AMatrix::dynamic> dense(packed);
+    for (std::size_t i = 0; i < 4; i++)
+        for (std::size_t j = 0; j < 4; j++)
+            AMATRIX_CHECK_EQUAL(dense(i, j), i + j);
+
+    packed.at(3, 1) = 7.00;
+    AMATRIX_CHECK_EQUAL(packed(1, 3), 7.00);
+
+    return 0;  // not failed
+}
+
+int main() {
+    std::size_t number_of_failed_tests = 0;
+    number_of_failed_tests += TestSymmetricView<1, AMatrix::upper>();
+    number_of_failed_tests += TestSymmetricView<3, AMatrix::upper>();
+    number_of_failed_tests += TestSymmetricView<4, AMatrix::lower>();
+
+    number_of_failed_tests += TestSymmetricProduct<1, AMatrix::upper>();
+    number_of_failed_tests += TestSymmetricProduct<3, AMatrix::upper>();
+    number_of_failed_tests += TestSymmetricProduct<3, AMatrix::lower>();
+    number_of_failed_tests += TestSymmetricProduct<6, AMatrix::upper>();
+    number_of_failed_tests += TestSymmetricProduct<6, AMatrix::lower>();
+
+    number_of_failed_tests += TestSymmetricMatrixAccess();
+
+    std::cout << number_of_failed_tests << " tests failed" << std::endl;
+
+    return number_of_failed_tests;
+}
@@ -0,0 +1,142 @@
+#include "amatrix.h"
+#include "checks.h"
+
+template <std::size_t TSize>
+void InitializeTriangular(AMatrix::Matrix<double, TSize, TSize>& rMatrix) {
+    for (std::size_t i = 0; i < TSize; i++)
+        for (std::size_t j = 0; j < TSize; j++)
+            rMatrix(i, j) = (i == j) ? 2.00 + i : 0.1 * (i + 1) - 0.3 * j;
+}
+
+template <std::size_t TSize, std::size_t TMode>
+std::size_t TestTriangularView() {
+    AMatrix::Matrix<double, TSize, TSize> a_matrix;
+    InitializeTriangular(a_matrix);
+
+    auto view = a_matrix.template triangular_view<TMode>();
+    for (std::size_t i = 0; i < TSize; i++)
+        for (std::size_t j = 0; j < TSize; j++) {
+            double expected = a_matrix(i, j);
+            if ((TMode & AMatrix::upper) ? (i > j) : (i < j))
+                expected = 0.00;
+            if (i == j && (TMode & AMatrix::unit_diagonal))
+                expected = 1.00;
+            AMATRIX_CHECK_EQUAL(view(i, j), expected);
+        }
+
+    return 0;  // not failed
+}
+
+template <std::size_t TSize, std::size_t TMode>
+std::size_t TestTriangularProduct() {
+    AMatrix::Matrix<double, TSize, TSize> a_matrix;
+    AMatrix::Matrix<double, TSize, 2> b_matrix;
+    InitializeTriangular(a_matrix);
+    for (std::size_t i = 0; i < TSize; i++)
+        for (std::size_t j = 0; j < 2; j++)
+            b_matrix(i, j) = i + 2.00 * j + 1.00;
+
+    auto view = a_matrix.template triangular_view<TMode>();
+    AMatrix::Matrix<double, TSize, TSize> dense(view);
+    AMatrix::Matrix<double, TSize, 2> c_matrix;
+    AMatrix::Matrix<double, TSize, 2> reference;
+    c_matrix = view * b_matrix;
+    reference = dense * b_matrix;
+
+    for (std::size_t i = 0; i < TSize; i++)
+        for (std::size_t j = 0; j < 2; j++)
+            AMATRIX_CHECK_NEAR(c_matrix(i, j), reference(i, j), 1e-14);
+
+    // The packed version should give the same result
+    AMatrix::TriangularMatrix<double, TSize, TMode> packed(a_matrix);
+    c_matrix = packed * b_matrix;
+    for (std::size_t i = 0; i < TSize; i++)
+        for (std::size_t j = 0; j < 2; j++)
+            AMATRIX_CHECK_NEAR(c_matrix(i, j), reference(i, j), 1e-14);
+
+    for (std::size_t i = 0; i < TSize; i++)
+        for (std::size_t j = 0; j < TSize; j++)
+            AMATRIX_CHECK_EQUAL(packed(i, j), view(i, j));
+
+    return 0;  // not failed
+}
+
+template <std::size_t TSize, std::size_t TMode>
+std::size_t TestTriangularSolve() {
+    AMatrix::Matrix<double, TSize, TSize> a_matrix;
+    AMatrix::Matrix<double, TSize, 3> x_matrix;
+    InitializeTriangular(a_matrix);
+    for (std::size_t i = 0; i < TSize; i++)
+        for (std::size_t j = 0; j < 3; j++)
+            x_matrix(i, j) = i - 1.50 * j;
+
+    auto view = a_matrix.template triangular_view<TMode>();
+    AMatrix::Matrix<double, TSize, 3> b_matrix(view * x_matrix);
+
+    auto x = view.solve(b_matrix);
+    for (std::size_t i = 0; i < TSize; i++)
+        for (std::size_t j = 0; j < 3; j++)
+            AMATRIX_CHECK_NEAR(x(i, j), x_matrix(i, j), 1e-13);
+
+    AMatrix::TriangularMatrix<double, TSize, TMode> packed(a_matrix);
+    AMatrix::Matrix<double, TSize, 1> x_vector;
+    for (std::size_t i = 0; i < TSize; i++)
+        x_vector[i] = i + 1.00;
+    AMatrix::Matrix<double, TSize, 1> b_vector(packed * x_vector);
+    packed.solve_in_place(b_vector);
+    for (std::size_t i = 0; i < TSize; i++)
+        AMATRIX_CHECK_NEAR(b_vector[i], x_vector[i], 1e-13);
+
+    return 0;  // not failed
+}
+
+std::size_t TestDynamicTriangularMatrix() {
+    const std::size_t size = 5;
+    AMatrix::Matrix<double, AMatrix::dynamic, AMatrix::dynamic> a_matrix(
+        size, size);
+    for (std::size_t i = 0; i < size; i++)
+        for (std::size_t j = 0; j < size; j++)
+            a_matrix(i, j) = (i == j) ? 3.00 : 0.2 * i + 0.1 * j;
+
+    AMatrix::TriangularMatrix<double, AMatrix::dynamic, AMatrix::lower> packed(
+        a_matrix);
+    AMATRIX_CHECK_EQUAL(packed.packed_size(), 15);
+
+    AMatrix::Matrix<double, AMatrix::dynamic, 1> x_vector(size);
+    for (std::size_t i = 0; i < size; i++)
+        x_vector[i] = 1.00 - i;
+
+    AMatrix::Matrix<double, AMatrix::dynamic, 1> b_vector(packed * x_vector);
+    auto x = packed.solve(b_vector);
+    for (std::size_t i = 0; i < size; i++)
+        AMATRIX_CHECK_NEAR(x[i], x_vector[i], 1e-13);
+
+    return 0;  // not failed
+}
+
+int main() {
+    std::size_t number_of_failed_tests = 0;
+    number_of_failed_tests += TestTriangularView<1, AMatrix::upper>();
+    number_of_failed_tests += TestTriangularView<3, AMatrix::upper>();
+    number_of_failed_tests += TestTriangularView<3, AMatrix::lower>();
+    number_of_failed_tests += TestTriangularView<4, AMatrix::unit_upper>();
+    number_of_failed_tests += TestTriangularView<4, AMatrix::unit_lower>();
+
+    number_of_failed_tests += TestTriangularProduct<1, AMatrix::upper>();
+    number_of_failed_tests += TestTriangularProduct<3, AMatrix::upper>();
+    number_of_failed_tests += TestTriangularProduct<3, AMatrix::lower>();
+    number_of_failed_tests += TestTriangularProduct<6, AMatrix::unit_upper>();
+    number_of_failed_tests += TestTriangularProduct<6, AMatrix::unit_lower>();
+
+    number_of_failed_tests += TestTriangularSolve<1, AMatrix::upper>();
+    number_of_failed_tests += TestTriangularSolve<3, AMatrix::upper>();
+    number_of_failed_tests += TestTriangularSolve<3, AMatrix::lower>();
+    number_of_failed_tests += TestTriangularSolve<6, AMatrix::unit_upper>();
+    number_of_failed_tests += TestTriangularSolve<6, AMatrix::unit_lower>();
+
+    number_of_failed_tests += TestDynamicTriangularMatrix();
+
+    std::cout << number_of_failed_tests << " tests failed" << std::endl;
+
+    return number_of_failed_tests;
+}
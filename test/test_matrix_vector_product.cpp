@@ -0,0 +1,136 @@
+#include <complex>
+
+#include "amatrix.h"
+#include "checks.h"
+
+template <typename TMatrixType>
+TMatrixType MakeMatrix(std::size_t Size1, std::size_t Size2) {
+    using data_type = typename TMatrixType::data_type;
+    TMatrixType result(Size1, Size2);
+    for (std::size_t i = 0; i < Size1; i++)
+        for (std::size_t j = 0; j < Size2; j++)
+            result(i, j) = data_type(1.00 / (i + 2 * j + 1));
+    return result;
+}
+
+template <typename TVectorType>
+TVectorType MakeVector(std::size_t Size) {
+    using data_type = typename TVectorType::data_type;
+    TVectorType result(Size, 1);
+    for (std::size_t i = 0; i < Size; i++)
+        result[i] = data_type((i % 7) - 3.00);
+    return result;
+}
+
+template <typename TDataType, std::size_t TSize1, std::size_t TSize2>
+std::size_t TestMatrixVectorProduct(
+    std::size_t Size1, std::size_t Size2, double Tolerance) {
+    using matrix_type = AMatrix::Matrix<TDataType, TSize1, TSize2>;
+    using x_vector_type = AMatrix::Matrix<TDataType, TSize2, 1>;
+    using y_vector_type = AMatrix::Matrix<TDataType, TSize1, 1>;
+    matrix_type a_matrix = MakeMatrix<matrix_type>(Size1, Size2);
+    x_vector_type x_vector = MakeVector<x_vector_type>(Size2);
+    y_vector_type y_vector = MakeVector<y_vector_type>(Size1);
+
+    y_vector_type a_x(a_matrix * x_vector);
+    AMATRIX_CHECK_EQUAL(a_x.size(), Size1);
+    for (std::size_t i = 0; i < Size1; i++) {
+        TDataType expected = TDataType();
+        for (std::size_t j = 0; j < Size2; j++)
+            expected += a_matrix(i, j) * x_vector[j];
+        AMATRIX_CHECK_NEAR(std::abs(a_x[i] - expected), 0.00,
+            Tolerance * (1.00 + std::abs(expected)));
+    }
+
+    x_vector_type a_transpose_y(a_matrix.transpose() * y_vector);
+    AMATRIX_CHECK_EQUAL(a_transpose_y.size(), Size2);
+    for (std::size_t j = 0; j < Size2; j++) {
+        TDataType expected = TDataType();
+        for (std::size_t i = 0; i < Size1; i++)
+            expected += a_matrix(i, j) * y_vector[i];
+        AMATRIX_CHECK_NEAR(std::abs(a_transpose_y[j] - expected), 0.00,
+            Tolerance * (1.00 + std::abs(expected)));
+    }
+
+    return 0;  // not failed
+}
+
+template <typename TDataType>
+std::size_t TestAllSizes(double Tolerance) {
+    constexpr std::size_t dynamic = AMatrix::dynamic;
+    std::size_t number_of_failed_tests = 0;
+    // Unrolled fixed sizes
+    number_of_failed_tests +=
+        TestMatrixVectorProduct<TDataType, 3, 3>(3, 3, Tolerance);
+    number_of_failed_tests +=
+        TestMatrixVectorProduct<TDataType, 2, 5>(2, 5, Tolerance);
+    // Fixed sizes with the dispatched kernels
+    number_of_failed_tests +=
+        TestMatrixVectorProduct<TDataType, 17, 30>(17, 30, Tolerance);
+    // Dynamic sizes, inline, dispatched and split between threads
+    number_of_failed_tests +=
+        TestMatrixVectorProduct<TDataType, dynamic, dynamic>(5, 7, Tolerance);
+    number_of_failed_tests += TestMatrixVectorProduct<TDataType, dynamic,
+        dynamic>(63, 45, Tolerance);
+    number_of_failed_tests += TestMatrixVectorProduct<TDataType, dynamic,
+        dynamic>(700, 450, Tolerance);
+    number_of_failed_tests += TestMatrixVectorProduct<TDataType, dynamic,
+        dynamic>(3, 60000, Tolerance);
+    number_of_failed_tests += TestMatrixVectorProduct<TDataType, dynamic,
+        dynamic>(60000, 3, Tolerance);
+    return number_of_failed_tests;
+}
+
+std::size_t TestOtherOperands() {
+    using matrix_type = AMatrix::Matrix<double, AMatrix::dynamic,
+        AMatrix::dynamic>;
+    using vector_type = AMatrix::Matrix<double, AMatrix::dynamic, 1>;
+    matrix_type a_matrix = MakeMatrix<matrix_type>(40, 30);
+    vector_type x_vector = MakeVector<vector_type>(40);
+
+    // The transpose of an expression is evaluated in general
+    vector_type expected(a_matrix.transpose() * x_vector);
+    const double factor = 2.00;
+    auto scaled = factor * a_matrix;
+    vector_type result(
+        AMatrix::TransposeMatrix<decltype(scaled)>(scaled) * x_vector);
+    for (std::size_t i = 0; i < 30; i++)
+        AMATRIX_CHECK_NEAR(result[i], 2.00 * expected[i], 1e-12);
+
+    // A^T * B with more than one column is not a matrix vector product
+    matrix_type b_matrix = MakeMatrix<matrix_type>(40, 2);
+    matrix_type c_matrix(a_matrix.transpose() * b_matrix);
+    for (std::size_t i = 0; i < 30; i++) {
+        double expected_i1 = 0.00;
+        for (std::size_t k = 0; k < 40; k++)
+            expected_i1 += a_matrix(k, i) * b_matrix(k, 1);
+        AMATRIX_CHECK_NEAR(c_matrix(i, 1), expected_i1, 1e-12);
+    }
+
+    // The vector is the destination
+    vector_type y_vector = MakeVector<vector_type>(30);
+    matrix_type square_matrix = MakeMatrix<matrix_type>(30, 30);
+    expected = square_matrix * y_vector;
+    y_vector = square_matrix * y_vector;
+    for (std::size_t i = 0; i < 30; i++)
+        AMATRIX_CHECK_EQUAL(y_vector[i], expected[i]);
+
+    return 0;  // not failed
+}
+
+int main() {
+    std::size_t number_of_failed_tests = 0;
+    const std::size_t number_of_threads = AMatrix::GetNumberOfThreads();
+    for (std::size_t threads = 1; threads <= 4; threads += 3) {
+        AMatrix::SetNumberOfThreads(threads);
+        number_of_failed_tests += TestAllSizes<double>(1e-12);
+        number_of_failed_tests += TestAllSizes<float>(1e-4);
+        number_of_failed_tests += TestAllSizes<std::complex<double>>(1e-12);
+    }
+    AMatrix::SetNumberOfThreads(number_of_threads);
+    number_of_failed_tests += TestOtherOperands();
+
+    std::cout << number_of_failed_tests << " tests failed" << std::endl;
+
+    return number_of_failed_tests;
+}
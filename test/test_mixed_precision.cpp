@@ -0,0 +1,207 @@
+#include <cmath>
+
+#include "amatrix.h"
+#include "checks.h"
+
+using float_matrix =
+    AMatrix::Matrix<float, AMatrix::dynamic, AMatrix::dynamic>;
+using float_vector = AMatrix::Matrix<float, AMatrix::dynamic, 1>;
+using double_matrix =
+    AMatrix::Matrix<double, AMatrix::dynamic, AMatrix::dynamic>;
+using double_vector = AMatrix::Matrix<double, AMatrix::dynamic, 1>;
+using permutation_vector = AMatrix::Matrix<std::size_t, AMatrix::dynamic, 1>;
+
+template <typename TMatrixType>
+TMatrixType MakeMatrix(std::size_t Size1, std::size_t Size2) {
+    TMatrixType result(Size1, Size2);
+    for (std::size_t i = 0; i < Size1; i++)
+        for (std::size_t j = 0; j < Size2; j++)
+            result(i, j) = 1.00 / (i + 2 * j + 1) + ((i == j) ? Size1 : 0);
+    return result;
+}
+
+std::size_t TestFloatLU() {
+    AMatrix::Matrix<float, 3, 3> a_matrix{0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f,
+        7.f, 9.f};
+    AMatrix::Matrix<float, 3, 1> b_vector{3.f, -6.f, 0.f};
+
+    AMatrix::LUFactorization<AMatrix::Matrix<float, 3, 3>, permutation_vector>
+        lu_factorization(a_matrix);
+    const float determinant = lu_factorization.determinant();
+    AMATRIX_CHECK_NEAR(determinant, -3.f, 1e-5f);
+
+    auto x_vector = lu_factorization.solve(b_vector);
+    AMATRIX_CHECK_NEAR(x_vector[0], 9.f, 1e-4f);
+    AMATRIX_CHECK_NEAR(x_vector[1], -27.f, 1e-4f);
+    AMATRIX_CHECK_NEAR(x_vector[2], 15.f, 1e-4f);
+
+    return 0;  // not failed
+}
+
+std::size_t TestFloatKernels() {
+    float_matrix a_matrix = MakeMatrix<float_matrix>(41, 37);
+    float_matrix b_matrix = MakeMatrix<float_matrix>(37, 43);
+    float_matrix c_matrix(a_matrix * b_matrix);
+    for (std::size_t i = 0; i < 41; i++)
+        for (std::size_t j = 0; j < 43; j++) {
+            double expected = 0.00;
+            for (std::size_t k = 0; k < 37; k++)
+                expected += double(a_matrix(i, k)) * b_matrix(k, j);
+            AMATRIX_CHECK_NEAR(c_matrix(i, j), expected, 1e-5 * expected);
+        }
+
+    const std::size_t size = 1001;
+    float_vector x_vector(size);
+    float_vector y_vector(size);
+    double expected = 0.00;
+    for (std::size_t i = 0; i < size; i++) {
+        x_vector[i] = i + 1.f;
+        y_vector[i] = 1.f / (i + 1.f);
+        expected += double(x_vector[i]) * y_vector[i];
+    }
+    AMATRIX_CHECK_NEAR(AMatrix::Dot(x_vector, y_vector), expected, 1e-3);
+    AMATRIX_CHECK_NEAR(
+        AMatrix::AccumulatedDot(x_vector, y_vector), expected, 1e-12);
+
+    return 0;  // not failed
+}
+
+std::size_t TestBFloat16() {
+    using AMatrix::BFloat16;
+    AMATRIX_CHECK_EQUAL(float(BFloat16(1.f)), 1.f);
+    AMATRIX_CHECK_EQUAL(float(BFloat16(-2.5f)), -2.5f);
+    AMATRIX_CHECK_EQUAL(BFloat16(1.f).bits(), 0x3f80);
+
+    // 8 bits of precision: 1 + 2^-8 is a tie and rounds to the even 1, while
+    // 1 + 3 * 2^-8 rounds up to 1 + 2^-6
+    AMATRIX_CHECK_EQUAL(float(BFloat16(1.f + 1.f / 256)), 1.f);
+    AMATRIX_CHECK_EQUAL(float(BFloat16(1.f + 3.f / 256)), 1.f + 1.f / 64);
+    AMATRIX_CHECK_EQUAL(float(BFloat16(1.f + 1.f / 128 + 1.f / 256)),
+        1.f + 1.f / 64);
+
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    AMATRIX_CHECK(std::isnan(float(BFloat16(nan))));
+    AMATRIX_CHECK(std::isinf(
+        float(BFloat16(std::numeric_limits<float>::infinity()))));
+
+    BFloat16 value(2.f);
+    value *= 1.5f;
+    value += 1.f;
+    AMATRIX_CHECK_EQUAL(float(value), 4.f);
+
+    return 0;  // not failed
+}
+
+std::size_t TestAccumulatedReductions() {
+    const std::size_t size = 1 << 20;
+    float_vector a_vector(size);
+    AMatrix::Matrix<AMatrix::BFloat16, AMatrix::dynamic, 1> b_vector(size);
+    for (std::size_t i = 0; i < size; i++) {
+        a_vector[i] = 0.1f;
+        b_vector[i] = 0.5f;
+    }
+
+    // Summed in float the rounding errors grow with the number of elements
+    const double expected = size * double(0.1f);
+    AMATRIX_CHECK_NEAR(AMatrix::AccumulatedSum(a_vector), expected, 1e-6);
+    AMATRIX_CHECK_NEAR(
+        AMatrix::AccumulatedSquaredNorm(a_vector), expected * 0.1f, 1e-6);
+    AMATRIX_CHECK_NEAR(AMatrix::AccumulatedNorm(a_vector),
+        std::sqrt(expected * 0.1f), 1e-9);
+
+    AMATRIX_CHECK_EQUAL(AMatrix::AccumulatedSum(b_vector), 0.5 * size);
+    AMATRIX_CHECK_EQUAL(
+        AMatrix::AccumulatedDot(b_vector, b_vector), 0.25 * size);
+    AMATRIX_CHECK_NEAR(AMatrix::AccumulatedDot(a_vector, a_vector),
+        expected * 0.1f, 1e-6);
+
+    // Mixed operands and non contiguous expressions are converted elementwise
+    AMATRIX_CHECK_NEAR(AMatrix::AccumulatedDot(a_vector, b_vector),
+        0.5 * expected, 1e-6);
+    AMATRIX_CHECK_NEAR(AMatrix::AccumulatedSum(2.f * a_vector),
+        2 * expected, 1e-6);
+
+    return 0;  // not failed
+}
+
+std::size_t TestAccumulatedProduct() {
+    float_matrix a_matrix = MakeMatrix<float_matrix>(70, 37);
+    float_matrix b_matrix = MakeMatrix<float_matrix>(37, 43);
+    double_matrix c_matrix(70, 43);
+    AMatrix::AccumulatedProduct(c_matrix, a_matrix, b_matrix);
+    for (std::size_t i = 0; i < 70; i++)
+        for (std::size_t j = 0; j < 43; j++) {
+            double expected = 0.00;
+            for (std::size_t k = 0; k < 37; k++)
+                expected += double(a_matrix(i, k)) * b_matrix(k, j);
+            AMATRIX_CHECK_NEAR(c_matrix(i, j), expected, 1e-12 * expected);
+        }
+
+    // The result is rounded once into the narrow type
+    AMatrix::Matrix<AMatrix::BFloat16, AMatrix::dynamic, AMatrix::dynamic>
+        d_matrix(70, 43);
+    AMatrix::AccumulatedProduct(d_matrix, a_matrix, b_matrix);
+    for (std::size_t i = 0; i < 70; i++)
+        for (std::size_t j = 0; j < 43; j++)
+            AMATRIX_CHECK_EQUAL(float(d_matrix(i, j)),
+                float(AMatrix::BFloat16(c_matrix(i, j))));
+
+    return 0;  // not failed
+}
+
+std::size_t TestIterativeRefinement() {
+    const std::size_t size = 60;
+    double_matrix a_matrix = MakeMatrix<double_matrix>(size, size);
+    double_vector x_vector(size);
+    for (std::size_t i = 0; i < size; i++)
+        x_vector[i] = 1.00 / (i + 1.00);
+    double_vector b_vector(a_matrix * x_vector);
+
+    AMatrix::IterativeRefinementLU<double_matrix> solver(a_matrix);
+    double_vector solution = solver.solve(b_vector);
+    AMATRIX_CHECK(solver.converged());
+    AMATRIX_CHECK(solver.number_of_iterations() > 0);
+    AMATRIX_CHECK(solver.number_of_iterations() < 10);
+
+    // The float factorization alone is only accurate to about 1e-6
+    double_matrix lu_matrix(a_matrix);
+    AMatrix::LUFactorization<double_matrix, permutation_vector>
+        lu_factorization(lu_matrix);
+    double_vector double_solution = lu_factorization.solve(b_vector);
+    for (std::size_t i = 0; i < size; i++)
+        AMATRIX_CHECK_NEAR(solution[i], double_solution[i], 1e-13);
+
+    // Without refinement steps the float accuracy is reported
+    AMatrix::IterativeRefinementLU<double_matrix> float_solver(a_matrix, 0);
+    float_solver.solve(b_vector);
+    AMATRIX_CHECK(!float_solver.converged());
+
+    return 0;  // not failed
+}
+
+int main() {
+    std::size_t number_of_failed_tests = 0;
+    const AMatrix::InstructionSet detected = AMatrix::DetectInstructionSet();
+    const AMatrix::InstructionSet instruction_sets[] = {
+        AMatrix::InstructionSet::generic_instructions,
+        AMatrix::InstructionSet::avx2_instructions,
+        AMatrix::InstructionSet::avx512_instructions};
+
+    for (auto instruction_set : instruction_sets) {
+        if (instruction_set > detected)
+            continue;
+        AMatrix::SetInstructionSet(instruction_set);
+        number_of_failed_tests += TestFloatKernels();
+        number_of_failed_tests += TestAccumulatedReductions();
+        number_of_failed_tests += TestAccumulatedProduct();
+    }
+    AMatrix::SetInstructionSet(detected);
+
+    number_of_failed_tests += TestFloatLU();
+    number_of_failed_tests += TestBFloat16();
+    number_of_failed_tests += TestIterativeRefinement();
+
+    std::cout << number_of_failed_tests << " tests failed" << std::endl;
+
+    return number_of_failed_tests;
+}
@@ -0,0 +1,121 @@
+#include "amatrix.h"
+#include "checks.h"
+
+template <typename TDataType, std::size_t TWidth>
+std::size_t TestPacketOperations() {
+    using packet_type = AMatrix::Packet<TDataType, TWidth>;
+    TDataType x[TWidth];
+    TDataType y[TWidth];
+    TDataType result[TWidth + 1];
+    for (std::size_t i = 0; i < TWidth; i++) {
+        x[i] = i + 1;
+        y[i] = 2 * i + 3;
+    }
+
+    const packet_type a = packet_type::load_unaligned(x);
+    const packet_type b = packet_type::load_unaligned(y);
+    const packet_type two = packet_type::broadcast(2);
+
+    (a + b).store_unaligned(result);
+    for (std::size_t i = 0; i < TWidth; i++)
+        AMATRIX_CHECK_EQUAL(result[i], x[i] + y[i]);
+
+    (a - b).store_unaligned(result);
+    for (std::size_t i = 0; i < TWidth; i++)
+        AMATRIX_CHECK_EQUAL(result[i], x[i] - y[i]);
+
+    (-a).store_unaligned(result);
+    for (std::size_t i = 0; i < TWidth; i++)
+        AMATRIX_CHECK_EQUAL(result[i], -x[i]);
+
+    AMatrix::MultiplyAdd(a, two, b).store_unaligned(result);
+    for (std::size_t i = 0; i < TWidth; i++) {
+        AMATRIX_CHECK_EQUAL(result[i], 2 * x[i] + y[i]);
+        AMATRIX_CHECK_EQUAL(a[i], x[i]);
+    }
+
+    TDataType expected_sum = 0;
+    for (std::size_t i = 0; i < TWidth; i++)
+        expected_sum += x[i];
+    AMATRIX_CHECK_EQUAL(AMatrix::ReduceSum(a), expected_sum);
+
+    const unsigned int mask = 0x5;  // elements 0 and 2
+    AMatrix::Blend(mask, a, b).store_unaligned(result);
+    for (std::size_t i = 0; i < TWidth; i++)
+        AMATRIX_CHECK_EQUAL(result[i], (((mask >> i) & 1) ? y[i] : x[i]));
+
+    AMatrix::SwapPairs(a).store_unaligned(result);
+    for (std::size_t i = 0; i < TWidth; i++)
+        AMATRIX_CHECK_EQUAL(result[i], x[((i ^ 1) < TWidth) ? (i ^ 1) : i]);
+
+    // The partial accesses leave the remaining elements untouched
+    for (std::size_t size = 0; size < TWidth; size++) {
+        for (std::size_t i = 0; i <= TWidth; i++)
+            result[i] = -1;
+        packet_type::load_partial(x, size).store_partial(result, size);
+        for (std::size_t i = 0; i < size; i++)
+            AMATRIX_CHECK_EQUAL(result[i], x[i]);
+        for (std::size_t i = size; i <= TWidth; i++)
+            AMATRIX_CHECK_EQUAL(result[i], -1);
+        AMATRIX_CHECK_EQUAL(
+            packet_type::load_partial(x, size)[TWidth - 1], TDataType());
+    }
+
+    return 0;  // not failed
+}
+
+template <typename TExpressionType>
+std::size_t CheckExpressionPackets(TExpressionType const& TheExpression) {
+    constexpr std::size_t width = AMatrix::NativePacketWidth<double>::value;
+    for (std::size_t i = 0; i + width <= TheExpression.size(); i += width) {
+        auto packet = TheExpression.template packet<width>(i);
+        for (std::size_t k = 0; k < width; k++)
+            AMATRIX_CHECK_EQUAL(packet[k], TheExpression[i + k]);
+    }
+    return 0;  // not failed
+}
+
+std::size_t TestExpressionPackets() {
+    AMatrix::Matrix<double, 3, 5> a_matrix;
+    AMatrix::Matrix<double, 3, 5> b_matrix;
+    for (std::size_t i = 0; i < a_matrix.size(); i++) {
+        a_matrix[i] = i + 1.00;
+        b_matrix[i] = 0.50 * i;
+    }
+
+    // The expressions refer to their operands, so they are checked within
+    // the full expression
+    AMATRIX_CHECK_EQUAL(
+        CheckExpressionPackets(2.00 * a_matrix - b_matrix / 0.50), 0);
+    AMATRIX_CHECK_EQUAL(CheckExpressionPackets(-a_matrix + b_matrix), 0);
+
+    // 15 elements are evaluated as packets and a scalar tail
+    AMatrix::Matrix<double, 3, 5> c_matrix(a_matrix + b_matrix);
+    for (std::size_t i = 0; i < c_matrix.size(); i++)
+        AMATRIX_CHECK_EQUAL(c_matrix[i], 1.50 * i + 1.00);
+
+    AMatrix::Matrix<double, AMatrix::dynamic, AMatrix::dynamic> d_matrix(
+        2.00 * a_matrix - b_matrix / 0.50);
+    for (std::size_t i = 0; i < d_matrix.size(); i++)
+        AMATRIX_CHECK_EQUAL(d_matrix[i], i + 2.00);
+
+    return 0;  // not failed
+}
+
+int main() {
+    std::size_t number_of_failed_tests = 0;
+    number_of_failed_tests += TestPacketOperations<double, 1>();
+    number_of_failed_tests += TestPacketOperations<double, 2>();
+    number_of_failed_tests += TestPacketOperations<float, 4>();
+    number_of_failed_tests += TestPacketOperations<double, 3>();
+    number_of_failed_tests += TestPacketOperations<int, 4>();
+    number_of_failed_tests += TestPacketOperations<double,
+        AMatrix::NativePacketWidth<double>::value>();
+    number_of_failed_tests += TestPacketOperations<float,
+        AMatrix::NativePacketWidth<float>::value>();
+    number_of_failed_tests += TestExpressionPackets();
+
+    std::cout << number_of_failed_tests << " tests failed" << std::endl;
+
+    return number_of_failed_tests;
+}
@@ -0,0 +1,114 @@
+#include "amatrix.h"
+#include "checks.h"
+
+template <typename TMatrixType>
+void InitializeRectangular(TMatrixType& rMatrix) {
+    for (std::size_t i = 0; i < rMatrix.size1(); i++)
+        for (std::size_t j = 0; j < rMatrix.size2(); j++)
+            rMatrix(i, j) = 0.5 * i - 0.25 * j + 1.00 / (i + j + 1);
+}
+
+template <std::size_t TMode, typename TResultType, typename TMatrixType>
+std::size_t CheckRankUpdate(TResultType const& C, TMatrixType const& A,
+    bool IsTranspose, double Alpha, double Beta, double InitialValue) {
+    const std::size_t size = C.size1();
+    const std::size_t inner_size = IsTranspose ? A.size1() : A.size2();
+    for (std::size_t i = 0; i < size; i++)
+        for (std::size_t j = 0; j < size; j++) {
+            if ((TMode & AMatrix::upper) ? (i > j) : (i < j))
+                continue;
+            double expected = 0.00;
+            for (std::size_t k = 0; k < inner_size; k++)
+                expected += IsTranspose ? A(k, i) * A(k, j) : A(i, k) * A(j, k);
+            expected = Alpha * expected + Beta * InitialValue;
+            AMATRIX_CHECK_NEAR(C(i, j), expected, 1e-10 * std::abs(expected) + 1e-12);
+        }
+    return 0;
+}
+
+template <std::size_t TSize1, std::size_t TSize2, std::size_t TMode>
+std::size_t TestRankUpdate() {
+    AMatrix::Matrix<double, TSize1, TSize2> a_matrix;
+    InitializeRectangular(a_matrix);
+
+    AMatrix::Matrix<double, TSize1, TSize1> c_matrix;
+    for (auto& value : c_matrix)
+        value = 2.00;
+    AMatrix::SymmetricRankUpdate<TMode>(c_matrix, a_matrix, 1.5, 0.5);
+    if (CheckRankUpdate<TMode>(c_matrix, a_matrix, false, 1.5, 0.5, 2.00))
+        return 1;
+
+    AMatrix::Matrix<double, TSize2, TSize2> d_matrix;
+    AMatrix::TransposeSymmetricRankUpdate<TMode>(d_matrix, a_matrix);
+    if (CheckRankUpdate<TMode>(d_matrix, a_matrix, true, 1.00, 0.00, 0.00))
+        return 1;
+
+    AMatrix::SymmetricMatrix<double, TSize2, TMode> packed;
+    AMatrix::TransposeSymmetricRankUpdate<TMode>(packed, a_matrix, -1.00);
+    if (CheckRankUpdate<TMode>(packed, a_matrix, true, -1.00, 0.00, 0.00))
+        return 1;
+
+    return 0;  // not failed
+}
+
+template <std::size_t TSize1, std::size_t TSize2>
+std::size_t TestGramMatrix() {
+    AMatrix::Matrix<double, TSize1, TSize2> a_matrix;
+    InitializeRectangular(a_matrix);
+
+    auto gram = AMatrix::GramMatrix(a_matrix);
+    AMatrix::Matrix<double, TSize2, TSize2> reference(
+        a_matrix.transpose() * a_matrix);
+
+    for (std::size_t i = 0; i < TSize2; i++)
+        for (std::size_t j = 0; j < TSize2; j++)
+            AMATRIX_CHECK_NEAR(gram(i, j), reference(i, j), 1e-12);
+
+    return 0;  // not failed
+}
+
+std::size_t TestDynamicRankUpdate(std::size_t NumberOfThreads) {
+    AMatrix::SetNumberOfThreads(NumberOfThreads);
+
+    // large enough to be split between the threads
+    AMatrix::Matrix<double, AMatrix::dynamic, AMatrix::dynamic> a_matrix(
+        300, 120);
+    InitializeRectangular(a_matrix);
+
+    AMatrix::Matrix<double, AMatrix::dynamic, AMatrix::dynamic> c_matrix(
+        300, 300);
+    AMatrix::SymmetricRankUpdate<AMatrix::lower>(c_matrix, a_matrix);
+    if (CheckRankUpdate<AMatrix::lower>(
+            c_matrix, a_matrix, false, 1.00, 0.00, 0.00))
+        return 1;
+
+    AMatrix::Matrix<double, AMatrix::dynamic, AMatrix::dynamic> d_matrix(
+        120, 120);
+    AMatrix::TransposeSymmetricRankUpdate<AMatrix::upper>(d_matrix, a_matrix);
+    AMatrix::MirrorTriangle<AMatrix::upper>(d_matrix);
+    if (CheckRankUpdate<AMatrix::lower>(
+            d_matrix, a_matrix, true, 1.00, 0.00, 0.00))
+        return 1;
+
+    return 0;  // not failed
+}
+
+int main() {
+    std::size_t number_of_failed_tests = 0;
+    number_of_failed_tests += TestRankUpdate<1, 1, AMatrix::upper>();
+    number_of_failed_tests += TestRankUpdate<3, 3, AMatrix::upper>();
+    number_of_failed_tests += TestRankUpdate<3, 3, AMatrix::lower>();
+    number_of_failed_tests += TestRankUpdate<6, 3, AMatrix::upper>();
+    number_of_failed_tests += TestRankUpdate<3, 6, AMatrix::lower>();
+    number_of_failed_tests += TestRankUpdate<9, 7, AMatrix::lower>();
+
+    number_of_failed_tests += TestGramMatrix<3, 3>();
+    number_of_failed_tests += TestGramMatrix<8, 5>();
+
+    number_of_failed_tests += TestDynamicRankUpdate(1);
+    number_of_failed_tests += TestDynamicRankUpdate(4);
+
+    std::cout << number_of_failed_tests << " tests failed" << std::endl;
+
+    return number_of_failed_tests;
+}
@@ -0,0 +1,115 @@
+#include "amatrix.h"
+#include "checks.h"
+
+template <std::size_t TSize>
+std::size_t TestVectorSum() {
+    AMatrix::Vector<double, TSize> a_vector;
+    for (std::size_t i = 0; i < TSize; i++)
+        a_vector[i] = i + 1.00;
+
+    const double expected = TSize * (TSize + 1) / 2.00;
+    AMATRIX_CHECK_EQUAL(AMatrix::Sum(a_vector), expected);
+    AMATRIX_CHECK_EQUAL(
+        AMatrix::Sum<AMatrix::pairwise_summation>(a_vector), expected);
+    AMATRIX_CHECK_EQUAL(
+        AMatrix::Sum<AMatrix::kahan_summation>(a_vector), expected);
+
+    return 0;  // not failed
+}
+
+std::size_t TestCompensatedSum() {
+    AMatrix::Vector<double, 5> a_vector{1.00, 1e100, 1.00, -1e100, 1.00};
+    AMATRIX_CHECK_EQUAL(
+        AMatrix::Sum<AMatrix::kahan_summation>(a_vector), 3.00);
+
+    const std::size_t size = 1000000;
+    AMatrix::Matrix<double, AMatrix::dynamic, 1> b_vector(size);
+    for (std::size_t i = 0; i < size; i++)
+        b_vector[i] = 0.1;
+
+    // 0.1 is not exact, so the reference is the sum of the stored value
+    const long double exact = static_cast<long double>(0.1) * size;
+    const double kahan_error = std::abs(static_cast<double>(
+        AMatrix::Sum<AMatrix::kahan_summation>(b_vector) - exact));
+    const double pairwise_error = std::abs(static_cast<double>(
+        AMatrix::Sum<AMatrix::pairwise_summation>(b_vector) - exact));
+
+    AMATRIX_CHECK(kahan_error <= 1e-16 * size * 0.1);
+    AMATRIX_CHECK(pairwise_error <= 1e-14 * size * 0.1);
+
+    return 0;  // not failed
+}
+
+std::size_t TestMinMax() {
+    AMatrix::Vector<double, 7> a_vector{3.0, -1.0, 4.0, -10.0, 5.0, 9.0, 2.0};
+    AMATRIX_CHECK_EQUAL(AMatrix::Max(a_vector), 9.00);
+    AMATRIX_CHECK_EQUAL(AMatrix::Min(a_vector), -10.00);
+    AMATRIX_CHECK_EQUAL(AMatrix::NormInf(a_vector), 10.00);
+
+    // An unordered expression is read without being materialized
+    AMatrix::Matrix<double, 2, 3> a_matrix{1.0, 2.0, 3.0, 4.0, -5.0, 6.0};
+    AMATRIX_CHECK_EQUAL(AMatrix::Max(a_matrix.transpose()), 6.00);
+    AMATRIX_CHECK_EQUAL(AMatrix::Min(a_matrix.transpose()), -5.00);
+    AMATRIX_CHECK_EQUAL(AMatrix::Sum(a_matrix.transpose()), 11.00);
+
+    return 0;  // not failed
+}
+
+std::size_t TestExpressionReductions() {
+    AMatrix::Vector<double, 5> a_vector{1.0, 2.0, 3.0, 4.0, 5.0};
+    AMatrix::Vector<double, 5> b_vector{1.0, 1.0, 1.0, 1.0, 1.0};
+
+    AMATRIX_CHECK_EQUAL(AMatrix::Sum(a_vector + b_vector), 20.00);
+    AMATRIX_CHECK_EQUAL(AMatrix::Dot(a_vector - b_vector, b_vector), 10.00);
+    AMATRIX_CHECK_EQUAL(AMatrix::SquaredNorm(2.00 * b_vector), 20.00);
+    AMATRIX_CHECK_EQUAL(a_vector.dot(b_vector), 15.00);
+
+    AMatrix::Matrix<double, 2, 2> a_matrix{1.0, 2.0, 3.0, 4.0};
+    AMatrix::Matrix<double, 2, 2> b_matrix{1.0, 0.0, 0.0, 1.0};
+    // trace of A^T B through an unordered expression
+    AMATRIX_CHECK_EQUAL(AMatrix::Dot(a_matrix.transpose(), b_matrix), 5.00);
+
+    return 0;  // not failed
+}
+
+std::size_t TestScaledNorm() {
+    AMatrix::Vector<double, 4> large{3e200, 4e200, 0.0, 0.0};
+    AMATRIX_CHECK_NEAR(large.norm(), 5e200, 1e186);
+
+    AMatrix::Vector<double, 4> small{3e-200, -4e-200, 0.0, 0.0};
+    AMATRIX_CHECK_NEAR(small.norm(), 5e-200, 1e-214);
+
+    AMatrix::Vector<double, 2> subnormal{3e-320, 4e-320};
+    AMATRIX_CHECK_NEAR(subnormal.norm(), 5e-320, 1e-322);
+
+    AMatrix::Vector<double, 3> zero{0.0, 0.0, 0.0};
+    AMATRIX_CHECK_EQUAL(zero.norm(), 0.00);
+
+    AMatrix::Vector<double, 3> infinite{
+        1.0, std::numeric_limits<double>::infinity(), 1.0};
+    AMATRIX_CHECK(std::isinf(infinite.norm()));
+
+    AMatrix::Vector<double, 2> normal{3.0, 4.0};
+    AMATRIX_CHECK_EQUAL(normal.norm(), 5.00);
+    AMATRIX_CHECK_EQUAL(AMatrix::Norm<AMatrix::kahan_summation>(normal), 5.00);
+
+    return 0;  // not failed
+}
+
+int main() {
+    std::size_t number_of_failed_tests = 0;
+    number_of_failed_tests += TestVectorSum<1>();
+    number_of_failed_tests += TestVectorSum<3>();
+    number_of_failed_tests += TestVectorSum<4>();
+    number_of_failed_tests += TestVectorSum<9>();
+    number_of_failed_tests += TestVectorSum<300>();
+
+    number_of_failed_tests += TestCompensatedSum();
+    number_of_failed_tests += TestMinMax();
+    number_of_failed_tests += TestExpressionReductions();
+    number_of_failed_tests += TestScaledNorm();
+
+    std::cout << number_of_failed_tests << " tests failed" << std::endl;
+
+    return number_of_failed_tests;
+}
@@ -0,0 +1,50 @@
+#include "amatrix.h"
+#include "checks.h"
+
+template <std::size_t TSummation>
+std::size_t TestReproducibleDot() {
+    const std::size_t size = 1000003;
+    AMatrix::Matrix<double, AMatrix::dynamic, 1> a_vector(size);
+    AMatrix::Matrix<double, AMatrix::dynamic, 1> b_vector(size);
+    for (std::size_t i = 0; i < size; i++) {
+        a_vector[i] = std::sin(0.37 * i) * 1e3 / (i + 1);
+        b_vector[i] = std::cos(1.3 * i) + 1e-5 * i;
+    }
+
+    AMatrix::SetReproducibleReductions(true);
+    AMatrix::SetNumberOfThreads(1);
+    const double reference_dot = AMatrix::Dot<TSummation>(a_vector, b_vector);
+    const double reference_norm = AMatrix::Norm<TSummation>(a_vector);
+    const double reference_sum = AMatrix::Sum<TSummation>(b_vector);
+
+    for (std::size_t number_of_threads : {2, 3, 4, 7, 16}) {
+        AMatrix::SetNumberOfThreads(number_of_threads);
+        AMATRIX_CHECK_EQUAL(
+            AMatrix::Dot<TSummation>(a_vector, b_vector), reference_dot);
+        AMATRIX_CHECK_EQUAL(AMatrix::Norm<TSummation>(a_vector), reference_norm);
+        AMATRIX_CHECK_EQUAL(AMatrix::Sum<TSummation>(b_vector), reference_sum);
+    }
+
+    // The fast mode gives the same value up to the rounding errors
+    AMatrix::SetReproducibleReductions(false);
+    for (std::size_t number_of_threads : {1, 3, 4}) {
+        AMatrix::SetNumberOfThreads(number_of_threads);
+        AMATRIX_CHECK_NEAR(AMatrix::Dot<TSummation>(a_vector, b_vector),
+            reference_dot, 1e-10 * std::abs(reference_dot));
+    }
+
+    AMatrix::SetNumberOfThreads(1);
+    return 0;  // not failed
+}
+
+int main() {
+    std::size_t number_of_failed_tests = 0;
+    number_of_failed_tests += TestReproducibleDot<AMatrix::fast_summation>();
+    number_of_failed_tests +=
+        TestReproducibleDot<AMatrix::pairwise_summation>();
+    number_of_failed_tests += TestReproducibleDot<AMatrix::kahan_summation>();
+
+    std::cout << number_of_failed_tests << " tests failed" << std::endl;
+
+    return number_of_failed_tests;
+}
@@ -1,6 +1,13 @@
+#include <vector>
+
 #include "amatrix.h"
 #include "checks.h"
 
+// The sub vector of a const vector is read with packets
+static_assert(AMatrix::HasPacketAccess<AMatrix::SubVector<
+                  const AMatrix::Vector<double, AMatrix::dynamic>>>::value,
+    "");
+
 template <std::size_t TSize>
 std::size_t TestSubVectorAcess() {
     AMatrix::Vector<double, TSize> a_vector;
@@ -128,9 +135,150 @@ std::size_t TestSubVectorMinusEqual() {
     return 0;  // not failed
 }
 
+using dynamic_vector = AMatrix::Vector<double, AMatrix::dynamic>;
+
+/// The range of a dense vector is a contiguous operand of the kernels
+std::size_t TestContiguousSubVector(std::size_t Size) {
+    static_assert(
+        AMatrix::IsContiguous<AMatrix::SubVector<dynamic_vector>>::value, "");
+    dynamic_vector a_vector(2 * Size + 1);
+    for (std::size_t i = 0; i < a_vector.size(); i++)
+        a_vector[i] = (i % 11) - 5.00;
+    dynamic_vector b_vector(Size);
+    for (std::size_t i = 0; i < Size; i++)
+        b_vector[i] = (i % 7) - 3.00;
+
+    AMatrix::SubVector<dynamic_vector> sub_vector(a_vector, 1, Size);
+    double expected_dot = 0.00;
+    for (std::size_t i = 0; i < Size; i++)
+        expected_dot += a_vector[i + 1] * b_vector[i];
+    AMATRIX_CHECK_EQUAL(b_vector.dot(sub_vector), expected_dot);
+    AMATRIX_CHECK_EQUAL(AMatrix::Dot(sub_vector, b_vector), expected_dot);
+
+    // A matrix vector product reads the range directly
+    AMatrix::Matrix<double, AMatrix::dynamic, AMatrix::dynamic> a_matrix(
+        3, Size);
+    for (std::size_t i = 0; i < a_matrix.size(); i++)
+        a_matrix[i] = (i % 5) - 2.00;
+    dynamic_vector product(a_matrix * sub_vector);
+    for (std::size_t i = 0; i < 3; i++) {
+        double expected = 0.00;
+        for (std::size_t j = 0; j < Size; j++)
+            expected += a_matrix(i, j) * a_vector[j + 1];
+        AMATRIX_CHECK_EQUAL(product[i], expected);
+    }
+
+    const double factor = 2.00;
+    sub_vector = factor * b_vector;
+    sub_vector += b_vector;
+    sub_vector -= b_vector;
+    AMATRIX_CHECK_EQUAL(a_vector[0], -5.00);
+    for (std::size_t i = 0; i < Size; i++)
+        AMATRIX_CHECK_EQUAL(a_vector[i + 1], 2.00 * b_vector[i]);
+    AMATRIX_CHECK_EQUAL(a_vector[Size + 1], ((Size + 1) % 11) - 5.00);
+
+    return 0;  // not failed
+}
+
+/// Gathers and scatters of the degrees of freedom of an element
+std::size_t TestIndexedSubVector(std::size_t NumberOfDofs) {
+    const std::size_t global_size = 4 * NumberOfDofs + 3;
+    dynamic_vector global_vector(global_size);
+    for (std::size_t i = 0; i < global_size; i++)
+        global_vector[i] = double(i);
+    std::vector<std::size_t> dofs(NumberOfDofs);
+    for (std::size_t i = 0; i < NumberOfDofs; i++)
+        dofs[i] = (i * 7 + 3) % global_size;
+
+    AMatrix::IndexedSubVector<dynamic_vector> element_dofs(
+        global_vector, dofs);
+    AMATRIX_CHECK_EQUAL(element_dofs.size(), NumberOfDofs);
+    dynamic_vector element_vector(element_dofs);
+    for (std::size_t i = 0; i < NumberOfDofs; i++)
+        AMATRIX_CHECK_EQUAL(element_vector[i], double(dofs[i]));
+
+    // Assembly
+    dynamic_vector expected(global_vector);
+    for (std::size_t i = 0; i < NumberOfDofs; i++)
+        element_vector[i] = 0.50 * i;
+    element_dofs += element_vector;
+    for (std::size_t i = 0; i < NumberOfDofs; i++)
+        expected[dofs[i]] += 0.50 * i;
+    for (std::size_t i = 0; i < global_size; i++)
+        AMATRIX_CHECK_EQUAL(global_vector[i], expected[i]);
+
+    element_dofs = element_vector;
+    element_dofs -= 0.50 * element_vector;
+    for (std::size_t i = 0; i < NumberOfDofs; i++)
+        AMATRIX_CHECK_EQUAL(global_vector[dofs[i]], 0.25 * i);
+
+    return 0;  // not failed
+}
+
+/// A range shifted within its vector reads the original elements
+std::size_t TestShiftedSubVector(std::size_t Size) {
+    dynamic_vector a_vector(Size);
+    for (std::size_t i = 0; i < Size; i++)
+        a_vector[i] = double(i);
+
+    AMatrix::SubVector<dynamic_vector> head(a_vector, 0, Size - 1);
+    AMatrix::SubVector<dynamic_vector> tail(a_vector, 1, Size - 1);
+    tail = head;
+    AMATRIX_CHECK_EQUAL(a_vector[0], 0.00);
+    for (std::size_t i = 1; i < Size; i++)
+        AMATRIX_CHECK_EQUAL(a_vector[i], double(i - 1));
+
+    tail += head;
+    AMATRIX_CHECK_EQUAL(a_vector[1], 0.00);
+    for (std::size_t i = 2; i < Size; i++)
+        AMATRIX_CHECK_EQUAL(a_vector[i], double(2 * i - 3));
+
+    tail -= head;
+    AMATRIX_CHECK_EQUAL(a_vector[1], 0.00);
+    AMATRIX_CHECK_EQUAL(a_vector[2], 1.00);
+    for (std::size_t i = 3; i < Size; i++)
+        AMATRIX_CHECK_EQUAL(a_vector[i], 2.00);
+
+    return 0;  // not failed
+}
+
+/// A vector permuted into itself reads the original elements
+std::size_t TestIndexedSubVectorPermutation(std::size_t Size) {
+    dynamic_vector a_vector(Size);
+    for (std::size_t i = 0; i < Size; i++)
+        a_vector[i] = double(i);
+    std::vector<std::size_t> reversed(Size);
+    for (std::size_t i = 0; i < Size; i++)
+        reversed[i] = Size - 1 - i;
+
+    AMatrix::IndexedSubVector<dynamic_vector> reversed_vector(
+        a_vector, reversed);
+    AMatrix::SubVector<dynamic_vector> whole_vector(a_vector, 0, Size);
+    reversed_vector = whole_vector;
+    for (std::size_t i = 0; i < Size; i++)
+        AMATRIX_CHECK_EQUAL(a_vector[i], double(Size - 1 - i));
+
+    reversed_vector += whole_vector;
+    for (std::size_t i = 0; i < Size; i++)
+        AMATRIX_CHECK_EQUAL(a_vector[i], double(Size - 1));
+
+    return 0;  // not failed
+}
+
 int main() {
     std::size_t number_of_failed_tests = 0;
 
+    number_of_failed_tests += TestContiguousSubVector(3);
+    number_of_failed_tests += TestContiguousSubVector(100);
+    number_of_failed_tests += TestContiguousSubVector(5001);
+    number_of_failed_tests += TestIndexedSubVector(5);
+    number_of_failed_tests += TestIndexedSubVector(24);
+    number_of_failed_tests += TestIndexedSubVector(300);
+    number_of_failed_tests += TestShiftedSubVector(5);
+    number_of_failed_tests += TestShiftedSubVector(64);
+    number_of_failed_tests += TestIndexedSubVectorPermutation(5);
+    number_of_failed_tests += TestIndexedSubVectorPermutation(64);
+
     number_of_failed_tests += TestSubVectorAcess<1>();
     number_of_failed_tests += TestSubVectorAcess<2>();
     number_of_failed_tests += TestSubVectorAcess<3>();